@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace asr {
+
+// Subsystem an allocation is charged to. Code sets the tag for its thread
+// with AllocTagScope; anything outside a scope is kOther.
+enum class AllocTag : uint8_t { Other = 0, Decode, Vad, Asr, Ws, Metrics };
+
+inline constexpr size_t kAllocTagCount = 6;
+
+const char* alloc_tag_name(AllocTag tag) noexcept;
+
+struct AllocTagStats {
+  uint64_t alloc_bytes = 0;  // cumulative, bytes requested through operator new
+  uint64_t allocs      = 0;  // cumulative, operator new calls
+  int64_t  live_bytes  = 0;  // estimate from sampled allocations not yet freed
+};
+
+struct AllocSnapshot {
+  bool                                      enabled      = false;  // built with ASR_ENABLE_ALLOC_PROFILER
+  size_t                                    sample_bytes = 0;
+  uint64_t                                  untracked    = 0;  // samples the live table had no room for
+  std::array<AllocTagStats, kAllocTagCount> tags{};
+};
+
+// Allocation sampler, compiled in only with -DASR_ENABLE_ALLOC_PROFILER=ON
+// (ASR_ALLOC_PROFILER=1). The build then replaces the global operator
+// new/delete: every allocation adds its size to thread-local per-tag
+// counters, and once a thread has allocated about sample_bytes since its
+// last sample (jittered, so periodic allocation patterns do not alias) the
+// allocation that crossed the line is sampled. A sample flushes the thread's
+// counters into the process totals and remembers the pointer with the bytes
+// it stands for; freeing a sampled pointer subtracts them again, which makes
+// live_bytes an unbiased estimate at a resolution of roughly sample_bytes.
+// Unsampled allocations touch only thread-local memory; every free does one
+// cache-line probe of the sample table while samples are live.
+//
+// Without the build flag the scopes compile away and alloc_snapshot()
+// reports enabled = false.
+void          set_alloc_sample_bytes(size_t bytes);
+AllocSnapshot alloc_snapshot();
+
+// Per-tag totals of `after` plus, when window_sec > 0, the allocation rate
+// between the two snapshots.
+nlohmann::json alloc_report(const AllocSnapshot& before, const AllocSnapshot& after, double window_sec);
+
+#if ASR_ALLOC_PROFILER
+AllocTag exchange_alloc_tag(AllocTag tag) noexcept;
+
+class AllocTagScope {
+ public:
+  explicit AllocTagScope(AllocTag tag) noexcept : previous_(exchange_alloc_tag(tag)) {}
+  ~AllocTagScope() { exchange_alloc_tag(previous_); }
+
+  AllocTagScope(const AllocTagScope&)            = delete;
+  AllocTagScope& operator=(const AllocTagScope&) = delete;
+
+ private:
+  AllocTag previous_;
+};
+#else
+class AllocTagScope {
+ public:
+  explicit AllocTagScope(AllocTag /*tag*/) noexcept {}
+
+  AllocTagScope(const AllocTagScope&)            = delete;
+  AllocTagScope& operator=(const AllocTagScope&) = delete;
+};
+#endif
+
+}  // namespace asr
@@ -29,6 +29,14 @@ struct AudioData {
 struct AudioStreamStats {
   size_t samples      = 0;
   float  duration_sec = 0.0f;
+  double resample_sec = 0.0;  // wall time spent in StreamResampler
+};
+
+// Layout of a headerless PCM16 body (application/octet-stream or audio/L16).
+struct RawPcmFormat {
+  int  sample_rate = 16000;
+  int  channels    = 1;      // interleaved, downmixed to mono
+  bool big_endian  = false;  // audio/L16 is network byte order
 };
 
 struct OpusDecodeStats {
@@ -55,7 +63,19 @@ AudioData decode_audio(span<const uint8_t> data, std::string_view file_name, int
 
 // Stream decode supported audio formats in target sample rate and emit fixed-size chunks.
 // The callback is invoked sequentially for each chunk (and a final tail chunk if any).
+// With decode_threads > 1, Ogg Opus files of several minutes or more are split into up
+// to that many ranges decoded in parallel; chunks still arrive in order from the calling
+// thread, and resample_sec is then summed over the ranges. The decode_threads - 1 extra
+// threads are a budget shared by all concurrent calls; a call that finds it spent decodes
+// on the calling thread alone.
 AudioStreamStats decode_audio_streamed(span<const uint8_t> data, std::string_view file_name, int target_rate,
+                                       size_t chunk_samples, const AudioChunkCallback& on_chunk,
+                                       size_t decode_threads = 1);
+
+// Stream decode headerless PCM16 in the given layout into target_rate mono chunks,
+// same chunking contract as decode_audio_streamed. Throws AudioError on a body that
+// is not a whole number of frames or exceeds the 1-hour limit.
+AudioStreamStats decode_pcm16_streamed(span<const uint8_t> data, const RawPcmFormat& format, int target_rate,
                                        size_t chunk_samples, const AudioChunkCallback& on_chunk);
 
 // Decode base64 payload into raw bytes.
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace asr {
+
+struct Config;
+
+// One point of the search space: encoder variant x pool/thread split.
+struct AutotuneLayout {
+  std::string encoder_file;
+  int         pool_size        = 1;
+  int         threads_per_slot = 1;
+};
+
+struct AutotuneResult {
+  AutotuneLayout layout;
+  double         throughput      = 0.0;  // audio seconds decoded per wall second
+  double         p95_latency_sec = 0.0;  // per-decode latency of the calibration clip
+};
+
+// Measures a layout for at most budget_sec; throws on load failure.
+using AutotuneBenchFn = std::function<AutotuneResult(const AutotuneLayout&, double budget_sec)>;
+
+// Encoder variants shipped in model_dir, configured encoder first.
+std::vector<std::string> autotune_encoder_files(const Config& cfg);
+
+// Power-of-two pool sizes up to num_threads (capped at 8), each slot getting
+// num_threads / pool_size threads, for every encoder file.
+std::vector<AutotuneLayout> autotune_candidates(const std::vector<std::string>& encoder_files,
+                                                int                             num_threads);
+
+// Highest throughput among results whose p95 latency meets the target; if
+// none does, the lowest-latency result. nullopt when results is empty.
+std::optional<AutotuneResult> pick_autotune_result(const std::vector<AutotuneResult>& results,
+                                                   double latency_target_sec);
+
+// Benchmarks every candidate with an equal share of the budget. Candidates
+// that fail to load are logged and skipped.
+std::optional<AutotuneResult> autotune_layouts(const std::vector<AutotuneLayout>& candidates,
+                                               double budget_sec, double latency_target_sec,
+                                               const AutotuneBenchFn& bench);
+
+// Cache key: CPU model and ISA flags plus every input that changes the answer.
+std::string autotune_fingerprint(const Config& cfg, const std::vector<std::string>& encoder_files);
+
+// Cache file is a JSON object of fingerprint -> layout, so a models volume
+// shared by different hosts keeps one entry per CPU type.
+std::optional<AutotuneLayout> load_autotune_cache(const std::string& path, const std::string& fingerprint);
+bool                          save_autotune_cache(const std::string& path, const std::string& fingerprint,
+                                                  const AutotuneResult& result);
+
+// Rewrites encoder_file / recognizer_pool_size / num_threads, then
+// re-resolves the pool limits: an auto max_concurrent_requests follows the
+// new shared slot count, and the realtime reservation and an explicit limit
+// are clamped to the new pool.
+void apply_autotune_layout(Config& cfg, const AutotuneLayout& layout);
+
+// Config a candidate is measured with: the layout applied, and every pool
+// slot open to the bench threads. Realtime-reserved slots would leave the
+// shared decodes queued behind them and elastic threads would hand a lone
+// decode the whole CPU, and neither is what the layout is ranked on.
+Config autotune_bench_config(const Config& base, const AutotuneLayout& layout);
+
+// Startup entry point (AUTOTUNE=1): reuses the cached layout for this host or
+// calibrates Recognizer pools on synthetic audio, then applies and caches it.
+// Keeps the configured layout if calibration produces nothing.
+void run_autotune(Config& cfg);
+
+}  // namespace asr
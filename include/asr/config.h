@@ -17,17 +17,40 @@ struct Config {
   std::string host                        = "0.0.0.0";
   uint16_t    port                        = 8081;
   size_t      threads                     = std::thread::hardware_concurrency();
-  size_t      idle_connection_timeout_sec = 0;  // 0 = no idle close
+  size_t      idle_connection_timeout_sec = 0;           // 0 = no idle close
+  bool        server_timing               = false;       // Server-Timing breakdown, see request_timing.h
+  std::string admin_token;                               // enables /admin/* endpoints, empty = disabled
+  size_t      alloc_sample_bytes          = 512 * 1024;  // /admin/allocations interval, see alloc_profiler.h
 
   // Model paths
-  std::string model_dir = "models/sherpa-onnx-nemo-transducer-punct-giga-am-v3-russian-2025-12-16";
-  std::string vad_model = "models/silero_vad.onnx";
+  std::string model_dir    = "models/sherpa-onnx-nemo-transducer-punct-giga-am-v3-russian-2025-12-16";
+  std::string vad_model    = "models/silero_vad.onnx";
+  std::string encoder_file = "encoder.int8.onnx";  // encoder variant inside model_dir
+
+  // Startup auto-tuning of encoder variant and pool/thread layout (see autotune.h)
+  bool        autotune                   = false;
+  std::string autotune_cache;                  // empty = <model_dir>/autotune.json
+  float       autotune_budget_sec        = 60.0f;
+  size_t      autotune_latency_target_ms = 1000;  // p95 decode latency of the calibration clip
 
   // ASR
-  std::string provider    = "cpu";
-  int         num_threads = 4;
-  int         sample_rate = 16000;
-  int         feature_dim = 64;
+  std::string recognizer_backend = "sherpa";  // sherpa | synthetic (model-free, see synthetic_recognizer.h)
+  std::string provider           = "cpu";
+  int         num_threads        = 4;
+  int         sample_rate        = 16000;
+  int         feature_dim        = 64;
+
+  // Synthetic backend cost model: call_ms + ms_per_audio_sec * audio_sec +- jitter_ms
+  float synthetic_call_ms          = 5.0f;
+  float synthetic_ms_per_audio_sec = 30.0f;
+  float synthetic_jitter_ms        = 0.0f;
+  bool  synthetic_burn_cpu         = false;  // spin instead of sleep
+
+  // Decoding: greedy_search | modified_beam_search | adaptive (beam while the pool is idle)
+  std::string decoding_method       = "greedy_search";
+  int         max_active_paths      = 4;      // beam size for modified_beam_search
+  float       adaptive_beam_below   = 0.25f;  // pressure at/below which adaptive returns to beam search
+  float       adaptive_greedy_above = 0.5f;   // pressure above which adaptive falls back to greedy
 
   // VAD
   float vad_threshold    = 0.5f;
@@ -36,13 +59,38 @@ struct Config {
   float vad_max_speech   = 20.0f;
   int   vad_window_size  = 512;
   int   vad_context_size = 64;
+  // Per-connection threshold raised on noisy channels, up to vad_threshold_max (see vad_threshold.h)
+  bool  vad_adaptive_threshold = false;
+  float vad_threshold_max      = 0.85f;
+  // Pre-ASR tone/music/noise classifier: off | flag | drop (see segment_classifier.h)
+  std::string nonspeech_filter = "off";
+  // Decode the open segment once trailing silence reaches this fraction of
+  // the VAD min silence, on a free recognizer slot; 0 = disabled
+  float speculative_fraction = 0.0f;
 
   // Concurrency
   int    recognizer_pool_size       = 1;  // default = 1
-  size_t max_concurrent_requests    = 0;  // 0 = auto = recognizer_pool_size
+  size_t recognizer_realtime_slots  = 0;  // pool slots only realtime segments may use
+  size_t max_concurrent_requests    = 0;  // 0 = auto = shared recognizer slots
   size_t recognizer_wait_timeout_ms = 30000;
+  bool   recognizer_elastic_threads = false;  // all NUM_THREADS for a decode on an otherwise idle pool
   size_t max_ws_connections         = 0;  // 0 = unlimited
 
+  // Load-aware readiness (/readyz); ratio/latency thresholds, 0 disables a signal
+  float  ready_queue_degraded        = 0.5f;   // executor queue depth / capacity
+  float  ready_queue_not_ready       = 0.9f;
+  float  ready_slots_degraded        = 1.0f;   // busy recognizer slots / pool size
+  float  ready_slots_not_ready       = 0.0f;
+  size_t ready_wait_p95_degraded_ms  = 500;    // recent recognizer slot wait p95
+  size_t ready_wait_p95_not_ready_ms = 5000;
+  size_t memory_budget_bytes         = 0;      // 0 = no memory budget
+  float  ready_memory_degraded       = 0.85f;  // RSS / memory_budget_bytes
+  float  ready_memory_not_ready      = 0.95f;
+  float  ready_recover_ratio         = 0.8f;   // hysteresis band for stepping back down
+
+  // Tenants: "name:api_key:weight[:max_concurrent[:audio_sec_per_min]];..." (empty = single tenant)
+  std::string tenants;
+
   // Audio
   float  silence_threshold       = 0.008f;
   float  min_audio_sec           = 0.5f;
@@ -50,10 +98,24 @@ struct Config {
   float  live_flush_interval_sec = 6.0f;  // 0 = disabled
   size_t max_upload_bytes        = static_cast<size_t>(100) * 1024 * 1024;
   size_t max_ws_message_bytes    = static_cast<size_t>(4) * 1024 * 1024;  // 4 MB per WS frame
+  float  realtime_lag_alert_sec  = 0.0f;                                  // lag alert threshold, 0 = off
+  // Ranges of a long Ogg Opus upload decoded in parallel, 0 = all cores; the
+  // N - 1 extra decoder threads are shared by all concurrent uploads
+  size_t opus_decode_threads     = 1;
+
+  // Inbound realtime traffic per connection for asr-replay (see realtime_recording.h); empty dir = off
+  std::string realtime_record_dir;
+  size_t      realtime_record_max_bytes = static_cast<size_t>(64) * 1024 * 1024;  // per connection
 
   // Parse all from environment variables
   static Config from_env();
   void          validate();
+
+  // Pool part of validate(): clamps the realtime reservation and resolves
+  // max_concurrent_requests against the shared slots; re-run after the pool
+  // is resized (autotune).
+  void                 resolve_recognizer_slots();
+  [[nodiscard]] size_t shared_recognizer_slots() const;  // pool slots HTTP requests may use
 };
 
 }  // namespace asr
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace asr {
+
+// Transducer search actually run for a decode.
+enum class DecodingMethod {
+  Greedy,
+  ModifiedBeamSearch,
+};
+
+// Configured strategy (DECODING_METHOD): a fixed method or load-adaptive.
+enum class DecodingStrategy {
+  Greedy,
+  ModifiedBeamSearch,
+  Adaptive,
+};
+
+// Throws ConfigError for anything but greedy_search | modified_beam_search | adaptive.
+DecodingStrategy parse_decoding_strategy(std::string_view value);
+const char*      decoding_method_name(DecodingMethod method) noexcept;
+
+// Picks beam search while the pool has spare capacity and falls back to greedy
+// under load. Pressure is (other busy slots + queued work) / pool size, so a
+// lone request on an idle pool always gets beam search. Hysteresis: switch to
+// greedy above greedy_above, back to beam only at or below beam_below.
+// Not thread-safe; the recognizer calls it under its pool mutex.
+class AdaptiveDecodingPolicy {
+ public:
+  AdaptiveDecodingPolicy(double beam_below, double greedy_above);
+
+  DecodingMethod               select(size_t busy_others, size_t queued, size_t slots_total);
+  [[nodiscard]] DecodingMethod current() const noexcept;
+
+ private:
+  double         beam_below_;
+  double         greedy_above_;
+  DecodingMethod current_ = DecodingMethod::ModifiedBeamSearch;
+};
+
+}  // namespace asr
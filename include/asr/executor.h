@@ -1,21 +1,77 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
-#include <deque>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace asr {
 
+// Fixed-capacity FIFO over a preallocated vector. Unlike std::deque it never
+// allocates on push or pop, so a bounded queue is allocation-free once built.
+// Callers check full() before push_back(). pop_front() resets the slot so a
+// popped callable releases its captures immediately. Capacity is at least 1.
+template <typename T>
+class FixedRing {
+ public:
+  explicit FixedRing(size_t capacity = 1) : slots_(std::max<size_t>(1, capacity)) {}
+
+  [[nodiscard]] bool empty() const noexcept {
+    return size_ == 0;
+  }
+  [[nodiscard]] bool full() const noexcept {
+    return size_ == slots_.size();
+  }
+  [[nodiscard]] size_t size() const noexcept {
+    return size_;
+  }
+
+  void push_back(T value) {
+    slots_[(head_ + size_) % slots_.size()] = std::move(value);
+    ++size_;
+  }
+
+  T& front() {
+    return slots_[head_];
+  }
+
+  void pop_front() {
+    slots_[head_] = T();
+    head_         = (head_ + 1) % slots_.size();
+    --size_;
+  }
+
+  void clear() {
+    while (!empty()) {
+      pop_front();
+    }
+  }
+
+ private:
+  std::vector<T> slots_;
+  size_t         head_ = 0;
+  size_t         size_ = 0;
+};
+
+// Fixed worker pool with a bounded queue split into weighted lanes (one per
+// tenant). Workers pick the non-empty lane with the smallest virtual pass and
+// advance it by kStride / weight, so queued work is interleaved in proportion
+// to the weights instead of strict FIFO. Each lane may hold at most its
+// weighted share of queue_capacity, which keeps one tenant from filling the
+// whole queue.
 class BoundedExecutor {
  public:
   using Task = std::function<void()>;
 
-  BoundedExecutor(size_t worker_count, size_t queue_capacity);
+  BoundedExecutor(size_t worker_count, size_t queue_capacity, std::vector<uint32_t> lane_weights = {1});
   ~BoundedExecutor();
 
   BoundedExecutor(const BoundedExecutor&)            = delete;
@@ -23,49 +79,147 @@ class BoundedExecutor {
   BoundedExecutor(BoundedExecutor&&)                 = delete;
   BoundedExecutor& operator=(BoundedExecutor&&)      = delete;
 
-  bool try_submit(Task task);
+  // Out-of-range lanes fall back to lane 0.
+  bool try_submit(Task task, size_t lane = 0);
   void shutdown();
   bool wait_for_idle(std::chrono::milliseconds timeout);
 
   [[nodiscard]] size_t queued() const;
+  [[nodiscard]] size_t queued(size_t lane) const;
   [[nodiscard]] size_t in_flight() const;
   [[nodiscard]] size_t capacity() const noexcept;
+  [[nodiscard]] size_t lane_count() const noexcept;
 
  private:
-  void worker_loop();
+  static constexpr uint64_t kStride = uint64_t{1} << 20;
+
+  struct Lane {
+    FixedRing<Task> queue;
+    uint64_t        pass   = 0;
+    uint32_t        weight = 1;
+    size_t          limit  = 0;
+  };
+
+  void  worker_loop();
+  Lane* next_lane();
 
   const size_t             queue_capacity_;
   mutable std::mutex       mutex_;
   std::condition_variable  cv_;
   std::condition_variable  idle_cv_;
-  std::deque<Task>         queue_;
+  std::vector<Lane>        lanes_;
   std::vector<std::thread> workers_;
-  size_t                   in_flight_ = 0;
-  bool                     stopping_  = false;
+  size_t                   queued_       = 0;
+  uint64_t                 virtual_time_ = 0;
+  size_t                   in_flight_    = 0;
+  bool                     stopping_     = false;
 };
 
-class SerializedTaskQueue {
+// Bounded single-producer mailbox of a serial actor. The producer fills
+// back_slot() and push()es it; whoever owns the drain handles front() and
+// pop()s it. A single atomic count is the whole protocol: push() returns true
+// on the empty -> non-empty transition, and the producer then owns the drain
+// and must schedule it; pop() returns false when the count drops back to
+// zero, handing ownership back. Only the drain owner touches front() and
+// pop(), and the acquire/release on the count publishes slot contents both
+// ways, so an event costs one atomic add and one atomic subtract. Slots are
+// reused and keep their buffers between messages.
+template <typename T>
+class ActorMailbox {
  public:
-  using StartFn = std::function<bool()>;
+  explicit ActorMailbox(size_t capacity) : slots_(std::max<size_t>(1, capacity)) {}
+
+  // Producer: the next free slot, or nullptr when full.
+  T* back_slot() {
+    return count_.load(std::memory_order_acquire) == slots_.size() ? nullptr : &slots_[tail_];
+  }
+
+  // Producer: publishes back_slot(). True when the caller now owns the drain.
+  [[nodiscard]] bool push() {
+    tail_ = (tail_ + 1) % slots_.size();
+    return count_.fetch_add(1, std::memory_order_acq_rel) == 0;
+  }
 
-  explicit SerializedTaskQueue(size_t max_pending);
+  // Drain owner: the oldest published slot.
+  T& front() {
+    return slots_[head_];
+  }
 
-  bool push_or_start(StartFn start);
-  void finish_current();
-  bool maybe_start_next();
-  void stop(bool drop_pending = true);
-  void clear();
+  // Drain owner: releases front(). False when the mailbox is now empty and
+  // the drain has been handed back to the next push().
+  bool pop() {
+    head_ = (head_ + 1) % slots_.size();
+    return count_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+  }
 
-  [[nodiscard]] bool   in_flight() const noexcept;
-  [[nodiscard]] bool   stopped() const noexcept;
-  [[nodiscard]] size_t pending() const noexcept;
+  [[nodiscard]] size_t size() const noexcept {
+    return count_.load(std::memory_order_acquire);
+  }
+  [[nodiscard]] size_t capacity() const noexcept {
+    return slots_.size();
+  }
 
  private:
-  mutable std::mutex  mutex_;
-  size_t              max_pending_ = 0;
-  std::deque<StartFn> pending_;
-  bool                in_flight_ = false;
-  bool                stopped_   = false;
+  std::vector<T>      slots_;
+  std::atomic<size_t> count_{0};
+  size_t              tail_ = 0;  // producer only
+  size_t              head_ = 0;  // drain owner only
+};
+
+// Drain scheduling of an ActorMailbox whose producer is one event loop. The
+// producer (pushed(), closed()), every drain completion and every retry run
+// on that same loop, so the counters below are plain fields; an executor
+// worker only runs the drain batch and posts its result back. A self
+// reference keeps the actor alive while a drain or retry is outstanding, and
+// a close that arrives meanwhile is deferred until the actor is idle.
+//
+// Subclasses bind the loop (post, post_after), the executor (submit_drain,
+// whose task calls run_batch()) and the mailbox (run_front).
+class LoopActor {
+ public:
+  static constexpr size_t kBatch         = 4;     // events per drain task
+  static constexpr double kRetryDelaySec = 0.01;  // executor full: retry after
+
+  LoopActor()          = default;
+  virtual ~LoopActor() = default;
+
+  LoopActor(const LoopActor&)            = delete;
+  LoopActor& operator=(const LoopActor&) = delete;
+  LoopActor(LoopActor&&)                 = delete;
+  LoopActor& operator=(LoopActor&&)      = delete;
+
+  // Loop thread: an event was published; owns_drain is the mailbox push() result.
+  void pushed(const std::shared_ptr<LoopActor>& self, bool owns_drain);
+
+  // Loop thread: the transport closed. on_closed() runs now, or once the
+  // last outstanding drain or retry has finished.
+  void closed();
+
+  // Executor worker owning the drain: runs up to kBatch events, then hands
+  // the drain back to the loop, released when the mailbox ran empty and
+  // still owned otherwise, so other actors on the lane get a turn.
+  void run_batch();
+
+  // Set on close or overflow; the loop then drains in place instead of
+  // submitting. Read by the drain owner.
+  std::atomic<bool> stop_processing{false};
+
+ protected:
+  virtual void post(std::function<void()> fn)                         = 0;  // run on the loop
+  virtual void post_after(double delay_sec, std::function<void()> fn) = 0;
+  virtual bool submit_drain()                                         = 0;  // false: executor full
+  virtual bool run_front()                                            = 0;  // run + pop; false: empty
+  virtual void on_closed()                                            = 0;  // loop thread, actor idle
+
+ private:
+  void start_drain(const std::shared_ptr<LoopActor>& self);
+  void drain_finished(bool owned);
+  void settle();
+
+  std::shared_ptr<LoopActor> keepalive_;
+  size_t                     drains_outstanding_ = 0;
+  bool                       retry_scheduled_    = false;
+  bool                       close_pending_      = false;
 };
 
 }  // namespace asr
@@ -3,13 +3,17 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "asr/metrics.h"
+#include "asr/segment_classifier.h"
 #include "asr/vad.h"
+#include "asr/vad_threshold.h"
 
 namespace asr {
-class Recognizer;
+class RecognizerBackend;
 struct Config;
 template <typename T>
 class span;
@@ -17,18 +21,55 @@ class span;
 
 namespace asr {
 
-class ASRSession {
+// One message of a session reply. json is the legacy wire form and stays
+// empty under policies that do not send it.
+struct ASRSessionMessage {
+  enum Type { Interim, Final, Done } type = Interim;
+  std::string json;
+  std::string text;
+};
+
+// Protocol policies for BasicASRSession. Each fixes at compile time what a
+// session produces besides final texts, so a mode does not format, count or
+// buffer anything its protocol never sends:
+//
+//   kInterims     an interim status message for each on_audio without a final
+//   kJson         json filled in for interim/final/done messages
+//   kLiveUpdates  periodic live flush, the RMS fallback decode of audio the
+//                 VAD did not claim, and speculative turn-end decodes
+//   kMetricMode   label of the request and TTFR metrics
+//
+// Legacy interim/final/done WebSocket protocol.
+struct LegacySessionPolicy {
+  static constexpr bool       kInterims    = true;
+  static constexpr bool       kJson        = true;
+  static constexpr bool       kLiveUpdates = true;
+  static constexpr MetricMode kMetricMode  = MetricMode::RealtimeWebsocket;
+};
+
+// OpenAI Realtime: events are built from final texts and speech transitions.
+struct RealtimeSessionPolicy {
+  static constexpr bool       kInterims    = false;
+  static constexpr bool       kJson        = false;
+  static constexpr bool       kLiveUpdates = true;
+  static constexpr MetricMode kMetricMode  = MetricMode::RealtimeWebsocket;
+};
+
+// A whole recording pushed through VAD: finals at segment ends, then done.
+struct OfflineSessionPolicy {
+  static constexpr bool       kInterims    = false;
+  static constexpr bool       kJson        = false;
+  static constexpr bool       kLiveUpdates = false;
+  static constexpr MetricMode kMetricMode  = MetricMode::Http;
+};
+
+template <typename Policy>
+class BasicASRSession {
  public:
   using SpeechTransition = asr::SpeechTransition;
+  using OutMessage       = ASRSessionMessage;
 
-  ASRSession(Recognizer& recognizer, const VadConfig& vad_config, const Config& config,
-             std::string metrics_mode);
-
-  struct OutMessage {
-    enum Type { Interim, Final, Done } type = Interim;
-    std::string json;
-    std::string text;
-  };
+  BasicASRSession(RecognizerBackend& recognizer, const VadConfig& vad_config, const Config& config);
 
   // Process binary audio chunk (float32 samples).
   // Returns a view into an internal buffer — valid until the next call.
@@ -71,6 +112,18 @@ class ASRSession {
   // finalize any segment.
   void process_live_chunk_fallback();
 
+  // Decode the open segment early once VAD is most of the way through a
+  // turn-end pause and a recognizer slot is free; take_speculation() hands
+  // the result to process_vad_segments() when the finalized segment is the
+  // exact audio that was decoded.
+  void maybe_speculate();
+  bool take_speculation(const SpeechSegment& segment, std::string& text, double& decode_sec);
+  void drop_speculation();
+
+  // Run the full pending_ window through VAD; real_samples of it (the rest
+  // is padding) go to live_chunk_ unless VAD takes the window as speech.
+  void feed_vad_window(size_t real_samples);
+
   [[nodiscard]] bool has_final_messages() const;
 
   // Pad remaining pending samples and flush VAD
@@ -86,15 +139,25 @@ class ASRSession {
   void write_final(const std::string& text, float duration);
   void write_done();
 
-  Recognizer&           recognizer_;
-  VoiceActivityDetector vad_;
-  const Config&         config_;
-  std::string           metrics_mode_;
+  RecognizerBackend&                  recognizer_;
+  VoiceActivityDetector               vad_;
+  const Config&                       config_;
+  std::optional<AdaptiveVadThreshold> vad_threshold_;  // VAD_ADAPTIVE_THRESHOLD, kept across sessions
+  NonSpeechMode                       nonspeech_mode_;
+  std::optional<SegmentClassifier>    segment_classifier_;  // unless NONSPEECH_FILTER=off
 
   // Sub-window accumulator
   std::vector<float> pending_;
+  // Audio VAD did not claim as speech, for the RMS fallback decode (kLiveUpdates)
   std::vector<float> live_chunk_;
 
+  // Speculative decode of the open segment (start sample + length identify the audio)
+  std::string spec_text_;
+  int64_t     spec_start_sample_ = -1;  // -1 = none for the current pause
+  size_t      spec_samples_      = 0;
+  double      spec_decode_sec_   = 0.0;
+  bool        spec_ready_        = false;  // false: attempted but no slot was free
+
   // Session state
   TimePoint start_ts_;
   TimePoint first_result_ts_;
@@ -113,4 +176,13 @@ class ASRSession {
   uint64_t  session_seq_             = 0;
 };
 
+// Instantiated in handler.cpp.
+extern template class BasicASRSession<LegacySessionPolicy>;
+extern template class BasicASRSession<RealtimeSessionPolicy>;
+extern template class BasicASRSession<OfflineSessionPolicy>;
+
+using LegacyASRSession   = BasicASRSession<LegacySessionPolicy>;
+using RealtimeASRSession = BasicASRSession<RealtimeSessionPolicy>;
+using OfflineASRSession  = BasicASRSession<OfflineSessionPolicy>;
+
 }  // namespace asr
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace asr {
+struct Config;
+}  // namespace asr
+
+namespace asr {
+
+enum class LoadState { Ok = 0, Degraded = 1, NotReady = 2 };
+
+const char* load_state_name(LoadState state) noexcept;
+
+// Point-in-time view of the node's capacity, gathered by the readiness probe.
+struct LoadSnapshot {
+  size_t queued              = 0;
+  size_t queue_capacity      = 0;
+  size_t in_flight           = 0;
+  size_t slots_busy          = 0;
+  size_t slots_total         = 0;
+  double wait_p95_sec        = 0.0;
+  size_t rss_bytes           = 0;
+  size_t memory_budget_bytes = 0;  // 0 = no budget
+
+  [[nodiscard]] double queue_utilization() const noexcept;
+  [[nodiscard]] double slot_utilization() const noexcept;
+  [[nodiscard]] double memory_utilization() const noexcept;
+};
+
+// Per-signal thresholds; 0 disables a signal.
+struct LoadThresholds {
+  double queue_degraded     = 0.5;
+  double queue_not_ready    = 0.9;
+  double slots_degraded     = 1.0;
+  double slots_not_ready    = 0.0;
+  double wait_p95_degraded  = 0.5;  // seconds
+  double wait_p95_not_ready = 5.0;  // seconds
+  double memory_degraded    = 0.85;
+  double memory_not_ready   = 0.95;
+  double recover_ratio      = 0.8;  // leave a state only below threshold * recover_ratio
+
+  static LoadThresholds from_config(const Config& cfg);
+};
+
+// Raises the state as soon as a threshold is crossed and lowers it only once
+// every signal is back under its threshold scaled by recover_ratio, so a node
+// hovering around a limit does not flap in and out of the balancer pool.
+class LoadStateTracker {
+ public:
+  explicit LoadStateTracker(const LoadThresholds& thresholds);
+
+  LoadState               update(const LoadSnapshot& snapshot);
+  [[nodiscard]] LoadState state() const;
+
+ private:
+  [[nodiscard]] LoadState classify(const LoadSnapshot& snapshot, double scale) const;
+
+  LoadThresholds     thresholds_;
+  mutable std::mutex mutex_;
+  LoadState          state_ = LoadState::Ok;
+};
+
+// Fixed-size ring of recent latency samples; samples older than max_age are
+// ignored so the percentile decays back to zero once traffic stops.
+class RecentLatencyWindow {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit RecentLatencyWindow(size_t capacity = 256,
+                               std::chrono::seconds max_age = std::chrono::seconds(30));
+
+  // Not synchronized: callers hold their own lock.
+  void                 record(double sec, Clock::time_point now = Clock::now());
+  [[nodiscard]] double percentile(double q, Clock::time_point now = Clock::now()) const;
+
+ private:
+  struct Sample {
+    Clock::time_point at;
+    double            sec = 0.0;
+  };
+
+  std::vector<Sample>         samples_;
+  mutable std::vector<double> scratch_;
+  size_t                      next_ = 0;
+  size_t                      size_ = 0;
+  std::chrono::seconds        max_age_;
+};
+
+// Resident set size of this process, 0 when the platform does not expose it.
+size_t current_rss_bytes() noexcept;
+
+}  // namespace asr
@@ -2,11 +2,17 @@
 
 #include <prometheus/registry.h>
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <vector>
+
+#include "asr/decoding_policy.h"
+#include "asr/segment_classifier.h"
 
 namespace prometheus {
 class Counter;
@@ -18,6 +24,11 @@ class Family;
 
 namespace asr {
 
+enum class SlotClass : uint8_t;  // recognizer.h
+
+// Request/TTFR metrics label: "realtime_websocket", "http" or "whisper_api".
+enum class MetricMode : uint8_t { RealtimeWebsocket, Http, WhisperApi };
+
 class ASRMetrics {
  public:
   static ASRMetrics& instance();
@@ -26,12 +37,17 @@ class ASRMetrics {
   static void shutdown();
 
   // Pipeline metrics
+  // The string overloads map unknown modes to http.
   void observe_ttfr(double sec, const std::string& mode);
+  void observe_ttfr(double sec, MetricMode mode);
   void observe_segment(double audio_sec, double decode_sec);
   void observe_request(double total_sec, double audio_sec, double decode_sec, int chunk_count,
                        size_t bytes_count, double preprocess_sec, double io_sec, const std::string& mode,
                        const std::string& status);
-  void observe_recognizer_wait(double sec, bool timed_out);
+  void observe_request(double total_sec, double audio_sec, double decode_sec, int chunk_count,
+                       size_t bytes_count, double preprocess_sec, double io_sec, MetricMode mode,
+                       const std::string& status);
+  void observe_recognizer_wait(double sec, bool timed_out, SlotClass slot_class);
   void observe_error(const std::string& error_type);
 
   // Connection metrics
@@ -45,6 +61,37 @@ class ASRMetrics {
   void record_audio_level(double rms);
   void record_silence();
   void set_speech_ratio(double ratio);
+  // Adaptive VAD threshold and noise floor of a connection, sampled per decoded segment
+  void observe_vad_threshold(double threshold, double noise_floor_dbfs);
+  // A segment or upload chunk the pre-ASR classifier took for non-speech (NONSPEECH_FILTER)
+  void observe_nonspeech_segment(SegmentClass kind, bool dropped);
+
+  // Readiness load state: 0 = ok, 1 = degraded, 2 = not_ready
+  void set_load_state(int state);
+
+  // Decoding method of the latest decode (0 = greedy, 1 = modified_beam_search) and per-method counts
+  void set_decoding_mode(int mode);
+  void observe_decode_method(DecodingMethod method);
+
+  // Tenant metrics: labeled instances are created once per configured tenant
+  // (index = tenant id); out-of-range ids are ignored.
+  void register_tenants(const std::vector<std::string>& names);
+  void observe_tenant_audio(size_t tenant, double audio_sec);
+  void observe_tenant_queue_wait(size_t tenant, double sec);
+  void observe_tenant_rejection(size_t tenant, std::string_view reason);  // concurrency | quota | queue_full
+  void set_tenant_active(size_t tenant, size_t active);
+
+  // Realtime lag: how far processed audio trails the wall clock, and speech
+  // end to transcript latency. Worst-lag gauges are ranked 1..kRealtimeLagRanks.
+  static constexpr size_t kRealtimeLagRanks = 5;
+  void                    observe_realtime_lag(double sec);
+  void                    observe_realtime_final_latency(double sec);
+  void                    set_realtime_worst_lag(size_t rank, double sec);
+  void                    observe_realtime_lag_alert(bool lagging);
+
+  // Speculative turn-end decodes: hit (emitted as the final), discarded
+  // (speech resumed) or busy (skipped, no free recognizer slot).
+  void observe_speculative_decode(std::string_view outcome);
 
   std::shared_ptr<prometheus::Registry> registry();
 
@@ -107,6 +154,25 @@ class ASRMetrics {
   prometheus::Family<prometheus::Counter>*   low_volume_warnings_family_    = nullptr;
   prometheus::Family<prometheus::Counter>*   detected_language_family_      = nullptr;
   prometheus::Family<prometheus::Gauge>*     speech_ratio_family_           = nullptr;
+  prometheus::Family<prometheus::Gauge>*     load_state_family_             = nullptr;
+  prometheus::Family<prometheus::Gauge>*     decoding_mode_family_          = nullptr;
+  prometheus::Family<prometheus::Counter>*   decodes_total_family_          = nullptr;
+  prometheus::Family<prometheus::Histogram>* vad_threshold_family_          = nullptr;
+  prometheus::Family<prometheus::Histogram>* vad_noise_floor_family_        = nullptr;
+  prometheus::Family<prometheus::Counter>*   nonspeech_segments_family_     = nullptr;
+
+  // ===== Tenant Metrics =====
+  prometheus::Family<prometheus::Counter>*   tenant_audio_seconds_family_ = nullptr;
+  prometheus::Family<prometheus::Histogram>* tenant_queue_wait_family_    = nullptr;
+  prometheus::Family<prometheus::Counter>*   tenant_rejections_family_    = nullptr;
+  prometheus::Family<prometheus::Gauge>*     tenant_active_family_        = nullptr;
+
+  // ===== Realtime Lag Metrics =====
+  prometheus::Family<prometheus::Histogram>* realtime_lag_family_           = nullptr;
+  prometheus::Family<prometheus::Histogram>* realtime_final_latency_family_ = nullptr;
+  prometheus::Family<prometheus::Gauge>*     realtime_worst_lag_family_     = nullptr;
+  prometheus::Family<prometheus::Counter>*   realtime_lag_alerts_family_    = nullptr;
+  prometheus::Family<prometheus::Counter>*   speculative_decodes_family_    = nullptr;
 
   // ===== Pre-fetched metric instances (created once in initialize()) =====
   // Histograms
@@ -123,36 +189,64 @@ class ASRMetrics {
   ModeMetricCache http_mode_;
   ModeMetricCache whisper_api_mode_;
 
+  struct TenantMetricCache {
+    prometheus::Counter*   audio_seconds          = nullptr;
+    prometheus::Histogram* queue_wait             = nullptr;
+    prometheus::Counter*   rejections_concurrency = nullptr;
+    prometheus::Counter*   rejections_quota       = nullptr;
+    prometheus::Counter*   rejections_queue_full  = nullptr;
+    prometheus::Gauge*     active                 = nullptr;
+  };
+  std::vector<TenantMetricCache> tenant_metrics_;
+
   prometheus::Histogram* decode_duration_     = nullptr;
   prometheus::Histogram* segment_duration_    = nullptr;
   prometheus::Histogram* segment_rtf_         = nullptr;
   prometheus::Histogram* audio_duration_      = nullptr;
   prometheus::Histogram* preprocess_duration_ = nullptr;
   prometheus::Histogram* io_duration_         = nullptr;
-  prometheus::Histogram* recognizer_wait_     = nullptr;
   prometheus::Histogram* connection_duration_ = nullptr;
   prometheus::Histogram* session_duration_    = nullptr;
   prometheus::Histogram* words_per_request_   = nullptr;
   prometheus::Histogram* audio_rms_           = nullptr;
+  prometheus::Histogram* vad_threshold_       = nullptr;
+  prometheus::Histogram* vad_noise_floor_     = nullptr;
+
+  // [tone, music, noise][flagged, dropped]
+  std::array<std::array<prometheus::Counter*, 2>, 3> nonspeech_segments_{};
+
+  // Indexed by SlotClass
+  std::array<prometheus::Histogram*, 2> recognizer_wait_{};
+  std::array<prometheus::Counter*, 2>   recognizer_wait_timeouts_{};
+
+  prometheus::Histogram*                            realtime_lag_           = nullptr;
+  prometheus::Histogram*                            realtime_final_latency_ = nullptr;
+  std::array<prometheus::Gauge*, kRealtimeLagRanks> realtime_worst_lag_{};
+  prometheus::Counter*                              realtime_lag_alerts_lagging_   = nullptr;
+  prometheus::Counter*                              realtime_lag_alerts_recovered_ = nullptr;
+  prometheus::Counter*                              speculative_hit_               = nullptr;
+  prometheus::Counter*                              speculative_discarded_         = nullptr;
+  prometheus::Counter*                              speculative_busy_              = nullptr;
 
   // Counters
-  prometheus::Counter* segments_total_           = nullptr;
-  prometheus::Counter* audio_seconds_total_      = nullptr;
-  prometheus::Counter* chunks_total_             = nullptr;
-  prometheus::Counter* bytes_total_              = nullptr;
-  prometheus::Counter* recognizer_wait_timeouts_ = nullptr;
-  prometheus::Counter* connections_total_        = nullptr;
-  prometheus::Counter* sessions_total_           = nullptr;
-  prometheus::Counter* empty_results_total_      = nullptr;
-  prometheus::Counter* words_total_              = nullptr;
-  prometheus::Counter* characters_total_         = nullptr;
-  prometheus::Counter* silence_segments_total_   = nullptr;
-  prometheus::Counter* low_volume_warnings_      = nullptr;
+  prometheus::Counter* segments_total_         = nullptr;
+  prometheus::Counter* audio_seconds_total_    = nullptr;
+  prometheus::Counter* chunks_total_           = nullptr;
+  prometheus::Counter* bytes_total_            = nullptr;
+  prometheus::Counter* connections_total_      = nullptr;
+  prometheus::Counter* sessions_total_         = nullptr;
+  prometheus::Counter* empty_results_total_    = nullptr;
+  prometheus::Counter* words_total_            = nullptr;
+  prometheus::Counter* characters_total_       = nullptr;
+  prometheus::Counter* silence_segments_total_ = nullptr;
+  prometheus::Counter* low_volume_warnings_    = nullptr;
 
   // Gauges
   prometheus::Gauge* active_connections_ = nullptr;
   prometheus::Gauge* active_sessions_    = nullptr;
   prometheus::Gauge* speech_ratio_       = nullptr;
+  prometheus::Gauge* load_state_         = nullptr;
+  prometheus::Gauge* decoding_mode_      = nullptr;
   prometheus::Gauge* current_ttfr_       = nullptr;
   prometheus::Gauge* current_decode_     = nullptr;
   prometheus::Gauge* current_rtf_        = nullptr;
@@ -174,8 +268,11 @@ class ASRMetrics {
   prometheus::Counter* errors_internal_error_                = nullptr;
   prometheus::Counter* errors_bad_multipart_                 = nullptr;
   prometheus::Counter* errors_invalid_param_                 = nullptr;
+  prometheus::Counter* errors_quota_exceeded_                = nullptr;
   prometheus::Counter* errors_realtime_ws_handler_exception_ = nullptr;
   prometheus::Counter* errors_other_                         = nullptr;
+  prometheus::Counter* decodes_greedy_                       = nullptr;
+  prometheus::Counter* decodes_beam_                         = nullptr;
 };
 
 }  // namespace asr
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace asr {
+
+// Aggregated result of one profiling run: folded stacks ("root;...;leaf")
+// with their sample counts, most frequent first.
+struct CpuProfile {
+  std::vector<std::pair<std::string, uint64_t>> stacks;
+  uint64_t                                      samples      = 0;
+  uint64_t                                      dropped      = 0;  // buffer full
+  double                                        duration_sec = 0.0;
+  int                                           frequency_hz = 0;
+};
+
+// In-process sampling CPU profiler. ITIMER_PROF delivers SIGPROF to the
+// thread that is burning CPU every 1/frequency_hz seconds of process CPU
+// time; the handler records that thread's stack into a preallocated buffer.
+// Stacks are symbolized with dladdr when the run is aggregated, so functions that
+// are not in the dynamic symbol table show up as module+offset.
+//
+// One run at a time per process; nothing else in the process may use
+// SIGPROF or ITIMER_PROF.
+class SamplingProfiler {
+ public:
+  static SamplingProfiler& instance();
+
+  static constexpr size_t kMaxDepth          = 48;
+  static constexpr size_t kDefaultMaxSamples = 32768;
+
+  struct StackSample {
+    void* frames[kMaxDepth];
+    int   depth;
+  };
+
+  // Raw samples of a halted run, owned by the caller so a new run can start
+  // while they are aggregated.
+  struct Run {
+    std::unique_ptr<StackSample[]> samples;
+    size_t                         count        = 0;
+    uint64_t                       dropped      = 0;
+    double                         duration_sec = 0.0;
+    int                            frequency_hz = 0;
+  };
+
+  // False when a run is already active or the platform has no SIGPROF timer.
+  bool start(int frequency_hz, size_t max_samples = kDefaultMaxSamples);
+
+  // Disarms the timer and takes the samples; cheap enough for an event loop.
+  // Empty when no run was active.
+  Run halt();
+
+  // Folds and symbolizes a halted run. Slow (dladdr per distinct frame);
+  // safe on any thread.
+  static CpuProfile aggregate(Run run);
+
+  // halt() + aggregate(); empty when no run was active.
+  CpuProfile stop() {
+    return aggregate(halt());
+  }
+
+  [[nodiscard]] bool running() const noexcept {
+    return running_.load(std::memory_order_acquire);
+  }
+
+ private:
+  SamplingProfiler() = default;
+
+  std::mutex                            mutex_;  // serializes start/stop
+  std::atomic<bool>                     running_{false};
+  int                                   frequency_hz_ = 0;
+  std::chrono::steady_clock::time_point started_at_;
+};
+
+// Brendan Gregg's folded format, one "stack count" line per stack; feeds
+// flamegraph.pl, speedscope and inferno as is.
+std::string render_folded(const CpuProfile& profile);
+
+// Thread roles for the per-thread CPU report. Threads register themselves;
+// Drogon I/O loops are recognized by thread name, the rest (ORT intra-op
+// pools, library threads) report as kThreadRoleOther.
+inline constexpr std::string_view kThreadRoleMain     = "main";
+inline constexpr std::string_view kThreadRoleHttpLoop = "http_loop";
+inline constexpr std::string_view kThreadRoleExecutor = "executor";
+inline constexpr std::string_view kThreadRoleOther    = "other";
+
+void set_current_thread_role(std::string_view role);
+
+struct ThreadCpuTime {
+  int         tid = 0;
+  std::string name;
+  std::string role;
+  double      user_sec   = 0.0;
+  double      system_sec = 0.0;
+};
+
+// CPU time consumed so far by every live thread of the process, from
+// /proc/self/task. Empty where /proc is unavailable.
+std::vector<ThreadCpuTime> thread_cpu_times();
+
+// Per-thread and per-role CPU between two snapshots taken window_sec apart,
+// with the cores each role kept busy; threads missing from `before` count
+// from zero. With an empty `before` the report is cumulative since thread
+// start and has no "cores".
+nlohmann::json thread_cpu_report(const std::vector<ThreadCpuTime>& before,
+                                 const std::vector<ThreadCpuTime>& after, double window_sec);
+
+}  // namespace asr
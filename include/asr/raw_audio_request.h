@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "asr/audio.h"
+
+namespace asr {
+
+enum class RawAudioEncoding {
+  Pcm16,  // headerless, layout in RawAudioRequest::pcm
+  Wav,
+  Opus,
+};
+
+struct RawAudioRequest {
+  RawAudioEncoding encoding = RawAudioEncoding::Pcm16;
+  RawPcmFormat     pcm;
+};
+
+struct RawAudioRequestError {
+  std::string message;
+  std::string param;
+  bool        unsupported_media_type = false;  // 415 rather than 400
+};
+
+// Parses the body layout of POST /recognize/raw from its Content-Type and the
+// "encoding", "sample_rate" and "channels" parameters (query string or
+// X-Audio-Encoding / X-Sample-Rate / X-Channels headers, merged by the caller).
+//   audio/L16;rate=R[;channels=N]  big-endian PCM16 (RFC 2586)
+//   application/octet-stream       encoding=pcm16 (default, little-endian) | pcm16be | wav | opus
+//   audio/wav, audio/ogg, ...      container decoded by decode_audio_streamed
+std::optional<RawAudioRequestError> parse_raw_audio_request(
+    std::string_view content_type, const std::unordered_map<std::string, std::string>& params,
+    RawAudioRequest* out);
+
+// File name hint that selects the container decoder in decode_audio_streamed.
+std::string_view raw_audio_file_name(RawAudioEncoding encoding);
+
+}  // namespace asr
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asr/audio.h"
+#include "asr/executor.h"
+#include "asr/handler.h"
+#include "asr/realtime_lag.h"
+#include "asr/realtime_session.h"
+#include "asr/tenant.h"
+
+namespace asr {
+class RecognizerBackend;
+struct Config;
+}  // namespace asr
+
+namespace asr {
+
+// Outbound side of a realtime connection: the server forwards to the
+// WebSocket, tests and benchmarks capture or discard.
+class RealtimeEventSink {
+ public:
+  RealtimeEventSink()          = default;
+  virtual ~RealtimeEventSink() = default;
+
+  RealtimeEventSink(const RealtimeEventSink&)            = delete;
+  RealtimeEventSink& operator=(const RealtimeEventSink&) = delete;
+  RealtimeEventSink(RealtimeEventSink&&)                 = delete;
+  RealtimeEventSink& operator=(RealtimeEventSink&&)      = delete;
+
+  virtual void send_text(std::string_view payload) = 0;
+};
+
+enum class RealtimeClientEventType {
+  SessionUpdate,
+  AudioAppend,
+  AudioCommit,
+  AudioClear,
+  BinaryAudio,
+  Invalid,   // rejected by the parser; parse_status says why
+  Overflow,  // the connection queue is full; reported before the close
+  Unknown,
+};
+
+enum class RealtimeParseStatus {
+  Ok,
+  Ping,  // ping / noop, handled without queueing
+  InvalidJson,
+  NotObject,
+  MissingType,
+};
+
+// One client message on its way from the WebSocket loop to the executor.
+// Inbox slots are reused, so after warm-up an append passes through without
+// allocating: the payload is moved in from the transport and its base64
+// audio is a view into the payload rather than a parsed JSON string.
+struct RealtimeInboundEvent {
+  RealtimeClientEventType type = RealtimeClientEventType::Unknown;
+  std::string             payload;  // JSON text or binary audio
+  std::string             event_type;
+  std::string             client_event_id;
+  nlohmann::json          json;  // full parse; null on the fast path
+  std::string_view        audio;  // base64 audio, into payload or json
+  bool                    has_audio    = false;
+  RealtimeParseStatus     parse_status = RealtimeParseStatus::Ok;  // Invalid events only
+
+  std::chrono::steady_clock::time_point received_at;  // set by the transport; unset = now
+};
+
+// Parses a client text message into `out`. Flat events whose members are all
+// escape-free strings (append, commit, clear, ping) are scanned in place;
+// everything else goes through nlohmann::json.
+RealtimeParseStatus parse_realtime_client_event(std::string&& message, RealtimeInboundEvent& out);
+
+// Binary frames are raw audio in the session's input format.
+void set_realtime_binary_event(std::string&& message, RealtimeInboundEvent& out);
+
+// Per-connection actor mailbox: the WebSocket loop is the producer, and the
+// executor worker that owns the drain runs the events in order.
+using RealtimeInbox = ActorMailbox<RealtimeInboundEvent>;
+
+// Per-connection realtime pipeline state, independent of the transport:
+// decode, resample, RealtimeASRSession, event serialization and counters.
+// The server extends it with its event loop and drain scheduling. Everything
+// below is owned by the connection's actor (whoever runs run_realtime_event)
+// except the fields marked "loop thread"; the transport reads the counters
+// only once the mailbox has drained.
+struct RealtimeConnectionContext {
+  RealtimeConnectionContext(RecognizerBackend& backend, const Config& config, uint64_t id,
+                            size_t tenant_index, TenantRegistry* tenant_registry, size_t inbox_capacity);
+  virtual ~RealtimeConnectionContext();
+
+  RealtimeConnectionContext(const RealtimeConnectionContext&)            = delete;
+  RealtimeConnectionContext& operator=(const RealtimeConnectionContext&) = delete;
+  RealtimeConnectionContext(RealtimeConnectionContext&&)                 = delete;
+  RealtimeConnectionContext& operator=(RealtimeConnectionContext&&)      = delete;
+
+  RecognizerBackend&                    recognizer;
+  const Config&                         base_config;
+  TenantRegistry*                       tenants = nullptr;  // null: no tenant accounting
+  std::shared_ptr<Config>               runtime_config;
+  RealtimeSession                       realtime{0};
+  std::shared_ptr<RealtimeASRSession>   session;
+  std::unique_ptr<StreamResampler>      resampler;
+  std::unique_ptr<RealtimeOpusDecoder>  opus_decoder;
+  RealtimeInbox                         inbox;
+  RealtimeLagTracker                    lag;
+  size_t                                lag_slot;  // RealtimeLagBoard entry
+  std::chrono::steady_clock::time_point connected_at;
+  std::chrono::steady_clock::time_point last_event_at;          // loop thread
+  std::string                           close_reason = "normal";  // loop thread
+  std::string                           last_client_event_type;   // loop thread
+  std::string                           last_error;
+  std::string                           event_buffer;  // reused for per-utterance events
+  std::vector<uint8_t>                  decoded_audio_bytes;
+  std::vector<float>                    decoded_audio_samples;
+  uint64_t                              connection_id{0};
+  size_t                                tenant{kDefaultTenant};
+  uint64_t                              raw_input_samples{0};  // decoded client-format samples
+  uint64_t                              input_samples{0};      // samples seen by ASR after resampling
+  uint64_t                              append_events{0};
+  uint64_t                              ping_events{0};  // loop thread
+  uint64_t                              invalid_events{0};
+  uint64_t                              decode_errors{0};
+  uint64_t                              committed_events{0};
+  uint64_t                              completed_events{0};
+  uint64_t                              interim_events{0};
+  uint64_t                              speech_started_events{0};
+  uint64_t                              speech_stopped_events{0};
+  double                                max_interevent_gap_sec{0.0};  // loop thread
+  double                                max_lag_sec{0.0};  // worst lag behind real time
+  bool                                  speech_active{false};
+  bool                                  quota_exhausted{false};  // quota_exceeded already reported
+};
+
+bool is_realtime_opus_format(std::string_view format);
+
+void send_realtime_error(RealtimeConnectionContext& ctx, RealtimeEventSink& sink, const std::string& code,
+                         const std::string& message, const std::string& param = "",
+                         const std::string& client_event_id = "");
+
+// Runs one inbound event against the pipeline and reports failures to the
+// client as error events. Runs on an executor worker, serialized per
+// connection.
+void run_realtime_event(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                        const RealtimeInboundEvent& event);
+
+}  // namespace asr
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace asr {
+
+enum class LagAlert { None, Lagging, Recovered };
+
+// How far a realtime stream runs behind the wall clock. Sample positions are
+// in ASR-rate samples since the connection opened (ctx.input_samples).
+//
+// The stream clock maps a position to the wall time at which that audio was
+// due from a real-time client: origin + position / sample_rate. A chunk that
+// arrives later than the clock predicts moves the origin forward, so pauses
+// on the client side are not counted against the server; a client sending
+// faster than real time simply runs ahead of the clock. Lag is the wall time
+// by which processed audio trails the clock, clamped at zero.
+//
+// Not synchronized: owned by one connection and used from its serialized
+// tasks.
+class RealtimeLagTracker {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit RealtimeLagTracker(int sample_rate);
+
+  // A chunk starting at `start_sample` arrived from the client at `received_at`.
+  void on_received(int64_t start_sample, Clock::time_point received_at);
+
+  // Audio up to `end_sample` has been processed; returns the current lag.
+  double on_processed(int64_t end_sample, Clock::time_point now);
+
+  // VAD positions restart from zero whenever the session is finalized or
+  // reset; `stream_sample` is the stream position at which that happened.
+  void set_segment_origin(int64_t stream_sample);
+
+  // The VAD saw speech end at `vad_sample` (relative to the segment origin).
+  void on_speech_end(int64_t vad_sample);
+
+  // A final transcript went out; returns the latency from the last speech
+  // end, or from the end of the processed audio when none was seen (commit).
+  double on_final(int64_t processed_end_sample, Clock::time_point now);
+
+  // Edge-triggered alert: Lagging once lag reaches threshold_sec, Recovered
+  // once it falls below threshold_sec * kRecoverRatio. threshold_sec <= 0
+  // disables alerts.
+  LagAlert check_alert(double threshold_sec);
+
+  [[nodiscard]] double lag_sec() const noexcept {
+    return lag_sec_;
+  }
+  [[nodiscard]] double max_lag_sec() const noexcept {
+    return max_lag_sec_;
+  }
+  [[nodiscard]] bool lagging() const noexcept {
+    return lagging_;
+  }
+
+  static constexpr double kRecoverRatio = 0.5;
+
+ private:
+  [[nodiscard]] Clock::time_point due_at(int64_t sample) const;
+  [[nodiscard]] double            behind_sec(int64_t sample, Clock::time_point now) const;
+
+  int               sample_rate_;
+  bool              anchored_ = false;
+  Clock::time_point origin_;
+  int64_t           segment_origin_ = 0;
+  int64_t           speech_end_     = 0;
+  bool              has_speech_end_ = false;
+  double            lag_sec_        = 0.0;
+  double            max_lag_sec_    = 0.0;
+  bool              lagging_        = false;
+};
+
+// Process-wide table of the current lag of every open realtime connection,
+// read periodically to export the worst ones. Slots are reused after release.
+//
+// publish() runs on every processed chunk of every connection, so it is
+// lock-free: lags live in fixed-size chunks of atomics that are allocated on
+// acquire and never move. The mutex only guards the slot bookkeeping in
+// acquire(), release() and worst().
+class RealtimeLagBoard {
+ public:
+  static RealtimeLagBoard& instance();
+
+  size_t acquire();
+  void   release(size_t slot);
+  void   publish(size_t slot, double lag_sec);
+
+  // Up to `count` largest lags of open connections, descending.
+  [[nodiscard]] std::vector<double> worst(size_t count) const;
+
+  static constexpr size_t kChunkSlots = 64;
+  static constexpr size_t kMaxChunks  = 1024;
+
+ private:
+  using Chunk = std::array<std::atomic<double>, kChunkSlots>;
+
+  RealtimeLagBoard() = default;
+
+  [[nodiscard]] std::atomic<double>* lag(size_t slot) const;
+
+  mutable std::mutex                          mutex_;
+  std::array<std::atomic<Chunk*>, kMaxChunks> chunks_{};
+  std::vector<std::unique_ptr<Chunk>>         owned_;
+  std::vector<bool>                           used_;
+  std::vector<size_t>                         free_;
+};
+
+}  // namespace asr
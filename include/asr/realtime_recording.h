@@ -0,0 +1,138 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace asr {
+class RecognizerBackend;
+struct Config;
+}  // namespace asr
+
+namespace asr {
+
+class RecordingError : public std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+// Inbound realtime traffic of one connection, as the WebSocket loop saw it,
+// so a production session can be replayed with its original frame sizes and
+// timing. File layout, little-endian:
+//
+//   header  "ASRRTREC" | u32 version | u64 connection_id | i64 started_unix_ms
+//   record  u64 offset_us since connect | u8 kind | u32 size | size payload bytes
+//
+// A Close record (size 0) marks the end of a connection that closed cleanly;
+// a file cut short by a crash or the size cap simply ends after the last
+// whole record.
+enum class RealtimeRecordKind : uint8_t { Text = 0, Binary = 1, Close = 2 };
+
+inline constexpr uint32_t kRealtimeRecordingVersion = 1;
+
+struct RecordedRealtimeEvent {
+  std::chrono::microseconds offset{0};
+  RealtimeRecordKind        kind = RealtimeRecordKind::Text;
+  std::string               payload;
+};
+
+// Writer owned by the connection and called from its WebSocket loop only.
+// Write failures and the size cap end the recording with a warning; they
+// never affect the connection.
+//
+// record() writes through the ofstream synchronously, so slow storage under
+// REALTIME_RECORD_DIR stalls the IO loop and every connection it serves.
+// Point it at local disk; should that not be enough, the writes belong on a
+// writer thread fed by a bounded queue.
+class RealtimeRecorder {
+ public:
+  // Creates <dir>/rt-<started_unix_ms>-<connection_id>.asrrec; nullptr with a
+  // warning when the file cannot be created.
+  static std::unique_ptr<RealtimeRecorder> open(const std::string& dir, uint64_t connection_id,
+                                                std::chrono::steady_clock::time_point connected_at,
+                                                size_t max_bytes);
+
+  ~RealtimeRecorder();
+
+  RealtimeRecorder(const RealtimeRecorder&)            = delete;
+  RealtimeRecorder& operator=(const RealtimeRecorder&) = delete;
+  RealtimeRecorder(RealtimeRecorder&&)                 = delete;
+  RealtimeRecorder& operator=(RealtimeRecorder&&)      = delete;
+
+  void record(RealtimeRecordKind kind, std::chrono::steady_clock::time_point at, std::string_view payload);
+
+  [[nodiscard]] const std::string& path() const noexcept {
+    return path_;
+  }
+  [[nodiscard]] size_t bytes_written() const noexcept {
+    return bytes_;
+  }
+
+ private:
+  RealtimeRecorder(std::string path, std::ofstream out, std::chrono::steady_clock::time_point connected_at,
+                   size_t max_bytes);
+
+  void write_record(RealtimeRecordKind kind, std::chrono::steady_clock::time_point at,
+                    std::string_view payload);
+  void stop(const char* reason);
+
+  std::string                           path_;
+  std::ofstream                         out_;
+  std::chrono::steady_clock::time_point connected_at_;
+  size_t                                max_bytes_;
+  size_t                                bytes_  = 0;
+  bool                                  active_ = true;
+};
+
+// Sequential reader; throws RecordingError on a missing file, a bad header
+// or an unsupported version. A truncated trailing record ends the stream.
+class RealtimeRecordingReader {
+ public:
+  explicit RealtimeRecordingReader(const std::string& path);
+
+  bool next(RecordedRealtimeEvent& out);
+
+  [[nodiscard]] uint64_t connection_id() const noexcept {
+    return connection_id_;
+  }
+  [[nodiscard]] int64_t started_unix_ms() const noexcept {
+    return started_unix_ms_;
+  }
+
+ private:
+  std::ifstream in_;
+  uint64_t      connection_id_   = 0;
+  int64_t       started_unix_ms_ = 0;
+};
+
+struct RealtimeReplayReport {
+  uint64_t            events      = 0;  // events run through the pipeline
+  uint64_t            skipped     = 0;  // pings and unparseable frames, as the server drops them
+  uint64_t            transcripts = 0;
+  uint64_t            errors      = 0;  // error events sent to the client
+  double              audio_sec   = 0.0;
+  double              wall_sec    = 0.0;
+  double              cpu_sec     = 0.0;  // whole process, including recognizer threads
+  double              max_lag_sec = 0.0;
+  std::vector<double> event_ms;  // per-event handling time
+  std::vector<double> final_ms;  // scheduled arrival of the triggering event -> transcript sent
+};
+
+// Feeds a recording through the same per-connection pipeline the server runs
+// (RealtimeConnectionContext + run_realtime_event), one event at a time as
+// the connection's actor would. speed 1 keeps the recorded timing,
+// 4 plays four times faster, 0 sends every event as soon as the previous one
+// is done. Events carry their scheduled arrival time, so falling behind shows
+// up in max_lag_sec and final_ms exactly as it would for a live client.
+RealtimeReplayReport replay_realtime_recording(RecognizerBackend& recognizer, const Config& config,
+                                               const std::string& path, double speed);
+
+nlohmann::json realtime_replay_report_json(const RealtimeReplayReport& report);
+
+}  // namespace asr
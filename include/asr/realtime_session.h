@@ -61,6 +61,18 @@ class RealtimeSession {
   [[nodiscard]] std::string event_transcription_delta(const std::string& item_id, const std::string& delta);
   [[nodiscard]] std::string event_transcription_completed(const std::string& item_id,
                                                           const std::string& transcript);
+
+  // Same events written into a caller-owned buffer (overwritten, capacity
+  // kept), for the per-utterance realtime path.
+  void event_speech_started(int64_t audio_start_ms, std::string& out);
+  void event_speech_stopped(int64_t audio_end_ms, std::string& out);
+  void event_buffer_committed(const RealtimeCommittedItem& commit, std::string& out);
+  void event_transcription_completed(const std::string& item_id, const std::string& transcript,
+                                     std::string& out);
+  // Server extension: the connection started (or stopped) trailing real time
+  // by more than the configured alert threshold.
+  void event_session_lag(bool lagging, int64_t lag_ms, std::string& out);
+
   [[nodiscard]] std::string event_error(const std::string& code, const std::string& message,
                                         const std::string& param           = "",
                                         const std::string& client_event_id = "");
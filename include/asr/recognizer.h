@@ -1,12 +1,19 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "asr/decoding_policy.h"
+#include "asr/load_monitor.h"
+
 namespace asr {
 struct Config;
 template <typename T>
@@ -22,30 +29,100 @@ class RecognizerBusyError : public std::runtime_error {
   using std::runtime_error::runtime_error;
 };
 
-class Recognizer {
+// Who a decode is for. Realtime segments may take the slots reserved by
+// RECOGNIZER_REALTIME_SLOTS as well as the shared ones; everything else
+// (HTTP uploads, autotune) only the shared ones, so long uploads cannot
+// hold the whole pool while live turns wait.
+enum class SlotClass : uint8_t { Shared = 0, Realtime = 1 };
+
+inline const char* slot_class_name(SlotClass slot_class) noexcept {
+  return slot_class == SlotClass::Realtime ? "realtime" : "shared";
+}
+
+// Pool occupancy as seen by the readiness probe.
+struct RecognizerLoad {
+  size_t slots_busy   = 0;
+  size_t slots_total  = 0;
+  double wait_p95_sec = 0.0;  // recent slot wait, see RecentLatencyWindow
+};
+
+// Decoder pool behind Server and BasicASRSession: the sherpa-onnx
+// Recognizer in production, SyntheticRecognizer (synthetic_recognizer.h) for
+// model-free scheduler and load tests. Implementations are thread-safe and throw
+// RecognizerBusyError when no slot frees up within the wait timeout.
+class RecognizerBackend {
+ public:
+  RecognizerBackend()          = default;
+  virtual ~RecognizerBackend() = default;
+
+  RecognizerBackend(const RecognizerBackend&)            = delete;
+  RecognizerBackend& operator=(const RecognizerBackend&) = delete;
+  RecognizerBackend(RecognizerBackend&&)                 = delete;
+  RecognizerBackend& operator=(RecognizerBackend&&)      = delete;
+
+  virtual std::string                  recognize(span<const float> audio, int sample_rate,
+                                                   SlotClass slot_class = SlotClass::Shared) = 0;
+  [[nodiscard]] virtual bool           ready() const noexcept                                = 0;
+  [[nodiscard]] virtual RecognizerLoad load() const                                          = 0;
+
+  // Work queued outside the pool (e.g. executor backlog). Set once at
+  // startup, before serving; backends without load-dependent behaviour ignore it.
+  virtual void set_pressure_source(std::function<size_t()> source);
+};
+
+// RECOGNIZER_BACKEND: "sherpa" (default) or "synthetic".
+std::unique_ptr<RecognizerBackend> make_recognizer_backend(const Config& cfg);
+
+class Recognizer final : public RecognizerBackend {
  public:
   explicit Recognizer(const Config& cfg);
-  ~Recognizer();
+  ~Recognizer() override;
+
+  // Thread-safe: acquires a free pool slot the class may use, decodes, releases it
+  std::string                  recognize(span<const float> audio, int sample_rate = 16000,
+                                         SlotClass slot_class = SlotClass::Shared) override;
+  [[nodiscard]] bool           ready() const noexcept override;
+  [[nodiscard]] RecognizerLoad load() const override;
 
-  // Non-copyable, non-movable (pool internals are non-trivial)
-  Recognizer(const Recognizer&)            = delete;
-  Recognizer& operator=(const Recognizer&) = delete;
-  Recognizer(Recognizer&&)                 = delete;
-  Recognizer& operator=(Recognizer&&)      = delete;
+  // Counted as pressure by the adaptive decoding policy.
+  void set_pressure_source(std::function<size_t()> source) override;
 
-  // Thread-safe: acquires a free pool slot, decodes, releases it
-  std::string        recognize(span<const float> audio, int sample_rate = 16000);
-  [[nodiscard]] bool ready() const noexcept;
+  // Decodes served by the elastic all-core handle, and the most of them that
+  // ever overlapped (never above 1). For tests and diagnostics.
+  [[nodiscard]] uint64_t wide_decodes() const noexcept {
+    return wide_decodes_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] size_t wide_peak() const noexcept {
+    return wide_peak_.load(std::memory_order_relaxed);
+  }
 
  private:
   struct Slot {
-    const SherpaOnnxOfflineRecognizer* handle = nullptr;
-    bool                               in_use = false;
+    const SherpaOnnxOfflineRecognizer* handle      = nullptr;  // configured method, greedy if adaptive
+    const SherpaOnnxOfflineRecognizer* beam_handle = nullptr;  // adaptive only
+    bool                               in_use      = false;
   };
 
-  std::vector<Slot>       slots_;
-  std::mutex              pool_mutex_;
+  const SherpaOnnxOfflineRecognizer* create_handle(const Config& cfg, int num_threads, DecodingMethod method);
+  void                               destroy_handles() noexcept;
+
+  std::vector<Slot>       slots_;  // [0, realtime_slots_) are reserved for SlotClass::Realtime
+  size_t                  realtime_slots_ = 0;
+  // RECOGNIZER_ELASTIC_THREADS: one extra handle with all NUM_THREADS,
+  // lent to a decode that finds the rest of the pool idle and nobody waiting.
+  const SherpaOnnxOfflineRecognizer* wide_handle_ = nullptr;
+  DecodingMethod                     wide_method_ = DecodingMethod::Greedy;
+  bool                               wide_in_use_ = false;  // guarded by pool_mutex_
+  std::atomic<uint64_t>              wide_decodes_{0};
+  std::atomic<size_t>                wide_running_{0};  // between lend and return, outside the lock
+  std::atomic<size_t>                wide_peak_{0};
+  mutable std::mutex      pool_mutex_;
   std::condition_variable pool_cv_;
+  RecentLatencyWindow     recent_waits_;  // guarded by pool_mutex_
+  DecodingStrategy        strategy_ = DecodingStrategy::Greedy;
+  AdaptiveDecodingPolicy  policy_;       // guarded by pool_mutex_
+  size_t                  waiters_ = 0;  // guarded by pool_mutex_
+  std::function<size_t()> pressure_source_;
 
   // Keep path strings alive for c_str() during construction
   std::string encoder_path_;
@@ -53,7 +130,8 @@ class Recognizer {
   std::string joiner_path_;
   std::string tokens_path_;
   std::string provider_;
-  size_t      wait_timeout_ms_ = 30000;
+  size_t      wait_timeout_ms_  = 30000;
+  int         max_active_paths_ = 4;
 };
 
 }  // namespace asr
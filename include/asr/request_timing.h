@@ -0,0 +1,59 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace asr {
+
+// Per-request latency breakdown of the offline HTTP handlers (/recognize,
+// /recognize/raw, /v1/audio/transcriptions). All values are in seconds.
+struct RequestTiming {
+  double queue_sec           = 0.0;  // executor backlog, submit to task start
+  double recognizer_wait_sec = 0.0;  // waiting for a free decoder slot
+  double container_sec       = 0.0;  // container parsing and sample conversion
+  double resample_sec        = 0.0;
+  double vad_sec             = 0.0;  // 0 on paths that run no VAD
+  double asr_sec             = 0.0;  // decoder time, slot wait excluded
+  double serialize_sec       = 0.0;  // building the response body
+  double total_sec           = 0.0;  // admission to response
+};
+
+// Splits the wall time of a streamed decode loop (pipeline_sec) whose
+// recognize() calls took recognize_sec in total. recognizer_wait_sec and
+// resample_sec must already be set; fills asr_sec and container_sec.
+void split_decode_time(RequestTiming& timing, double pipeline_sec, double recognize_sec);
+
+// Server-Timing header value (W3C Server Timing), durations in ms:
+//   queue;dur=1.2, recognizer_wait;dur=0.0, container;dur=3.4, ...
+std::string format_server_timing(const RequestTiming& timing);
+
+// The same breakdown as a JSON object in milliseconds. serialize_ms is left
+// out: the object is part of the body whose serialization it would measure.
+nlohmann::json request_timing_json(const RequestTiming& timing);
+
+// Collects recognizer slot wait on the calling thread while open. Backends
+// report each wait with record_recognizer_wait(); handlers open a scope
+// around the decode loop of one request. Scopes nest; the innermost wins.
+class RecognizerWaitScope {
+ public:
+  RecognizerWaitScope();
+  ~RecognizerWaitScope();
+
+  RecognizerWaitScope(const RecognizerWaitScope&)            = delete;
+  RecognizerWaitScope& operator=(const RecognizerWaitScope&) = delete;
+  RecognizerWaitScope(RecognizerWaitScope&&)                 = delete;
+  RecognizerWaitScope& operator=(RecognizerWaitScope&&)      = delete;
+
+  [[nodiscard]] double seconds() const noexcept {
+    return seconds_;
+  }
+
+ private:
+  double  seconds_ = 0.0;
+  double* previous_;
+};
+
+// No-op when the calling thread has no open RecognizerWaitScope.
+void record_recognizer_wait(double sec) noexcept;
+
+}  // namespace asr
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace asr {
+template <typename T>
+class span;
+}  // namespace asr
+
+namespace asr {
+
+// What a VAD segment or upload chunk sounds like, before it is decoded.
+// Anything but Speech is an obvious non-speech sound the VAD let through.
+enum class SegmentClass : uint8_t { Speech = 0, Tone = 1, Music = 2, Noise = 3 };
+
+const char* segment_class_name(SegmentClass kind) noexcept;
+
+// NONSPEECH_FILTER: off skips the classifier, flag classifies and counts but
+// still decodes, drop also skips the decode.
+enum class NonSpeechMode : uint8_t { Off = 0, Flag = 1, Drop = 2 };
+
+// Accepts off | flag | drop (any case); throws ConfigError otherwise.
+NonSpeechMode parse_nonspeech_mode(std::string_view value);
+
+// Averages over the voiced frames of a segment, band kLowHz..kHighHz:
+//
+//   flatness        geometric / arithmetic mean of the power spectrum; near
+//                   0.56 for white noise, well under 0.3 for voiced speech.
+//   tonality        share of the band energy within two bins of the two
+//                   strongest peaks; a beep or a DTMF pair puts nearly all of
+//                   it there, voiced speech spreads it over its harmonics.
+//   stability       share of consecutive frames whose magnitude spectra are
+//                   at least kStableSimilarity alike (cosine); a held tone or
+//                   chord keeps its pitch and harmonics in place, speech moves
+//                   both every few frames.
+struct SegmentFeatures {
+  float  flatness  = 0.0f;
+  float  tonality  = 0.0f;
+  float  stability = 0.0f;
+  size_t frames    = 0;  // voiced frames the averages are over
+};
+
+// Cheap pre-ASR classifier: one 512-point FFT per 32 ms (at 16 kHz) of
+// audio, frames below kMinFrameDbfs skipped. The thresholds are deliberately
+// conservative; a segment is only non-speech when every feature agrees.
+//
+// Not synchronized: keeps its FFT scratch, owned by one session or request.
+class SegmentClassifier {
+ public:
+  explicit SegmentClassifier(int sample_rate);
+
+  [[nodiscard]] SegmentClass classify(span<const float> samples);
+  [[nodiscard]] SegmentFeatures features(span<const float> samples);
+
+  // For long stretches such as a 20 s upload chunk, where averaging the whole
+  // thing would let a minute of hold music outvote a few seconds of speech:
+  // classifies kBlockSec blocks (the tail joins the last one) and returns
+  // non-speech only when every block with kMinFrames voiced frames is; the
+  // class reported is the one most of those blocks had.
+  [[nodiscard]] SegmentClass classify_blocks(span<const float> samples);
+
+  static constexpr size_t kFrame            = 512;
+  static constexpr size_t kMinFrames        = 8;  // fewer voiced frames are always Speech
+  static constexpr float  kLowHz            = 100.0f;
+  static constexpr float  kHighHz           = 4000.0f;
+  static constexpr float  kMinFrameDbfs     = -50.0f;
+  static constexpr float  kToneTonality     = 0.9f;
+  static constexpr float  kMusicTonality    = 0.45f;
+  static constexpr float  kMusicStable      = 0.8f;
+  static constexpr double kStableSimilarity = 0.9;
+  static constexpr float  kNoiseFlatness    = 0.45f;
+  static constexpr float  kNoiseTonality    = 0.3f;
+  static constexpr float  kBlockSec         = 1.0f;
+
+ private:
+  void                spectrum(const float* frame);
+  static SegmentClass decide(const SegmentFeatures& f);
+
+  size_t                block_;  // kBlockSec in samples
+  size_t                low_bin_;
+  size_t                high_bin_;  // exclusive
+  std::vector<float>    window_;
+  std::vector<float>    cos_;  // twiddles, kFrame / 2
+  std::vector<float>    sin_;
+  std::vector<uint16_t> bit_reverse_;
+  std::vector<float>    re_;
+  std::vector<float>    im_;
+  std::vector<float>    power_;  // band bins only
+  std::vector<float>    prev_;  // magnitudes of the last voiced frame
+};
+
+}  // namespace asr
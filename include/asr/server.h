@@ -5,7 +5,7 @@
 #include "asr/vad.h"
 
 namespace asr {
-class Recognizer;
+class RecognizerBackend;
 struct Config;
 }  // namespace asr
 
@@ -13,7 +13,7 @@ namespace asr {
 
 class Server {
  public:
-  Server(const Config& config, Recognizer& recognizer);
+  Server(const Config& config, RecognizerBackend& recognizer);
   void run();
 
  private:
@@ -21,9 +21,9 @@ class Server {
   static void setup_realtime_ws_handler();
   static void install_signal_handlers();
 
-  const Config& config_;
-  Recognizer&   recognizer_;
-  VadConfig     vad_config_;
+  const Config&      config_;
+  RecognizerBackend& recognizer_;
+  VadConfig          vad_config_;
 
  public:
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
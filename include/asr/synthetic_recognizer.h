@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+
+#include "asr/load_monitor.h"
+#include "asr/recognizer.h"
+
+namespace asr {
+
+// Latency of one synthetic decode: call_ms + ms_per_audio_sec * audio_sec,
+// plus uniform jitter in [-jitter_ms, +jitter_ms], never below zero.
+struct SyntheticCostModel {
+  double call_ms          = 5.0;
+  double ms_per_audio_sec = 30.0;
+  double jitter_ms        = 0.0;
+  bool   burn_cpu         = false;  // spin instead of sleeping, to load the cores like a real decode
+
+  [[nodiscard]] double base_cost_sec(double audio_sec) const noexcept;
+};
+
+// Model-free RecognizerBackend with the same slot pool semantics as
+// Recognizer: pool_size concurrent decodes of which realtime_slots are
+// reserved for SlotClass::Realtime, RecognizerBusyError after the wait
+// timeout, slot waits recorded for /readyz. Jitter comes from a seeded
+// generator, so a single-threaded run is reproducible. The transcript is a
+// fixed-format summary of the input ("synthetic 1.50s").
+class SyntheticRecognizer final : public RecognizerBackend {
+ public:
+  SyntheticRecognizer(size_t pool_size, SyntheticCostModel model, size_t wait_timeout_ms = 30000,
+                      uint64_t seed = 1, size_t realtime_slots = 0);
+  explicit SyntheticRecognizer(const Config& cfg);
+
+  std::string                  recognize(span<const float> audio, int sample_rate = 16000,
+                                         SlotClass slot_class = SlotClass::Shared) override;
+  [[nodiscard]] bool           ready() const noexcept override;
+  [[nodiscard]] RecognizerLoad load() const override;
+
+  [[nodiscard]] const SyntheticCostModel& cost_model() const noexcept;
+  [[nodiscard]] size_t                    decodes() const;
+
+ private:
+  double next_cost_sec(double audio_sec);  // caller holds mutex_
+
+  SyntheticCostModel      model_;
+  size_t                  slots_total_;
+  size_t                  realtime_slots_;
+  size_t                  wait_timeout_ms_;
+  mutable std::mutex      mutex_;
+  std::condition_variable cv_;
+  size_t                  slots_busy_    = 0;  // guarded by mutex_
+  size_t                  realtime_busy_ = 0;  // reserved slots in use, guarded by mutex_
+  size_t                  decodes_       = 0;  // guarded by mutex_
+  std::mt19937_64         rng_;             // guarded by mutex_
+  RecentLatencyWindow     recent_waits_;    // guarded by mutex_
+};
+
+}  // namespace asr
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace asr {
+
+constexpr size_t kDefaultTenant = 0;
+
+struct TenantSpec {
+  std::string name;
+  std::string api_key;
+  uint32_t    weight            = 1;
+  size_t      max_concurrent    = 0;    // 0 = unlimited requests/connections in progress
+  double      audio_sec_per_min = 0.0;  // 0 = no audio quota
+};
+
+// Parses TENANTS: entries "name:api_key:weight[:max_concurrent[:audio_sec_per_min]]"
+// separated by ';'. An entry named "default" configures the tenant used for
+// requests without a recognised key. Throws ConfigError on malformed input.
+std::vector<TenantSpec> parse_tenant_specs(std::string_view spec);
+
+// Refills at rate_per_sec up to burst. charge() may drive the balance negative
+// so a long request is never cut mid-decode; the tenant is then refused until
+// the debt is paid back.
+class TokenBucket {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  TokenBucket(double rate_per_sec, double burst, Clock::time_point now = Clock::now());
+
+  [[nodiscard]] bool   has_tokens(Clock::time_point now = Clock::now());
+  void                 charge(double amount, Clock::time_point now = Clock::now());
+  [[nodiscard]] double available(Clock::time_point now = Clock::now());
+
+ private:
+  void refill(Clock::time_point now);
+
+  double            rate_per_sec_;
+  double            burst_;
+  double            tokens_;
+  Clock::time_point last_refill_;
+};
+
+enum class TenantAdmission { Admitted, ConcurrencyLimit, QuotaExceeded };
+
+class TenantRegistry {
+ public:
+  explicit TenantRegistry(const std::vector<TenantSpec>& specs);
+
+  TenantRegistry(const TenantRegistry&)            = delete;
+  TenantRegistry& operator=(const TenantRegistry&) = delete;
+  TenantRegistry(TenantRegistry&&)                 = delete;
+  TenantRegistry& operator=(TenantRegistry&&)      = delete;
+
+  // Unknown or empty keys resolve to kDefaultTenant.
+  [[nodiscard]] size_t                resolve(std::string_view api_key) const;
+  [[nodiscard]] size_t                size() const noexcept;
+  [[nodiscard]] const TenantSpec&     spec(size_t tenant) const;
+  [[nodiscard]] std::vector<uint32_t> weights() const;
+
+  // Thread-safe admission: checks the concurrency cap and the audio quota;
+  // Admitted must be paired with release().
+  TenantAdmission      try_admit(size_t tenant);
+  void                 release(size_t tenant);
+  void                 charge_audio(size_t tenant, double audio_sec);
+  [[nodiscard]] bool   has_audio_quota(size_t tenant);
+  [[nodiscard]] size_t active(size_t tenant) const;
+
+ private:
+  struct State {
+    TenantSpec                   spec;
+    std::atomic<size_t>          active{0};
+    std::mutex                   bucket_mutex;
+    std::unique_ptr<TokenBucket> bucket;  // null when no audio quota
+  };
+
+  std::vector<std::unique_ptr<State>>     tenants_;
+  std::unordered_map<std::string, size_t> by_key_;
+};
+
+}  // namespace asr
@@ -3,6 +3,7 @@
 #include <onnxruntime_cxx_api.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <memory>
@@ -45,8 +46,19 @@ class VoiceActivityDetector {
  public:
   explicit VoiceActivityDetector(const VadConfig& config);
 
+  // Non-copyable, non-movable (IoBindings point into member buffers)
+  VoiceActivityDetector(const VoiceActivityDetector&)            = delete;
+  VoiceActivityDetector& operator=(const VoiceActivityDetector&) = delete;
+  VoiceActivityDetector(VoiceActivityDetector&&)                 = delete;
+  VoiceActivityDetector& operator=(VoiceActivityDetector&&)      = delete;
+
   // Feed exactly window_size samples
   void accept_waveform(span<const float> samples);
+  // accept_waveform() in two halves: speech_probability() runs the model on
+  // one window (advancing its state, not the segmenter) and accept_window()
+  // runs the segmenter on a window whose probability is already known.
+  float speech_probability(span<const float> samples);
+  void  accept_window(span<const float> samples, float prob);
 
   // Segment queue
   [[nodiscard]] bool                 empty() const;
@@ -56,13 +68,28 @@ class VoiceActivityDetector {
   // State
   [[nodiscard]] bool                    is_speech() const;
   void                                  flush();
+  // Mid-speech cut for live streaming: finalizes the open segment at the
+  // lowest-probability window boundary within the last lookback_samples and
+  // keeps the rest open, so no audio is dropped or queued twice. No
+  // transitions are emitted; speech continues. Returns false (and changes
+  // nothing) when no cut leaves min_speech_duration of audio in the head.
+  bool                                  split_open_segment(int64_t lookback_samples);
+  // The open segment as flush() would queue it right now (trailing silence
+  // excluded), and how far its trailing silence is towards
+  // min_silence_duration, in [0, 1). Empty and 0 outside speech.
+  [[nodiscard]] span<const float>       open_speech() const;
+  [[nodiscard]] int64_t                 open_start_sample() const;
+  [[nodiscard]] float                   silence_progress() const;
   void                                  reset();
+  // Speech probability threshold for the windows that follow; reset() keeps it.
+  void                                  set_threshold(float threshold);
   [[nodiscard]] bool                    has_transition() const;
   [[nodiscard]] const SpeechTransition& front_transition() const;
   void                                  pop_transition();
 
  private:
   float infer(span<const float> samples);
+  void  bind_tensors();
   void  finalize_segment();
   void  append_pre_roll(span<const float> samples);
 
@@ -72,16 +99,17 @@ class VoiceActivityDetector {
   std::shared_ptr<SharedVadRuntime> runtime_;
   Ort::RunOptions                   run_options_{nullptr};  // pre-constructed, reused per infer()
 
-  // Pre-allocated tensors (zero runtime allocations)
-  static constexpr int          kStateSize = 2 * 1 * 128;  // shape (2, 1, 128)
-  std::array<float, kStateSize> state_{};
-  std::vector<float>            input_buf_;  // context_size + window_size
-  std::vector<float>            context_;    // last context_size samples
-  int64_t                       sr_tensor_ = 16000;
-
-  // ONNX input/output names (must persist for session lifetime)
-  static constexpr const char* kInputNames[]  = {"input", "state", "sr"};
-  static constexpr const char* kOutputNames[] = {"output", "stateN"};
+  // Pre-allocated tensors (zero runtime allocations). Inputs and outputs are
+  // bound once; bindings_[i] reads states_[i] and writes stateN into
+  // states_[1 - i], so infer() flips state_idx_ instead of copying state.
+  static constexpr int                         kStateSize = 2 * 1 * 128;  // shape (2, 1, 128)
+  std::array<std::array<float, kStateSize>, 2> states_{};
+  size_t                                       state_idx_ = 0;
+  float                                        prob_      = 0.0f;  // output, shape (1, 1)
+  std::vector<float>                           input_buf_;         // context_size + window_size
+  std::vector<float>                           context_;           // last context_size samples
+  int64_t                                      sr_tensor_ = 16000;
+  std::array<Ort::IoBinding, 2>                bindings_{Ort::IoBinding{nullptr}, Ort::IoBinding{nullptr}};
 
   // State machine
   bool                         in_speech_              = false;
@@ -91,10 +119,37 @@ class VoiceActivityDetector {
   int64_t                      current_start_sample_   = 0;
   int64_t                      current_end_sample_     = 0;
   int64_t                      prefix_padding_samples_ = 0;
+  size_t                       speech_buf_head_        = 0;      // pre-roll samples ahead of the first window
+  bool                         split_remainder_        = false;  // open segment continues a split
   std::vector<float>           speech_buf_;
+  std::vector<float>           window_probs_;  // one per window appended to speech_buf_
   std::vector<float>           pre_roll_;
   std::deque<SpeechSegment>    segments_;
   std::deque<SpeechTransition> transitions_;
 };
 
+// One shard of an offline VAD pass, in windows: the model runs over
+// [warmup_begin, end) and its probabilities are kept for [begin, end).
+struct VadShard {
+  size_t warmup_begin = 0;
+  size_t begin        = 0;
+  size_t end          = 0;
+};
+
+// Splits `windows` windows into at most max_shards contiguous shards of at
+// least min_shard_windows each. Every shard but the first starts
+// warmup_windows early, so the LSTM state re-converges from zero before its
+// first kept window.
+std::vector<VadShard> plan_vad_shards(size_t windows, size_t max_shards, size_t min_shard_windows,
+                                      size_t warmup_windows);
+
+// Segments a whole decoded file the way a session would (a short tail is
+// zero-padded to a full window, then flush()). With threads > 1 a file long
+// enough for several 30 s shards is scored on one detector per shard in
+// parallel, each warmed up on the 2 s before its shard, and a single
+// segmenter then runs over the merged probabilities in order, so segment
+// boundaries do not depend on where the shards were cut.
+std::vector<SpeechSegment> segment_speech(const VadConfig& config, span<const float> audio,
+                                          size_t threads = 1);
+
 }  // namespace asr
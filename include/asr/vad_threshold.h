@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace asr {
+template <typename T>
+class span;
+}  // namespace asr
+
+namespace asr {
+
+// Per-connection VAD threshold for noisy channels (VAD_ADAPTIVE_THRESHOLD).
+// Two signals raise it from the configured base towards max:
+//
+//   noise floor   a running estimate (in dB) of the level of windows the
+//                 VAD left as non-speech; it falls quickly and rises slowly,
+//                 so a cough or speech bleeding into a pause barely moves it. Between kQuietDbfs
+//                 and kNoisyDbfs it lifts the threshold by up to half the
+//                 range.
+//   empty decodes the outcome of the last kHistory decoded segments. Once
+//                 at least half came back empty the threshold steps up by
+//                 kStep; after a full history with at most one empty it
+//                 steps back down. Each step starts a fresh history, and
+//                 ratios in between hold, so it does not oscillate.
+//
+// Not synchronized: owned by one BasicASRSession.
+class AdaptiveVadThreshold {
+ public:
+  AdaptiveVadThreshold(float base, float max);
+
+  // A VAD window; non-speech windows feed the noise floor.
+  void on_window(span<const float> samples, bool speech);
+
+  // A VAD segment was decoded; returns true when the threshold stepped.
+  bool on_decode(bool empty);
+
+  [[nodiscard]] float threshold() const noexcept {
+    return threshold_;
+  }
+  [[nodiscard]] float noise_floor_dbfs() const noexcept;
+  [[nodiscard]] float empty_ratio() const noexcept;
+
+  static constexpr float  kQuietDbfs  = -60.0f;
+  static constexpr float  kNoisyDbfs  = -30.0f;
+  static constexpr float  kStep       = 0.05f;
+  static constexpr size_t kHistory    = 8;
+  static constexpr size_t kMinDecodes = 4;  // before a step up
+
+ private:
+  void update();
+
+  float                      base_;
+  float                      max_;
+  float                      threshold_;
+  float                      decode_lift_ = 0.0f;
+  double                     noise_db_    = 0.0;  // level of non-speech windows, dBFS
+  bool                       has_noise_   = false;
+  std::array<bool, kHistory> outcomes_{};  // true = empty
+  size_t                     outcome_count_ = 0;
+  size_t                     outcome_next_  = 0;
+};
+
+}  // namespace asr
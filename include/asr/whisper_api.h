@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "asr/request_timing.h"
+
 namespace asr {
 
 enum class WhisperResponseFormat {
@@ -40,9 +42,10 @@ struct WhisperApiValidationError {
 };
 
 struct WhisperTranscriptionResponsePayload {
-  std::string text;
-  float       duration_sec = 0.0f;
-  std::string language;
+  std::string                  text;
+  float                        duration_sec = 0.0f;
+  std::string                  language;
+  std::optional<RequestTiming> timings;  // "timings" object in json/verbose_json
 };
 
 struct WhisperRenderedResponse {
@@ -0,0 +1,339 @@
+#include "asr/alloc_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace asr {
+namespace {
+
+constexpr size_t kDefaultSampleBytes = 512 * 1024;
+
+constexpr std::array<const char*, kAllocTagCount> kTagNames{"other", "decode", "vad", "asr", "ws", "metrics"};
+
+std::atomic<size_t> g_sample_bytes{kDefaultSampleBytes};
+
+#if ASR_ALLOC_PROFILER
+// Everything below is reached from operator new, so it must neither allocate
+// nor depend on dynamic initialization: plain atomics and constant-initialized
+// thread-locals only.
+struct TagCounters {
+  std::atomic<uint64_t> alloc_bytes{0};
+  std::atomic<uint64_t> allocs{0};
+  std::atomic<int64_t>  live_bytes{0};
+};
+
+std::array<TagCounters, kAllocTagCount> g_tags;
+std::atomic<uint64_t>                   g_untracked{0};
+std::atomic<uint64_t>                   g_live_samples{0};
+
+// Sampled pointers still alive. A pointer may only sit in the 8 slots of the
+// cache line its hash selects, so a free probes exactly one line; a sample
+// that finds its line full is counted in g_untracked instead.
+constexpr size_t kGroupSlots = 8;
+constexpr size_t kGroupBits  = 13;
+constexpr size_t kGroups     = size_t{1} << kGroupBits;
+
+struct alignas(64) SampleGroup {
+  std::atomic<uintptr_t> keys[kGroupSlots];
+};
+
+SampleGroup           g_groups[kGroups];
+std::atomic<uint64_t> g_meta[kGroups * kGroupSlots];  // weight << 8 | tag
+
+struct ThreadState {
+  int64_t  until_sample;
+  uint64_t since_sample;
+  uint64_t rng;
+  uint64_t bytes[kAllocTagCount];
+  uint64_t allocs[kAllocTagCount];
+  AllocTag tag;
+};
+
+thread_local ThreadState t_state{};
+
+size_t group_of(uintptr_t key) noexcept {
+  return static_cast<size_t>(((key >> 4) * 0x9E3779B97F4A7C15ULL) >> (64 - kGroupBits));
+}
+
+// Uniform in [interval / 2, 3 * interval / 2]: same mean as a fixed interval,
+// without locking onto allocation patterns that repeat at that period.
+int64_t next_interval(ThreadState& t) noexcept {
+  if (t.rng == 0) {
+    t.rng = (reinterpret_cast<uintptr_t>(&t) * 0x9E3779B97F4A7C15ULL) | 1U;
+  }
+  t.rng ^= t.rng << 13;
+  t.rng ^= t.rng >> 7;
+  t.rng ^= t.rng << 17;
+  const uint64_t interval = std::max<size_t>(1, g_sample_bytes.load(std::memory_order_relaxed));
+  return static_cast<int64_t>(interval / 2 + t.rng % (interval + 1));
+}
+
+bool track(uintptr_t key, uint64_t weight, size_t tag) noexcept {
+  const size_t group = group_of(key);
+  auto&        keys  = g_groups[group].keys;
+  for (size_t i = 0; i < kGroupSlots; ++i) {
+    uintptr_t expected = 0;
+    if (keys[i].load(std::memory_order_relaxed) == 0 &&
+        keys[i].compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+      // The pointer is not handed out yet, so no free can look at the slot
+      // before this store.
+      g_meta[group * kGroupSlots + i].store((weight << 8U) | tag, std::memory_order_relaxed);
+      g_live_samples.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void record_sample(ThreadState& t, void* p, size_t tag) noexcept {
+  for (size_t i = 0; i < kAllocTagCount; ++i) {
+    if (t.allocs[i] != 0) {
+      g_tags[i].alloc_bytes.fetch_add(t.bytes[i], std::memory_order_relaxed);
+      g_tags[i].allocs.fetch_add(t.allocs[i], std::memory_order_relaxed);
+      t.bytes[i]  = 0;
+      t.allocs[i] = 0;
+    }
+  }
+
+  const uint64_t weight = t.since_sample;
+  t.since_sample        = 0;
+  t.until_sample        = next_interval(t);
+  if (track(reinterpret_cast<uintptr_t>(p), weight, tag)) {
+    g_tags[tag].live_bytes.fetch_add(static_cast<int64_t>(weight), std::memory_order_relaxed);
+  } else {
+    g_untracked.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void on_alloc(void* p, size_t size) noexcept {
+  auto&        t   = t_state;
+  const size_t tag = static_cast<size_t>(t.tag);
+  t.bytes[tag] += size;
+  ++t.allocs[tag];
+  t.since_sample += size;
+  t.until_sample -= static_cast<int64_t>(size);
+  if (t.until_sample <= 0) {
+    record_sample(t, p, tag);
+  }
+}
+
+void on_free(void* p) noexcept {
+  if (p == nullptr || g_live_samples.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  const auto   key   = reinterpret_cast<uintptr_t>(p);
+  const size_t group = group_of(key);
+  auto&        keys  = g_groups[group].keys;
+  for (size_t i = 0; i < kGroupSlots; ++i) {
+    if (keys[i].load(std::memory_order_acquire) != key) {
+      continue;
+    }
+    // Read the sample before releasing the slot to the next track().
+    const uint64_t meta = g_meta[group * kGroupSlots + i].load(std::memory_order_relaxed);
+    keys[i].store(0, std::memory_order_release);
+    g_live_samples.fetch_sub(1, std::memory_order_relaxed);
+    g_tags[meta & 0xFFU].live_bytes.fetch_sub(static_cast<int64_t>(meta >> 8U), std::memory_order_relaxed);
+    return;
+  }
+}
+
+void* allocate(std::size_t size) {
+  for (;;) {
+    if (void* p = std::malloc(std::max<std::size_t>(size, 1))) {  // NOLINT(cppcoreguidelines-no-malloc)
+      on_alloc(p, size);
+      return p;
+    }
+    const std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void* allocate_aligned(std::size_t size, std::align_val_t align) {
+  const size_t alignment = std::max(static_cast<size_t>(align), sizeof(void*));
+  const size_t rounded   = (std::max<std::size_t>(size, 1) + alignment - 1) & ~(alignment - 1);
+  for (;;) {
+    if (void* p = std::aligned_alloc(alignment, rounded)) {  // NOLINT(cppcoreguidelines-no-malloc)
+      on_alloc(p, size);
+      return p;
+    }
+    const std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void release(void* p) noexcept {
+  on_free(p);
+  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+#endif
+
+}  // namespace
+
+const char* alloc_tag_name(AllocTag tag) noexcept {
+  const auto idx = static_cast<size_t>(tag);
+  return idx < kTagNames.size() ? kTagNames[idx] : "other";
+}
+
+void set_alloc_sample_bytes(size_t bytes) {
+  g_sample_bytes.store(std::max<size_t>(bytes, 1), std::memory_order_relaxed);
+}
+
+AllocSnapshot alloc_snapshot() {
+  AllocSnapshot snap;
+  snap.sample_bytes = g_sample_bytes.load(std::memory_order_relaxed);
+#if ASR_ALLOC_PROFILER
+  snap.enabled   = true;
+  snap.untracked = g_untracked.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < kAllocTagCount; ++i) {
+    snap.tags[i].alloc_bytes = g_tags[i].alloc_bytes.load(std::memory_order_relaxed);
+    snap.tags[i].allocs      = g_tags[i].allocs.load(std::memory_order_relaxed);
+    snap.tags[i].live_bytes  = g_tags[i].live_bytes.load(std::memory_order_relaxed);
+  }
+#endif
+  return snap;
+}
+
+nlohmann::json alloc_report(const AllocSnapshot& before, const AllocSnapshot& after, double window_sec) {
+  nlohmann::json report;
+  report["enabled"]           = after.enabled;
+  report["sample_bytes"]      = after.sample_bytes;
+  report["untracked_samples"] = after.untracked;
+  report["window_sec"]        = window_sec > 0.0 ? nlohmann::json(window_sec) : nlohmann::json(nullptr);
+
+  nlohmann::json tags = nlohmann::json::object();
+  for (size_t i = 0; i < kAllocTagCount; ++i) {
+    const auto&    now = after.tags[i];
+    nlohmann::json tag;
+    tag["alloc_bytes"] = now.alloc_bytes;
+    tag["allocs"]      = now.allocs;
+    tag["live_bytes"]  = now.live_bytes;
+    if (window_sec > 0.0) {
+      const auto& then           = before.tags[i];
+      tag["alloc_bytes_per_sec"] = static_cast<double>(now.alloc_bytes - then.alloc_bytes) / window_sec;
+      tag["allocs_per_sec"]      = static_cast<double>(now.allocs - then.allocs) / window_sec;
+    }
+    tags[alloc_tag_name(static_cast<AllocTag>(i))] = std::move(tag);
+  }
+  report["tags"] = std::move(tags);
+  return report;
+}
+
+#if ASR_ALLOC_PROFILER
+AllocTag exchange_alloc_tag(AllocTag tag) noexcept {
+  const AllocTag previous = t_state.tag;
+  t_state.tag             = tag;
+  return previous;
+}
+#endif
+
+}  // namespace asr
+
+#if ASR_ALLOC_PROFILER
+// Replaceable global allocation functions. Every form is replaced so that
+// sampled pointers are always released through on_free().
+// NOLINTBEGIN(misc-new-delete-overloads)
+void* operator new(std::size_t size) {
+  return asr::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+  return asr::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+  try {
+    return asr::allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+  try {
+    return asr::allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  return asr::allocate_aligned(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  return asr::allocate_aligned(size, align);
+}
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t& /*tag*/) noexcept {
+  try {
+    return asr::allocate_aligned(size, align);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t& /*tag*/) noexcept {
+  try {
+    return asr::allocate_aligned(size, align);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* p) noexcept {
+  asr::release(p);
+}
+
+void operator delete[](void* p) noexcept {
+  asr::release(p);
+}
+
+void operator delete(void* p, const std::nothrow_t& /*tag*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t& /*tag*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete[](void* p, std::size_t /*size*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete(void* p, std::align_val_t /*align*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete[](void* p, std::align_val_t /*align*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/, std::align_val_t /*align*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete[](void* p, std::size_t /*size*/, std::align_val_t /*align*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete(void* p, std::align_val_t /*align*/, const std::nothrow_t& /*tag*/) noexcept {
+  asr::release(p);
+}
+
+void operator delete[](void* p, std::align_val_t /*align*/, const std::nothrow_t& /*tag*/) noexcept {
+  asr::release(p);
+}
+// NOLINTEND(misc-new-delete-overloads)
+#endif
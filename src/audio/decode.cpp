@@ -1,12 +1,20 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <numeric>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "asr/alloc_profiler.h"
 #include "asr/audio.h"
 #include "asr/span.h"
 #include "asr/string_utils.h"
@@ -65,6 +73,21 @@ void downmix_interleaved_to_mono(span<const float> interleaved, int channels, st
   }
 }
 
+// Resampler calls on the streamed paths, timed into AudioStreamStats::resample_sec.
+span<const float> timed_process(StreamResampler& resampler, span<const float> input, double& elapsed_sec) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto out   = resampler.process(input);
+  elapsed_sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return out;
+}
+
+span<const float> timed_flush(StreamResampler& resampler, double& elapsed_sec) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto out   = resampler.flush();
+  elapsed_sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return out;
+}
+
 class ChunkEmitter {
  public:
   ChunkEmitter(size_t chunk_samples, const AudioChunkCallback& on_chunk)
@@ -137,6 +160,7 @@ AudioStreamStats decode_wav_stream_impl(drwav& wav, int target_rate, size_t chun
   mono_buf.reserve(static_cast<size_t>(kWavReadFrames));
 
   uint64_t total_output_samples = 0;
+  double   resample_sec         = 0.0;
   if (input_rate == target_rate) {
     for (;;) {
       const auto frames_read = drwav_read_pcm_frames_f32(&wav, kWavReadFrames, read_buf.data());
@@ -169,12 +193,12 @@ AudioStreamStats decode_wav_stream_impl(drwav& wav, int target_rate, size_t chun
             mono_buf);
         mono_chunk = mono_buf;
       }
-      const auto out = resampler.process(mono_chunk);
+      const auto out = timed_process(resampler, mono_chunk, resample_sec);
       chunker.push(out);
       total_output_samples += static_cast<uint64_t>(out.size());
     }
 
-    const auto tail = resampler.flush();
+    const auto tail = timed_flush(resampler, resample_sec);
     if (!tail.empty()) {
       chunker.push(tail);
       total_output_samples += static_cast<uint64_t>(tail.size());
@@ -187,6 +211,7 @@ AudioStreamStats decode_wav_stream_impl(drwav& wav, int target_rate, size_t chun
   stats.samples = static_cast<size_t>(total_output_samples);
   stats.duration_sec =
       static_cast<float>(static_cast<double>(total_output_samples) / static_cast<double>(target_rate));
+  stats.resample_sec = resample_sec;
   return stats;
 }
 
@@ -358,8 +383,224 @@ AudioData decode_opus_file(span<const uint8_t> data, int target_rate) {
   return audio;
 }
 
+// Long files are cut into ranges at multiples of the resampler period, so a
+// range boundary falls on a whole output sample. Each range is decoded on
+// its own OggOpusFile starting kOpusRangeRollFrames early (op_pcm_seek
+// already pre-rolls the decoder; this settles the resampler) and running as
+// far past its end, and only the output that belongs to the range is kept.
+constexpr opus_int64 kOpusRangeMinFrames  = 48000LL * 60;  // shorter ranges are not worth a thread
+constexpr opus_int64 kOpusRangeRollFrames = 4800;          // 100 ms at 48 kHz
+
+// Range workers running for all uploads together. An upload asks for up to
+// decode_threads - 1 of them and gets what is left of that budget, down to
+// none, so concurrent uploads never run more than decode_threads - 1 decoder
+// threads between them on top of their own calling threads.
+std::atomic<size_t> g_opus_range_workers{0};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+class RangeWorkerLease {
+ public:
+  RangeWorkerLease(size_t wanted, size_t budget) {
+    size_t current = g_opus_range_workers.load(std::memory_order_relaxed);
+    while (wanted > 0 && current < budget) {
+      const size_t take = std::min(wanted, budget - current);
+      if (g_opus_range_workers.compare_exchange_weak(current, current + take, std::memory_order_acq_rel,
+                                                     std::memory_order_relaxed)) {
+        count_ = take;
+        break;
+      }
+    }
+  }
+  ~RangeWorkerLease() {
+    g_opus_range_workers.fetch_sub(count_, std::memory_order_acq_rel);
+  }
+  RangeWorkerLease(const RangeWorkerLease&)            = delete;
+  RangeWorkerLease& operator=(const RangeWorkerLease&) = delete;
+
+  [[nodiscard]] size_t count() const {
+    return count_;
+  }
+
+ private:
+  size_t count_ = 0;
+};
+
+struct OpusFileCloser {
+  void operator()(OggOpusFile* of) const {
+    op_free(of);
+  }
+};
+using OpusFilePtr = std::unique_ptr<OggOpusFile, OpusFileCloser>;
+
+// Next block of 48 kHz mono, empty at the end of the stream.
+span<const float> read_opus_mono(OggOpusFile* of, int channels, std::vector<float>& read_buf,
+                                 std::vector<float>& mono_buf) {
+  int n = 0;
+  if (channels == 1) {
+    int section = 0;
+    n           = op_read_float(of, read_buf.data(), static_cast<int>(read_buf.size()), &section);
+  } else {
+    n = op_read_float_stereo(of, read_buf.data(), static_cast<int>(read_buf.size()));
+  }
+  if (n < 0) {
+    throw AudioError("Failed to decode Opus packet: " + opusfile_error_message(n));
+  }
+  if (channels == 1) {
+    return {read_buf.data(), static_cast<size_t>(n)};
+  }
+  downmix_interleaved_to_mono({read_buf.data(), static_cast<size_t>(n) * 2U}, 2, mono_buf);
+  return mono_buf;
+}
+
+// Decodes [begin, end) of the file (end < 0: to the end of the stream) at
+// target_rate and hands the output to emit in order. Stops early once
+// cancel is set.
+void decode_opus_range(span<const uint8_t> data, int target_rate, opus_int64 begin, opus_int64 end,
+                       const std::function<void(span<const float>)>& emit, double& resample_sec,
+                       const std::atomic<bool>& cancel) {
+  int               err = 0;
+  const OpusFilePtr of(op_open_memory(data.data(), static_cast<int>(data.size()), &err));
+  if (!of) {
+    throw AudioError("Failed to decode Opus file: " + opusfile_error_message(err));
+  }
+  const int        channels = op_channel_count(of.get(), -1);
+  const opus_int64 start    = std::max<opus_int64>(0, begin - kOpusRangeRollFrames);
+  if (start > 0) {
+    const int rc = op_pcm_seek(of.get(), start);
+    if (rc != 0) {
+      throw AudioError("Failed to seek Opus file: " + opusfile_error_message(rc));
+    }
+  }
+
+  // Kept output window, in output samples counted from `start`.
+  const auto to_output = [target_rate](opus_int64 frames) {
+    return static_cast<size_t>(frames * target_rate / 48000);
+  };
+  const size_t     keep_from = to_output(begin - start);
+  const size_t     keep_to   = end < 0 ? SIZE_MAX : to_output(end - start);
+  const opus_int64 stop      = end < 0 ? -1 : end + kOpusRangeRollFrames;
+  size_t           produced  = 0;
+  const auto       take      = [&](span<const float> out) {
+    const size_t lo = std::max(produced, keep_from);
+    const size_t hi = std::min(produced + out.size(), keep_to);
+    if (hi > lo) {
+      emit(out.subspan(lo - produced, hi - lo));
+    }
+    produced += out.size();
+  };
+
+  std::unique_ptr<StreamResampler> resampler;
+  if (target_rate != 48000) {
+    resampler = std::make_unique<StreamResampler>(48000, target_rate);
+  }
+  std::vector<float> read_buf(4096U * static_cast<size_t>(std::max(channels, 2)));
+  std::vector<float> mono_buf;
+  mono_buf.reserve(4096U);
+  opus_int64 position = start;
+  while ((stop < 0 || position < stop) && !cancel.load(std::memory_order_relaxed)) {
+    const auto mono = read_opus_mono(of.get(), channels, read_buf, mono_buf);
+    if (mono.empty()) {
+      break;
+    }
+    position += static_cast<opus_int64>(mono.size());
+    take(resampler ? timed_process(*resampler, mono, resample_sec) : mono);
+  }
+  if (resampler && produced < keep_to) {
+    take(timed_flush(*resampler, resample_sec));
+  }
+}
+
+// Range 0 is decoded on the calling thread and streamed as it goes, so the
+// first chunk does not wait for the rest of the file; ranges 1..n-1 decode
+// into buffers on worker threads and are emitted in order behind it.
+AudioStreamStats decode_opus_ranges_parallel(span<const uint8_t> data, int target_rate, size_t chunk_samples,
+                                             const AudioChunkCallback& on_chunk, opus_int64 total_frames,
+                                             size_t range_count) {
+  struct Range {
+    opus_int64         begin = 0;
+    opus_int64         end   = -1;
+    std::vector<float> samples;
+    double             resample_sec = 0.0;
+    std::exception_ptr error;
+  };
+
+  const opus_int64   period = 48000 / std::gcd(48000, target_rate);
+  std::vector<Range> ranges(range_count);
+  for (size_t i = 1; i < range_count; ++i) {
+    const auto split  = total_frames * static_cast<opus_int64>(i) / static_cast<opus_int64>(range_count);
+    ranges[i].begin   = split / period * period;
+    ranges[i - 1].end = ranges[i].begin;
+  }
+
+  std::atomic<bool>        cancel{false};
+  std::vector<std::thread> workers;
+  workers.reserve(range_count - 1);
+  const auto stop_workers = [&cancel, &workers]() {
+    cancel.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  };
+
+  ChunkEmitter chunker(chunk_samples, on_chunk);
+  uint64_t     total_output_samples = 0;
+  double       resample_sec         = 0.0;
+  try {
+    for (size_t i = 1; i < range_count; ++i) {
+      workers.emplace_back([&data, &ranges, &cancel, target_rate, i]() {
+        const AllocTagScope alloc_scope(AllocTag::Decode);
+        auto&               range = ranges[i];
+        try {
+          decode_opus_range(
+              data, target_rate, range.begin, range.end,
+              [&range](span<const float> out) {
+                range.samples.insert(range.samples.end(), out.begin(), out.end());
+              },
+              range.resample_sec, cancel);
+        } catch (...) {
+          range.error = std::current_exception();
+        }
+      });
+    }
+    decode_opus_range(
+        data, target_rate, ranges[0].begin, ranges[0].end,
+        [&chunker, &total_output_samples](span<const float> out) {
+          chunker.push(out);
+          total_output_samples += static_cast<uint64_t>(out.size());
+        },
+        resample_sec, cancel);
+    for (size_t i = 1; i < range_count; ++i) {
+      workers[i - 1].join();
+      auto& range = ranges[i];
+      if (range.error) {
+        std::rethrow_exception(range.error);
+      }
+      chunker.push(range.samples);
+      total_output_samples += static_cast<uint64_t>(range.samples.size());
+      resample_sec += range.resample_sec;
+      std::vector<float>().swap(range.samples);
+    }
+  } catch (...) {
+    stop_workers();  // also covers a thread that failed to start
+    throw;
+  }
+  chunker.flush();
+
+  if (total_output_samples == 0ULL) {
+    throw AudioError("Opus file contains no audio frames");
+  }
+
+  AudioStreamStats stats;
+  stats.samples = static_cast<size_t>(total_output_samples);
+  stats.duration_sec =
+      static_cast<float>(static_cast<double>(total_output_samples) / static_cast<double>(target_rate));
+  stats.resample_sec = resample_sec;
+  return stats;
+}
+
 AudioStreamStats decode_opus_file_streamed(span<const uint8_t> data, int target_rate, size_t chunk_samples,
-                                           const AudioChunkCallback& on_chunk) {
+                                           const AudioChunkCallback& on_chunk, size_t decode_threads) {
   int          err = 0;
   OggOpusFile* of  = op_open_memory(data.data(), static_cast<int>(data.size()), &err);
   if (of == nullptr) {
@@ -385,11 +626,23 @@ AudioStreamStats decode_opus_file_streamed(span<const uint8_t> data, int target_
     throw AudioError("Opus file too long: " + std::to_string(total_frames) + " frames exceeds 1-hour limit");
   }
 
+  const size_t max_ranges = total_frames > 0 ? static_cast<size_t>(total_frames / kOpusRangeMinFrames) : 0;
+  const size_t wanted     = std::min(decode_threads, max_ranges);
+  if (wanted > 1) {
+    const RangeWorkerLease lease(wanted - 1, decode_threads - 1);
+    if (lease.count() > 0) {
+      cleanup();
+      return decode_opus_ranges_parallel(data, target_rate, chunk_samples, on_chunk, total_frames,
+                                         lease.count() + 1);
+    }
+  }
+
   ChunkEmitter       chunker(chunk_samples, on_chunk);
   std::vector<float> read_buf(4096U * static_cast<size_t>(std::max(channels, 2)));
   std::vector<float> mono_buf;
   mono_buf.reserve(4096U);
   uint64_t total_output_samples = 0;
+  double   resample_sec         = 0.0;
 
   if (target_rate == 48000) {
     for (;;) {
@@ -440,12 +693,12 @@ AudioStreamStats decode_opus_file_streamed(span<const uint8_t> data, int target_
         downmix_interleaved_to_mono({read_buf.data(), static_cast<size_t>(n) * 2U}, 2, mono_buf);
         mono_chunk = mono_buf;
       }
-      auto out = resampler.process(mono_chunk);
+      auto out = timed_process(resampler, mono_chunk, resample_sec);
       chunker.push(out);
       total_output_samples += static_cast<uint64_t>(out.size());
     }
 
-    auto tail = resampler.flush();
+    auto tail = timed_flush(resampler, resample_sec);
     if (!tail.empty()) {
       chunker.push(tail);
       total_output_samples += static_cast<uint64_t>(tail.size());
@@ -463,6 +716,7 @@ AudioStreamStats decode_opus_file_streamed(span<const uint8_t> data, int target_
   stats.samples = static_cast<size_t>(total_output_samples);
   stats.duration_sec =
       static_cast<float>(static_cast<double>(total_output_samples) / static_cast<double>(target_rate));
+  stats.resample_sec = resample_sec;
   return stats;
 }
 
@@ -555,6 +809,7 @@ bool is_supported_whisper_audio_extension(std::string_view extension) {
 }
 
 AudioData decode_audio(span<const uint8_t> data, std::string_view file_name, int target_rate) {
+  const AllocTagScope alloc_scope(AllocTag::Decode);
   if (data.empty()) {
     throw AudioError("Empty audio data");
   }
@@ -580,7 +835,9 @@ AudioData decode_audio(span<const uint8_t> data, std::string_view file_name, int
 }
 
 AudioStreamStats decode_audio_streamed(span<const uint8_t> data, std::string_view file_name, int target_rate,
-                                       size_t chunk_samples, const AudioChunkCallback& on_chunk) {
+                                       size_t chunk_samples, const AudioChunkCallback& on_chunk,
+                                       size_t decode_threads) {
+  const AllocTagScope alloc_scope(AllocTag::Decode);
   if (data.empty()) {
     throw AudioError("Empty audio data");
   }
@@ -597,14 +854,95 @@ AudioStreamStats decode_audio_streamed(span<const uint8_t> data, std::string_vie
 
 #ifdef ASR_HAS_OPUSFILE
   if (extension == "opus") {
-    return decode_opus_file_streamed(data, target_rate, chunk_samples, on_chunk);
+    return decode_opus_file_streamed(data, target_rate, chunk_samples, on_chunk, decode_threads);
   }
+#else
+  (void)decode_threads;
 #endif
 
   throw AudioError("Unsupported audio format '." + extension +
                    "' — accepted: " + supported_audio_extensions_list());
 }
 
+AudioStreamStats decode_pcm16_streamed(span<const uint8_t> data, const RawPcmFormat& format, int target_rate,
+                                       size_t chunk_samples, const AudioChunkCallback& on_chunk) {
+  const AllocTagScope alloc_scope(AllocTag::Decode);
+  if (data.empty()) {
+    throw AudioError("Empty audio data");
+  }
+  if (format.channels <= 0 || format.sample_rate <= 0) {
+    throw AudioError("Invalid PCM16 layout: rate=" + std::to_string(format.sample_rate) +
+                     " channels=" + std::to_string(format.channels));
+  }
+
+  const auto   channels    = static_cast<size_t>(format.channels);
+  const size_t frame_bytes = 2U * channels;
+  if (data.size() % frame_bytes != 0U) {
+    throw AudioError("Invalid PCM16 payload: byte count must be a multiple of " +
+                     std::to_string(frame_bytes));
+  }
+  const uint64_t total_frames = data.size() / frame_bytes;
+  if (total_frames > kMaxAudioFrames) {
+    throw AudioError("PCM16 payload too long: " + std::to_string(total_frames) +
+                     " frames exceeds 1-hour limit");
+  }
+
+  ChunkEmitter       chunker(chunk_samples, on_chunk);
+  std::vector<float> read_buf(static_cast<size_t>(kWavReadFrames) * channels);
+  std::vector<float> mono_buf;
+  mono_buf.reserve(static_cast<size_t>(kWavReadFrames));
+
+  std::unique_ptr<StreamResampler> resampler;
+  if (format.sample_rate != target_rate) {
+    resampler = std::make_unique<StreamResampler>(format.sample_rate, target_rate);
+  }
+
+  uint64_t total_output_samples = 0;
+  double   resample_sec         = 0.0;
+  auto     emit                 = [&](span<const float> mono) {
+    if (resampler) {
+      mono = timed_process(*resampler, mono, resample_sec);
+    }
+    chunker.push(mono);
+    total_output_samples += static_cast<uint64_t>(mono.size());
+  };
+
+  const size_t block_bytes = static_cast<size_t>(kWavReadFrames) * frame_bytes;
+  for (size_t offset = 0; offset < data.size(); offset += block_bytes) {
+    const size_t bytes   = std::min(block_bytes, data.size() - offset);
+    const size_t samples = bytes / 2U;
+    const auto*  src     = data.data() + offset;
+    for (size_t i = 0; i < samples; ++i) {
+      const uint8_t b0  = src[i * 2U];
+      const uint8_t b1  = src[i * 2U + 1U];
+      const auto    raw = format.big_endian ? static_cast<uint16_t>((b0 << 8U) | b1)
+                                            : static_cast<uint16_t>((b1 << 8U) | b0);
+      read_buf[i]       = static_cast<float>(static_cast<int16_t>(raw)) / 32768.0F;
+    }
+
+    if (channels == 1) {
+      emit({read_buf.data(), samples});
+    } else {
+      downmix_interleaved_to_mono({read_buf.data(), samples}, format.channels, mono_buf);
+      emit(mono_buf);
+    }
+  }
+
+  if (resampler) {
+    const auto tail = timed_flush(*resampler, resample_sec);
+    chunker.push(tail);
+    total_output_samples += static_cast<uint64_t>(tail.size());
+  }
+  chunker.flush();
+
+  AudioStreamStats stats;
+  stats.samples = static_cast<size_t>(total_output_samples);
+  stats.duration_sec =
+      static_cast<float>(static_cast<double>(total_output_samples) / static_cast<double>(target_rate));
+  stats.resample_sec = resample_sec;
+  return stats;
+}
+
 std::vector<float> decode_realtime_audio_bytes(span<const uint8_t> audio_bytes, std::string_view format,
                                                int target_rate) {
   auto normalized = to_lower_ascii(format);
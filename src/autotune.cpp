@@ -0,0 +1,357 @@
+#include "asr/autotune.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "asr/config.h"
+#include "asr/recognizer.h"
+#include "asr/span.h"
+#include "nlohmann/json.hpp"
+
+namespace asr {
+
+namespace {
+
+constexpr int         kMaxAutotunePool    = 8;
+constexpr double      kCalibrationClipSec = 4.0;
+constexpr double      kPi                 = 3.14159265358979323846;
+constexpr const char* kEncoderVariants[]  = {"encoder.int8.onnx", "encoder.onnx"};  // NOLINT
+
+bool file_exists(const std::string& path) {
+  const std::ifstream f(path);
+  return f.good();
+}
+
+// Voiced-speech-like signal: harmonic stack on a wavering pitch, gated by a
+// ~4 Hz syllable envelope, over low-level noise. Deterministic across boots.
+std::vector<float> make_calibration_clip(int sample_rate) {
+  const auto                      n = static_cast<size_t>(kCalibrationClipSec * sample_rate);
+  std::vector<float>              clip(n);
+  std::mt19937                    rng(42);  // NOLINT(cert-msc51-cpp): reproducible on purpose
+  std::normal_distribution<float> noise(0.0f, 0.005f);
+  double                          phase = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    const double t  = static_cast<double>(i) / sample_rate;
+    const double f0 = 120.0 + 20.0 * std::sin(2.0 * kPi * 0.7 * t);
+    phase += 2.0 * kPi * f0 / sample_rate;
+    double voiced = 0.0;
+    for (int k = 1; k <= 10; ++k) {
+      voiced += std::sin(k * phase) / k;
+    }
+    const double envelope = std::max(0.0, std::sin(2.0 * kPi * 4.0 * t));
+    clip[i]                = static_cast<float>(0.08 * envelope * voiced) + noise(rng);
+  }
+  return clip;
+}
+
+double percentile(std::vector<double> values, double q) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  const auto idx = static_cast<size_t>(q * static_cast<double>(values.size() - 1) + 0.5);
+  std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(idx), values.end());
+  return values[idx];
+}
+
+// Saturates a pool of the given layout with one decoder thread per slot.
+AutotuneResult bench_recognizer(const Config& base, const AutotuneLayout& layout, double budget_sec) {
+  using Clock = std::chrono::steady_clock;
+
+  const auto deadline = Clock::now() + std::chrono::duration<double>(budget_sec);
+  const auto cfg      = autotune_bench_config(base, layout);
+  Recognizer recognizer(cfg);
+
+  const auto clip    = make_calibration_clip(cfg.sample_rate);
+  const auto workers = static_cast<size_t>(layout.pool_size);
+
+  // Warm-up: first decode per slot pays for allocator and kernel setup.
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t w = 0; w < workers; ++w) {
+      threads.emplace_back([&]() { (void)recognizer.recognize(span<const float>(clip), cfg.sample_rate); });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+
+  std::mutex          latencies_mutex;
+  std::vector<double> latencies;
+  const auto          started = Clock::now();
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t w = 0; w < workers; ++w) {
+      threads.emplace_back([&]() {
+        std::vector<double> local;
+        do {  // at least one measured decode even when loading ate the budget
+          const auto t0 = Clock::now();
+          (void)recognizer.recognize(span<const float>(clip), cfg.sample_rate);
+          local.push_back(std::chrono::duration<double>(Clock::now() - t0).count());
+        } while (Clock::now() < deadline);
+        const std::scoped_lock lock(latencies_mutex);
+        latencies.insert(latencies.end(), local.begin(), local.end());
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+  const auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+  AutotuneResult result;
+  result.layout = layout;
+  result.throughput =
+      elapsed > 0.0 ? static_cast<double>(latencies.size()) * kCalibrationClipSec / elapsed : 0.0;
+  result.p95_latency_sec = percentile(latencies, 0.95);
+  return result;
+}
+
+std::string read_cpu_fingerprint() {
+  std::string   model;
+  std::string   isa;
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string   line;
+  while (std::getline(cpuinfo, line) && (model.empty() || isa.empty())) {
+    const auto colon = line.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+    const auto key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+    if (key == "model name" && model.empty()) {
+      model = line.substr(std::min(line.size(), colon + 2));
+    } else if ((key == "flags" || key == "Features") && isa.empty()) {
+      std::istringstream flags(line.substr(colon + 1));
+      std::string        flag;
+      while (flags >> flag) {
+        if (flag == "avx2" || flag == "avx512f" || flag == "avx512_vnni" || flag == "avx_vnni" ||
+            flag == "amx_tile" || flag == "asimddp" || flag == "sve") {
+          isa += (isa.empty() ? "" : ",") + flag;
+        }
+      }
+      if (isa.empty()) {
+        isa = "-";
+      }
+    }
+  }
+  return "cpu=" + (model.empty() ? std::string("unknown") : model) + ";isa=" + (isa.empty() ? "-" : isa) +
+         ";cores=" + std::to_string(std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+std::vector<std::string> autotune_encoder_files(const Config& cfg) {
+  std::vector<std::string> files;
+  if (file_exists(cfg.model_dir + "/" + cfg.encoder_file)) {
+    files.push_back(cfg.encoder_file);
+  }
+  for (const char* variant : kEncoderVariants) {
+    if (variant != cfg.encoder_file && file_exists(cfg.model_dir + "/" + variant)) {
+      files.emplace_back(variant);
+    }
+  }
+  return files;
+}
+
+std::vector<AutotuneLayout> autotune_candidates(const std::vector<std::string>& encoder_files,
+                                                int num_threads) {
+  std::vector<AutotuneLayout> candidates;
+  const int                   max_pool = std::clamp(num_threads, 1, kMaxAutotunePool);
+  for (const auto& encoder : encoder_files) {
+    for (int pool = 1; pool <= max_pool; pool *= 2) {
+      candidates.push_back({encoder, pool, std::max(1, num_threads / pool)});
+    }
+  }
+  return candidates;
+}
+
+std::optional<AutotuneResult> pick_autotune_result(const std::vector<AutotuneResult>& results,
+                                                   double latency_target_sec) {
+  const AutotuneResult* best_within = nullptr;
+  const AutotuneResult* fastest     = nullptr;
+  for (const auto& r : results) {
+    if (r.p95_latency_sec <= latency_target_sec &&
+        (best_within == nullptr || r.throughput > best_within->throughput)) {
+      best_within = &r;
+    }
+    if (fastest == nullptr || r.p95_latency_sec < fastest->p95_latency_sec) {
+      fastest = &r;
+    }
+  }
+  if (best_within != nullptr) {
+    return *best_within;
+  }
+  if (fastest != nullptr) {
+    return *fastest;
+  }
+  return std::nullopt;
+}
+
+std::optional<AutotuneResult> autotune_layouts(const std::vector<AutotuneLayout>& candidates,
+                                               double budget_sec, double latency_target_sec,
+                                               const AutotuneBenchFn& bench) {
+  if (candidates.empty()) {
+    return std::nullopt;
+  }
+  const double                share = budget_sec / static_cast<double>(candidates.size());
+  std::vector<AutotuneResult> results;
+  results.reserve(candidates.size());
+  for (const auto& layout : candidates) {
+    try {
+      results.push_back(bench(layout, share));
+      const auto& r = results.back();
+      spdlog::info("Autotune: {} pool={} threads={}: {:.2f}x realtime, p95={:.0f}ms", layout.encoder_file,
+                   layout.pool_size, layout.threads_per_slot, r.throughput, r.p95_latency_sec * 1000.0);
+    } catch (const std::exception& e) {
+      spdlog::warn("Autotune: {} pool={} threads={} skipped: {}", layout.encoder_file, layout.pool_size,
+                   layout.threads_per_slot, e.what());
+    }
+  }
+  return pick_autotune_result(results, latency_target_sec);
+}
+
+std::string autotune_fingerprint(const Config& cfg, const std::vector<std::string>& encoder_files) {
+  std::string fingerprint = read_cpu_fingerprint();
+  fingerprint += ";provider=" + cfg.provider;
+  fingerprint += ";threads=" + std::to_string(cfg.num_threads);
+  fingerprint += ";decoding=" + cfg.decoding_method;
+  fingerprint += ";target_ms=" + std::to_string(cfg.autotune_latency_target_ms);
+  fingerprint += ";model=" + cfg.model_dir;
+  fingerprint += ";encoders=";
+  for (size_t i = 0; i < encoder_files.size(); ++i) {
+    fingerprint += (i > 0 ? "," : "") + encoder_files[i];
+  }
+  return fingerprint;
+}
+
+std::optional<AutotuneLayout> load_autotune_cache(const std::string& path, const std::string& fingerprint) {
+  std::ifstream in(path);
+  if (!in) {
+    return std::nullopt;
+  }
+  const auto doc = nlohmann::json::parse(in, nullptr, /*allow_exceptions=*/false);
+  if (!doc.is_object() || !doc.contains(fingerprint)) {
+    return std::nullopt;
+  }
+  const auto& entry = doc[fingerprint];
+  if (!entry.is_object() || !entry.value("encoder_file", nlohmann::json()).is_string() ||
+      !entry.value("pool_size", nlohmann::json()).is_number_integer() ||
+      !entry.value("threads_per_slot", nlohmann::json()).is_number_integer()) {
+    spdlog::warn("Autotune: ignoring malformed cache entry in {}", path);
+    return std::nullopt;
+  }
+  AutotuneLayout layout;
+  layout.encoder_file     = entry["encoder_file"].get<std::string>();
+  layout.pool_size        = entry["pool_size"].get<int>();
+  layout.threads_per_slot = entry["threads_per_slot"].get<int>();
+  if (layout.pool_size < 1 || layout.threads_per_slot < 1) {
+    return std::nullopt;
+  }
+  return layout;
+}
+
+bool save_autotune_cache(const std::string& path, const std::string& fingerprint,
+                         const AutotuneResult& result) {
+  nlohmann::json doc = nlohmann::json::object();
+  if (std::ifstream in(path); in) {
+    auto existing = nlohmann::json::parse(in, nullptr, /*allow_exceptions=*/false);
+    if (existing.is_object()) {
+      doc = std::move(existing);
+    }
+  }
+  doc[fingerprint] = {
+      {"encoder_file", result.layout.encoder_file},
+      {"pool_size", result.layout.pool_size},
+      {"threads_per_slot", result.layout.threads_per_slot},
+      {"throughput", result.throughput},
+      {"p95_latency_ms", result.p95_latency_sec * 1000.0},
+  };
+
+  // Write-then-rename so a concurrent boot never reads a torn file.
+  const auto tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    if (!out) {
+      return false;
+    }
+    out << doc.dump(2) << '\n';
+    if (!out) {
+      return false;
+    }
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+void apply_autotune_layout(Config& cfg, const AutotuneLayout& layout) {
+  if (cfg.max_concurrent_requests == cfg.shared_recognizer_slots()) {
+    cfg.max_concurrent_requests = 0;  // auto-resolved: follow the new pool
+  }
+  cfg.encoder_file         = layout.encoder_file;
+  cfg.recognizer_pool_size = layout.pool_size;
+  cfg.num_threads          = layout.pool_size * layout.threads_per_slot;
+  cfg.resolve_recognizer_slots();
+}
+
+Config autotune_bench_config(const Config& base, const AutotuneLayout& layout) {
+  Config cfg = base;
+  apply_autotune_layout(cfg, layout);
+  cfg.recognizer_realtime_slots  = 0;
+  cfg.recognizer_elastic_threads = false;
+  return cfg;
+}
+
+void run_autotune(Config& cfg) {
+  const auto encoders    = autotune_encoder_files(cfg);
+  const auto cache_path  = cfg.autotune_cache.empty() ? cfg.model_dir + "/autotune.json" : cfg.autotune_cache;
+  const auto fingerprint = autotune_fingerprint(cfg, encoders);
+
+  if (const auto cached = load_autotune_cache(cache_path, fingerprint)) {
+    if (std::find(encoders.begin(), encoders.end(), cached->encoder_file) != encoders.end()) {
+      spdlog::info("Autotune: cached layout from {}: {} pool={} threads={}", cache_path, cached->encoder_file,
+                   cached->pool_size, cached->threads_per_slot);
+      apply_autotune_layout(cfg, *cached);
+      return;
+    }
+  }
+
+  const auto   candidates = autotune_candidates(encoders, cfg.num_threads);
+  const double target_sec = static_cast<double>(cfg.autotune_latency_target_ms) / 1000.0;
+  spdlog::info("Autotune: calibrating {} layouts within {:.0f}s (p95 target {}ms on a {:.0f}s clip)",
+               candidates.size(), cfg.autotune_budget_sec, cfg.autotune_latency_target_ms,
+               kCalibrationClipSec);
+
+  const auto best = autotune_layouts(candidates, cfg.autotune_budget_sec, target_sec,
+                                     [&cfg](const AutotuneLayout& layout, double budget_sec) {
+                                       return bench_recognizer(cfg, layout, budget_sec);
+                                     });
+  if (!best) {
+    spdlog::warn("Autotune: no layout could be measured, keeping {} pool={} threads={}", cfg.encoder_file,
+                 cfg.recognizer_pool_size, cfg.num_threads);
+    return;
+  }
+  if (best->p95_latency_sec > target_sec) {
+    spdlog::warn("Autotune: no layout meets the {}ms p95 target, using the lowest-latency one",
+                 cfg.autotune_latency_target_ms);
+  }
+  spdlog::info("Autotune: selected {} pool={} threads={} ({:.2f}x realtime, p95={:.0f}ms)",
+               best->layout.encoder_file, best->layout.pool_size, best->layout.threads_per_slot,
+               best->throughput, best->p95_latency_sec * 1000.0);
+  apply_autotune_layout(cfg, best->layout);
+  if (!save_autotune_cache(cache_path, fingerprint, *best)) {
+    spdlog::warn("Autotune: could not write cache {}", cache_path);
+  }
+}
+
+}  // namespace asr
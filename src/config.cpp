@@ -7,6 +7,11 @@
 #include <exception>
 #include <string>
 
+#include "asr/decoding_policy.h"
+#include "asr/segment_classifier.h"
+#include "asr/string_utils.h"
+#include "asr/tenant.h"
+
 namespace asr {
 
 namespace {
@@ -49,6 +54,19 @@ uint16_t get_env_uint16(const char* name, uint16_t default_val) {
   return static_cast<uint16_t>(val);
 }
 
+bool get_env_bool(const char* name, bool default_val) {
+  const char* val = std::getenv(name);
+  if (val == nullptr)
+    return default_val;
+  const auto normalized = to_lower_ascii(trim_ascii(val));
+  if (normalized == "1" || normalized == "true" || normalized == "yes" || normalized == "on")
+    return true;
+  if (normalized == "0" || normalized == "false" || normalized == "no" || normalized == "off")
+    return false;
+  spdlog::warn("{}: invalid boolean '{}', using default {}", name, val, default_val);
+  return default_val;
+}
+
 size_t get_env_size(const char* name, size_t default_val) {
   const char* val = std::getenv(name);
   if (val == nullptr)
@@ -70,8 +88,17 @@ Config Config::from_env() {
   cfg.threads = get_env_size("THREADS", cfg.threads);
   cfg.idle_connection_timeout_sec =
       get_env_size("IDLE_CONNECTION_TIMEOUT_SEC", cfg.idle_connection_timeout_sec);
+  cfg.server_timing              = get_env_bool("SERVER_TIMING", cfg.server_timing);
+  cfg.admin_token                = get_env("ADMIN_TOKEN", cfg.admin_token);
+  cfg.alloc_sample_bytes         = get_env_size("ALLOC_SAMPLE_BYTES", cfg.alloc_sample_bytes);
   cfg.model_dir                  = get_env("MODEL_DIR", cfg.model_dir);
   cfg.vad_model                  = get_env("VAD_MODEL", cfg.vad_model);
+  cfg.encoder_file               = get_env("ENCODER_FILE", cfg.encoder_file);
+  cfg.autotune                   = get_env_bool("AUTOTUNE", cfg.autotune);
+  cfg.autotune_cache             = get_env("AUTOTUNE_CACHE", cfg.autotune_cache);
+  cfg.autotune_budget_sec        = get_env_float("AUTOTUNE_BUDGET_SEC", cfg.autotune_budget_sec);
+  cfg.autotune_latency_target_ms = get_env_size("AUTOTUNE_LATENCY_TARGET_MS", cfg.autotune_latency_target_ms);
+  cfg.recognizer_backend         = get_env("RECOGNIZER_BACKEND", cfg.recognizer_backend);
   cfg.provider                   = get_env("PROVIDER", cfg.provider);
   cfg.num_threads                = get_env_int("NUM_THREADS", cfg.num_threads);
   cfg.sample_rate                = get_env_int("SAMPLE_RATE", cfg.sample_rate);
@@ -82,17 +109,81 @@ Config Config::from_env() {
   cfg.vad_max_speech             = get_env_float("VAD_MAX_SPEECH", cfg.vad_max_speech);
   cfg.vad_window_size            = get_env_int("VAD_WINDOW_SIZE", cfg.vad_window_size);
   cfg.vad_context_size           = get_env_int("VAD_CONTEXT_SIZE", cfg.vad_context_size);
+  cfg.vad_adaptive_threshold     = get_env_bool("VAD_ADAPTIVE_THRESHOLD", cfg.vad_adaptive_threshold);
+  cfg.vad_threshold_max          = get_env_float("VAD_THRESHOLD_MAX", cfg.vad_threshold_max);
+  cfg.nonspeech_filter           = get_env("NONSPEECH_FILTER", cfg.nonspeech_filter);
+  cfg.speculative_fraction       = get_env_float("SPECULATIVE_DECODE_FRACTION", cfg.speculative_fraction);
   cfg.silence_threshold          = get_env_float("SILENCE_THRESHOLD", cfg.silence_threshold);
   cfg.min_audio_sec              = get_env_float("MIN_AUDIO_SEC", cfg.min_audio_sec);
   cfg.max_upload_bytes           = get_env_size("MAX_UPLOAD_BYTES", cfg.max_upload_bytes);
   cfg.max_ws_message_bytes       = get_env_size("MAX_WS_MESSAGE_BYTES", cfg.max_ws_message_bytes);
+  cfg.realtime_lag_alert_sec     = get_env_float("REALTIME_LAG_ALERT_SEC", cfg.realtime_lag_alert_sec);
+  cfg.opus_decode_threads        = get_env_size("OPUS_DECODE_THREADS", cfg.opus_decode_threads);
+  cfg.realtime_record_dir        = get_env("REALTIME_RECORD_DIR", cfg.realtime_record_dir);
+  cfg.realtime_record_max_bytes  = get_env_size("REALTIME_RECORD_MAX_BYTES", cfg.realtime_record_max_bytes);
   cfg.recognizer_pool_size       = get_env_int("RECOGNIZER_POOL_SIZE", cfg.recognizer_pool_size);
+  cfg.recognizer_realtime_slots  = get_env_size("RECOGNIZER_REALTIME_SLOTS", cfg.recognizer_realtime_slots);
   cfg.max_concurrent_requests    = get_env_size("MAX_CONCURRENT_REQUESTS", cfg.max_concurrent_requests);
   cfg.recognizer_wait_timeout_ms = get_env_size("RECOGNIZER_WAIT_TIMEOUT_MS", cfg.recognizer_wait_timeout_ms);
+  cfg.recognizer_elastic_threads = get_env_bool("RECOGNIZER_ELASTIC_THREADS", cfg.recognizer_elastic_threads);
   cfg.max_ws_connections         = get_env_size("MAX_WS_CONNECTIONS", cfg.max_ws_connections);
+  cfg.ready_queue_degraded       = get_env_float("READY_QUEUE_DEGRADED", cfg.ready_queue_degraded);
+  cfg.ready_queue_not_ready      = get_env_float("READY_QUEUE_NOT_READY", cfg.ready_queue_not_ready);
+  cfg.ready_slots_degraded       = get_env_float("READY_SLOTS_DEGRADED", cfg.ready_slots_degraded);
+  cfg.ready_slots_not_ready      = get_env_float("READY_SLOTS_NOT_READY", cfg.ready_slots_not_ready);
+  cfg.ready_wait_p95_degraded_ms =
+      get_env_size("READY_WAIT_P95_DEGRADED_MS", cfg.ready_wait_p95_degraded_ms);
+  cfg.ready_wait_p95_not_ready_ms =
+      get_env_size("READY_WAIT_P95_NOT_READY_MS", cfg.ready_wait_p95_not_ready_ms);
+  cfg.memory_budget_bytes    = get_env_size("MEMORY_BUDGET_BYTES", cfg.memory_budget_bytes);
+  cfg.ready_memory_degraded  = get_env_float("READY_MEMORY_DEGRADED", cfg.ready_memory_degraded);
+  cfg.ready_memory_not_ready = get_env_float("READY_MEMORY_NOT_READY", cfg.ready_memory_not_ready);
+  cfg.ready_recover_ratio    = get_env_float("READY_RECOVER_RATIO", cfg.ready_recover_ratio);
+  cfg.tenants                = get_env("TENANTS", cfg.tenants);
+  cfg.decoding_method        = get_env("DECODING_METHOD", cfg.decoding_method);
+  cfg.max_active_paths       = get_env_int("MAX_ACTIVE_PATHS", cfg.max_active_paths);
+  cfg.adaptive_beam_below    = get_env_float("ADAPTIVE_BEAM_BELOW", cfg.adaptive_beam_below);
+  cfg.adaptive_greedy_above  = get_env_float("ADAPTIVE_GREEDY_ABOVE", cfg.adaptive_greedy_above);
+
+  cfg.synthetic_call_ms          = get_env_float("SYNTHETIC_CALL_MS", cfg.synthetic_call_ms);
+  cfg.synthetic_ms_per_audio_sec =
+      get_env_float("SYNTHETIC_MS_PER_AUDIO_SEC", cfg.synthetic_ms_per_audio_sec);
+  cfg.synthetic_jitter_ms        = get_env_float("SYNTHETIC_JITTER_MS", cfg.synthetic_jitter_ms);
+  cfg.synthetic_burn_cpu         = get_env_bool("SYNTHETIC_BURN_CPU", cfg.synthetic_burn_cpu);
   return cfg;
 }
 
+size_t Config::shared_recognizer_slots() const {
+  const auto pool = static_cast<size_t>(std::max(recognizer_pool_size, 1));
+  return recognizer_realtime_slots < pool ? pool - recognizer_realtime_slots : 1;
+}
+
+void Config::resolve_recognizer_slots() {
+  // Pool size: default = 1
+  if (recognizer_pool_size == 0) {
+    recognizer_pool_size = 1;
+  }
+  if (recognizer_pool_size < 1 || recognizer_pool_size > 256) {
+    spdlog::warn("Clamping recognizer_pool_size {} to [1, 256]", recognizer_pool_size);
+    recognizer_pool_size = std::clamp(recognizer_pool_size, 1, 256);
+  }
+  if (recognizer_realtime_slots >= static_cast<size_t>(recognizer_pool_size)) {
+    spdlog::warn("recognizer_realtime_slots ({}) must leave a shared slot in a pool of {}, clamping to {}",
+                 recognizer_realtime_slots, recognizer_pool_size, recognizer_pool_size - 1);
+    recognizer_realtime_slots = static_cast<size_t>(recognizer_pool_size - 1);
+  }
+
+  // Max concurrent requests: 0 = auto (= the shared recognizer slots HTTP can use).
+  // More would only queue on the pool behind the wait timeout.
+  if (max_concurrent_requests == 0) {
+    max_concurrent_requests = shared_recognizer_slots();
+  } else if (max_concurrent_requests > shared_recognizer_slots()) {
+    spdlog::warn("max_concurrent_requests ({}) exceeds the {} shared recognizer slots, clamping",
+                 max_concurrent_requests, shared_recognizer_slots());
+    max_concurrent_requests = shared_recognizer_slots();
+  }
+}
+
 void Config::validate() {
   if (sample_rate <= 0) {
     throw ConfigError("sample_rate must be positive, got " + std::to_string(sample_rate));
@@ -115,11 +206,41 @@ void Config::validate() {
                       std::to_string(vad_context_size));
   }
 
+  recognizer_backend = to_lower_ascii(trim_ascii(recognizer_backend));
+  if (recognizer_backend != "sherpa" && recognizer_backend != "synthetic") {
+    throw ConfigError("recognizer_backend must be sherpa or synthetic, got '" + recognizer_backend + "'");
+  }
+  if (synthetic_call_ms < 0.0f || synthetic_ms_per_audio_sec < 0.0f || synthetic_jitter_ms < 0.0f) {
+    spdlog::warn("Clamping negative synthetic cost model values to 0");
+    synthetic_call_ms          = std::max(synthetic_call_ms, 0.0f);
+    synthetic_ms_per_audio_sec = std::max(synthetic_ms_per_audio_sec, 0.0f);
+    synthetic_jitter_ms        = std::max(synthetic_jitter_ms, 0.0f);
+  }
+  if (autotune && recognizer_backend != "sherpa") {
+    spdlog::warn("AUTOTUNE ignored: recognizer_backend={} has no model variants to tune", recognizer_backend);
+    autotune = false;
+  }
+  if (encoder_file.empty() || encoder_file.find('/') != std::string::npos) {
+    throw ConfigError("encoder_file must be a file name inside model_dir, got '" + encoder_file + "'");
+  }
+  if (autotune_budget_sec < 1.0f || autotune_budget_sec > 3600.0f) {
+    spdlog::warn("Clamping autotune_budget_sec {} to [1, 3600]", autotune_budget_sec);
+    autotune_budget_sec = std::clamp(autotune_budget_sec, 1.0f, 3600.0f);
+  }
+  if (autotune_latency_target_ms == 0) {
+    throw ConfigError("autotune_latency_target_ms must be positive");
+  }
+
   if (num_threads < 1 || num_threads > 128) {
     spdlog::warn("Clamping num_threads {} to [1, 128]", num_threads);
     num_threads = std::clamp(num_threads, 1, 128);
   }
 
+  if (alloc_sample_bytes < 4096) {
+    spdlog::warn("Clamping alloc_sample_bytes {} to at least 4096", alloc_sample_bytes);
+    alloc_sample_bytes = 4096;
+  }
+
   if (threads < 1 || threads > 256) {
     spdlog::warn("Clamping threads {} to [1, 256]", threads);
     threads = std::clamp(threads, static_cast<size_t>(1), static_cast<size_t>(256));
@@ -129,6 +250,17 @@ void Config::validate() {
     spdlog::warn("Clamping vad_threshold {} to (0.0, 1.0)", vad_threshold);
     vad_threshold = std::clamp(vad_threshold, 0.01f, 0.99f);
   }
+  if (vad_threshold_max < vad_threshold || vad_threshold_max >= 1.0f) {
+    spdlog::warn("Clamping vad_threshold_max {} to [vad_threshold, 0.99]", vad_threshold_max);
+    vad_threshold_max = std::clamp(vad_threshold_max, vad_threshold, 0.99f);
+  }
+
+  (void)parse_nonspeech_mode(nonspeech_filter);
+
+  if (speculative_fraction < 0.0f || speculative_fraction >= 1.0f) {
+    spdlog::warn("speculative_fraction ({}) must be in [0, 1), disabling", speculative_fraction);
+    speculative_fraction = 0.0f;
+  }
 
   if (min_audio_sec < 0.0f) {
     spdlog::warn("Clamping min_audio_sec {} to 0", min_audio_sec);
@@ -143,6 +275,11 @@ void Config::validate() {
     live_flush_interval_sec = 0.2f;
   }
 
+  if (realtime_lag_alert_sec < 0.0f) {
+    spdlog::warn("Clamping realtime_lag_alert_sec {} to 0 (disabled)", realtime_lag_alert_sec);
+    realtime_lag_alert_sec = 0.0f;
+  }
+
   // 0 disables the internal session duration limit.
   if (max_audio_sec < 0.0f) {
     spdlog::warn("Clamping max_audio_sec {} to 0 (unlimited)", max_audio_sec);
@@ -156,6 +293,21 @@ void Config::validate() {
     throw ConfigError("feature_dim must be positive, got " + std::to_string(feature_dim));
   }
 
+  (void)parse_decoding_strategy(decoding_method);
+  if (max_active_paths < 1 || max_active_paths > 64) {
+    spdlog::warn("Clamping max_active_paths {} to [1, 64]", max_active_paths);
+    max_active_paths = std::clamp(max_active_paths, 1, 64);
+  }
+  if (adaptive_greedy_above < 0.0f) {
+    spdlog::warn("Clamping adaptive_greedy_above {} to 0", adaptive_greedy_above);
+    adaptive_greedy_above = 0.0f;
+  }
+  if (adaptive_beam_below < 0.0f || adaptive_beam_below > adaptive_greedy_above) {
+    spdlog::warn("Clamping adaptive_beam_below {} to [0, adaptive_greedy_above={}]", adaptive_beam_below,
+                 adaptive_greedy_above);
+    adaptive_beam_below = std::clamp(adaptive_beam_below, 0.0f, adaptive_greedy_above);
+  }
+
   if (max_upload_bytes == 0) {
     throw ConfigError("max_upload_bytes must be positive");
   }
@@ -168,23 +320,33 @@ void Config::validate() {
     throw ConfigError("max_ws_message_bytes must be positive");
   }
 
-  // Pool size: default = 1
-  if (recognizer_pool_size == 0) {
-    recognizer_pool_size = 1;
-  }
-  if (recognizer_pool_size < 1 || recognizer_pool_size > 256) {
-    spdlog::warn("Clamping recognizer_pool_size {} to [1, 256]", recognizer_pool_size);
-    recognizer_pool_size = std::clamp(recognizer_pool_size, 1, 256);
+  if (opus_decode_threads == 0) {
+    opus_decode_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
   }
 
+  resolve_recognizer_slots();
+
   if (recognizer_wait_timeout_ms == 0) {
     spdlog::warn("recognizer_wait_timeout_ms must be positive, using default 30000");
     recognizer_wait_timeout_ms = 30000;
   }
 
-  // Max concurrent requests: 0 = auto (= recognizer_pool_size)
-  if (max_concurrent_requests == 0) {
-    max_concurrent_requests = static_cast<size_t>(recognizer_pool_size);
+  // Load thresholds: negative values make no sense, 0 disables a signal.
+  for (auto* threshold : {&ready_queue_degraded, &ready_queue_not_ready, &ready_slots_degraded,
+                          &ready_slots_not_ready, &ready_memory_degraded, &ready_memory_not_ready}) {
+    if (*threshold < 0.0f) {
+      spdlog::warn("Clamping readiness threshold {} to 0 (disabled)", *threshold);
+      *threshold = 0.0f;
+    }
+  }
+  if (ready_recover_ratio <= 0.0f || ready_recover_ratio > 1.0f) {
+    spdlog::warn("Clamping ready_recover_ratio {} to (0, 1]", ready_recover_ratio);
+    ready_recover_ratio = std::clamp(ready_recover_ratio, 0.1f, 1.0f);
+  }
+
+  // Tenants: malformed specs must fail at startup, not on the first request.
+  if (!tenants.empty()) {
+    (void)parse_tenant_specs(tenants);
   }
 
   // Cross-validation: VAD durations
@@ -0,0 +1,53 @@
+#include "asr/decoding_policy.h"
+
+#include <string>
+
+#include "asr/config.h"
+#include "asr/string_utils.h"
+
+namespace asr {
+
+DecodingStrategy parse_decoding_strategy(std::string_view value) {
+  const auto normalized = to_lower_ascii(trim_ascii(value));
+  if (normalized == "greedy_search" || normalized == "greedy") {
+    return DecodingStrategy::Greedy;
+  }
+  if (normalized == "modified_beam_search" || normalized == "beam") {
+    return DecodingStrategy::ModifiedBeamSearch;
+  }
+  if (normalized == "adaptive") {
+    return DecodingStrategy::Adaptive;
+  }
+  throw ConfigError("decoding_method must be greedy_search, modified_beam_search or adaptive, got '" +
+                    std::string(value) + "'");
+}
+
+const char* decoding_method_name(DecodingMethod method) noexcept {
+  switch (method) {
+    case DecodingMethod::Greedy:
+      return "greedy_search";
+    case DecodingMethod::ModifiedBeamSearch:
+      return "modified_beam_search";
+  }
+  return "greedy_search";
+}
+
+AdaptiveDecodingPolicy::AdaptiveDecodingPolicy(double beam_below, double greedy_above)
+    : beam_below_(beam_below), greedy_above_(greedy_above) {}
+
+DecodingMethod AdaptiveDecodingPolicy::select(size_t busy_others, size_t queued, size_t slots_total) {
+  const double pressure =
+      slots_total > 0 ? static_cast<double>(busy_others + queued) / static_cast<double>(slots_total) : 1.0;
+  if (current_ == DecodingMethod::ModifiedBeamSearch && pressure > greedy_above_) {
+    current_ = DecodingMethod::Greedy;
+  } else if (current_ == DecodingMethod::Greedy && pressure <= beam_below_) {
+    current_ = DecodingMethod::ModifiedBeamSearch;
+  }
+  return current_;
+}
+
+DecodingMethod AdaptiveDecodingPolicy::current() const noexcept {
+  return current_;
+}
+
+}  // namespace asr
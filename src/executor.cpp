@@ -2,14 +2,19 @@
 
 #include <_stdio.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <exception>
+#include <numeric>
 #include <stdexcept>
 #include <utility>
 
+#include "asr/profiler.h"
+
 namespace asr {
 
-BoundedExecutor::BoundedExecutor(size_t worker_count, size_t queue_capacity)
+BoundedExecutor::BoundedExecutor(size_t worker_count, size_t queue_capacity,
+                                 std::vector<uint32_t> lane_weights)
     : queue_capacity_(queue_capacity) {
   if (worker_count == 0) {
     throw std::invalid_argument("BoundedExecutor worker_count must be positive");
@@ -17,6 +22,21 @@ BoundedExecutor::BoundedExecutor(size_t worker_count, size_t queue_capacity)
   if (queue_capacity_ == 0) {
     throw std::invalid_argument("BoundedExecutor queue_capacity must be positive");
   }
+  if (lane_weights.empty()) {
+    lane_weights.push_back(1);
+  }
+  if (std::any_of(lane_weights.begin(), lane_weights.end(), [](uint32_t w) { return w == 0; })) {
+    throw std::invalid_argument("BoundedExecutor lane weights must be positive");
+  }
+
+  const uint64_t total_weight = std::accumulate(lane_weights.begin(), lane_weights.end(), uint64_t{0});
+  lanes_.resize(lane_weights.size());
+  for (size_t i = 0; i < lanes_.size(); ++i) {
+    lanes_[i].weight = lane_weights[i];
+    lanes_[i].limit =
+        std::max<size_t>(1, static_cast<size_t>(queue_capacity_ * uint64_t{lane_weights[i]} / total_weight));
+    lanes_[i].queue = FixedRing<Task>(lanes_[i].limit);
+  }
 
   workers_.reserve(worker_count);
   for (size_t i = 0; i < worker_count; ++i) {
@@ -28,22 +48,39 @@ BoundedExecutor::~BoundedExecutor() {
   shutdown();
 }
 
-bool BoundedExecutor::try_submit(Task task) {
+bool BoundedExecutor::try_submit(Task task, size_t lane) {
   if (!task) {
     return false;
   }
 
   {
     std::lock_guard lock(mutex_);
-    if (stopping_ || queue_.size() >= queue_capacity_) {
+    auto&           target = lanes_[lane < lanes_.size() ? lane : 0];
+    if (stopping_ || queued_ >= queue_capacity_ || target.queue.size() >= target.limit) {
       return false;
     }
-    queue_.push_back(std::move(task));
+    if (target.queue.empty()) {
+      // An idle lane re-enters at the current virtual time instead of
+      // spending credit it banked while it had nothing queued.
+      target.pass = std::max(target.pass, virtual_time_);
+    }
+    target.queue.push_back(std::move(task));
+    ++queued_;
   }
   cv_.notify_one();
   return true;
 }
 
+BoundedExecutor::Lane* BoundedExecutor::next_lane() {
+  Lane* best = nullptr;
+  for (auto& lane : lanes_) {
+    if (!lane.queue.empty() && (best == nullptr || lane.pass < best->pass)) {
+      best = &lane;
+    }
+  }
+  return best;
+}
+
 void BoundedExecutor::shutdown() {
   {
     std::lock_guard lock(mutex_);
@@ -65,12 +102,17 @@ void BoundedExecutor::shutdown() {
 
 bool BoundedExecutor::wait_for_idle(std::chrono::milliseconds timeout) {
   std::unique_lock lock(mutex_);
-  return idle_cv_.wait_for(lock, timeout, [this]() { return queue_.empty() && in_flight_ == 0; });
+  return idle_cv_.wait_for(lock, timeout, [this]() { return queued_ == 0 && in_flight_ == 0; });
 }
 
 size_t BoundedExecutor::queued() const {
   std::lock_guard lock(mutex_);
-  return queue_.size();
+  return queued_;
+}
+
+size_t BoundedExecutor::queued(size_t lane) const {
+  std::lock_guard lock(mutex_);
+  return lane < lanes_.size() ? lanes_[lane].queue.size() : 0;
 }
 
 size_t BoundedExecutor::in_flight() const {
@@ -82,17 +124,26 @@ size_t BoundedExecutor::capacity() const noexcept {
   return queue_capacity_;
 }
 
+size_t BoundedExecutor::lane_count() const noexcept {
+  return lanes_.size();
+}
+
 void BoundedExecutor::worker_loop() {
+  set_current_thread_role(kThreadRoleExecutor);
   for (;;) {
     Task task;
     {
       std::unique_lock lock(mutex_);
-      cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
-      if (stopping_ && queue_.empty()) {
+      cv_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+      if (stopping_ && queued_ == 0) {
         return;
       }
-      task = std::move(queue_.front());
-      queue_.pop_front();
+      Lane* lane    = next_lane();
+      virtual_time_ = lane->pass;
+      lane->pass += kStride / lane->weight;
+      task = std::move(lane->queue.front());
+      lane->queue.pop_front();
+      --queued_;
       ++in_flight_;
     }
 
@@ -107,82 +158,80 @@ void BoundedExecutor::worker_loop() {
     {
       std::lock_guard lock(mutex_);
       --in_flight_;
-      if (queue_.empty() && in_flight_ == 0) {
+      if (queued_ == 0 && in_flight_ == 0) {
         idle_cv_.notify_all();
       }
     }
   }
 }
 
-SerializedTaskQueue::SerializedTaskQueue(size_t max_pending) : max_pending_(max_pending) {}
-
-bool SerializedTaskQueue::push_or_start(StartFn start) {
-  std::lock_guard lock(mutex_);
-  if (!start || stopped_) {
-    return false;
+void LoopActor::pushed(const std::shared_ptr<LoopActor>& self, bool owns_drain) {
+  if (!keepalive_) {
+    keepalive_ = self;
   }
-  if (in_flight_ || !pending_.empty()) {
-    if (pending_.size() >= max_pending_) {
-      return false;
-    }
-    pending_.push_back(std::move(start));
-    return true;
-  }
-  if (start()) {
-    in_flight_ = true;
-    return true;
+  if (owns_drain) {
+    start_drain(self);
   }
-  if (pending_.size() >= max_pending_) {
-    return false;
-  }
-  pending_.push_back(std::move(start));
-  return true;
+  settle();
 }
 
-void SerializedTaskQueue::finish_current() {
-  std::lock_guard lock(mutex_);
-  in_flight_ = false;
-}
-
-bool SerializedTaskQueue::maybe_start_next() {
-  std::lock_guard lock(mutex_);
-  if (stopped_ || in_flight_ || pending_.empty()) {
-    return false;
-  }
-  if (!pending_.front()()) {
-    return false;
+void LoopActor::closed() {
+  stop_processing.store(true, std::memory_order_release);
+  if (drains_outstanding_ > 0 || retry_scheduled_) {
+    close_pending_ = true;  // the drain owner still holds the actor's state
+    return;
   }
-  pending_.pop_front();
-  in_flight_ = true;
-  return true;
+  on_closed();
 }
 
-void SerializedTaskQueue::stop(bool drop_pending) {
-  std::lock_guard lock(mutex_);
-  stopped_ = true;
-  if (drop_pending) {
-    pending_.clear();
+void LoopActor::run_batch() {
+  bool owned = true;
+  for (size_t n = 0; owned && n < kBatch; ++n) {
+    owned = run_front();
   }
+  post([this, owned]() { drain_finished(owned); });
 }
 
-void SerializedTaskQueue::clear() {
-  std::lock_guard lock(mutex_);
-  pending_.clear();
-}
-
-bool SerializedTaskQueue::in_flight() const noexcept {
-  std::lock_guard lock(mutex_);
-  return in_flight_;
-}
-
-bool SerializedTaskQueue::stopped() const noexcept {
-  std::lock_guard lock(mutex_);
-  return stopped_;
+// Loop thread, owning the drain: hands it to a worker, or retries shortly
+// when the executor is full. A stopped actor is drained in place.
+void LoopActor::start_drain(const std::shared_ptr<LoopActor>& self) {
+  if (stop_processing.load(std::memory_order_acquire)) {
+    while (run_front()) {
+    }
+    return;
+  }
+  if (submit_drain()) {
+    ++drains_outstanding_;
+    return;
+  }
+  retry_scheduled_ = true;
+  post_after(kRetryDelaySec, [self]() {
+    self->retry_scheduled_ = false;
+    self->start_drain(self);
+    self->settle();
+  });
+}
+
+void LoopActor::drain_finished(bool owned) {
+  const auto self = keepalive_;  // held until this returns
+  --drains_outstanding_;
+  if (owned) {
+    start_drain(self);
+  }
+  settle();
 }
 
-size_t SerializedTaskQueue::pending() const noexcept {
-  std::lock_guard lock(mutex_);
-  return pending_.size();
+// Loop thread: once no drain is outstanding, runs a deferred close and drops
+// the self-reference.
+void LoopActor::settle() {
+  if (drains_outstanding_ > 0 || retry_scheduled_) {
+    return;
+  }
+  if (close_pending_) {
+    close_pending_ = false;
+    on_closed();
+  }
+  keepalive_.reset();  // may destroy this
 }
 
 }  // namespace asr
@@ -19,11 +19,28 @@
 
 namespace asr {
 
-ASRSession::ASRSession(Recognizer& recognizer, const VadConfig& vad_config, const Config& config,
-                       std::string metrics_mode)
-    : recognizer_(recognizer), vad_(vad_config), config_(config), metrics_mode_(std::move(metrics_mode)) {
+namespace {
+
+// How far back from the flush point a live split may look for a pause.
+constexpr float kLiveSplitLookbackSec = 1.0f;
+
+}  // namespace
+
+template <typename Policy>
+BasicASRSession<Policy>::BasicASRSession(RecognizerBackend& recognizer, const VadConfig& vad_config,
+                                         const Config& config)
+    : recognizer_(recognizer),
+      vad_(vad_config),
+      config_(config),
+      nonspeech_mode_(parse_nonspeech_mode(config.nonspeech_filter)) {
   pending_.reserve(static_cast<size_t>(vad_config.window_size));
-  if (config_.live_flush_interval_sec > 0.0f) {
+  if (config_.vad_adaptive_threshold) {
+    vad_threshold_.emplace(vad_config.threshold, config_.vad_threshold_max);
+  }
+  if (nonspeech_mode_ != NonSpeechMode::Off) {
+    segment_classifier_.emplace(config_.sample_rate);
+  }
+  if (Policy::kLiveUpdates && config_.live_flush_interval_sec > 0.0f) {
     const auto live_reserve = static_cast<size_t>(std::max(1.0f, config_.live_flush_interval_sec) *
                                                   static_cast<float>(config_.sample_rate));
     live_chunk_.reserve(live_reserve);
@@ -34,20 +51,25 @@ ASRSession::ASRSession(Recognizer& recognizer, const VadConfig& vad_config, cons
 
 // --- Zero-alloc message buffer ---
 
-ASRSession::OutMessage& ASRSession::next_message() {
+template <typename Policy>
+ASRSessionMessage& BasicASRSession<Policy>::next_message() {
   if (out_size_ >= out_messages_.size()) {
     out_messages_.emplace_back();
-    out_messages_.back().json.reserve(128);
+    if constexpr (Policy::kJson) {
+      out_messages_.back().json.reserve(128);
+    }
     out_messages_.back().text.reserve(128);
   }
   return out_messages_[out_size_++];
 }
 
-span<const ASRSession::OutMessage> ASRSession::current_messages() const {
+template <typename Policy>
+span<const ASRSessionMessage> BasicASRSession<Policy>::current_messages() const {
   return {out_messages_.data(), out_size_};
 }
 
-void ASRSession::write_interim(float duration, float rms, bool is_speech) {
+template <typename Policy>
+void BasicASRSession<Policy>::write_interim(float duration, float rms, bool is_speech) {
   auto& msg = next_message();
   msg.type  = OutMessage::Interim;
   msg.json.clear();
@@ -58,28 +80,37 @@ void ASRSession::write_interim(float duration, float rms, bool is_speech) {
                  is_speech ? "true" : "false");
 }
 
-void ASRSession::write_final(const std::string& text, float duration) {
+template <typename Policy>
+void BasicASRSession<Policy>::write_final(const std::string& text, float duration) {
   auto& msg = next_message();
   msg.type  = OutMessage::Final;
   msg.json.clear();
   msg.text.assign(text);
-  msg.json.append(R"({"type":"final","text":")");
-  append_json_escaped(msg.json, text);
-  fmt::format_to(std::back_inserter(msg.json), R"(","duration":{:.3f}}})",
-                 std::round(duration * 1000.0f) / 1000.0f);
+  if constexpr (Policy::kJson) {
+    msg.json.append(R"({"type":"final","text":")");
+    append_json_escaped(msg.json, text);
+    fmt::format_to(std::back_inserter(msg.json), R"(","duration":{:.3f}}})",
+                   std::round(duration * 1000.0f) / 1000.0f);
+  } else {
+    (void)duration;
+  }
 }
 
-void ASRSession::write_done() {
+template <typename Policy>
+void BasicASRSession<Policy>::write_done() {
   auto& msg = next_message();
   msg.type  = OutMessage::Done;
   msg.json.clear();
   msg.text.clear();
-  msg.json.append(R"({"type":"done"})");
+  if constexpr (Policy::kJson) {
+    msg.json.append(R"({"type":"done"})");
+  }
 }
 
 // --- Session lifecycle ---
 
-void ASRSession::reset_session() {
+template <typename Policy>
+void BasicASRSession<Policy>::reset_session() {
   ++session_seq_;
   start_ts_                = SteadyClock::now();
   first_result_ts_         = {};
@@ -96,7 +127,8 @@ void ASRSession::reset_session() {
   max_duration_exceeded_   = false;
 }
 
-void ASRSession::process_vad_segments() {
+template <typename Policy>
+void BasicASRSession<Policy>::process_vad_segments() {
   while (!vad_.empty()) {
     const auto& segment = vad_.front();
     const float audio_sec =
@@ -110,11 +142,32 @@ void ASRSession::process_vad_segments() {
       continue;
     }
 
-    // Recognize
-    auto         t0             = SteadyClock::now();
-    auto         text           = recognizer_.recognize(segment.samples, config_.sample_rate);
-    auto         t1             = SteadyClock::now();
-    const double seg_decode_sec = std::chrono::duration<double>(t1 - t0).count();
+    // Tones, hold music and hiss the VAD let through
+    if (segment_classifier_) {
+      const auto kind = segment_classifier_->classify(segment.samples);
+      if (kind != SegmentClass::Speech) {
+        const bool drop = nonspeech_mode_ == NonSpeechMode::Drop;
+        ASRMetrics::instance().observe_nonspeech_segment(kind, drop);
+        spdlog::debug("ASR session #{}: {} segment {:.3f}s{}", session_seq_, segment_class_name(kind),
+                      audio_sec, drop ? ", dropped" : "");
+        if (drop) {
+          drop_speculation();
+          silence_segments_++;
+          ASRMetrics::instance().record_silence();
+          vad_.pop();
+          continue;
+        }
+      }
+    }
+
+    // Recognize, unless a speculative decode already covered exactly this audio
+    std::string text;
+    double      seg_decode_sec = 0.0;
+    if (!take_speculation(segment, text, seg_decode_sec)) {
+      const auto t0  = SteadyClock::now();
+      text           = recognizer_.recognize(segment.samples, config_.sample_rate, SlotClass::Realtime);
+      seg_decode_sec = std::chrono::duration<double>(SteadyClock::now() - t0).count();
+    }
     decode_sec_ += seg_decode_sec;
     audio_samples_ += segment.samples.size();
 
@@ -123,12 +176,22 @@ void ASRSession::process_vad_segments() {
       first_result_ts_  = SteadyClock::now();
       has_first_result_ = true;
       const double ttfr = std::chrono::duration<double>(first_result_ts_ - start_ts_).count();
-      ASRMetrics::instance().observe_ttfr(ttfr, metrics_mode_);
+      ASRMetrics::instance().observe_ttfr(ttfr, Policy::kMetricMode);
     }
 
     // Metrics
     ASRMetrics::instance().observe_segment(static_cast<double>(audio_sec), seg_decode_sec);
 
+    if (vad_threshold_) {
+      if (vad_threshold_->on_decode(text.empty())) {
+        vad_.set_threshold(vad_threshold_->threshold());
+        spdlog::debug("ASR session #{}: VAD threshold {:.2f} (noise floor {:.1f} dBFS)", session_seq_,
+                      vad_threshold_->threshold(), vad_threshold_->noise_floor_dbfs());
+      }
+      ASRMetrics::instance().observe_vad_threshold(static_cast<double>(vad_threshold_->threshold()),
+                                                   static_cast<double>(vad_threshold_->noise_floor_dbfs()));
+    }
+
     if (text.empty()) {
       spdlog::debug("ASR session #{}: empty decode result for segment {:.3f}s", session_seq_, audio_sec);
       silence_segments_++;
@@ -145,12 +208,80 @@ void ASRSession::process_vad_segments() {
   }
 }
 
-bool ASRSession::has_final_messages() const {
+template <typename Policy>
+void BasicASRSession<Policy>::maybe_speculate() {
+  if (config_.speculative_fraction <= 0.0f || vad_.silence_progress() < config_.speculative_fraction) {
+    return;
+  }
+  const auto speech      = vad_.open_speech();
+  const auto start       = vad_.open_start_sample();
+  const auto min_samples = std::max<size_t>(1, static_cast<size_t>(std::max(0.0F, config_.min_audio_sec) *
+                                                                    static_cast<float>(config_.sample_rate)));
+  if (speech.size() < min_samples || (spec_start_sample_ == start && spec_samples_ == speech.size())) {
+    return;  // too short to be decoded at all, or this pause was already tried
+  }
+
+  drop_speculation();  // speech resumed since the last attempt
+  spec_start_sample_ = start;
+  spec_samples_      = speech.size();
+
+  const auto load = recognizer_.load();
+  if (load.slots_busy >= load.slots_total) {
+    ASRMetrics::instance().observe_speculative_decode("busy");
+    return;
+  }
+  try {
+    const auto t0    = SteadyClock::now();
+    spec_text_       = recognizer_.recognize(speech, config_.sample_rate, SlotClass::Realtime);
+    spec_decode_sec_ = std::chrono::duration<double>(SteadyClock::now() - t0).count();
+    spec_ready_      = true;
+  } catch (const RecognizerBusyError&) {
+    // Lost the free slot to another session; decode normally at turn end.
+    ASRMetrics::instance().observe_speculative_decode("busy");
+    return;
+  }
+  spdlog::debug("ASR session #{}: speculative decode {:.3f}s at silence {:.0f}% took {:.3f}s", session_seq_,
+                static_cast<double>(speech.size()) / static_cast<double>(config_.sample_rate),
+                static_cast<double>(vad_.silence_progress()) * 100.0, spec_decode_sec_);
+}
+
+template <typename Policy>
+bool BasicASRSession<Policy>::take_speculation(const SpeechSegment& segment, std::string& text,
+                                               double& decode_sec) {
+  const bool hit = spec_ready_ && spec_start_sample_ == segment.start_sample &&
+                   spec_samples_ == segment.samples.size();
+  if (!hit) {
+    drop_speculation();
+    return false;
+  }
+  text       = std::move(spec_text_);
+  decode_sec = spec_decode_sec_;
+  ASRMetrics::instance().observe_speculative_decode("hit");
+  spec_ready_        = false;
+  spec_start_sample_ = -1;
+  spec_samples_      = 0;
+  return true;
+}
+
+template <typename Policy>
+void BasicASRSession<Policy>::drop_speculation() {
+  if (spec_ready_) {
+    ASRMetrics::instance().observe_speculative_decode("discarded");
+  }
+  spec_text_.clear();
+  spec_ready_        = false;
+  spec_start_sample_ = -1;
+  spec_samples_      = 0;
+}
+
+template <typename Policy>
+bool BasicASRSession<Policy>::has_final_messages() const {
   return std::any_of(out_messages_.begin(), out_messages_.begin() + static_cast<std::ptrdiff_t>(out_size_),
                      [](const OutMessage& message) { return message.type == OutMessage::Final; });
 }
 
-void ASRSession::process_live_chunk_fallback() {
+template <typename Policy>
+void BasicASRSession<Policy>::process_live_chunk_fallback() {
   const auto min_samples =
       static_cast<size_t>(std::max(0.0F, config_.min_audio_sec) * static_cast<float>(config_.sample_rate));
 
@@ -170,7 +301,7 @@ void ASRSession::process_live_chunk_fallback() {
 
   const float audio_sec  = static_cast<float>(live_chunk_.size()) / static_cast<float>(config_.sample_rate);
   auto        t0         = SteadyClock::now();
-  auto        text       = recognizer_.recognize(live_chunk_, config_.sample_rate);
+  auto        text       = recognizer_.recognize(live_chunk_, config_.sample_rate, SlotClass::Realtime);
   auto        t1         = SteadyClock::now();
   const auto  decode_sec = std::chrono::duration<double>(t1 - t0).count();
 
@@ -181,7 +312,7 @@ void ASRSession::process_live_chunk_fallback() {
     first_result_ts_  = SteadyClock::now();
     has_first_result_ = true;
     const double ttfr = std::chrono::duration<double>(first_result_ts_ - start_ts_).count();
-    ASRMetrics::instance().observe_ttfr(ttfr, metrics_mode_);
+    ASRMetrics::instance().observe_ttfr(ttfr, Policy::kMetricMode);
   }
 
   ASRMetrics::instance().observe_segment(static_cast<double>(audio_sec), decode_sec);
@@ -202,19 +333,42 @@ void ASRSession::process_live_chunk_fallback() {
   live_chunk_.clear();
 }
 
-void ASRSession::flush_pending() {
+template <typename Policy>
+void BasicASRSession<Policy>::feed_vad_window(size_t real_samples) {
+  const bool was_speech = vad_.is_speech();
+  vad_.accept_waveform(pending_);
+  if (vad_threshold_) {
+    const bool speech = was_speech || vad_.is_speech();
+    vad_threshold_->on_window(span<const float>(pending_.data(), real_samples), speech);
+    vad_.set_threshold(vad_threshold_->threshold());
+  }
+  if constexpr (Policy::kLiveUpdates) {
+    if (was_speech || vad_.is_speech()) {
+      // The VAD owns this window (and the pre-roll before a speech start);
+      // it is decoded with the segment, not by the fallback.
+      live_chunk_.clear();
+    } else {
+      live_chunk_.insert(live_chunk_.end(), pending_.begin(),
+                         pending_.begin() + static_cast<ptrdiff_t>(real_samples));
+    }
+  }
+  pending_.clear();
+}
+
+template <typename Policy>
+void BasicASRSession<Policy>::flush_pending() {
   if (!pending_.empty()) {
     const size_t tail_samples = pending_.size();
     pending_.resize(static_cast<size_t>(config_.vad_window_size), 0.0f);
-    vad_.accept_waveform(pending_);
-    pending_.clear();
+    feed_vad_window(tail_samples);
     spdlog::debug("ASR session #{}: flushed pending tail {} samples (padded to {})", session_seq_,
                   tail_samples, config_.vad_window_size);
   }
   vad_.flush();
 }
 
-void ASRSession::finalize_session(const char* reason) {
+template <typename Policy>
+void BasicASRSession<Policy>::finalize_session(const char* reason) {
   // Record request-level metrics
   const auto   now       = SteadyClock::now();
   const double total_sec = std::chrono::duration<double>(now - start_ts_).count();
@@ -226,7 +380,7 @@ void ASRSession::finalize_session(const char* reason) {
       session_seq_, reason, total_sec, audio_sec, chunks_, bytes_, segments_, silence_segments_);
 
   ASRMetrics::instance().observe_request(total_sec, audio_sec, decode_sec_, chunks_, bytes_, preprocess_sec_,
-                                         0.0, metrics_mode_, "success");
+                                         0.0, Policy::kMetricMode, "success");
 
   // Speech ratio
   const int total_segments = segments_ + silence_segments_;
@@ -248,12 +402,14 @@ void ASRSession::finalize_session(const char* reason) {
   vad_.reset();
   pending_.clear();
   live_chunk_.clear();
+  drop_speculation();
   reset_session();
 }
 
 // --- Public API ---
 
-span<const ASRSession::OutMessage> ASRSession::on_audio(span<const float> samples) {
+template <typename Policy>
+span<const ASRSessionMessage> BasicASRSession<Policy>::on_audio(span<const float> samples) {
   begin_messages();
 
   // Previous call may have force-finalized due max_audio_sec and sent {"type":"done"}.
@@ -273,7 +429,6 @@ span<const ASRSession::OutMessage> ASRSession::on_audio(span<const float> sample
   chunks_++;
   total_samples_received_ += samples.size();
   bytes_ += samples.size() * sizeof(float);
-  live_chunk_.insert(live_chunk_.end(), samples.begin(), samples.end());
 
   // Compute RMS for the chunk
   const float rms = compute_rms(samples);
@@ -290,8 +445,7 @@ span<const ASRSession::OutMessage> ASRSession::on_audio(span<const float> sample
     offset += to_copy;
 
     if (static_cast<int>(pending_.size()) == config_.vad_window_size) {
-      vad_.accept_waveform(pending_);
-      pending_.clear();
+      feed_vad_window(pending_.size());
     }
   }
 
@@ -300,43 +454,56 @@ span<const ASRSession::OutMessage> ASRSession::on_audio(span<const float> sample
 
   // Process any finalized VAD segments
   process_vad_segments();
-  if (has_final_messages()) {
-    live_chunk_.clear();
+  if constexpr (Policy::kLiveUpdates) {
+    if (has_final_messages()) {
+      live_chunk_.clear();
+    }
+    maybe_speculate();
   }
 
   // In long continuous speech VAD may delay finalization until silence.
-  // Periodically flush live stream state to emit regular finals without
-  // requiring client-side RECOGNIZE.
-  if (config_.live_flush_interval_sec > 0.0f) {
-    const auto interval_samples =
-        static_cast<size_t>(config_.live_flush_interval_sec * static_cast<float>(config_.sample_rate));
-    if (interval_samples > 0 && (total_samples_received_ - last_live_flush_samples_) >= interval_samples) {
-      const double total_input_sec =
-          static_cast<double>(total_samples_received_) / static_cast<double>(config_.sample_rate);
-      const double since_last_flush_sec =
-          static_cast<double>(total_samples_received_ - last_live_flush_samples_) /
-          static_cast<double>(config_.sample_rate);
-      spdlog::debug(
-          "ASR session #{}: periodic live flush total_input_sec={:.2f} since_last_flush_sec={:.2f} "
-          "pending_samples={} in_speech={}",
-          session_seq_, total_input_sec, since_last_flush_sec, pending_.size(),
-          vad_.is_speech() ? "true" : "false");
-      flush_pending();
-      process_vad_segments();
-      if (!has_final_messages()) {
-        process_live_chunk_fallback();
-      } else {
-        live_chunk_.clear();
+  // Periodically cut the open segment to emit regular finals without
+  // requiring client-side RECOGNIZE. The cut lands on the quietest recent
+  // VAD window and the rest stays open, so every sample is decoded once;
+  // the pending sub-window tail is left for the next window rather than
+  // zero-padded into the VAD stream.
+  if constexpr (Policy::kLiveUpdates) {
+    if (config_.live_flush_interval_sec > 0.0f) {
+      const auto interval_samples =
+          static_cast<size_t>(config_.live_flush_interval_sec * static_cast<float>(config_.sample_rate));
+      if (interval_samples > 0 && (total_samples_received_ - last_live_flush_samples_) >= interval_samples) {
+        const double total_input_sec =
+            static_cast<double>(total_samples_received_) / static_cast<double>(config_.sample_rate);
+        const double since_last_flush_sec =
+            static_cast<double>(total_samples_received_ - last_live_flush_samples_) /
+            static_cast<double>(config_.sample_rate);
+        spdlog::debug(
+            "ASR session #{}: periodic live flush total_input_sec={:.2f} since_last_flush_sec={:.2f} "
+            "pending_samples={} in_speech={}",
+            session_seq_, total_input_sec, since_last_flush_sec, pending_.size(),
+            vad_.is_speech() ? "true" : "false");
+        if (vad_.is_speech()) {
+          const auto max_lookback =
+              static_cast<size_t>(kLiveSplitLookbackSec * static_cast<float>(config_.sample_rate));
+          vad_.split_open_segment(static_cast<int64_t>(std::min(interval_samples, max_lookback)));
+          process_vad_segments();
+        } else if (!has_final_messages()) {
+          process_live_chunk_fallback();
+        } else {
+          live_chunk_.clear();
+        }
+        last_live_flush_samples_ = total_samples_received_;
       }
-      last_live_flush_samples_ = total_samples_received_;
     }
   }
 
   // If no segments were finalized, send interim status
-  if (out_size_ == 0) {
-    const float duration =
-        static_cast<float>(total_samples_received_) / static_cast<float>(config_.sample_rate);
-    write_interim(duration, rms, vad_.is_speech());
+  if constexpr (Policy::kInterims) {
+    if (out_size_ == 0) {
+      const float duration =
+          static_cast<float>(total_samples_received_) / static_cast<float>(config_.sample_rate);
+      write_interim(duration, rms, vad_.is_speech());
+    }
   }
 
   // Auto-finalize if max audio duration exceeded (DoS protection).
@@ -357,7 +524,8 @@ span<const ASRSession::OutMessage> ASRSession::on_audio(span<const float> sample
   return current_messages();
 }
 
-span<const ASRSession::OutMessage> ASRSession::on_recognize() {
+template <typename Policy>
+span<const ASRSessionMessage> BasicASRSession<Policy>::on_recognize() {
   begin_messages();
   spdlog::debug("ASR session #{}: RECOGNIZE received (session_active={} max_duration_exceeded={})",
                 session_seq_, session_active_ ? "true" : "false", max_duration_exceeded_ ? "true" : "false");
@@ -373,16 +541,19 @@ span<const ASRSession::OutMessage> ASRSession::on_recognize() {
 
   flush_pending();
   process_vad_segments();
-  if (!has_final_messages()) {
-    process_live_chunk_fallback();
-  } else {
-    live_chunk_.clear();
+  if constexpr (Policy::kLiveUpdates) {
+    if (!has_final_messages()) {
+      process_live_chunk_fallback();
+    } else {
+      live_chunk_.clear();
+    }
   }
   finalize_session("recognize_command");
   return current_messages();
 }
 
-void ASRSession::on_reset() {
+template <typename Policy>
+void BasicASRSession<Policy>::on_reset() {
   spdlog::debug("ASR session #{}: RESET received (chunks={} bytes={} samples={})", session_seq_, chunks_,
                 bytes_, total_samples_received_);
   max_duration_exceeded_ = false;
@@ -393,26 +564,32 @@ void ASRSession::on_reset() {
   vad_.reset();
   pending_.clear();
   live_chunk_.clear();
+  drop_speculation();
   reset_session();
 }
 
-bool ASRSession::is_speech() const {
+template <typename Policy>
+bool BasicASRSession<Policy>::is_speech() const {
   return vad_.is_speech();
 }
 
-bool ASRSession::has_speech_transition() const {
+template <typename Policy>
+bool BasicASRSession<Policy>::has_speech_transition() const {
   return vad_.has_transition();
 }
 
-const ASRSession::SpeechTransition& ASRSession::front_speech_transition() const {
+template <typename Policy>
+const SpeechTransition& BasicASRSession<Policy>::front_speech_transition() const {
   return vad_.front_transition();
 }
 
-void ASRSession::pop_speech_transition() {
+template <typename Policy>
+void BasicASRSession<Policy>::pop_speech_transition() {
   vad_.pop_transition();
 }
 
-void ASRSession::on_close() {
+template <typename Policy>
+void BasicASRSession<Policy>::on_close() {
   if (session_active_) {
     const auto   now     = SteadyClock::now();
     const double elapsed = std::chrono::duration<double>(now - start_ts_).count();
@@ -427,4 +604,8 @@ void ASRSession::on_close() {
   }
 }
 
+template class BasicASRSession<LegacySessionPolicy>;
+template class BasicASRSession<RealtimeSessionPolicy>;
+template class BasicASRSession<OfflineSessionPolicy>;
+
 }  // namespace asr
@@ -0,0 +1,168 @@
+#include "asr/load_monitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#include "asr/config.h"
+
+namespace asr {
+
+namespace {
+
+double ratio(size_t value, size_t limit) noexcept {
+  return limit > 0 ? static_cast<double>(value) / static_cast<double>(limit) : 0.0;
+}
+
+// Level contributed by one signal; a threshold of 0 disables that level.
+LoadState signal_level(double value, double degraded, double not_ready, double scale) noexcept {
+  if (not_ready > 0.0 && value >= not_ready * scale) {
+    return LoadState::NotReady;
+  }
+  if (degraded > 0.0 && value >= degraded * scale) {
+    return LoadState::Degraded;
+  }
+  return LoadState::Ok;
+}
+
+}  // namespace
+
+const char* load_state_name(LoadState state) noexcept {
+  switch (state) {
+    case LoadState::Ok:
+      return "ok";
+    case LoadState::Degraded:
+      return "degraded";
+    case LoadState::NotReady:
+      return "not_ready";
+  }
+  return "ok";
+}
+
+double LoadSnapshot::queue_utilization() const noexcept {
+  return ratio(queued, queue_capacity);
+}
+
+double LoadSnapshot::slot_utilization() const noexcept {
+  return ratio(slots_busy, slots_total);
+}
+
+double LoadSnapshot::memory_utilization() const noexcept {
+  return ratio(rss_bytes, memory_budget_bytes);
+}
+
+LoadThresholds LoadThresholds::from_config(const Config& cfg) {
+  LoadThresholds t;
+  t.queue_degraded     = cfg.ready_queue_degraded;
+  t.queue_not_ready    = cfg.ready_queue_not_ready;
+  t.slots_degraded     = cfg.ready_slots_degraded;
+  t.slots_not_ready    = cfg.ready_slots_not_ready;
+  t.wait_p95_degraded  = static_cast<double>(cfg.ready_wait_p95_degraded_ms) / 1000.0;
+  t.wait_p95_not_ready = static_cast<double>(cfg.ready_wait_p95_not_ready_ms) / 1000.0;
+  t.memory_degraded    = cfg.ready_memory_degraded;
+  t.memory_not_ready   = cfg.ready_memory_not_ready;
+  t.recover_ratio      = cfg.ready_recover_ratio;
+  return t;
+}
+
+LoadStateTracker::LoadStateTracker(const LoadThresholds& thresholds) : thresholds_(thresholds) {}
+
+LoadState LoadStateTracker::classify(const LoadSnapshot& snapshot, double scale) const {
+  const auto& t = thresholds_;
+  LoadState   level =
+      signal_level(snapshot.queue_utilization(), t.queue_degraded, t.queue_not_ready, scale);
+  level = std::max(level,
+                   signal_level(snapshot.slot_utilization(), t.slots_degraded, t.slots_not_ready, scale));
+  level = std::max(level,
+                   signal_level(snapshot.wait_p95_sec, t.wait_p95_degraded, t.wait_p95_not_ready, scale));
+  if (snapshot.memory_budget_bytes > 0) {
+    level = std::max(
+        level, signal_level(snapshot.memory_utilization(), t.memory_degraded, t.memory_not_ready, scale));
+  }
+  return level;
+}
+
+LoadState LoadStateTracker::update(const LoadSnapshot& snapshot) {
+  const std::scoped_lock lock(mutex_);
+  const LoadState        raised = classify(snapshot, 1.0);
+  if (raised >= state_) {
+    state_ = raised;
+    return state_;
+  }
+  // Below the entry thresholds: only step down once clear of the recovery band.
+  const LoadState recovered = classify(snapshot, thresholds_.recover_ratio);
+  if (recovered < state_) {
+    state_ = recovered;
+  }
+  return state_;
+}
+
+LoadState LoadStateTracker::state() const {
+  const std::scoped_lock lock(mutex_);
+  return state_;
+}
+
+RecentLatencyWindow::RecentLatencyWindow(size_t capacity, std::chrono::seconds max_age)
+    : samples_(std::max<size_t>(1, capacity)), max_age_(max_age) {
+  scratch_.reserve(samples_.size());
+}
+
+void RecentLatencyWindow::record(double sec, Clock::time_point now) {
+  samples_[next_] = Sample{now, sec};
+  next_           = (next_ + 1) % samples_.size();
+  size_           = std::min(size_ + 1, samples_.size());
+}
+
+double RecentLatencyWindow::percentile(double q, Clock::time_point now) const {
+  scratch_.clear();
+  const auto oldest = now - max_age_;
+  for (size_t i = 0; i < size_; ++i) {
+    if (samples_[i].at >= oldest) {
+      scratch_.push_back(samples_[i].sec);
+    }
+  }
+  if (scratch_.empty()) {
+    return 0.0;
+  }
+  const double clamped = std::clamp(q, 0.0, 1.0);
+  const auto   rank    = static_cast<size_t>(std::ceil(clamped * static_cast<double>(scratch_.size())));
+  const auto   nth     = scratch_.begin() + static_cast<std::ptrdiff_t>(rank > 0 ? rank - 1 : 0);
+  std::nth_element(scratch_.begin(), nth, scratch_.end());
+  return *nth;
+}
+
+size_t current_rss_bytes() noexcept {
+#if defined(__linux__)
+  std::FILE* f = std::fopen("/proc/self/statm", "r");
+  if (f == nullptr) {
+    return 0;
+  }
+  unsigned long size_pages     = 0;  // NOLINT(google-runtime-int)
+  unsigned long resident_pages = 0;  // NOLINT(google-runtime-int)
+  const int     parsed         = std::fscanf(f, "%lu %lu", &size_pages, &resident_pages);
+  std::fclose(f);  // NOLINT(cert-err33-c)
+  if (parsed != 2) {
+    return 0;
+  }
+  const long page_size = sysconf(_SC_PAGESIZE);  // NOLINT(google-runtime-int)
+  return page_size > 0 ? static_cast<size_t>(resident_pages) * static_cast<size_t>(page_size) : 0;
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t info{};
+  mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+      KERN_SUCCESS) {
+    return 0;
+  }
+  return static_cast<size_t>(info.resident_size);
+#else
+  return 0;
+#endif
+}
+
+}  // namespace asr
@@ -10,6 +10,7 @@
 #include <string>
 #include <utility>
 
+#include "asr/autotune.h"
 #include "asr/config.h"
 #include "asr/metrics.h"
 #include "asr/recognizer.h"
@@ -50,17 +51,20 @@ int run_server() {
   config.validate();
 
   spdlog::info("ASR Server v1.0.0 (C++)");
-  spdlog::info("Loading GigaAM v3 model from {}...", config.model_dir);
+  if (config.autotune) {
+    asr::run_autotune(config);
+  }
+  spdlog::info("Loading GigaAM v3 model from {} ({})...", config.model_dir, config.encoder_file);
 
-  asr::Recognizer recognizer(config);
-  spdlog::info("Model loaded. Provider: {}, threads: {}, pool_size: {}", config.provider, config.num_threads,
-               config.recognizer_pool_size);
+  const auto recognizer = asr::make_recognizer_backend(config);
+  spdlog::info("Model loaded. Backend: {}, provider: {}, threads: {}, pool_size: {}",
+               config.recognizer_backend, config.provider, config.num_threads, config.recognizer_pool_size);
   spdlog::info("Runtime config: sample_rate={} idle_connection_timeout_sec={} max_ws_connections={}",
                config.sample_rate, config.idle_connection_timeout_sec, config.max_ws_connections);
 
   asr::ASRMetrics::instance().initialize();
 
-  asr::Server server(config, recognizer);
+  asr::Server server(config, *recognizer);
   server.run();
   shutdown_logging();
   return 0;
@@ -6,6 +6,8 @@
 #include <prometheus/histogram.h>
 #include <spdlog/spdlog.h>
 
+#include "asr/recognizer.h"
+
 namespace asr {
 
 // Static bucket definitions — allocated once, reused on every observation
@@ -81,11 +83,27 @@ const prometheus::Histogram::BucketBoundaries& kWords() {
   return kBuckets;
 }
 
+const prometheus::Histogram::BucketBoundaries& kLag() {
+  static const auto kBuckets =
+      prometheus::Histogram::BucketBoundaries{0.05, 0.1, 0.25, 0.5, 1.0, 2.0, 3.0, 5.0, 10.0, 30.0};
+  return kBuckets;
+}
+
 const prometheus::Histogram::BucketBoundaries& kRMS() {
   static const auto kBuckets =
       prometheus::Histogram::BucketBoundaries{0.001, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5};
   return kBuckets;
 }
+
+const prometheus::Histogram::BucketBoundaries& kVadThreshold() {
+  static const auto kBuckets = prometheus::Histogram::BucketBoundaries{0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};
+  return kBuckets;
+}
+
+const prometheus::Histogram::BucketBoundaries& kNoiseFloor() {
+  static const auto kBuckets = prometheus::Histogram::BucketBoundaries{-70, -60, -50, -40, -30, -20};
+  return kBuckets;
+}
 }  // namespace buckets
 
 namespace {
@@ -93,7 +111,8 @@ namespace {
 std::string_view canonical_error_type(std::string_view error_type) {
   if (error_type == "capacity_exceeded" || error_type == "empty_file" || error_type == "file_too_large" ||
       error_type == "invalid_audio" || error_type == "internal_error" || error_type == "bad_multipart" ||
-      error_type == "invalid_param" || error_type == "realtime_ws_handler_exception") {
+      error_type == "invalid_param" || error_type == "quota_exceeded" ||
+      error_type == "realtime_ws_handler_exception") {
     return error_type;
   }
   return "other";
@@ -106,12 +125,6 @@ std::string_view canonical_disconnect_reason(std::string_view reason) {
   return "other";
 }
 
-enum class MetricMode {
-  RealtimeWebsocket,
-  Http,
-  WhisperApi,
-};
-
 MetricMode canonical_mode(std::string_view mode) {
   if (mode == "realtime_websocket") {
     return MetricMode::RealtimeWebsocket;
@@ -188,7 +201,10 @@ void ASRMetrics::initialize() {
                                    .Name("gigaam_recognizer_wait_seconds")
                                    .Help("Time spent waiting for a recognizer slot")
                                    .Register(*registry_);
-    recognizer_wait_        = &recognizer_wait_family_->Add({}, buckets::kQueueWait());
+    for (const auto slot_class : {SlotClass::Shared, SlotClass::Realtime}) {
+      recognizer_wait_[static_cast<size_t>(slot_class)] =
+          &recognizer_wait_family_->Add({{"class", slot_class_name(slot_class)}}, buckets::kQueueWait());
+    }
 
     segment_rtf_family_ =
         &prometheus::BuildHistogram().Name("gigaam_segment_rtf").Help("RTF per segment").Register(*registry_);
@@ -228,7 +244,10 @@ void ASRMetrics::initialize() {
                                             .Name("gigaam_recognizer_wait_timeouts_total")
                                             .Help("Timed out waits for recognizer slots")
                                             .Register(*registry_);
-    recognizer_wait_timeouts_        = &recognizer_wait_timeouts_family_->Add({});
+    for (const auto slot_class : {SlotClass::Shared, SlotClass::Realtime}) {
+      recognizer_wait_timeouts_[static_cast<size_t>(slot_class)] =
+          &recognizer_wait_timeouts_family_->Add({{"class", slot_class_name(slot_class)}});
+    }
 
     // ===== Pipeline Gauges =====
     active_connections_family_ = &prometheus::BuildGauge()
@@ -367,6 +386,103 @@ void ASRMetrics::initialize() {
                                 .Register(*registry_);
     speech_ratio_        = &speech_ratio_family_->Add({});
 
+    load_state_family_ = &prometheus::BuildGauge()
+                              .Name("gigaam_load_state")
+                              .Help("Readiness load state (0=ok, 1=degraded, 2=not_ready)")
+                              .Register(*registry_);
+    load_state_        = &load_state_family_->Add({});
+
+    decoding_mode_family_ = &prometheus::BuildGauge()
+                                 .Name("gigaam_decoding_mode")
+                                 .Help("Latest decode method (0=greedy_search, 1=modified_beam_search)")
+                                 .Register(*registry_);
+    decoding_mode_        = &decoding_mode_family_->Add({});
+
+    decodes_total_family_ = &prometheus::BuildCounter()
+                                 .Name("gigaam_decodes_total")
+                                 .Help("Offline decodes by transducer search method")
+                                 .Register(*registry_);
+    decodes_greedy_       = &decodes_total_family_->Add({{"method", "greedy_search"}});
+    decodes_beam_         = &decodes_total_family_->Add({{"method", "modified_beam_search"}});
+
+    vad_threshold_family_ = &prometheus::BuildHistogram()
+                                 .Name("gigaam_vad_threshold")
+                                 .Help("Adaptive VAD threshold at each decoded segment")
+                                 .Register(*registry_);
+    vad_threshold_        = &vad_threshold_family_->Add({}, buckets::kVadThreshold());
+
+    vad_noise_floor_family_ = &prometheus::BuildHistogram()
+                                   .Name("gigaam_vad_noise_floor_dbfs")
+                                   .Help("Estimated channel noise floor at each decoded segment")
+                                   .Register(*registry_);
+    vad_noise_floor_        = &vad_noise_floor_family_->Add({}, buckets::kNoiseFloor());
+
+    nonspeech_segments_family_ = &prometheus::BuildCounter()
+                                      .Name("gigaam_nonspeech_segments_total")
+                                      .Help("Segments the pre-ASR classifier took for tones, music or noise")
+                                      .Register(*registry_);
+    for (const auto kind : {SegmentClass::Tone, SegmentClass::Music, SegmentClass::Noise}) {
+      const std::string name     = segment_class_name(kind);
+      auto&             counters = nonspeech_segments_[static_cast<size_t>(kind) - 1];
+      counters[0] = &nonspeech_segments_family_->Add({{"class", name}, {"action", "flagged"}});
+      counters[1] = &nonspeech_segments_family_->Add({{"class", name}, {"action", "dropped"}});
+    }
+
+    tenant_audio_seconds_family_ = &prometheus::BuildCounter()
+                                        .Name("gigaam_tenant_audio_seconds_total")
+                                        .Help("Audio seconds accepted per tenant")
+                                        .Register(*registry_);
+
+    tenant_queue_wait_family_ = &prometheus::BuildHistogram()
+                                     .Name("gigaam_tenant_queue_wait_seconds")
+                                     .Help("Executor queue wait per tenant")
+                                     .Register(*registry_);
+
+    tenant_rejections_family_ = &prometheus::BuildCounter()
+                                     .Name("gigaam_tenant_rejections_total")
+                                     .Help("Requests rejected per tenant by reason")
+                                     .Register(*registry_);
+
+    tenant_active_family_ = &prometheus::BuildGauge()
+                                 .Name("gigaam_tenant_active")
+                                 .Help("Requests and realtime connections in progress per tenant")
+                                 .Register(*registry_);
+
+    realtime_lag_family_ = &prometheus::BuildHistogram()
+                                .Name("gigaam_realtime_audio_lag_seconds")
+                                .Help("How far processed realtime audio trails the wall clock, per append")
+                                .Register(*registry_);
+    realtime_lag_        = &realtime_lag_family_->Add({}, buckets::kLag());
+
+    realtime_final_latency_family_ = &prometheus::BuildHistogram()
+                                          .Name("gigaam_realtime_final_latency_seconds")
+                                          .Help("Realtime speech end to final transcript latency")
+                                          .Register(*registry_);
+    realtime_final_latency_        = &realtime_final_latency_family_->Add({}, buckets::kLag());
+
+    realtime_worst_lag_family_ = &prometheus::BuildGauge()
+                                      .Name("gigaam_realtime_worst_lag_seconds")
+                                      .Help("Current lag of the most lagging realtime connections, by rank")
+                                      .Register(*registry_);
+    for (size_t i = 0; i < realtime_worst_lag_.size(); ++i) {
+      realtime_worst_lag_[i] = &realtime_worst_lag_family_->Add({{"rank", std::to_string(i + 1)}});
+    }
+
+    realtime_lag_alerts_family_    = &prometheus::BuildCounter()
+                                          .Name("gigaam_realtime_lag_alerts_total")
+                                          .Help("Realtime lag alert transitions sent to clients")
+                                          .Register(*registry_);
+    realtime_lag_alerts_lagging_   = &realtime_lag_alerts_family_->Add({{"state", "lagging"}});
+    realtime_lag_alerts_recovered_ = &realtime_lag_alerts_family_->Add({{"state", "recovered"}});
+
+    speculative_decodes_family_ = &prometheus::BuildCounter()
+                                       .Name("gigaam_speculative_decodes_total")
+                                       .Help("Speculative turn-end decodes by outcome")
+                                       .Register(*registry_);
+    speculative_hit_            = &speculative_decodes_family_->Add({{"outcome", "hit"}});
+    speculative_discarded_      = &speculative_decodes_family_->Add({{"outcome", "discarded"}});
+    speculative_busy_           = &speculative_decodes_family_->Add({{"outcome", "busy"}});
+
     // Pre-cache labeled instances to avoid map<string,string> allocs on hot paths
     realtime_websocket_mode_.requests_success =
         &requests_total_family_->Add({{"status", "success"}, {"mode", "realtime_websocket"}});
@@ -410,6 +526,7 @@ void ASRMetrics::initialize() {
     errors_internal_error_            = &errors_total_family_->Add({{"error_type", "internal_error"}});
     errors_bad_multipart_             = &errors_total_family_->Add({{"error_type", "bad_multipart"}});
     errors_invalid_param_             = &errors_total_family_->Add({{"error_type", "invalid_param"}});
+    errors_quota_exceeded_            = &errors_total_family_->Add({{"error_type", "quota_exceeded"}});
     errors_realtime_ws_handler_exception_ =
         &errors_total_family_->Add({{"error_type", "realtime_ws_handler_exception"}});
     errors_other_ = &errors_total_family_->Add({{"error_type", "other"}});
@@ -428,9 +545,13 @@ std::shared_ptr<prometheus::Registry> ASRMetrics::registry() {
 }
 
 void ASRMetrics::observe_ttfr(double sec, const std::string& mode) {
+  observe_ttfr(sec, canonical_mode(mode));
+}
+
+void ASRMetrics::observe_ttfr(double sec, MetricMode mode) {
   if (!initialized_)
     return;
-  switch (canonical_mode(mode)) {
+  switch (mode) {
     case MetricMode::RealtimeWebsocket:
       realtime_websocket_mode_.ttfr->Observe(sec);
       break;
@@ -462,13 +583,19 @@ void ASRMetrics::observe_segment(double audio_sec, double decode_sec) {
 void ASRMetrics::observe_request(double total_sec, double audio_sec, double decode_sec, int chunk_count,
                                  size_t bytes_count, double preprocess_sec, double io_sec,
                                  const std::string& mode, const std::string& status) {
+  observe_request(total_sec, audio_sec, decode_sec, chunk_count, bytes_count, preprocess_sec, io_sec,
+                  canonical_mode(mode), status);
+}
+
+void ASRMetrics::observe_request(double total_sec, double audio_sec, double decode_sec, int chunk_count,
+                                 size_t bytes_count, double preprocess_sec, double io_sec, MetricMode mode,
+                                 const std::string& status) {
   if (!initialized_)
     return;
 
-  const auto  mode_kind  = canonical_mode(mode);
   const bool  is_success = (status == "success");
-  const auto& mode_cache = [this, mode_kind]() -> const ModeMetricCache& {
-    switch (mode_kind) {
+  const auto& mode_cache = [this, mode]() -> const ModeMetricCache& {
+    switch (mode) {
       case MetricMode::RealtimeWebsocket:
         return realtime_websocket_mode_;
       case MetricMode::Http:
@@ -509,13 +636,14 @@ void ASRMetrics::observe_request(double total_sec, double audio_sec, double deco
   current_io_->Set(io_sec);
 }
 
-void ASRMetrics::observe_recognizer_wait(double sec, bool timed_out) {
+void ASRMetrics::observe_recognizer_wait(double sec, bool timed_out, SlotClass slot_class) {
   if (!initialized_) {
     return;
   }
-  recognizer_wait_->Observe(sec);
+  const auto idx = static_cast<size_t>(slot_class);
+  recognizer_wait_[idx]->Observe(sec);
   if (timed_out) {
-    recognizer_wait_timeouts_->Increment();
+    recognizer_wait_timeouts_[idx]->Increment();
   }
 }
 
@@ -537,6 +665,8 @@ void ASRMetrics::observe_error(const std::string& error_type) {
     errors_bad_multipart_->Increment();
   } else if (canonical == "invalid_param") {
     errors_invalid_param_->Increment();
+  } else if (canonical == "quota_exceeded") {
+    errors_quota_exceeded_->Increment();
   } else if (canonical == "realtime_ws_handler_exception") {
     errors_realtime_ws_handler_exception_->Increment();
   } else {
@@ -621,10 +751,127 @@ void ASRMetrics::record_silence() {
   silence_segments_total_->Increment();
 }
 
+void ASRMetrics::observe_vad_threshold(double threshold, double noise_floor_dbfs) {
+  if (!initialized_)
+    return;
+  vad_threshold_->Observe(threshold);
+  vad_noise_floor_->Observe(noise_floor_dbfs);
+}
+
+void ASRMetrics::observe_nonspeech_segment(SegmentClass kind, bool dropped) {
+  if (!initialized_ || kind == SegmentClass::Speech)
+    return;
+  nonspeech_segments_[static_cast<size_t>(kind) - 1][dropped ? 1 : 0]->Increment();
+}
+
 void ASRMetrics::set_speech_ratio(double ratio) {
   if (!initialized_)
     return;
   speech_ratio_->Set(ratio);
 }
 
+void ASRMetrics::set_load_state(int state) {
+  if (!initialized_)
+    return;
+  load_state_->Set(state);
+}
+
+void ASRMetrics::set_decoding_mode(int mode) {
+  if (!initialized_)
+    return;
+  decoding_mode_->Set(mode);
+}
+
+void ASRMetrics::observe_decode_method(DecodingMethod method) {
+  if (!initialized_)
+    return;
+  (method == DecodingMethod::ModifiedBeamSearch ? decodes_beam_ : decodes_greedy_)->Increment();
+}
+
+void ASRMetrics::register_tenants(const std::vector<std::string>& names) {
+  if (!initialized_)
+    return;
+  tenant_metrics_.clear();
+  tenant_metrics_.reserve(names.size());
+  for (const auto& name : names) {
+    TenantMetricCache cache;
+    cache.audio_seconds = &tenant_audio_seconds_family_->Add({{"tenant", name}});
+    cache.queue_wait    = &tenant_queue_wait_family_->Add({{"tenant", name}}, buckets::kQueueWait());
+    cache.rejections_concurrency =
+        &tenant_rejections_family_->Add({{"tenant", name}, {"reason", "concurrency"}});
+    cache.rejections_quota = &tenant_rejections_family_->Add({{"tenant", name}, {"reason", "quota"}});
+    cache.rejections_queue_full =
+        &tenant_rejections_family_->Add({{"tenant", name}, {"reason", "queue_full"}});
+    cache.active = &tenant_active_family_->Add({{"tenant", name}});
+    tenant_metrics_.push_back(cache);
+  }
+}
+
+void ASRMetrics::observe_tenant_audio(size_t tenant, double audio_sec) {
+  if (!initialized_ || tenant >= tenant_metrics_.size() || audio_sec <= 0.0)
+    return;
+  tenant_metrics_[tenant].audio_seconds->Increment(audio_sec);
+}
+
+void ASRMetrics::observe_tenant_queue_wait(size_t tenant, double sec) {
+  if (!initialized_ || tenant >= tenant_metrics_.size())
+    return;
+  tenant_metrics_[tenant].queue_wait->Observe(sec);
+}
+
+void ASRMetrics::observe_tenant_rejection(size_t tenant, std::string_view reason) {
+  if (!initialized_ || tenant >= tenant_metrics_.size())
+    return;
+  auto& cache = tenant_metrics_[tenant];
+  if (reason == "concurrency") {
+    cache.rejections_concurrency->Increment();
+  } else if (reason == "quota") {
+    cache.rejections_quota->Increment();
+  } else {
+    cache.rejections_queue_full->Increment();
+  }
+}
+
+void ASRMetrics::set_tenant_active(size_t tenant, size_t active) {
+  if (!initialized_ || tenant >= tenant_metrics_.size())
+    return;
+  tenant_metrics_[tenant].active->Set(static_cast<double>(active));
+}
+
+void ASRMetrics::observe_realtime_lag(double sec) {
+  if (!initialized_)
+    return;
+  realtime_lag_->Observe(sec);
+}
+
+void ASRMetrics::observe_realtime_final_latency(double sec) {
+  if (!initialized_)
+    return;
+  realtime_final_latency_->Observe(sec);
+}
+
+void ASRMetrics::set_realtime_worst_lag(size_t rank, double sec) {
+  if (!initialized_ || rank == 0 || rank > realtime_worst_lag_.size())
+    return;
+  realtime_worst_lag_[rank - 1]->Set(sec);
+}
+
+void ASRMetrics::observe_realtime_lag_alert(bool lagging) {
+  if (!initialized_)
+    return;
+  (lagging ? realtime_lag_alerts_lagging_ : realtime_lag_alerts_recovered_)->Increment();
+}
+
+void ASRMetrics::observe_speculative_decode(std::string_view outcome) {
+  if (!initialized_)
+    return;
+  if (outcome == "hit") {
+    speculative_hit_->Increment();
+  } else if (outcome == "discarded") {
+    speculative_discarded_->Increment();
+  } else if (outcome == "busy") {
+    speculative_busy_->Increment();
+  }
+}
+
 }  // namespace asr
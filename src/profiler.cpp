@@ -0,0 +1,390 @@
+#include "asr/profiler.h"
+
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#define ASR_HAS_SIGPROF 1
+#endif
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace asr {
+namespace {
+
+#ifdef ASR_HAS_SIGPROF
+// frames[0] is on_sigprof, frames[1] the kernel's signal trampoline.
+constexpr int kSkipFrames = 2;
+
+using StackSample = SamplingProfiler::StackSample;
+
+// State shared with the SIGPROF handler: lock-free atomics and a buffer that
+// is only freed once no handler can be running.
+struct SignalState {
+  std::atomic<StackSample*> buffer{nullptr};
+  std::atomic<size_t>       capacity{0};
+  std::atomic<size_t>       next{0};
+  std::atomic<uint64_t>     dropped{0};
+  std::atomic<int>          in_handler{0};
+};
+
+SignalState                    g_signal;
+std::unique_ptr<StackSample[]> g_samples;  // guarded by SamplingProfiler::mutex_
+bool                           g_handler_installed = false;
+
+void on_sigprof(int /*signo*/) {
+  const int saved_errno = errno;
+  g_signal.in_handler.fetch_add(1);
+  if (auto* buffer = g_signal.buffer.load(); buffer != nullptr) {
+    const size_t idx = g_signal.next.fetch_add(1, std::memory_order_relaxed);
+    if (idx < g_signal.capacity.load(std::memory_order_relaxed)) {
+      buffer[idx].depth = backtrace(buffer[idx].frames, static_cast<int>(SamplingProfiler::kMaxDepth));
+    } else {
+      g_signal.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  g_signal.in_handler.fetch_sub(1);
+  errno = saved_errno;
+}
+
+bool set_profile_timer(int frequency_hz) {
+  itimerval timer{};
+  if (frequency_hz > 0) {
+    timer.it_interval.tv_usec = 1000000 / frequency_hz;
+    timer.it_value            = timer.it_interval;
+  }
+  return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+std::string symbolize(const void* addr) {
+  Dl_info info{};
+  if (dladdr(addr, &info) != 0) {
+    if (info.dli_sname != nullptr) {
+      int         status    = 0;
+      char*       demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+      std::string name(status == 0 && demangled != nullptr ? demangled : info.dli_sname);
+      std::free(demangled);  // NOLINT(cppcoreguidelines-no-malloc)
+      return name;
+    }
+    if (info.dli_fname != nullptr) {
+      std::string_view module(info.dli_fname);
+      if (const auto slash = module.find_last_of('/'); slash != std::string_view::npos) {
+        module.remove_prefix(slash + 1);
+      }
+      return fmt::format("{}+0x{:x}", module,
+                         reinterpret_cast<uintptr_t>(addr) - reinterpret_cast<uintptr_t>(info.dli_fbase));
+    }
+  }
+  return fmt::format("0x{:x}", reinterpret_cast<uintptr_t>(addr));
+}
+#endif
+
+}  // namespace
+
+SamplingProfiler& SamplingProfiler::instance() {
+  static SamplingProfiler profiler;
+  return profiler;
+}
+
+bool SamplingProfiler::start(int frequency_hz, size_t max_samples) {
+#ifdef ASR_HAS_SIGPROF
+  const std::scoped_lock lock(mutex_);
+  if (running_.load()) {
+    return false;
+  }
+  frequency_hz = std::clamp(frequency_hz, 1, 1000);
+  max_samples  = std::max<size_t>(1, max_samples);
+
+  // The first backtrace() loads the unwinder, which is not safe inside a
+  // signal handler; take it here.
+  void* warmup[4];
+  (void)backtrace(warmup, 4);
+
+  // The handler stays installed after the run and does nothing while no
+  // buffer is published, so a SIGPROF still in flight after stop() is harmless.
+  if (!g_handler_installed) {
+    struct sigaction action {};
+    action.sa_handler = on_sigprof;
+    action.sa_flags   = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+      return false;
+    }
+    g_handler_installed = true;
+  }
+
+  g_samples = std::make_unique<StackSample[]>(max_samples);
+  g_signal.next.store(0);
+  g_signal.dropped.store(0);
+  g_signal.capacity.store(max_samples);
+  g_signal.buffer.store(g_samples.get());
+  if (!set_profile_timer(frequency_hz)) {
+    g_signal.buffer.store(nullptr);
+    g_samples.reset();
+    return false;
+  }
+  frequency_hz_ = frequency_hz;
+  started_at_   = std::chrono::steady_clock::now();
+  running_.store(true, std::memory_order_release);
+  return true;
+#else
+  (void)frequency_hz;
+  (void)max_samples;
+  return false;
+#endif
+}
+
+SamplingProfiler::Run SamplingProfiler::halt() {
+  Run run;
+#ifdef ASR_HAS_SIGPROF
+  const std::scoped_lock lock(mutex_);
+  if (!running_.load()) {
+    return run;
+  }
+  (void)set_profile_timer(0);
+  g_signal.buffer.store(nullptr);
+  while (g_signal.in_handler.load() != 0) {
+    std::this_thread::yield();
+  }
+  running_.store(false, std::memory_order_release);
+
+  run.count        = std::min(g_signal.next.load(), g_signal.capacity.load());
+  run.dropped      = g_signal.dropped.load();
+  run.frequency_hz = frequency_hz_;
+  run.duration_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at_).count();
+  run.samples      = std::move(g_samples);
+#endif
+  return run;
+}
+
+CpuProfile SamplingProfiler::aggregate(Run run) {
+  CpuProfile profile;
+  profile.samples      = run.count;
+  profile.dropped      = run.dropped;
+  profile.frequency_hz = run.frequency_hz;
+  profile.duration_sec = run.duration_sec;
+#ifdef ASR_HAS_SIGPROF
+  std::map<std::vector<void*>, uint64_t> by_frames;
+  for (size_t i = 0; i < run.count; ++i) {
+    const auto& sample = run.samples[i];
+    if (sample.depth <= kSkipFrames) {
+      continue;
+    }
+    // Root first; return addresses step back one byte to land inside the call.
+    std::vector<void*> frames;
+    frames.reserve(static_cast<size_t>(sample.depth - kSkipFrames));
+    for (int f = sample.depth - 1; f >= kSkipFrames; --f) {
+      auto* pc = static_cast<char*>(sample.frames[f]);
+      frames.push_back(f == kSkipFrames ? pc : pc - 1);
+    }
+    ++by_frames[std::move(frames)];
+  }
+  run.samples.reset();
+
+  std::unordered_map<void*, std::string>    names;
+  std::unordered_map<std::string, uint64_t> folded;
+  for (const auto& [frames, n] : by_frames) {
+    std::string stack;
+    for (void* pc : frames) {
+      auto it = names.find(pc);
+      if (it == names.end()) {
+        it = names.emplace(pc, symbolize(pc)).first;
+      }
+      if (!stack.empty()) {
+        stack.push_back(';');
+      }
+      stack += it->second;
+    }
+    folded[std::move(stack)] += n;
+  }
+
+  profile.stacks.assign(folded.begin(), folded.end());
+  std::sort(profile.stacks.begin(), profile.stacks.end(), [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+#endif
+  return profile;
+}
+
+std::string render_folded(const CpuProfile& profile) {
+  std::string out;
+  for (const auto& [stack, count] : profile.stacks) {
+    out += stack;
+    out.push_back(' ');
+    out += std::to_string(count);
+    out.push_back('\n');
+  }
+  return out;
+}
+
+#if defined(__linux__)
+namespace {
+
+struct ThreadRoleRegistry {
+  std::mutex                           mutex;
+  std::unordered_map<int, std::string> roles;
+};
+
+ThreadRoleRegistry& thread_roles() {
+  static ThreadRoleRegistry registry;
+  return registry;
+}
+
+bool is_decimal(std::string_view text) {
+  return !text.empty() && std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+std::string classify_thread(int tid, std::string_view name) {
+  {
+    auto&                  registry = thread_roles();
+    const std::scoped_lock lock(registry.mutex);
+    if (const auto it = registry.roles.find(tid); it != registry.roles.end()) {
+      return it->second;
+    }
+  }
+  // trantor names Drogon's I/O loop threads "DrogonIoLoop".
+  if (name.substr(0, 6) == "Drogon") {
+    return std::string(kThreadRoleHttpLoop);
+  }
+  return std::string(kThreadRoleOther);
+}
+
+}  // namespace
+#endif
+
+void set_current_thread_role(std::string_view role) {
+#if defined(__linux__)
+  const auto             tid      = static_cast<int>(::syscall(SYS_gettid));
+  auto&                  registry = thread_roles();
+  const std::scoped_lock lock(registry.mutex);
+  registry.roles[tid] = std::string(role);
+#else
+  (void)role;
+#endif
+}
+
+std::vector<ThreadCpuTime> thread_cpu_times() {
+  std::vector<ThreadCpuTime> threads;
+#if defined(__linux__)
+  DIR* dir = ::opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return threads;
+  }
+  const double ticks = static_cast<double>(std::max(1L, ::sysconf(_SC_CLK_TCK)));
+  while (const dirent* entry = ::readdir(dir)) {
+    const std::string_view tid_str(entry->d_name);
+    if (!is_decimal(tid_str)) {
+      continue;  // "." and ".."
+    }
+    std::ifstream stat_file("/proc/self/task/" + std::string(tid_str) + "/stat");
+    std::string   line;
+    if (!std::getline(stat_file, line)) {
+      continue;  // thread exited meanwhile
+    }
+    // "tid (comm) state ppid ... utime stime ..."; comm may contain spaces.
+    const auto open  = line.find('(');
+    const auto close = line.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open) {
+      continue;
+    }
+    std::istringstream rest(line.substr(close + 1));
+    std::string        field;
+    unsigned long long utime = 0;  // NOLINT(google-runtime-int)
+    unsigned long long stime = 0;  // NOLINT(google-runtime-int)
+    // Fields 3..13 precede utime (14) and stime (15).
+    for (int i = 3; i < 14; ++i) {
+      rest >> field;
+    }
+    if (!(rest >> utime >> stime)) {
+      continue;
+    }
+
+    ThreadCpuTime thread;
+    thread.tid        = std::atoi(entry->d_name);
+    thread.name       = line.substr(open + 1, close - open - 1);
+    thread.role       = classify_thread(thread.tid, thread.name);
+    thread.user_sec   = static_cast<double>(utime) / ticks;
+    thread.system_sec = static_cast<double>(stime) / ticks;
+    threads.push_back(std::move(thread));
+  }
+  ::closedir(dir);
+  std::sort(threads.begin(), threads.end(),
+            [](const ThreadCpuTime& a, const ThreadCpuTime& b) { return a.tid < b.tid; });
+#endif
+  return threads;
+}
+
+nlohmann::json thread_cpu_report(const std::vector<ThreadCpuTime>& before,
+                                 const std::vector<ThreadCpuTime>& after, double window_sec) {
+  std::unordered_map<int, const ThreadCpuTime*> baseline;
+  for (const auto& thread : before) {
+    baseline.emplace(thread.tid, &thread);
+  }
+  const bool windowed = !before.empty() && window_sec > 0.0;
+
+  struct RoleTotal {
+    size_t threads = 0;
+    double cpu_sec = 0.0;
+  };
+  std::map<std::string, RoleTotal> roles;
+  std::vector<nlohmann::json>      rows;
+  rows.reserve(after.size());
+  for (const auto& thread : after) {
+    double user   = thread.user_sec;
+    double system = thread.system_sec;
+    if (const auto it = baseline.find(thread.tid); it != baseline.end()) {
+      user   = std::max(0.0, user - it->second->user_sec);
+      system = std::max(0.0, system - it->second->system_sec);
+    }
+    auto& role = roles[thread.role];
+    ++role.threads;
+    role.cpu_sec += user + system;
+
+    nlohmann::json row;
+    row["tid"]        = thread.tid;
+    row["name"]       = thread.name;
+    row["role"]       = thread.role;
+    row["cpu_sec"]    = user + system;
+    row["user_sec"]   = user;
+    row["system_sec"] = system;
+    rows.push_back(std::move(row));
+  }
+  std::stable_sort(rows.begin(), rows.end(), [](const nlohmann::json& a, const nlohmann::json& b) {
+    return a["cpu_sec"].get<double>() > b["cpu_sec"].get<double>();
+  });
+
+  nlohmann::json report;
+  report["window_sec"] = windowed ? nlohmann::json(window_sec) : nlohmann::json(nullptr);
+  report["roles"]      = nlohmann::json::object();
+  for (const auto& [name, total] : roles) {
+    nlohmann::json role;
+    role["threads"] = total.threads;
+    role["cpu_sec"] = total.cpu_sec;
+    if (windowed) {
+      role["cores"] = total.cpu_sec / window_sec;
+    }
+    report["roles"][name] = std::move(role);
+  }
+  report["threads"] = std::move(rows);
+  return report;
+}
+
+}  // namespace asr
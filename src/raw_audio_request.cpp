@@ -0,0 +1,174 @@
+#include "asr/raw_audio_request.h"
+
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "asr/string_utils.h"
+
+namespace asr {
+namespace {
+
+constexpr int kMinRawSampleRate = 8000;
+constexpr int kMaxRawSampleRate = 48000;
+constexpr int kMaxRawChannels   = 8;
+
+RawAudioRequestError make_error(std::string message, std::string param, bool unsupported_media_type = false) {
+  RawAudioRequestError error;
+  error.message                = std::move(message);
+  error.param                  = std::move(param);
+  error.unsupported_media_type = unsupported_media_type;
+  return error;
+}
+
+// Splits "type/subtype; key=value; ..." into the lowercased media type and its parameters.
+std::string parse_media_type(std::string_view                              content_type,
+                             std::unordered_map<std::string, std::string>* params) {
+  std::string media_type;
+  size_t      start = 0;
+  for (bool first = true;; first = false) {
+    const auto pos  = content_type.find(';', start);
+    const auto len  = pos == std::string_view::npos ? pos : pos - start;
+    const auto part = trim_ascii(content_type.substr(start, len));
+    if (first) {
+      media_type = to_lower_ascii(part);
+    } else if (const auto eq = part.find('='); eq != std::string::npos) {
+      params->emplace(to_lower_ascii(trim_ascii(std::string_view(part).substr(0, eq))),
+                      trim_ascii(std::string_view(part).substr(eq + 1)));
+    }
+    if (pos == std::string_view::npos) {
+      return media_type;
+    }
+    start = pos + 1;
+  }
+}
+
+const std::string* find_param(const std::unordered_map<std::string, std::string>& params, const char* key) {
+  const auto it = params.find(key);
+  if (it == params.end() || trim_ascii(it->second).empty()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+std::optional<RawAudioRequestError> parse_int_param(const std::string* value, const char* name, int min_value,
+                                                    int max_value, int* out) {
+  if (value == nullptr) {
+    return std::nullopt;
+  }
+  const auto trimmed = trim_ascii(*value);
+  int        parsed  = 0;
+  try {
+    size_t consumed = 0;
+    parsed          = std::stoi(trimmed, &consumed);
+    if (consumed != trimmed.size()) {
+      return make_error(std::string("Invalid integer value for '") + name + "'", name);
+    }
+  } catch (const std::exception&) {
+    return make_error(std::string("Invalid integer value for '") + name + "'", name);
+  }
+  if (parsed < min_value || parsed > max_value) {
+    return make_error(std::string("'") + name + "' must be in range [" + std::to_string(min_value) + ", " +
+                          std::to_string(max_value) + "]",
+                      name);
+  }
+  *out = parsed;
+  return std::nullopt;
+}
+
+std::optional<RawAudioEncoding> parse_encoding(std::string_view value, bool* big_endian) {
+  const auto normalized = to_lower_ascii(trim_ascii(value));
+  if (normalized.empty() || normalized == "pcm16" || normalized == "pcm16le" || normalized == "s16le") {
+    *big_endian = false;
+    return RawAudioEncoding::Pcm16;
+  }
+  if (normalized == "pcm16be" || normalized == "s16be" || normalized == "l16") {
+    *big_endian = true;
+    return RawAudioEncoding::Pcm16;
+  }
+  if (normalized == "wav") {
+    return RawAudioEncoding::Wav;
+  }
+  if (normalized == "opus" || normalized == "ogg") {
+    return RawAudioEncoding::Opus;
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+std::optional<RawAudioRequestError> parse_raw_audio_request(
+    std::string_view content_type, const std::unordered_map<std::string, std::string>& params,
+    RawAudioRequest* out) {
+  if (out == nullptr) {
+    return make_error("Internal error: output request pointer is null", "");
+  }
+
+  RawAudioRequest req;
+
+  std::unordered_map<std::string, std::string> media_params;
+  const auto                                   media_type = parse_media_type(content_type, &media_params);
+
+  if (media_type == "audio/l16") {
+    // RFC 2586: network byte order, rate/channels carried in the media type.
+    req.pcm.big_endian = true;
+    if (auto error = parse_int_param(find_param(media_params, "rate"), "rate", kMinRawSampleRate,
+                                     kMaxRawSampleRate, &req.pcm.sample_rate)) {
+      return error;
+    }
+    if (auto error = parse_int_param(find_param(media_params, "channels"), "channels", 1, kMaxRawChannels,
+                                     &req.pcm.channels)) {
+      return error;
+    }
+    *out = req;
+    return std::nullopt;
+  }
+
+  if (media_type == "audio/wav" || media_type == "audio/wave" || media_type == "audio/x-wav") {
+    req.encoding = RawAudioEncoding::Wav;
+  } else if (media_type == "audio/ogg" || media_type == "audio/opus") {
+    req.encoding = RawAudioEncoding::Opus;
+  } else if (media_type.empty() || media_type == "application/octet-stream") {
+    if (const auto* encoding = find_param(params, "encoding")) {
+      const auto parsed = parse_encoding(*encoding, &req.pcm.big_endian);
+      if (!parsed.has_value()) {
+        return make_error("Invalid 'encoding'. Supported: pcm16, pcm16be, wav, opus", "encoding");
+      }
+      req.encoding = *parsed;
+    }
+  } else {
+    return make_error("Unsupported Content-Type '" + media_type +
+                          "'. Supported: application/octet-stream, audio/L16, audio/wav, audio/ogg",
+                      "content_type", true);
+  }
+
+  if (req.encoding == RawAudioEncoding::Pcm16) {
+    if (auto error = parse_int_param(find_param(params, "sample_rate"), "sample_rate", kMinRawSampleRate,
+                                     kMaxRawSampleRate, &req.pcm.sample_rate)) {
+      return error;
+    }
+    if (auto error = parse_int_param(find_param(params, "channels"), "channels", 1, kMaxRawChannels,
+                                     &req.pcm.channels)) {
+      return error;
+    }
+  }
+
+  *out = req;
+  return std::nullopt;
+}
+
+std::string_view raw_audio_file_name(RawAudioEncoding encoding) {
+  switch (encoding) {
+    case RawAudioEncoding::Wav:
+      return "body.wav";
+    case RawAudioEncoding::Opus:
+      return "body.opus";
+    case RawAudioEncoding::Pcm16:
+      break;
+  }
+  return "body.pcm";
+}
+
+}  // namespace asr
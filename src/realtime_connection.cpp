@@ -0,0 +1,673 @@
+#include "asr/realtime_connection.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "asr/alloc_profiler.h"
+#include "asr/config.h"
+#include "asr/logging.h"
+#include "asr/metrics.h"
+#include "asr/recognizer.h"
+#include "asr/span.h"
+
+namespace asr {
+
+namespace {
+
+constexpr int kHotPathWarnIntervalMs = 2000;
+
+OpusPacketMode realtime_opus_packet_mode(std::string_view format) {
+  if (format == "opus_raw") {
+    return OpusPacketMode::Raw;
+  }
+  if (format == "opus_rtp") {
+    return OpusPacketMode::Rtp;
+  }
+  return OpusPacketMode::Auto;
+}
+
+RealtimeClientEventType realtime_client_event_type(std::string_view type) {
+  if (type == "input_audio_buffer.append") {
+    return RealtimeClientEventType::AudioAppend;
+  }
+  if (type == "input_audio_buffer.commit") {
+    return RealtimeClientEventType::AudioCommit;
+  }
+  if (type == "input_audio_buffer.clear") {
+    return RealtimeClientEventType::AudioClear;
+  }
+  if (type == "transcription_session.update" || type == "session.update") {
+    return RealtimeClientEventType::SessionUpdate;
+  }
+  return RealtimeClientEventType::Unknown;
+}
+
+bool is_ping_event(std::string_view type) {
+  return type == "ping" || type == "noop";
+}
+
+bool is_json_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Scans a string starting after its opening quote; fails on escapes so that
+// the returned view is the decoded value.
+bool scan_plain_string(std::string_view text, size_t& pos, std::string_view& value) {
+  const size_t start = pos;
+  while (pos < text.size()) {
+    const char c = text[pos];
+    if (c == '"') {
+      value = text.substr(start, pos - start);
+      ++pos;
+      return true;
+    }
+    if (c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+      return false;
+    }
+    ++pos;
+  }
+  return false;
+}
+
+// Fast path for flat events: an object whose members are all escape-free
+// strings. Returns false whenever the full parser is needed, including on
+// malformed input, so errors are reported the same way on both paths.
+bool scan_flat_event(std::string_view text, std::string_view& type, std::string_view& event_id,
+                     std::string_view& audio, bool& has_type, bool& has_audio) {
+  size_t pos  = 0;
+  auto   skip = [&text, &pos]() {
+    while (pos < text.size() && is_json_space(text[pos])) {
+      ++pos;
+    }
+  };
+  skip();
+  if (pos >= text.size() || text[pos] != '{') {
+    return false;
+  }
+  ++pos;
+  skip();
+  if (pos < text.size() && text[pos] == '}') {
+    return false;  // let the full parser report the missing type
+  }
+  for (;;) {
+    std::string_view key;
+    std::string_view value;
+    if (pos >= text.size() || text[pos] != '"') {
+      return false;
+    }
+    ++pos;
+    if (!scan_plain_string(text, pos, key)) {
+      return false;
+    }
+    skip();
+    if (pos >= text.size() || text[pos] != ':') {
+      return false;
+    }
+    ++pos;
+    skip();
+    if (pos >= text.size() || text[pos] != '"') {
+      return false;
+    }
+    ++pos;
+    if (!scan_plain_string(text, pos, value)) {
+      return false;
+    }
+    if (key == "type") {
+      type     = value;
+      has_type = true;
+    } else if (key == "event_id") {
+      event_id = value;
+    } else if (key == "audio") {
+      audio     = value;
+      has_audio = true;
+    }
+    skip();
+    if (pos < text.size() && text[pos] == ',') {
+      ++pos;
+      skip();
+      continue;
+    }
+    if (pos < text.size() && text[pos] == '}') {
+      ++pos;
+      skip();
+      return pos == text.size();
+    }
+    return false;
+  }
+}
+
+int64_t sample_position_ms(const RealtimeConnectionContext& ctx, int64_t sample_position) {
+  if (!ctx.runtime_config || ctx.runtime_config->sample_rate <= 0 || sample_position <= 0) {
+    return 0;
+  }
+  const auto rate = static_cast<int64_t>(ctx.runtime_config->sample_rate);
+  return static_cast<int64_t>((sample_position * 1000LL) / rate);
+}
+
+void prepare_runtime_config(Config& runtime, const Config& base) {
+  runtime                         = base;
+  runtime.max_audio_sec           = 0.0F;
+  runtime.live_flush_interval_sec = 5.0F;
+}
+
+void rebuild_pipeline(RealtimeConnectionContext& ctx) {
+  const auto& realtime_cfg = ctx.realtime.config();
+
+  prepare_runtime_config(*ctx.runtime_config, ctx.base_config);
+  if (realtime_cfg.turn_detection.has_value()) {
+    const auto& turn                    = realtime_cfg.turn_detection.value();
+    ctx.runtime_config->vad_threshold   = turn.threshold;
+    ctx.runtime_config->vad_min_silence = static_cast<float>(turn.silence_duration_ms) / 1000.0F;
+  }
+
+  if (realtime_cfg.input_sample_rate != ctx.runtime_config->sample_rate) {
+    ctx.resampler =
+        std::make_unique<StreamResampler>(realtime_cfg.input_sample_rate, ctx.runtime_config->sample_rate);
+  } else {
+    ctx.resampler.reset();
+  }
+
+  if (is_realtime_opus_format(realtime_cfg.input_audio_format)) {
+    ctx.opus_decoder =
+        std::make_unique<RealtimeOpusDecoder>(realtime_cfg.input_sample_rate, 8, true,
+                                              realtime_opus_packet_mode(realtime_cfg.input_audio_format));
+  } else {
+    ctx.opus_decoder.reset();
+  }
+
+  ctx.decoded_audio_bytes.clear();
+  ctx.decoded_audio_samples.clear();
+  ctx.decoded_audio_bytes.reserve(static_cast<size_t>(64U) * static_cast<size_t>(1024U));
+  ctx.decoded_audio_samples.reserve(static_cast<size_t>(ctx.runtime_config->sample_rate));
+
+  const auto vad_cfg = make_realtime_vad_config(*ctx.runtime_config, realtime_cfg);
+  ctx.session       = std::make_shared<RealtimeASRSession>(ctx.recognizer, vad_cfg, *ctx.runtime_config);
+  ctx.speech_active = false;
+  ctx.realtime.clear_current_item();
+  ctx.lag.set_segment_origin(static_cast<int64_t>(ctx.input_samples));
+}
+
+void charge_tenant_audio(RealtimeConnectionContext& ctx, double audio_sec) {
+  if (ctx.tenants != nullptr) {
+    ctx.tenants->charge_audio(ctx.tenant, audio_sec);
+  }
+  ASRMetrics::instance().observe_tenant_audio(ctx.tenant, audio_sec);
+}
+
+size_t emit_transcription_events(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                                 span<const ASRSessionMessage> out_messages) {
+  size_t finals = 0;
+  for (const auto& out : out_messages) {
+    if (out.type != ASRSessionMessage::Final) {
+      continue;
+    }
+    if (out.text.empty()) {
+      continue;
+    }
+
+    const auto commit = ctx.realtime.commit_current_item();
+    ctx.realtime.event_buffer_committed(commit, ctx.event_buffer);
+    sink.send_text(ctx.event_buffer);
+    ctx.realtime.event_transcription_completed(commit.item_id, out.text, ctx.event_buffer);
+    sink.send_text(ctx.event_buffer);
+    ASRMetrics::instance().observe_realtime_final_latency(
+        ctx.lag.on_final(static_cast<int64_t>(ctx.input_samples), std::chrono::steady_clock::now()));
+    ++ctx.committed_events;
+    ++ctx.completed_events;
+    ++finals;
+    spdlog::debug(
+        "RealtimeWS[{}]: transcription.completed item_id={} previous_item_id={} text_len={} "
+        "append_events={} input_audio_sec={:.2f}",
+        ctx.connection_id, commit.item_id,
+        commit.previous_item_id.empty() ? "<none>" : commit.previous_item_id, out.text.size(),
+        ctx.append_events,
+        (ctx.runtime_config && ctx.runtime_config->sample_rate > 0)
+            ? static_cast<double>(ctx.input_samples) / static_cast<double>(ctx.runtime_config->sample_rate)
+            : 0.0);
+  }
+  return finals;
+}
+
+void emit_speech_transition_events(RealtimeConnectionContext& ctx, RealtimeEventSink& sink) {
+  if (!ctx.realtime.config().turn_detection.has_value()) {
+    return;
+  }
+
+  while (ctx.session->has_speech_transition()) {
+    const auto& transition = ctx.session->front_speech_transition();
+    const auto  pos_ms     = sample_position_ms(ctx, transition.sample);
+    const auto  item_id    = ctx.realtime.ensure_current_item_id();
+    if (transition.kind == SpeechTransition::Started) {
+      ctx.realtime.event_speech_started(pos_ms, ctx.event_buffer);
+      sink.send_text(ctx.event_buffer);
+      ctx.speech_active = true;
+      ++ctx.speech_started_events;
+      spdlog::debug("RealtimeWS[{}]: speech_started item_id={} audio_start_ms={} append_events={}",
+                    ctx.connection_id, item_id, pos_ms, ctx.append_events);
+    } else {
+      ctx.realtime.event_speech_stopped(pos_ms, ctx.event_buffer);
+      sink.send_text(ctx.event_buffer);
+      ctx.speech_active = false;
+      ctx.lag.on_speech_end(transition.sample);
+      ++ctx.speech_stopped_events;
+      spdlog::debug("RealtimeWS[{}]: speech_stopped item_id={} audio_end_ms={} append_events={}",
+                    ctx.connection_id, item_id, pos_ms, ctx.append_events);
+    }
+    ctx.session->pop_speech_transition();
+  }
+}
+
+void handle_session_update(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                           const nlohmann::json& event, const std::string& client_event_id) {
+  if (!event.contains("session")) {
+    send_realtime_error(ctx, sink, "missing_session", "Event must include 'session' object", "session",
+                        client_event_id);
+    return;
+  }
+
+  std::string error_message;
+  if (!ctx.realtime.apply_session_update(event["session"], &error_message)) {
+    send_realtime_error(ctx, sink, "invalid_session_update", error_message, "session", client_event_id);
+    return;
+  }
+
+  rebuild_pipeline(ctx);
+  sink.send_text(ctx.realtime.event_session_updated());
+  const auto& realtime_cfg = ctx.realtime.config();
+  if (realtime_cfg.turn_detection.has_value()) {
+    const auto& turn = realtime_cfg.turn_detection.value();
+    spdlog::info(
+        "RealtimeWS[{}]: session.update applied event_id='{}' input_format={} input_rate={} "
+        "turn=server_vad threshold={:.3f} prefix_padding_ms={} silence_ms={}",
+        ctx.connection_id, client_event_id, realtime_cfg.input_audio_format, realtime_cfg.input_sample_rate,
+        turn.threshold, turn.prefix_padding_ms, turn.silence_duration_ms);
+  } else {
+    spdlog::info(
+        "RealtimeWS[{}]: session.update applied event_id='{}' input_format={} input_rate={} turn=null",
+        ctx.connection_id, client_event_id, realtime_cfg.input_audio_format, realtime_cfg.input_sample_rate);
+  }
+}
+
+span<const float> decode_append_samples(RealtimeConnectionContext& ctx, span<const uint8_t> audio_bytes) {
+  const AllocTagScope alloc_scope(AllocTag::Decode);
+  const auto& format = ctx.realtime.config().input_audio_format;
+  if (format.empty() || format == "pcm16") {
+    pcm16_to_float32_into(audio_bytes, ctx.decoded_audio_samples);
+    return ctx.decoded_audio_samples;
+  }
+
+  if (is_realtime_opus_format(format)) {
+    if (!ctx.opus_decoder) {
+      ctx.opus_decoder = std::make_unique<RealtimeOpusDecoder>(ctx.realtime.config().input_sample_rate, 8,
+                                                               true, realtime_opus_packet_mode(format));
+    }
+    return ctx.opus_decoder->decode_packet(audio_bytes);
+  }
+
+  throw AudioError("Unsupported realtime audio format '" + format + "'");
+}
+
+// Lag of the audio processed so far against the stream clock; crossing the
+// alert threshold either way notifies the client with a session.lag event.
+void update_realtime_lag(RealtimeConnectionContext& ctx, RealtimeEventSink& sink) {
+  const double lag_sec =
+      ctx.lag.on_processed(static_cast<int64_t>(ctx.input_samples), std::chrono::steady_clock::now());
+  ASRMetrics::instance().observe_realtime_lag(lag_sec);
+  RealtimeLagBoard::instance().publish(ctx.lag_slot, lag_sec);
+  ctx.max_lag_sec = ctx.lag.max_lag_sec();
+
+  const auto alert = ctx.lag.check_alert(ctx.base_config.realtime_lag_alert_sec);
+  if (alert == LagAlert::None) {
+    return;
+  }
+  const bool lagging = alert == LagAlert::Lagging;
+  ctx.realtime.event_session_lag(lagging, static_cast<int64_t>(lag_sec * 1000.0), ctx.event_buffer);
+  sink.send_text(ctx.event_buffer);
+  ASRMetrics::instance().observe_realtime_lag_alert(lagging);
+  if (lagging) {
+    spdlog::warn("RealtimeWS[{}]: lagging {:.2f}s behind real time", ctx.connection_id, lag_sec);
+  } else {
+    spdlog::info("RealtimeWS[{}]: caught up, lag {:.2f}s (max {:.2f}s)", ctx.connection_id, lag_sec,
+                 ctx.lag.max_lag_sec());
+  }
+}
+
+void process_audio_append_samples(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                                  span<const float> samples,
+                                  std::chrono::steady_clock::time_point received_at,
+                                  const std::string& client_event_id, const char* payload_label,
+                                  size_t payload_size) {
+  if (ctx.tenants != nullptr && !ctx.tenants->has_audio_quota(ctx.tenant)) {
+    // Drop audio until the bucket refills; report once per exhausted episode.
+    const bool report   = !ctx.quota_exhausted;
+    ctx.quota_exhausted = true;
+    if (report) {
+      ASRMetrics::instance().observe_tenant_rejection(ctx.tenant, "quota");
+      ASRMetrics::instance().observe_error("quota_exceeded");
+      send_realtime_error(ctx, sink, "quota_exceeded",
+                          "Tenant audio quota exceeded, audio dropped until it refills", "audio",
+                          client_event_id);
+    }
+    return;
+  }
+
+  ++ctx.append_events;
+  ctx.raw_input_samples += samples.size();
+  ctx.quota_exhausted = false;
+  ctx.lag.on_received(static_cast<int64_t>(ctx.input_samples), received_at);
+  if (ctx.realtime.config().input_sample_rate > 0) {
+    charge_tenant_audio(ctx, static_cast<double>(samples.size()) /
+                                 static_cast<double>(ctx.realtime.config().input_sample_rate));
+  }
+
+  span<const ASRSessionMessage> out_messages;
+  size_t                        asr_samples_in = 0;
+  if (ctx.resampler) {
+    auto resampled = ctx.resampler->process(samples);
+    ctx.input_samples += resampled.size();
+    asr_samples_in = resampled.size();
+    out_messages   = ctx.session->on_audio(resampled);
+  } else {
+    ctx.input_samples += samples.size();
+    asr_samples_in = samples.size();
+    out_messages   = ctx.session->on_audio(samples);
+  }
+
+  size_t final_count = 0;
+  for (const auto& out : out_messages) {
+    if (out.type == ASRSessionMessage::Final) {
+      ++final_count;
+    }
+  }
+  // An append without a final is what the legacy protocol answered with an interim.
+  const size_t interim_count = final_count == 0 ? 1 : 0;
+  ctx.interim_events += interim_count;
+
+  emit_speech_transition_events(ctx, sink);
+  const size_t emitted_finals = emit_transcription_events(ctx, sink, out_messages);
+  update_realtime_lag(ctx, sink);
+
+  if (ctx.append_events == 1 || ctx.append_events % 250 == 0 || emitted_finals > 0) {
+    const double input_audio_sec =
+        (ctx.runtime_config && ctx.runtime_config->sample_rate > 0)
+            ? static_cast<double>(ctx.input_samples) / static_cast<double>(ctx.runtime_config->sample_rate)
+            : 0.0;
+    uint64_t opus_lost = 0;
+    uint64_t opus_plc  = 0;
+    uint64_t opus_fec  = 0;
+    uint64_t opus_dup  = 0;
+    uint64_t opus_ooo  = 0;
+    if (ctx.opus_decoder && is_realtime_opus_format(ctx.realtime.config().input_audio_format)) {
+      const auto& stats = ctx.opus_decoder->stats();
+      opus_lost         = stats.lost_packets;
+      opus_plc          = stats.plc_packets;
+      opus_fec          = stats.fec_packets;
+      opus_dup          = stats.duplicate_packets;
+      opus_ooo          = stats.out_of_order_packets;
+    }
+
+    spdlog::debug(
+        "RealtimeWS[{}]: append#{} event_id='{}' {}={} decoded_samples={} asr_samples={} "
+        "interim={} final={} speech_active={} input_audio_sec={:.2f} "
+        "opus_lost={} opus_plc={} opus_fec={} opus_dup={} opus_ooo={}",
+        ctx.connection_id, ctx.append_events, client_event_id, payload_label, payload_size, samples.size(),
+        asr_samples_in, interim_count, final_count, ctx.speech_active ? "true" : "false", input_audio_sec,
+        opus_lost, opus_plc, opus_fec, opus_dup, opus_ooo);
+  }
+}
+
+std::chrono::steady_clock::time_point event_received_at(const RealtimeInboundEvent& event) {
+  return event.received_at == std::chrono::steady_clock::time_point{} ? std::chrono::steady_clock::now()
+                                                                      : event.received_at;
+}
+
+void handle_audio_append(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                         const RealtimeInboundEvent& event) {
+  if (!event.has_audio) {
+    send_realtime_error(ctx, sink, "invalid_audio", "Event must include base64 string field 'audio'", "audio",
+                        event.client_event_id);
+    return;
+  }
+
+  base64_decode_into(event.audio, ctx.decoded_audio_bytes);
+  auto samples = decode_append_samples(ctx, ctx.decoded_audio_bytes);
+  process_audio_append_samples(ctx, sink, samples, event_received_at(event), event.client_event_id, "b64_len",
+                               event.audio.size());
+}
+
+void handle_audio_append_binary(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                                const RealtimeInboundEvent& event) {
+  static const std::string kBinaryEventId = "<binary>";
+  const auto&              payload        = event.payload;
+  auto bytes   = span<const uint8_t>(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+  auto samples = decode_append_samples(ctx, bytes);
+  process_audio_append_samples(ctx, sink, samples, event_received_at(event), kBinaryEventId, "bin_len",
+                               payload.size());
+}
+
+void handle_audio_commit(RealtimeConnectionContext& ctx, RealtimeEventSink& sink) {
+  spdlog::debug("RealtimeWS[{}]: input_audio_buffer.commit requested append_events={} speech_active={}",
+                ctx.connection_id, ctx.append_events, ctx.speech_active ? "true" : "false");
+
+  size_t finals = 0;
+  if (ctx.resampler) {
+    auto tail = ctx.resampler->flush();
+    if (!tail.empty()) {
+      ctx.input_samples += tail.size();
+      const auto out_messages = ctx.session->on_audio(tail);
+      emit_speech_transition_events(ctx, sink);
+      finals += emit_transcription_events(ctx, sink, out_messages);
+    }
+  }
+
+  const auto recognize_messages = ctx.session->on_recognize();
+  emit_speech_transition_events(ctx, sink);
+  finals += emit_transcription_events(ctx, sink, recognize_messages);
+  ctx.lag.set_segment_origin(static_cast<int64_t>(ctx.input_samples));
+  if (finals == 0) {
+    const auto commit = ctx.realtime.commit_current_item();
+    ctx.realtime.event_buffer_committed(commit, ctx.event_buffer);
+    sink.send_text(ctx.event_buffer);
+    ++ctx.committed_events;
+    spdlog::debug("RealtimeWS[{}]: commit without final item_id={} previous_item_id={}", ctx.connection_id,
+                  commit.item_id, commit.previous_item_id.empty() ? "<none>" : commit.previous_item_id);
+  }
+  ctx.speech_active = false;
+  spdlog::debug("RealtimeWS[{}]: commit completed finals={} committed_total={} completed_total={}",
+                ctx.connection_id, finals, ctx.committed_events, ctx.completed_events);
+}
+
+void handle_audio_clear(RealtimeConnectionContext& ctx, RealtimeEventSink& sink) {
+  ctx.session->on_reset();
+  ctx.lag.set_segment_origin(static_cast<int64_t>(ctx.input_samples));
+  if (ctx.resampler) {
+    ctx.resampler->reset();
+  }
+  if (ctx.opus_decoder) {
+    ctx.opus_decoder->reset();
+  }
+  ctx.speech_active = false;
+  ctx.realtime.clear_current_item();
+  sink.send_text(ctx.realtime.event_buffer_cleared());
+  spdlog::debug("RealtimeWS[{}]: input_audio_buffer.clear applied", ctx.connection_id);
+}
+
+// Frames the transport could not parse are reported from the actor, in order
+// with the events before them, so it stays the only writer of the session.
+void handle_invalid_event(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                          const RealtimeInboundEvent& event) {
+  ++ctx.invalid_events;
+  switch (event.parse_status) {
+    case RealtimeParseStatus::InvalidJson:
+      send_realtime_error(ctx, sink, "invalid_json", "Invalid JSON payload");
+      return;
+    case RealtimeParseStatus::NotObject:
+      send_realtime_error(ctx, sink, "invalid_event", "JSON event must be an object");
+      return;
+    case RealtimeParseStatus::MissingType:
+      send_realtime_error(ctx, sink, "invalid_event_type", "Event 'type' must be a string", "type",
+                          event.client_event_id);
+      return;
+    case RealtimeParseStatus::Ok:
+    case RealtimeParseStatus::Ping:
+      return;
+  }
+}
+
+void dispatch_realtime_event(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                             const RealtimeInboundEvent& event) {
+  switch (event.type) {
+    case RealtimeClientEventType::SessionUpdate:
+      handle_session_update(ctx, sink, event.json, event.client_event_id);
+      return;
+    case RealtimeClientEventType::AudioAppend:
+      handle_audio_append(ctx, sink, event);
+      return;
+    case RealtimeClientEventType::BinaryAudio:
+      handle_audio_append_binary(ctx, sink, event);
+      return;
+    case RealtimeClientEventType::AudioCommit:
+      handle_audio_commit(ctx, sink);
+      return;
+    case RealtimeClientEventType::AudioClear:
+      handle_audio_clear(ctx, sink);
+      return;
+    case RealtimeClientEventType::Invalid:
+      handle_invalid_event(ctx, sink, event);
+      return;
+    case RealtimeClientEventType::Overflow:
+      send_realtime_error(ctx, sink, "server_busy", "Connection queue is full", "", event.client_event_id);
+      return;
+    case RealtimeClientEventType::Unknown:
+      break;
+  }
+  ++ctx.invalid_events;
+  ASR_LOG_WARN_EVERY(kHotPathWarnIntervalMs, "RealtimeWS[{}]: unknown event type='{}' event_id='{}'",
+                     ctx.connection_id, event.event_type, event.client_event_id);
+  send_realtime_error(ctx, sink, "unknown_event_type", "Unsupported event type", "type",
+                      event.client_event_id);
+}
+
+}  // namespace
+
+RealtimeParseStatus parse_realtime_client_event(std::string&& message, RealtimeInboundEvent& out) {
+  out.payload   = std::move(message);
+  out.json      = nullptr;
+  out.audio     = {};
+  out.has_audio = false;
+
+  std::string_view type;
+  std::string_view event_id;
+  std::string_view audio;
+  bool             has_type  = false;
+  bool             has_audio = false;
+  if (scan_flat_event(out.payload, type, event_id, audio, has_type, has_audio) && has_type &&
+      (is_ping_event(type) || realtime_client_event_type(type) != RealtimeClientEventType::SessionUpdate)) {
+    out.event_type.assign(type);
+    out.client_event_id.assign(event_id);
+    out.audio     = audio;
+    out.has_audio = has_audio;
+    out.type      = realtime_client_event_type(type);
+    return is_ping_event(type) ? RealtimeParseStatus::Ping : RealtimeParseStatus::Ok;
+  }
+
+  auto parsed = nlohmann::json::parse(out.payload, nullptr, false);
+  if (parsed.is_discarded()) {
+    return RealtimeParseStatus::InvalidJson;
+  }
+  if (!parsed.is_object()) {
+    return RealtimeParseStatus::NotObject;
+  }
+  out.json = std::move(parsed);
+
+  out.client_event_id.clear();
+  if (const auto it = out.json.find("event_id"); it != out.json.end() && it->is_string()) {
+    out.client_event_id.assign(it->get_ref<const std::string&>());
+  }
+  const auto type_it = out.json.find("type");
+  if (type_it == out.json.end() || !type_it->is_string()) {
+    return RealtimeParseStatus::MissingType;
+  }
+  out.event_type.assign(type_it->get_ref<const std::string&>());
+  out.type = realtime_client_event_type(out.event_type);
+  if (const auto it = out.json.find("audio"); it != out.json.end() && it->is_string()) {
+    out.audio     = it->get_ref<const std::string&>();
+    out.has_audio = true;
+  }
+  return is_ping_event(out.event_type) ? RealtimeParseStatus::Ping : RealtimeParseStatus::Ok;
+}
+
+void set_realtime_binary_event(std::string&& message, RealtimeInboundEvent& out) {
+  out.type      = RealtimeClientEventType::BinaryAudio;
+  out.payload   = std::move(message);
+  out.json      = nullptr;
+  out.audio     = {};
+  out.has_audio = false;
+  out.client_event_id.clear();
+}
+
+RealtimeConnectionContext::RealtimeConnectionContext(RecognizerBackend& backend, const Config& config,
+                                                     uint64_t id, size_t tenant_index,
+                                                     TenantRegistry* tenant_registry, size_t inbox_capacity)
+    : recognizer(backend),
+      base_config(config),
+      tenants(tenant_registry),
+      runtime_config(std::make_shared<Config>()),
+      inbox(inbox_capacity),
+      lag(config.sample_rate),
+      lag_slot(RealtimeLagBoard::instance().acquire()),
+      connected_at(std::chrono::steady_clock::now()),
+      last_event_at(connected_at),
+      connection_id(id),
+      tenant(tenant_index) {
+  prepare_runtime_config(*runtime_config, base_config);
+  realtime = RealtimeSession(connection_id, make_default_realtime_session_config(*runtime_config));
+  if (realtime.config().input_sample_rate != runtime_config->sample_rate) {
+    resampler =
+        std::make_unique<StreamResampler>(realtime.config().input_sample_rate, runtime_config->sample_rate);
+  }
+  const auto vad_cfg = make_realtime_vad_config(*runtime_config, realtime.config());
+  session = std::make_shared<RealtimeASRSession>(recognizer, vad_cfg, *runtime_config);
+}
+
+RealtimeConnectionContext::~RealtimeConnectionContext() {
+  RealtimeLagBoard::instance().release(lag_slot);
+}
+
+bool is_realtime_opus_format(std::string_view format) {
+  return format == "opus" || format == "opus_raw" || format == "opus_rtp";
+}
+
+void send_realtime_error(RealtimeConnectionContext& ctx, RealtimeEventSink& sink, const std::string& code,
+                         const std::string& message, const std::string& param,
+                         const std::string& client_event_id) {
+  ctx.last_error = code + ":" + message;
+  sink.send_text(ctx.realtime.event_error(code, message, param, client_event_id));
+}
+
+void run_realtime_event(RealtimeConnectionContext& ctx, RealtimeEventSink& sink,
+                        const RealtimeInboundEvent& event) {
+  const AllocTagScope alloc_scope(AllocTag::Ws);
+  try {
+    dispatch_realtime_event(ctx, sink, event);
+  } catch (const RecognizerBusyError& e) {
+    ASRMetrics::instance().observe_error("capacity_exceeded");
+    send_realtime_error(ctx, sink, "server_busy", e.what());
+  } catch (const AudioError& e) {
+    ++ctx.decode_errors;
+    send_realtime_error(ctx, sink, "audio_decode_error", e.what(), "audio", event.client_event_id);
+  } catch (const std::exception& e) {
+    spdlog::error("RealtimeWS[{}]: exception: {}", ctx.connection_id, e.what());
+    ASRMetrics::instance().observe_error("realtime_ws_handler_exception");
+    send_realtime_error(ctx, sink, "internal_error", e.what(), "", event.client_event_id);
+  } catch (...) {
+    spdlog::error("RealtimeWS[{}]: exception: unknown", ctx.connection_id);
+    ASRMetrics::instance().observe_error("realtime_ws_handler_exception");
+    send_realtime_error(ctx, sink, "internal_error", "Unknown internal error", "", event.client_event_id);
+  }
+}
+
+}  // namespace asr
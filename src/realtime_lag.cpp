@@ -0,0 +1,134 @@
+#include "asr/realtime_lag.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace asr {
+
+RealtimeLagTracker::RealtimeLagTracker(int sample_rate) : sample_rate_(std::max(1, sample_rate)) {}
+
+RealtimeLagTracker::Clock::time_point RealtimeLagTracker::due_at(int64_t sample) const {
+  const std::chrono::duration<double> offset(static_cast<double>(sample) / sample_rate_);
+  return origin_ + std::chrono::duration_cast<Clock::duration>(offset);
+}
+
+double RealtimeLagTracker::behind_sec(int64_t sample, Clock::time_point now) const {
+  if (!anchored_) {
+    return 0.0;
+  }
+  return std::max(0.0, std::chrono::duration<double>(now - due_at(sample)).count());
+}
+
+void RealtimeLagTracker::on_received(int64_t start_sample, Clock::time_point received_at) {
+  if (!anchored_ || received_at > due_at(start_sample)) {
+    const std::chrono::duration<double> offset(static_cast<double>(start_sample) / sample_rate_);
+    origin_   = received_at - std::chrono::duration_cast<Clock::duration>(offset);
+    anchored_ = true;
+  }
+}
+
+double RealtimeLagTracker::on_processed(int64_t end_sample, Clock::time_point now) {
+  lag_sec_     = behind_sec(end_sample, now);
+  max_lag_sec_ = std::max(max_lag_sec_, lag_sec_);
+  return lag_sec_;
+}
+
+void RealtimeLagTracker::set_segment_origin(int64_t stream_sample) {
+  segment_origin_ = stream_sample;
+  has_speech_end_ = false;
+}
+
+void RealtimeLagTracker::on_speech_end(int64_t vad_sample) {
+  speech_end_     = segment_origin_ + vad_sample;
+  has_speech_end_ = true;
+}
+
+double RealtimeLagTracker::on_final(int64_t processed_end_sample, Clock::time_point now) {
+  const int64_t reference = has_speech_end_ ? speech_end_ : processed_end_sample;
+  has_speech_end_         = false;
+  return behind_sec(reference, now);
+}
+
+LagAlert RealtimeLagTracker::check_alert(double threshold_sec) {
+  if (threshold_sec <= 0.0) {
+    return LagAlert::None;
+  }
+  if (!lagging_ && lag_sec_ >= threshold_sec) {
+    lagging_ = true;
+    return LagAlert::Lagging;
+  }
+  if (lagging_ && lag_sec_ < threshold_sec * kRecoverRatio) {
+    lagging_ = false;
+    return LagAlert::Recovered;
+  }
+  return LagAlert::None;
+}
+
+RealtimeLagBoard& RealtimeLagBoard::instance() {
+  static RealtimeLagBoard board;
+  return board;
+}
+
+std::atomic<double>* RealtimeLagBoard::lag(size_t slot) const {
+  if (slot / kChunkSlots >= kMaxChunks) {
+    return nullptr;
+  }
+  Chunk* chunk = chunks_[slot / kChunkSlots].load(std::memory_order_acquire);
+  return chunk != nullptr ? &(*chunk)[slot % kChunkSlots] : nullptr;
+}
+
+size_t RealtimeLagBoard::acquire() {
+  const std::scoped_lock lock(mutex_);
+  size_t                 slot = 0;
+  if (!free_.empty()) {
+    slot = free_.back();
+    free_.pop_back();
+  } else {
+    slot = used_.size();
+    if (slot % kChunkSlots == 0 && slot / kChunkSlots < kMaxChunks) {
+      owned_.push_back(std::make_unique<Chunk>());  // value-initialized: all zero
+      chunks_[slot / kChunkSlots].store(owned_.back().get(), std::memory_order_release);
+    }
+    used_.push_back(false);
+  }
+  used_[slot] = true;
+  // Past kMaxChunks the slot is tracked but has no storage: publish() drops it.
+  if (auto* v = lag(slot)) {
+    v->store(0.0, std::memory_order_relaxed);
+  }
+  return slot;
+}
+
+void RealtimeLagBoard::release(size_t slot) {
+  const std::scoped_lock lock(mutex_);
+  if (slot < used_.size() && used_[slot]) {
+    used_[slot] = false;
+    free_.push_back(slot);
+  }
+}
+
+void RealtimeLagBoard::publish(size_t slot, double lag_sec) {
+  if (auto* v = lag(slot)) {
+    v->store(lag_sec, std::memory_order_relaxed);
+  }
+}
+
+std::vector<double> RealtimeLagBoard::worst(size_t count) const {
+  std::vector<double> out;
+  {
+    const std::scoped_lock lock(mutex_);
+    out.reserve(used_.size());
+    for (size_t i = 0; i < used_.size(); ++i) {
+      const auto* v = lag(i);
+      if (used_[i] && v != nullptr) {
+        out.push_back(v->load(std::memory_order_relaxed));
+      }
+    }
+  }
+  const size_t n = std::min(count, out.size());
+  std::partial_sort(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(n), out.end(), std::greater<>());
+  out.resize(n);
+  return out;
+}
+
+}  // namespace asr
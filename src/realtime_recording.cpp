@@ -0,0 +1,289 @@
+#include "asr/realtime_recording.h"
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "asr/config.h"
+#include "asr/realtime_connection.h"
+#include "asr/tenant.h"
+
+namespace asr {
+namespace {
+
+constexpr std::string_view kMagic            = "ASRRTREC";
+constexpr size_t           kHeaderBytes      = 8 + 4 + 8 + 8;
+constexpr size_t           kRecordHeaderSize = 8 + 1 + 4;
+constexpr uint32_t         kMaxRecordBytes   = uint32_t{1} << 30;
+
+template <typename T>
+void put_le(char* out, T value) {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    out[i] = static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFFU);
+  }
+}
+
+template <typename T>
+T get_le(const char* in) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+  }
+  return static_cast<T>(value);
+}
+
+double to_ms(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+nlohmann::json distribution_json(std::vector<double> values) {
+  nlohmann::json j;
+  j["count"] = values.size();
+  if (values.empty()) {
+    return j;
+  }
+  std::sort(values.begin(), values.end());
+  const auto rank = [&values](double q) {
+    const auto idx = static_cast<size_t>(q * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(idx, values.size() - 1)];
+  };
+  j["p50"] = rank(0.50);
+  j["p95"] = rank(0.95);
+  j["p99"] = rank(0.99);
+  j["max"] = values.back();
+  return j;
+}
+
+// Server events are hand-serialized with "type" first; the rest (errors)
+// come from nlohmann::json with sorted keys.
+std::string event_type_of(std::string_view payload) {
+  constexpr std::string_view kPrefix = R"({"type":")";
+  if (payload.substr(0, kPrefix.size()) == kPrefix) {
+    const auto end = payload.find('"', kPrefix.size());
+    if (end != std::string_view::npos) {
+      return std::string(payload.substr(kPrefix.size(), end - kPrefix.size()));
+    }
+  }
+  const auto parsed = nlohmann::json::parse(payload, nullptr, false);
+  if (parsed.is_object() && parsed.contains("type") && parsed["type"].is_string()) {
+    return parsed["type"].get<std::string>();
+  }
+  return {};
+}
+
+class ReplaySink final : public RealtimeEventSink {
+ public:
+  explicit ReplaySink(RealtimeReplayReport& report) : report_(report) {}
+
+  void send_text(std::string_view payload) override {
+    const auto type = event_type_of(payload);
+    if (type == "conversation.item.input_audio_transcription.completed") {
+      ++report_.transcripts;
+      report_.final_ms.push_back(to_ms(std::chrono::steady_clock::now() - scheduled_at));
+    } else if (type == "error") {
+      ++report_.errors;
+    }
+  }
+
+  std::chrono::steady_clock::time_point scheduled_at;
+
+ private:
+  RealtimeReplayReport& report_;
+};
+
+}  // namespace
+
+std::unique_ptr<RealtimeRecorder> RealtimeRecorder::open(const std::string& dir, uint64_t connection_id,
+                                                         std::chrono::steady_clock::time_point connected_at,
+                                                         size_t max_bytes) {
+  const auto since_connect = std::chrono::steady_clock::now() - connected_at;
+  const auto started_at    = std::chrono::system_clock::now() -
+                          std::chrono::duration_cast<std::chrono::system_clock::duration>(since_connect);
+  const int64_t started_unix_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(started_at.time_since_epoch()).count();
+
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  const auto path =
+      (std::filesystem::path(dir) / fmt::format("rt-{}-{}.asrrec", started_unix_ms, connection_id)).string();
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    spdlog::warn("RealtimeWS[{}]: cannot create recording {}: {}", connection_id, path,
+                 ec ? ec.message() : "open failed");
+    return nullptr;
+  }
+
+  std::array<char, kHeaderBytes> header{};
+  std::copy(kMagic.begin(), kMagic.end(), header.begin());
+  put_le(header.data() + 8, kRealtimeRecordingVersion);
+  put_le(header.data() + 12, connection_id);
+  put_le(header.data() + 20, started_unix_ms);
+  out.write(header.data(), header.size());
+
+  return std::unique_ptr<RealtimeRecorder>(
+      new RealtimeRecorder(path, std::move(out), connected_at, max_bytes));
+}
+
+RealtimeRecorder::RealtimeRecorder(std::string path, std::ofstream out,
+                                   std::chrono::steady_clock::time_point connected_at, size_t max_bytes)
+    : path_(std::move(path)),
+      out_(std::move(out)),
+      connected_at_(connected_at),
+      max_bytes_(max_bytes),
+      bytes_(kHeaderBytes) {}
+
+RealtimeRecorder::~RealtimeRecorder() {
+  if (active_) {
+    write_record(RealtimeRecordKind::Close, std::chrono::steady_clock::now(), {});
+  }
+}
+
+void RealtimeRecorder::record(RealtimeRecordKind kind, std::chrono::steady_clock::time_point at,
+                              std::string_view payload) {
+  if (!active_) {
+    return;
+  }
+  if (bytes_ + kRecordHeaderSize + payload.size() > max_bytes_) {
+    stop("size limit reached");
+    return;
+  }
+  write_record(kind, at, payload);
+}
+
+void RealtimeRecorder::write_record(RealtimeRecordKind kind, std::chrono::steady_clock::time_point at,
+                                    std::string_view payload) {
+  const auto offset_us = std::max<int64_t>(
+      0, std::chrono::duration_cast<std::chrono::microseconds>(at - connected_at_).count());
+
+  std::array<char, kRecordHeaderSize> header{};
+  put_le(header.data(), static_cast<uint64_t>(offset_us));
+  header[8] = static_cast<char>(kind);
+  put_le(header.data() + 9, static_cast<uint32_t>(payload.size()));
+  out_.write(header.data(), header.size());
+  out_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+  bytes_ += kRecordHeaderSize + payload.size();
+  if (!out_) {
+    stop("write failed");
+  }
+}
+
+void RealtimeRecorder::stop(const char* reason) {
+  active_ = false;
+  out_.close();
+  spdlog::warn("Realtime recording {} stopped after {} bytes: {}", path_, bytes_, reason);
+}
+
+RealtimeRecordingReader::RealtimeRecordingReader(const std::string& path) : in_(path, std::ios::binary) {
+  if (!in_) {
+    throw RecordingError("Cannot open recording " + path);
+  }
+  std::array<char, kHeaderBytes> header{};
+  in_.read(header.data(), header.size());
+  if (in_.gcount() != static_cast<std::streamsize>(header.size()) ||
+      std::string_view(header.data(), kMagic.size()) != kMagic) {
+    throw RecordingError("Not a realtime recording: " + path);
+  }
+  const auto version = get_le<uint32_t>(header.data() + 8);
+  if (version != kRealtimeRecordingVersion) {
+    throw RecordingError("Unsupported recording version " + std::to_string(version) + ": " + path);
+  }
+  connection_id_   = get_le<uint64_t>(header.data() + 12);
+  started_unix_ms_ = get_le<int64_t>(header.data() + 20);
+}
+
+bool RealtimeRecordingReader::next(RecordedRealtimeEvent& out) {
+  std::array<char, kRecordHeaderSize> header{};
+  in_.read(header.data(), header.size());
+  if (in_.gcount() != static_cast<std::streamsize>(header.size())) {
+    return false;
+  }
+  const auto kind = static_cast<uint8_t>(header[8]);
+  const auto size = get_le<uint32_t>(header.data() + 9);
+  if (kind > static_cast<uint8_t>(RealtimeRecordKind::Close) || size > kMaxRecordBytes) {
+    throw RecordingError("Corrupt recording record (kind " + std::to_string(kind) + ", " +
+                         std::to_string(size) + " bytes)");
+  }
+
+  out.offset = std::chrono::microseconds(static_cast<int64_t>(get_le<uint64_t>(header.data())));
+  out.kind   = static_cast<RealtimeRecordKind>(kind);
+  out.payload.resize(size);
+  in_.read(out.payload.data(), static_cast<std::streamsize>(size));
+  return in_.gcount() == static_cast<std::streamsize>(size);
+}
+
+RealtimeReplayReport replay_realtime_recording(RecognizerBackend& recognizer, const Config& config,
+                                               const std::string& path, double speed) {
+  RealtimeRecordingReader   reader(path);
+  RealtimeReplayReport      report;
+  RealtimeConnectionContext ctx(recognizer, config, reader.connection_id(), kDefaultTenant, nullptr, 1);
+  ReplaySink                sink(report);
+  RealtimeInboundEvent      event;
+  RecordedRealtimeEvent     recorded;
+
+  const auto         started_at = std::chrono::steady_clock::now();
+  const std::clock_t cpu_start  = std::clock();
+  while (reader.next(recorded)) {
+    auto scheduled = std::chrono::steady_clock::now();
+    if (speed > 0.0) {
+      scheduled = started_at + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double, std::micro>(
+                                       static_cast<double>(recorded.offset.count()) / speed));
+      std::this_thread::sleep_until(scheduled);
+    }
+    if (recorded.kind == RealtimeRecordKind::Close) {
+      break;
+    }
+
+    if (recorded.kind == RealtimeRecordKind::Binary) {
+      set_realtime_binary_event(std::move(recorded.payload), event);
+    } else if (parse_realtime_client_event(std::move(recorded.payload), event) != RealtimeParseStatus::Ok) {
+      ++report.skipped;
+      continue;
+    }
+    event.received_at = scheduled;
+    sink.scheduled_at = scheduled;
+
+    const auto begin = std::chrono::steady_clock::now();
+    run_realtime_event(ctx, sink, event);
+    report.event_ms.push_back(to_ms(std::chrono::steady_clock::now() - begin));
+    ++report.events;
+  }
+  if (ctx.session) {
+    ctx.session->on_close();
+  }
+
+  report.wall_sec    = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+  report.cpu_sec     = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  report.max_lag_sec = ctx.max_lag_sec;
+  if (ctx.runtime_config && ctx.runtime_config->sample_rate > 0) {
+    report.audio_sec =
+        static_cast<double>(ctx.input_samples) / static_cast<double>(ctx.runtime_config->sample_rate);
+  }
+  return report;
+}
+
+nlohmann::json realtime_replay_report_json(const RealtimeReplayReport& report) {
+  nlohmann::json j;
+  j["events"]      = report.events;
+  j["skipped"]     = report.skipped;
+  j["transcripts"] = report.transcripts;
+  j["errors"]      = report.errors;
+  j["audio_sec"]   = report.audio_sec;
+  j["wall_sec"]    = report.wall_sec;
+  j["cpu_sec"]     = report.cpu_sec;
+  j["cpu_rtf"]     = report.audio_sec > 0.0 ? nlohmann::json(report.cpu_sec / report.audio_sec)
+                                            : nlohmann::json(nullptr);
+  j["max_lag_sec"] = report.max_lag_sec;
+  j["event_ms"]    = distribution_json(report.event_ms);
+  j["final_ms"]    = distribution_json(report.final_ms);
+  return j;
+}
+
+}  // namespace asr
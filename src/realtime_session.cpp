@@ -21,10 +21,11 @@ void set_error(std::string* out, std::string message) {
   }
 }
 
-std::string event_speech_started_json(std::string_view event_id, std::string_view item_id,
-                                      int64_t audio_start_ms) {
-  std::string out;
-  out.reserve(128);
+// The write_* helpers overwrite `out`, keeping its capacity, so a connection
+// that reuses one buffer serializes these events without allocating.
+void write_speech_started_json(std::string& out, std::string_view event_id, std::string_view item_id,
+                               int64_t audio_start_ms) {
+  out.clear();
   out.append(R"({"type":"input_audio_buffer.speech_started","event_id":")");
   out.append(event_id);
   out.append(R"(","audio_start_ms":)");
@@ -32,13 +33,11 @@ std::string event_speech_started_json(std::string_view event_id, std::string_vie
   out.append(R"(,"item_id":")");
   out.append(item_id);
   out.append("\"}");
-  return out;
 }
 
-std::string event_speech_stopped_json(std::string_view event_id, std::string_view item_id,
-                                      int64_t audio_end_ms) {
-  std::string out;
-  out.reserve(128);
+void write_speech_stopped_json(std::string& out, std::string_view event_id, std::string_view item_id,
+                               int64_t audio_end_ms) {
+  out.clear();
   out.append(R"({"type":"input_audio_buffer.speech_stopped","event_id":")");
   out.append(event_id);
   out.append(R"(","audio_end_ms":)");
@@ -46,12 +45,20 @@ std::string event_speech_stopped_json(std::string_view event_id, std::string_vie
   out.append(R"(,"item_id":")");
   out.append(item_id);
   out.append("\"}");
-  return out;
 }
 
-std::string event_buffer_committed_json(std::string_view event_id, const RealtimeCommittedItem& commit) {
-  std::string out;
-  out.reserve(160);
+void write_session_lag_json(std::string& out, std::string_view event_id, bool lagging, int64_t lag_ms) {
+  out.clear();
+  out.append(R"({"type":"session.lag","event_id":")");
+  out.append(event_id);
+  out.append(lagging ? R"(","state":"lagging","lag_ms":)" : R"(","state":"recovered","lag_ms":)");
+  append_decimal(out, lag_ms);
+  out.push_back('}');
+}
+
+void write_buffer_committed_json(std::string& out, std::string_view event_id,
+                                 const RealtimeCommittedItem& commit) {
+  out.clear();
   out.append(R"({"type":"input_audio_buffer.committed","event_id":")");
   out.append(event_id);
   out.append(R"(","item_id":")");
@@ -65,7 +72,6 @@ std::string event_buffer_committed_json(std::string_view event_id, const Realtim
     out.push_back('"');
   }
   out.push_back('}');
-  return out;
 }
 
 std::string event_buffer_cleared_json(std::string_view event_id) {
@@ -77,10 +83,9 @@ std::string event_buffer_cleared_json(std::string_view event_id) {
   return out;
 }
 
-std::string event_transcription_completed_json(std::string_view event_id, std::string_view item_id,
-                                               std::string_view transcript) {
-  std::string out;
-  out.reserve(160 + transcript.size());
+void write_transcription_completed_json(std::string& out, std::string_view event_id, std::string_view item_id,
+                                        std::string_view transcript) {
+  out.clear();
   out.append(R"({"type":"conversation.item.input_audio_transcription.completed","event_id":")");
   out.append(event_id);
   out.append(R"(","item_id":")");
@@ -88,7 +93,6 @@ std::string event_transcription_completed_json(std::string_view event_id, std::s
   out.append(R"(","content_index":0,"transcript":")");
   append_json_escaped(out, transcript);
   out.append("\"}");
-  return out;
 }
 
 bool is_supported_input_audio_format(const std::string& format) {
@@ -383,20 +387,46 @@ std::string RealtimeSession::event_session_updated() {
 }
 
 std::string RealtimeSession::event_speech_started(int64_t audio_start_ms) {
+  std::string out;
+  out.reserve(128);
+  event_speech_started(audio_start_ms, out);
+  return out;
+}
+
+void RealtimeSession::event_speech_started(int64_t audio_start_ms, std::string& out) {
   const auto event_id = next_event_id();
   const auto item_id  = ensure_current_item_id();
-  return event_speech_started_json(event_id, item_id, audio_start_ms);
+  write_speech_started_json(out, event_id, item_id, audio_start_ms);
 }
 
 std::string RealtimeSession::event_speech_stopped(int64_t audio_end_ms) {
+  std::string out;
+  out.reserve(128);
+  event_speech_stopped(audio_end_ms, out);
+  return out;
+}
+
+void RealtimeSession::event_speech_stopped(int64_t audio_end_ms, std::string& out) {
   const auto event_id = next_event_id();
   const auto item_id  = ensure_current_item_id();
-  return event_speech_stopped_json(event_id, item_id, audio_end_ms);
+  write_speech_stopped_json(out, event_id, item_id, audio_end_ms);
 }
 
 std::string RealtimeSession::event_buffer_committed(const RealtimeCommittedItem& commit) {
+  std::string out;
+  out.reserve(160);
+  event_buffer_committed(commit, out);
+  return out;
+}
+
+void RealtimeSession::event_buffer_committed(const RealtimeCommittedItem& commit, std::string& out) {
   const auto event_id = next_event_id();
-  return event_buffer_committed_json(event_id, commit);
+  write_buffer_committed_json(out, event_id, commit);
+}
+
+void RealtimeSession::event_session_lag(bool lagging, int64_t lag_ms, std::string& out) {
+  const auto event_id = next_event_id();
+  write_session_lag_json(out, event_id, lagging, lag_ms);
 }
 
 std::string RealtimeSession::event_buffer_cleared() {
@@ -416,8 +446,16 @@ std::string RealtimeSession::event_transcription_delta(const std::string& item_i
 
 std::string RealtimeSession::event_transcription_completed(const std::string& item_id,
                                                            const std::string& transcript) {
+  std::string out;
+  out.reserve(160 + transcript.size());
+  event_transcription_completed(item_id, transcript, out);
+  return out;
+}
+
+void RealtimeSession::event_transcription_completed(const std::string& item_id, const std::string& transcript,
+                                                    std::string& out) {
   const auto event_id = next_event_id();
-  return event_transcription_completed_json(event_id, item_id, transcript);
+  write_transcription_completed_json(out, event_id, item_id, transcript);
 }
 
 std::string RealtimeSession::event_error(const std::string& code, const std::string& message,
@@ -9,120 +9,238 @@
 #include <memory>
 #include <ratio>
 #include <stdexcept>
+#include <utility>
 
+#include "asr/alloc_profiler.h"
 #include "asr/config.h"
 #include "asr/metrics.h"
+#include "asr/request_timing.h"
 #include "asr/span.h"
+#include "asr/synthetic_recognizer.h"
 
 namespace asr {
 
+void RecognizerBackend::set_pressure_source(std::function<size_t()> /*source*/) {}
+
+std::unique_ptr<RecognizerBackend> make_recognizer_backend(const Config& cfg) {
+  if (cfg.recognizer_backend == "synthetic") {
+    return std::make_unique<SyntheticRecognizer>(cfg);
+  }
+  return std::make_unique<Recognizer>(cfg);
+}
+
 Recognizer::Recognizer(const Config& cfg)
-    : encoder_path_(cfg.model_dir + "/encoder.int8.onnx"),
+    : strategy_(parse_decoding_strategy(cfg.decoding_method)),
+      policy_(cfg.adaptive_beam_below, cfg.adaptive_greedy_above),
+      encoder_path_(cfg.model_dir + "/" + cfg.encoder_file),
       decoder_path_(cfg.model_dir + "/decoder.onnx"),
       joiner_path_(cfg.model_dir + "/joiner.onnx"),
       tokens_path_(cfg.model_dir + "/tokens.txt"),
       provider_(cfg.provider),
-      wait_timeout_ms_(cfg.recognizer_wait_timeout_ms) {
+      wait_timeout_ms_(cfg.recognizer_wait_timeout_ms),
+      max_active_paths_(cfg.max_active_paths) {
   const int pool_size        = cfg.recognizer_pool_size > 0 ? cfg.recognizer_pool_size : 1;
   const int threads_per_slot = std::max(1, cfg.num_threads / pool_size);
 
   slots_.resize(static_cast<size_t>(pool_size));
+  // At least one slot stays shared, even for a config that skipped validate().
+  realtime_slots_ = std::min(cfg.recognizer_realtime_slots, slots_.size() - 1);
 
+  const auto primary = strategy_ == DecodingStrategy::ModifiedBeamSearch ? DecodingMethod::ModifiedBeamSearch
+                                                                         : DecodingMethod::Greedy;
   for (int i = 0; i < pool_size; ++i) {
-    SherpaOnnxOfflineRecognizerConfig c{};
-
-    // Transducer model config
-    c.model_config.transducer.encoder = encoder_path_.c_str();
-    c.model_config.transducer.decoder = decoder_path_.c_str();
-    c.model_config.transducer.joiner  = joiner_path_.c_str();
-
-    // General model config
-    c.model_config.tokens      = tokens_path_.c_str();
-    c.model_config.num_threads = threads_per_slot;
-    c.model_config.provider    = provider_.c_str();
-    c.model_config.model_type  = "nemo_transducer";
-    c.model_config.debug       = 0;
-
-    // Feature config
-    c.feat_config.sample_rate = cfg.sample_rate;
-    c.feat_config.feature_dim = cfg.feature_dim;
-
-    // Decoding config
-    c.decoding_method = "greedy_search";
-
-    const auto* handle = SherpaOnnxCreateOfflineRecognizer(&c);
-    if (handle == nullptr) {
-      // Destroy any handles already created
-      for (int j = 0; j < i; ++j) {
-        SherpaOnnxDestroyOfflineRecognizer(slots_[static_cast<size_t>(j)].handle);
-      }
+    auto& slot  = slots_[static_cast<size_t>(i)];
+    slot.handle = create_handle(cfg, threads_per_slot, primary);
+    if (slot.handle != nullptr && strategy_ == DecodingStrategy::Adaptive) {
+      // sherpa-onnx fixes the search per recognizer, so adaptive mode keeps a
+      // second (beam) handle per slot. Only one of the pair runs at a time.
+      slot.beam_handle = create_handle(cfg, threads_per_slot, DecodingMethod::ModifiedBeamSearch);
+    }
+    if (slot.handle == nullptr || (strategy_ == DecodingStrategy::Adaptive && slot.beam_handle == nullptr)) {
+      destroy_handles();
       throw std::runtime_error("Failed to create sherpa-onnx offline recognizer slot " + std::to_string(i) +
                                " (provider=" + cfg.provider + ", model_dir=" + cfg.model_dir +
                                "). Check that model files exist and provider is available.");
     }
+    slot.in_use = false;
+  }
 
-    slots_[static_cast<size_t>(i)].handle = handle;
-    slots_[static_cast<size_t>(i)].in_use = false;
+  // sherpa-onnx fixes intra-op threads per recognizer too, so elasticity is
+  // a single all-core handle rather than a per-run setting. It runs the
+  // search an idle pool would pick: beam for adaptive.
+  if (cfg.recognizer_elastic_threads && cfg.num_threads > threads_per_slot) {
+    wide_method_ = strategy_ == DecodingStrategy::Greedy ? DecodingMethod::Greedy
+                                                         : DecodingMethod::ModifiedBeamSearch;
+    wide_handle_ = create_handle(cfg, cfg.num_threads, wide_method_);
+    if (wide_handle_ == nullptr) {
+      destroy_handles();
+      throw std::runtime_error("Failed to create sherpa-onnx elastic recognizer (provider=" + cfg.provider +
+                               ", model_dir=" + cfg.model_dir + ")");
+    }
   }
 
-  spdlog::info("Recognizer pool initialized: pool_size={}, threads_per_slot={}, provider={}", pool_size,
-               threads_per_slot, cfg.provider);
+  spdlog::info(
+      "Recognizer pool initialized: pool_size={}, realtime_slots={}, threads_per_slot={}, "
+      "elastic_threads={}, provider={}, decoding_method={}, max_active_paths={}",
+      pool_size, realtime_slots_, threads_per_slot, wide_handle_ != nullptr ? cfg.num_threads : 0,
+      cfg.provider, cfg.decoding_method, max_active_paths_);
 }
 
-Recognizer::~Recognizer() {
+const SherpaOnnxOfflineRecognizer* Recognizer::create_handle(const Config& cfg, int num_threads,
+                                                             DecodingMethod method) {
+  SherpaOnnxOfflineRecognizerConfig c{};
+
+  // Transducer model config
+  c.model_config.transducer.encoder = encoder_path_.c_str();
+  c.model_config.transducer.decoder = decoder_path_.c_str();
+  c.model_config.transducer.joiner  = joiner_path_.c_str();
+
+  // General model config
+  c.model_config.tokens      = tokens_path_.c_str();
+  c.model_config.num_threads = num_threads;
+  c.model_config.provider    = provider_.c_str();
+  c.model_config.model_type  = "nemo_transducer";
+  c.model_config.debug       = 0;
+
+  // Feature config
+  c.feat_config.sample_rate = cfg.sample_rate;
+  c.feat_config.feature_dim = cfg.feature_dim;
+
+  // Decoding config
+  c.decoding_method  = decoding_method_name(method);
+  c.max_active_paths = max_active_paths_;
+
+  return SherpaOnnxCreateOfflineRecognizer(&c);
+}
+
+void Recognizer::destroy_handles() noexcept {
   for (auto& slot : slots_) {
     if (slot.handle != nullptr) {
       SherpaOnnxDestroyOfflineRecognizer(slot.handle);
+      slot.handle = nullptr;
+    }
+    if (slot.beam_handle != nullptr) {
+      SherpaOnnxDestroyOfflineRecognizer(slot.beam_handle);
+      slot.beam_handle = nullptr;
     }
   }
+  if (wide_handle_ != nullptr) {
+    SherpaOnnxDestroyOfflineRecognizer(wide_handle_);
+    wide_handle_ = nullptr;
+  }
+}
+
+void Recognizer::set_pressure_source(std::function<size_t()> source) {
+  const std::scoped_lock lock(pool_mutex_);
+  pressure_source_ = std::move(source);
+}
+
+Recognizer::~Recognizer() {
+  destroy_handles();
 }
 
-std::string Recognizer::recognize(span<const float> audio, int sample_rate) {
+std::string Recognizer::recognize(span<const float> audio, int sample_rate, SlotClass slot_class) {
   if (audio.empty()) {
     return {};
   }
+  const AllocTagScope alloc_scope(AllocTag::Asr);
 
   struct SlotLease {
     Recognizer* owner    = nullptr;
     size_t      slot_idx = 0;
+    bool        wide     = false;
 
     ~SlotLease() {
       if (owner == nullptr) {
         return;
       }
+      if (wide) {
+        // Before the handle is returned, so the next borrower cannot overlap.
+        owner->wide_running_.fetch_sub(1, std::memory_order_relaxed);
+      }
       {
         const std::scoped_lock lock(owner->pool_mutex_);
         owner->slots_[slot_idx].in_use = false;
+        if (wide) {
+          owner->wide_in_use_ = false;
+        }
+      }
+      // With reserved slots a waiter of the other class may be first in
+      // line and unable to take this slot; wake them all to re-check.
+      if (owner->realtime_slots_ > 0) {
+        owner->pool_cv_.notify_all();
+      } else {
+        owner->pool_cv_.notify_one();
       }
-      owner->pool_cv_.notify_one();
     }
   };
 
   const SherpaOnnxOfflineRecognizer* handle       = nullptr;
   size_t                             slot_idx     = 0;
+  bool                               wide         = false;
   const auto                         wait_started = std::chrono::steady_clock::now();
   {
     std::unique_lock lock(pool_mutex_);
-    const bool       acquired =
-        pool_cv_.wait_for(lock, std::chrono::milliseconds(wait_timeout_ms_), [this, &slot_idx]() {
-          const auto it =
-              std::find_if(slots_.begin(), slots_.end(), [](const Slot& slot) { return !slot.in_use; });
+    ++waiters_;
+    // Realtime scans from the reserved slots so the shared ones stay free
+    // for uploads; shared requests never see the reserved range.
+    const auto first = slots_.begin() + static_cast<std::ptrdiff_t>(
+                                            slot_class == SlotClass::Realtime ? 0 : realtime_slots_);
+    const bool acquired =
+        pool_cv_.wait_for(lock, std::chrono::milliseconds(wait_timeout_ms_), [this, first, &slot_idx]() {
+          const auto it = std::find_if(first, slots_.end(), [](const Slot& slot) { return !slot.in_use; });
           if (it == slots_.end()) {
             return false;
           }
           slot_idx = static_cast<size_t>(std::distance(slots_.begin(), it));
           return true;
         });
+    --waiters_;
     const auto wait_sec =
         std::chrono::duration<double>(std::chrono::steady_clock::now() - wait_started).count();
-    ASRMetrics::instance().observe_recognizer_wait(wait_sec, !acquired);
+    ASRMetrics::instance().observe_recognizer_wait(wait_sec, !acquired, slot_class);
+    record_recognizer_wait(wait_sec);
+    recent_waits_.record(wait_sec);
     if (!acquired) {
       throw RecognizerBusyError("Recognizer pool is saturated");
     }
     slots_[slot_idx].in_use = true;
     handle                  = slots_[slot_idx].handle;
+
+    const auto busy_others = static_cast<size_t>(
+        std::count_if(slots_.begin(), slots_.end(), [](const Slot& slot) { return slot.in_use; }) - 1);
+    const size_t external =
+        pressure_source_ && (strategy_ == DecodingStrategy::Adaptive || wide_handle_ != nullptr)
+            ? pressure_source_()
+            : 0;
+    auto method = strategy_ == DecodingStrategy::ModifiedBeamSearch ? DecodingMethod::ModifiedBeamSearch
+                                                                    : DecodingMethod::Greedy;
+    if (strategy_ == DecodingStrategy::Adaptive) {
+      method = policy_.select(busy_others, waiters_ + external, slots_.size());
+      if (method == DecodingMethod::ModifiedBeamSearch) {
+        handle = slots_[slot_idx].beam_handle;
+      }
+    }
+    // Alone on the pool: borrow every core. A request arriving meanwhile
+    // decodes on its own slot at its fair share; the two overlap only until
+    // this decode ends.
+    if (wide_handle_ != nullptr && !wide_in_use_ && method == wide_method_ && busy_others == 0 &&
+        waiters_ + external == 0) {
+      wide_in_use_ = true;
+      wide         = true;
+      handle       = wide_handle_;
+    }
+    ASRMetrics::instance().set_decoding_mode(static_cast<int>(method));
+    ASRMetrics::instance().observe_decode_method(method);
+  }
+  SlotLease slot_lease{this, slot_idx, wide};
+  if (wide) {
+    wide_decodes_.fetch_add(1, std::memory_order_relaxed);
+    const size_t running = wide_running_.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t       peak    = wide_peak_.load(std::memory_order_relaxed);
+    while (running > peak && !wide_peak_.compare_exchange_weak(peak, running, std::memory_order_relaxed)) {
+    }
   }
-  SlotLease slot_lease{this, slot_idx};
 
   using StreamHandle =
       std::unique_ptr<const SherpaOnnxOfflineStream, decltype(&SherpaOnnxDestroyOfflineStream)>;
@@ -165,4 +283,14 @@ bool Recognizer::ready() const noexcept {
   return std::all_of(slots_.begin(), slots_.end(), [](const Slot& slot) { return slot.handle != nullptr; });
 }
 
+RecognizerLoad Recognizer::load() const {
+  RecognizerLoad         load;
+  const std::scoped_lock lock(pool_mutex_);
+  load.slots_total  = slots_.size();
+  load.slots_busy   = static_cast<size_t>(
+      std::count_if(slots_.begin(), slots_.end(), [](const Slot& slot) { return slot.in_use; }));
+  load.wait_p95_sec = recent_waits_.percentile(0.95);
+  return load;
+}
+
 }  // namespace asr
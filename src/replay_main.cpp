@@ -0,0 +1,91 @@
+// asr-replay: runs recorded realtime sessions (REALTIME_RECORD_DIR) through
+// the realtime pipeline and prints one JSON report per recording.
+//
+// Usage: asr-replay [--speed X] recording.asrrec...
+//        --speed 1 (default) keeps the recorded timing, 4 plays 4x faster,
+//        0 sends each event as soon as the previous one is handled.
+// Recognizer, VAD and pool settings come from the same environment variables
+// as the server; RECOGNIZER_BACKEND=synthetic replays without a model.
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asr/config.h"
+#include "asr/realtime_recording.h"
+#include "asr/recognizer.h"
+
+namespace {
+
+void print_usage() {
+  std::fputs("Usage: asr-replay [--speed X] recording.asrrec...\n", stderr);
+}
+
+int run_replay(int argc, char** argv) {
+  double                   speed = 1.0;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg == "--speed" && i + 1 < argc) {
+      char* end = nullptr;
+      speed     = std::strtod(argv[++i], &end);
+      if (*end != '\0' || speed < 0.0) {
+        print_usage();
+        return 2;
+      }
+    } else if (arg == "-h" || arg == "--help") {
+      print_usage();
+      return 0;
+    } else {
+      files.emplace_back(arg);
+    }
+  }
+  if (files.empty()) {
+    print_usage();
+    return 2;
+  }
+
+  // Reports go to stdout; keep the log on stderr.
+  spdlog::set_default_logger(spdlog::stderr_color_mt("asr"));
+  spdlog::set_level(spdlog::level::warn);
+
+  auto config = asr::Config::from_env();
+  config.validate();
+  const auto recognizer = asr::make_recognizer_backend(config);
+
+  int failures = 0;
+  for (const auto& file : files) {
+    try {
+      const auto result = asr::replay_realtime_recording(*recognizer, config, file, speed);
+      auto       report = asr::realtime_replay_report_json(result);
+      report["file"]    = file;
+      report["speed"]   = speed;
+      std::cout << report.dump() << '\n';
+    } catch (const asr::RecordingError& e) {
+      std::fprintf(stderr, "%s\n", e.what());
+      ++failures;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    return run_replay(argc, argv);
+  } catch (const asr::ConfigError& e) {
+    std::fprintf(stderr, "Configuration error: %s\n", e.what());
+    return 2;
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "Fatal error: %s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,75 @@
+#include "asr/request_timing.h"
+
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
+
+namespace asr {
+namespace {
+
+thread_local double* t_wait_sink = nullptr;
+
+double to_ms(double sec) {
+  return sec * 1000.0;
+}
+
+}  // namespace
+
+void split_decode_time(RequestTiming& timing, double pipeline_sec, double recognize_sec) {
+  timing.asr_sec       = std::max(0.0, recognize_sec - timing.recognizer_wait_sec);
+  timing.container_sec = std::max(0.0, pipeline_sec - recognize_sec - timing.resample_sec);
+}
+
+std::string format_server_timing(const RequestTiming& timing) {
+  const std::array<std::pair<const char*, double>, 8> entries{{
+      {"queue", timing.queue_sec},
+      {"recognizer_wait", timing.recognizer_wait_sec},
+      {"container", timing.container_sec},
+      {"resample", timing.resample_sec},
+      {"vad", timing.vad_sec},
+      {"asr", timing.asr_sec},
+      {"serialize", timing.serialize_sec},
+      {"total", timing.total_sec},
+  }};
+
+  std::string out;
+  out.reserve(192);
+  for (const auto& [name, sec] : entries) {
+    if (!out.empty()) {
+      out += ", ";
+    }
+    fmt::format_to(std::back_inserter(out), "{};dur={:.1f}", name, to_ms(sec));
+  }
+  return out;
+}
+
+nlohmann::json request_timing_json(const RequestTiming& timing) {
+  nlohmann::json j;
+  j["queue_ms"]           = to_ms(timing.queue_sec);
+  j["recognizer_wait_ms"] = to_ms(timing.recognizer_wait_sec);
+  j["container_ms"]       = to_ms(timing.container_sec);
+  j["resample_ms"]        = to_ms(timing.resample_sec);
+  j["vad_ms"]             = to_ms(timing.vad_sec);
+  j["asr_ms"]             = to_ms(timing.asr_sec);
+  j["total_ms"]           = to_ms(timing.total_sec);
+  return j;
+}
+
+RecognizerWaitScope::RecognizerWaitScope() : previous_(t_wait_sink) {
+  t_wait_sink = &seconds_;
+}
+
+RecognizerWaitScope::~RecognizerWaitScope() {
+  t_wait_sink = previous_;
+}
+
+void record_recognizer_wait(double sec) noexcept {
+  if (t_wait_sink != nullptr) {
+    *t_wait_sink += sec;
+  }
+}
+
+}  // namespace asr
@@ -0,0 +1,264 @@
+#include "asr/segment_classifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "asr/config.h"
+#include "asr/span.h"
+#include "asr/string_utils.h"
+
+namespace asr {
+
+namespace {
+
+constexpr double kPi        = 3.14159265358979323846;
+constexpr size_t kPeakWidth = 2;      // bins either side of a peak that belong to it
+constexpr double kLogFloor  = 1e-10;  // relative to the mean bin power
+
+size_t distance(size_t a, size_t b) {
+  return a > b ? a - b : b - a;
+}
+
+}  // namespace
+
+const char* segment_class_name(SegmentClass kind) noexcept {
+  switch (kind) {
+    case SegmentClass::Speech:
+      return "speech";
+    case SegmentClass::Tone:
+      return "tone";
+    case SegmentClass::Music:
+      return "music";
+    case SegmentClass::Noise:
+      return "noise";
+  }
+  return "speech";
+}
+
+NonSpeechMode parse_nonspeech_mode(std::string_view value) {
+  const auto mode = to_lower_ascii(trim_ascii(value));
+  if (mode == "off") {
+    return NonSpeechMode::Off;
+  }
+  if (mode == "flag") {
+    return NonSpeechMode::Flag;
+  }
+  if (mode == "drop") {
+    return NonSpeechMode::Drop;
+  }
+  throw ConfigError("nonspeech_filter must be off, flag or drop, got '" + std::string(value) + "'");
+}
+
+SegmentClassifier::SegmentClassifier(int sample_rate)
+    : block_(std::max<size_t>(kFrame, static_cast<size_t>(kBlockSec * static_cast<float>(sample_rate)))),
+      window_(kFrame),
+      cos_(kFrame / 2),
+      sin_(kFrame / 2),
+      bit_reverse_(kFrame),
+      re_(kFrame),
+      im_(kFrame) {
+  const double hz_per_bin = static_cast<double>(sample_rate) / static_cast<double>(kFrame);
+  low_bin_                = std::max<size_t>(1, static_cast<size_t>(std::ceil(kLowHz / hz_per_bin)));
+  high_bin_ = std::min(kFrame / 2, static_cast<size_t>(static_cast<double>(kHighHz) / hz_per_bin) + 1);
+  high_bin_ = std::max(high_bin_, low_bin_ + 1);
+  power_.resize(high_bin_ - low_bin_);
+  prev_.resize(power_.size());
+
+  for (size_t i = 0; i < kFrame; ++i) {
+    window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(i) / kFrame));
+  }
+  for (size_t k = 0; k < kFrame / 2; ++k) {
+    cos_[k] = static_cast<float>(std::cos(2.0 * kPi * static_cast<double>(k) / kFrame));
+    sin_[k] = static_cast<float>(-std::sin(2.0 * kPi * static_cast<double>(k) / kFrame));
+  }
+  size_t bits = 0;
+  while ((size_t{1} << bits) < kFrame) {
+    ++bits;
+  }
+  for (size_t i = 0; i < kFrame; ++i) {
+    size_t reversed = 0;
+    for (size_t b = 0; b < bits; ++b) {
+      reversed |= ((i >> b) & 1U) << (bits - 1 - b);
+    }
+    bit_reverse_[i] = static_cast<uint16_t>(reversed);
+  }
+}
+
+// Iterative radix-2 FFT of the windowed frame into power_. The window and
+// power loops run over plain contiguous float arrays so the compiler
+// vectorizes them; the butterflies are the bulk of the cost and stay scalar.
+void SegmentClassifier::spectrum(const float* frame) {
+  for (size_t i = 0; i < kFrame; ++i) {
+    re_[bit_reverse_[i]] = frame[i] * window_[i];
+  }
+  std::fill(im_.begin(), im_.end(), 0.0f);
+
+  for (size_t len = 2; len <= kFrame; len <<= 1) {
+    const size_t half = len / 2;
+    const size_t step = kFrame / len;
+    for (size_t start = 0; start < kFrame; start += len) {
+      for (size_t j = 0; j < half; ++j) {
+        const float  wr = cos_[j * step];
+        const float  wi = sin_[j * step];
+        const size_t a  = start + j;
+        const size_t b  = a + half;
+        const float  xr = re_[b] * wr - im_[b] * wi;
+        const float  xi = re_[b] * wi + im_[b] * wr;
+        re_[b]          = re_[a] - xr;
+        im_[b]          = im_[a] - xi;
+        re_[a] += xr;
+        im_[a] += xi;
+      }
+    }
+  }
+
+  const float* re    = re_.data() + low_bin_;
+  const float* im    = im_.data() + low_bin_;
+  float*       power = power_.data();
+  const size_t bins  = power_.size();
+  for (size_t k = 0; k < bins; ++k) {
+    power[k] = re[k] * re[k] + im[k] * im[k];
+  }
+}
+
+SegmentFeatures SegmentClassifier::features(span<const float> samples) {
+  SegmentFeatures out;
+  const double    min_energy = static_cast<double>(kFrame) * std::pow(10.0, kMinFrameDbfs / 10.0);
+  const size_t    bins       = power_.size();
+
+  double flatness_sum = 0.0;
+  double tonality_sum = 0.0;
+  size_t pairs        = 0;
+  size_t stable       = 0;
+  bool   has_prev     = false;
+
+  for (size_t offset = 0; offset + kFrame <= samples.size(); offset += kFrame) {
+    const float* frame  = samples.data() + offset;
+    double       energy = 0.0;
+    for (size_t i = 0; i < kFrame; ++i) {
+      energy += static_cast<double>(frame[i]) * static_cast<double>(frame[i]);
+    }
+    if (energy < min_energy) {
+      has_prev = false;  // a pause breaks the track
+      continue;
+    }
+    spectrum(frame);
+
+    double total = 0.0;
+    size_t peak  = 0;
+    for (size_t k = 0; k < bins; ++k) {
+      total += power_[k];
+      if (power_[k] > power_[peak]) {
+        peak = k;
+      }
+    }
+    if (total <= 0.0) {
+      continue;
+    }
+    const double mean    = total / static_cast<double>(bins);
+    const double floor   = mean * kLogFloor;
+    double       log_sum = 0.0;
+    double       first   = 0.0;
+    size_t       second  = bins;
+    for (size_t k = 0; k < bins; ++k) {
+      log_sum += std::log(std::max(static_cast<double>(power_[k]), floor));
+      if (distance(k, peak) <= kPeakWidth) {
+        first += power_[k];
+      } else if (second == bins || power_[k] > power_[second]) {
+        second = k;
+      }
+    }
+    double next = 0.0;
+    if (second != bins) {
+      const size_t begin = second > kPeakWidth ? second - kPeakWidth : 0;
+      const size_t end   = std::min(bins, second + kPeakWidth + 1);
+      for (size_t k = begin; k < end; ++k) {
+        if (distance(k, peak) > kPeakWidth) {
+          next += power_[k];
+        }
+      }
+    }
+
+    flatness_sum += std::exp(log_sum / static_cast<double>(bins)) / mean;
+    tonality_sum += (first + next) / total;
+    // Cosine similarity of this frame's magnitude spectrum with the last one.
+    double dot       = 0.0;
+    double norm      = 0.0;
+    double prev_norm = 0.0;
+    for (size_t k = 0; k < bins; ++k) {
+      const double magnitude = std::sqrt(static_cast<double>(power_[k]));
+      dot += magnitude * static_cast<double>(prev_[k]);
+      norm += magnitude * magnitude;
+      prev_norm += static_cast<double>(prev_[k]) * static_cast<double>(prev_[k]);
+      prev_[k] = static_cast<float>(magnitude);
+    }
+    if (has_prev) {
+      ++pairs;
+      if (dot >= kStableSimilarity * std::sqrt(norm * prev_norm)) {
+        ++stable;
+      }
+    }
+    has_prev = true;
+    ++out.frames;
+  }
+
+  if (out.frames > 0) {
+    out.flatness = static_cast<float>(flatness_sum / static_cast<double>(out.frames));
+    out.tonality = static_cast<float>(tonality_sum / static_cast<double>(out.frames));
+  }
+  if (pairs > 0) {
+    out.stability = static_cast<float>(static_cast<double>(stable) / static_cast<double>(pairs));
+  }
+  return out;
+}
+
+SegmentClass SegmentClassifier::classify(span<const float> samples) {
+  return decide(features(samples));
+}
+
+SegmentClass SegmentClassifier::classify_blocks(span<const float> samples) {
+  const size_t blocks   = std::max<size_t>(1, samples.size() / block_);
+  size_t       votes[4] = {};  // by SegmentClass; Speech never counted
+  for (size_t b = 0; b < blocks; ++b) {
+    const size_t begin = b * block_;
+    const size_t end   = b + 1 == blocks ? samples.size() : begin + block_;
+    const auto   f     = features(samples.subspan(begin, end - begin));
+    if (f.frames < kMinFrames) {
+      continue;  // a pause says nothing either way
+    }
+    const auto kind = decide(f);
+    if (kind == SegmentClass::Speech) {
+      return SegmentClass::Speech;
+    }
+    ++votes[static_cast<size_t>(kind)];
+  }
+  size_t best = 0;
+  for (size_t k = 1; k < 4; ++k) {
+    if (votes[k] > votes[best]) {
+      best = k;
+    }
+  }
+  return static_cast<SegmentClass>(best);
+}
+
+SegmentClass SegmentClassifier::decide(const SegmentFeatures& f) {
+  if (f.frames < kMinFrames) {
+    return SegmentClass::Speech;
+  }
+  if (f.tonality >= kToneTonality) {
+    return SegmentClass::Tone;
+  }
+  if (f.tonality >= kMusicTonality && f.stability >= kMusicStable) {
+    return SegmentClass::Music;
+  }
+  if (f.flatness >= kNoiseFlatness && f.tonality < kNoiseTonality) {
+    return SegmentClass::Noise;
+  }
+  return SegmentClass::Speech;
+}
+
+}  // namespace asr
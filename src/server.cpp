@@ -14,6 +14,7 @@
 #include <prometheus/registry.h>
 #include <prometheus/text_serializer.h>
 #include <spdlog/spdlog.h>
+#include <trantor/net/EventLoop.h>
 #include <trantor/net/InetAddress.h>
 #include <trantor/utils/Logger.h>
 #include <unistd.h>
@@ -21,9 +22,11 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <condition_variable>
 #include <csignal>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
 #include <filesystem>
@@ -41,26 +44,35 @@
 #include <utility>
 #include <vector>
 
+#include "asr/alloc_profiler.h"
 #include "asr/audio.h"
 #include "asr/config.h"
 #include "asr/executor.h"
 #include "asr/handler.h"
+#include "asr/load_monitor.h"
 #include "asr/logging.h"
 #include "asr/metrics.h"
+#include "asr/profiler.h"
+#include "asr/raw_audio_request.h"
+#include "asr/realtime_connection.h"
+#include "asr/realtime_lag.h"
+#include "asr/realtime_recording.h"
 #include "asr/realtime_session.h"
 #include "asr/recognizer.h"
+#include "asr/request_timing.h"
+#include "asr/segment_classifier.h"
 #include "asr/span.h"
 #include "asr/string_utils.h"
+#include "asr/tenant.h"
 #include "asr/whisper_api.h"
-#include "trantor/net/EventLoop.h"
 
 namespace asr {
 
 // Shared server state, initialized before accepting connections.
 struct ServerSharedState {
-  Recognizer*   recognizer = nullptr;
-  VadConfig     vad_config;
-  const Config* config = nullptr;
+  RecognizerBackend* recognizer = nullptr;
+  VadConfig          vad_config;
+  const Config*      config = nullptr;
 };
 
 namespace {
@@ -72,12 +84,16 @@ std::atomic<size_t> g_active_ws_connections{0};  // NOLINT(cppcoreguidelines-avo
 constexpr float  kHttpRecognitionChunkSec = 20.0f;
 constexpr auto   kCloseTryAgainLater      = static_cast<drogon::CloseCode>(1013);
 constexpr size_t kRealtimeWsPendingTasks  = 16;
-constexpr double kExecutorRetryDelaySec   = 0.01;
-constexpr int    kHotPathWarnIntervalMs   = 2000;
 constexpr int    kCapacityWarnIntervalMs  = 1000;
+constexpr double kMaxAdminWindowSec       = 60.0;  // longest window of an /admin/* measurement
 
 std::unique_ptr<BoundedExecutor>
     g_asr_executor;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::unique_ptr<LoadStateTracker>
+    g_load_tracker;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::unique_ptr<TenantRegistry> g_tenants;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// Set after the first successful VAD probe so /readyz polling does not rebuild the ONNX session.
+std::atomic<bool> g_vad_runtime_ready{false};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 void append_transcription_chunk(std::string& text, std::string_view chunk_text) {
   auto trimmed = trim_ascii(chunk_text);
@@ -90,22 +106,39 @@ void append_transcription_chunk(std::string& text, std::string_view chunk_text)
   text += trimmed;
 }
 
-size_t http_chunk_samples(int sample_rate) {
-  return std::max<size_t>(1, static_cast<size_t>(kHttpRecognitionChunkSec * static_cast<float>(sample_rate)));
-}
-
-bool is_realtime_opus_format(std::string_view format) {
-  return format == "opus" || format == "opus_raw" || format == "opus_rtp";
-}
-
-OpusPacketMode realtime_opus_packet_mode(std::string_view format) {
-  if (format == "opus_raw") {
-    return OpusPacketMode::Raw;
+// NONSPEECH_FILTER for the chunks of one upload. Chunks are classified one
+// SegmentClassifier block at a time and only dropped when every voiced block
+// reads as a tone, music or noise, so a second of speech keeps the chunk.
+class UploadNonSpeechFilter {
+ public:
+  explicit UploadNonSpeechFilter(const Config& config)
+      : mode_(parse_nonspeech_mode(config.nonspeech_filter)) {
+    if (mode_ != NonSpeechMode::Off) {
+      classifier_.emplace(config.sample_rate);
+    }
   }
-  if (format == "opus_rtp") {
-    return OpusPacketMode::Rtp;
+
+  // True when the chunk should not be decoded.
+  bool drop(span<const float> chunk) {
+    if (!classifier_) {
+      return false;
+    }
+    const auto kind = classifier_->classify_blocks(chunk);
+    if (kind == SegmentClass::Speech) {
+      return false;
+    }
+    const bool dropped = mode_ == NonSpeechMode::Drop;
+    ASRMetrics::instance().observe_nonspeech_segment(kind, dropped);
+    return dropped;
   }
-  return OpusPacketMode::Auto;
+
+ private:
+  NonSpeechMode                    mode_;
+  std::optional<SegmentClassifier> classifier_;
+};
+
+size_t http_chunk_samples(int sample_rate) {
+  return std::max<size_t>(1, static_cast<size_t>(kHttpRecognitionChunkSec * static_cast<float>(sample_rate)));
 }
 
 std::string canonical_whisper_response_language(std::string_view requested_language) {
@@ -166,112 +199,227 @@ struct WsSlotGuard {
     active = false;
   }
 };
-}  // namespace
 
-struct RealtimeConnectionContext {
-  std::shared_ptr<Config>               runtime_config;
-  RealtimeSession                       realtime{0};
-  std::shared_ptr<ASRSession>           session;
-  trantor::EventLoop*                   loop = nullptr;
-  std::unique_ptr<StreamResampler>      resampler;
-  std::unique_ptr<RealtimeOpusDecoder>  opus_decoder;
-  std::mutex                            state_mutex;
-  std::unique_ptr<SerializedTaskQueue>  task_queue;
-  std::atomic<bool>                     stop_processing{false};
-  bool                                  retry_scheduled       = false;
-  bool                                  session_close_pending = false;
-  std::chrono::steady_clock::time_point connected_at;
-  std::chrono::steady_clock::time_point last_event_at;
-  std::string                           close_reason = "normal";
-  std::string                           last_client_event_type;
-  std::string                           last_error;
-  std::vector<uint8_t>                  decoded_audio_bytes;
-  std::vector<float>                    decoded_audio_samples;
-  uint64_t                              connection_id{0};
-  uint64_t                              raw_input_samples{0};  // decoded client-format samples
-  uint64_t                              input_samples{0};      // samples seen by ASR after resampling
-  uint64_t                              append_events{0};
-  uint64_t                              ping_events{0};
-  uint64_t                              invalid_events{0};
-  uint64_t                              decode_errors{0};
-  uint64_t                              committed_events{0};
-  uint64_t                              completed_events{0};
-  uint64_t                              interim_events{0};
-  uint64_t                              speech_started_events{0};
-  uint64_t                              speech_stopped_events{0};
-  double                                max_interevent_gap_sec{0.0};
-  bool                                  speech_active{false};
-  bool                                  metrics_accounted{false};
-};
+// API key from "X-API-Key", "Authorization: Bearer <key>" or, for WebSocket
+// clients that cannot set headers, the "api_key" query parameter.
+std::string request_api_key(const drogon::HttpRequestPtr& req) {
+  const auto& key = req->getHeader("x-api-key");
+  if (!key.empty()) {
+    return trim_ascii(key);
+  }
+  constexpr std::string_view kBearer = "Bearer ";
+  const std::string_view     auth    = req->getHeader("authorization");
+  if (auth.size() > kBearer.size() && auth.substr(0, kBearer.size()) == kBearer) {
+    return trim_ascii(auth.substr(kBearer.size()));
+  }
+  return req->getParameter("api_key");
+}
 
-namespace {
+size_t resolve_tenant(const drogon::HttpRequestPtr& req) {
+  return g_tenants ? g_tenants->resolve(request_api_key(req)) : kDefaultTenant;
+}
 
-int64_t sample_position_ms(const RealtimeConnectionContext& ctx, int64_t sample_position) {
-  if (!ctx.runtime_config || ctx.runtime_config->sample_rate <= 0 || sample_position <= 0) {
-    return 0;
+TenantAdmission admit_tenant(size_t tenant) {
+  if (!g_tenants) {
+    return TenantAdmission::Admitted;
+  }
+  auto&      metrics   = ASRMetrics::instance();
+  const auto admission = g_tenants->try_admit(tenant);
+  if (admission == TenantAdmission::Admitted) {
+    metrics.set_tenant_active(tenant, g_tenants->active(tenant));
+  } else {
+    metrics.observe_tenant_rejection(tenant,
+                                     admission == TenantAdmission::QuotaExceeded ? "quota" : "concurrency");
   }
-  const auto rate = static_cast<int64_t>(ctx.runtime_config->sample_rate);
-  return static_cast<int64_t>((sample_position * 1000LL) / rate);
+  return admission;
 }
 
-template <typename Context>
-void schedule_serial_queue_retry(const std::shared_ptr<Context>& ctx);
-
-template <typename Context>
-void on_serial_task_finished(const std::shared_ptr<Context>& ctx) {
-  if (!ctx || !ctx->task_queue) {
+void release_tenant(size_t tenant) {
+  if (!g_tenants) {
     return;
   }
+  g_tenants->release(tenant);
+  ASRMetrics::instance().set_tenant_active(tenant, g_tenants->active(tenant));
+}
 
-  ctx->task_queue->finish_current();
-  if (ctx->stop_processing.load(std::memory_order_acquire)) {
-    ctx->task_queue->stop(true);
-  } else if (!ctx->task_queue->maybe_start_next() && ctx->task_queue->pending() > 0) {
-    schedule_serial_queue_retry(ctx);
+void charge_tenant_audio(size_t tenant, double audio_sec) {
+  if (g_tenants) {
+    g_tenants->charge_audio(tenant, audio_sec);
   }
+  ASRMetrics::instance().observe_tenant_audio(tenant, audio_sec);
+}
+
+double observe_tenant_queue_wait(size_t tenant, std::chrono::steady_clock::time_point submitted_at) {
+  const double wait_sec =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - submitted_at).count();
+  ASRMetrics::instance().observe_tenant_queue_wait(tenant, wait_sec);
+  return wait_sec;
+}
+
+// "?timings=1" also puts the SERVER_TIMING breakdown into the JSON body.
+bool wants_timing_fields(const drogon::HttpRequestPtr& req) {
+  const auto value = to_lower_ascii(trim_ascii(req->getParameter("timings")));
+  return value == "1" || value == "true";
+}
 
-  if (ctx->session_close_pending && !ctx->task_queue->in_flight() && ctx->session) {
-    ctx->session->on_close();
-    ctx->session_close_pending = false;
+// Admin endpoints take the token only from "X-Admin-Token": "Authorization"
+// already carries tenant API keys. Compared without an early exit.
+bool admin_authorized(const drogon::HttpRequestPtr& req, const std::string& token) {
+  const std::string& presented = req->getHeader("x-admin-token");
+  if (token.empty() || presented.size() != token.size()) {
+    return false;
+  }
+  unsigned char diff = 0;
+  for (size_t i = 0; i < token.size(); ++i) {
+    diff |= static_cast<unsigned char>(presented[i] ^ token[i]);
+  }
+  return diff == 0;
+}
+
+// Numeric query parameter clamped to [lo, hi]; fallback when absent,
+// nullopt when present but not a number.
+std::optional<double> query_number(const drogon::HttpRequestPtr& req, const std::string& key, double fallback,
+                                   double lo, double hi) {
+  const auto& raw = req->getParameter(key);
+  if (raw.empty()) {
+    return fallback;
+  }
+  char*        end   = nullptr;
+  const double value = std::strtod(raw.c_str(), &end);
+  if (end == raw.c_str() || *end != '\0' || !std::isfinite(value)) {
+    return std::nullopt;
   }
+  return std::clamp(value, lo, hi);
 }
 
-template <typename Context>
-void schedule_serial_queue_retry(const std::shared_ptr<Context>& ctx) {
-  if (!ctx || !ctx->loop || !ctx->task_queue || ctx->retry_scheduled || ctx->task_queue->stopped() ||
-      ctx->task_queue->in_flight() || ctx->task_queue->pending() == 0) {
+// Closes the serialization and total spans and attaches the Server-Timing header.
+void add_server_timing_header(const drogon::HttpResponsePtr& resp, RequestTiming& timing,
+                              std::chrono::steady_clock::time_point start_ts,
+                              std::chrono::steady_clock::time_point serialize_start) {
+  const auto now       = std::chrono::steady_clock::now();
+  timing.serialize_sec = std::chrono::duration<double>(now - serialize_start).count();
+  timing.total_sec     = std::chrono::duration<double>(now - start_ts).count();
+  resp->addHeader("Server-Timing", format_server_timing(timing));
+}
+}  // namespace
+
+// WebSocket side of a realtime connection: the loop that owns it and how the
+// inbox drain is scheduled. The inbox is the connection's actor mailbox: the
+// connection's own IO loop pushes events, LoopActor hands the drain to an
+// executor worker, and completions and retries come back to that same loop.
+// Drain tasks capture the raw pointer, so their closures fit std::function's
+// inline storage and reach the executor without a heap allocation.
+struct RealtimeWsContext : RealtimeConnectionContext, LoopActor {
+  using RealtimeConnectionContext::RealtimeConnectionContext;
+
+  trantor::EventLoop*                        loop = nullptr;  // the connection's IO loop
+  std::weak_ptr<drogon::WebSocketConnection> conn;
+  std::unique_ptr<RealtimeRecorder>          recorder;  // REALTIME_RECORD_DIR, loop thread only
+  bool                                       metrics_accounted{false};
+
+ protected:
+  void post(std::function<void()> fn) override {
+    loop->queueInLoop(std::move(fn));
+  }
+  void post_after(double delay_sec, std::function<void()> fn) override {
+    loop->runAfter(delay_sec, std::move(fn));
+  }
+  bool submit_drain() override;
+  bool run_front() override;
+  void on_closed() override;
+};
+
+namespace {
+
+class WsEventSink final : public RealtimeEventSink {
+ public:
+  explicit WsEventSink(const drogon::WebSocketConnectionPtr& conn) : conn_(conn) {}
+
+  void send_text(std::string_view payload) override {
+    conn_->send(payload.data(), payload.size(), drogon::WebSocketMessageType::Text);
+  }
+
+ private:
+  const drogon::WebSocketConnectionPtr& conn_;
+};
+
+// Drain owner: runs the oldest inbox event. Once the connection stops only
+// the overflow report still goes out, and it closes the connection.
+void run_inbox_front(RealtimeWsContext& ctx, const drogon::WebSocketConnectionPtr& conn) {
+  const auto& event    = ctx.inbox.front();
+  const bool  overflow = event.type == RealtimeClientEventType::Overflow;
+  if (!conn || (!overflow && ctx.stop_processing.load(std::memory_order_acquire))) {
     return;
   }
+  WsEventSink sink(conn);
+  run_realtime_event(ctx, sink, event);
+  if (overflow) {
+    conn->shutdown(kCloseTryAgainLater, "Connection queue is full");
+  }
+}
 
-  ctx->retry_scheduled = true;
-  ctx->loop->runAfter(kExecutorRetryDelaySec, [ctx]() {
-    if (!ctx) {
-      return;
-    }
-    ctx->retry_scheduled = false;
-    if (!ctx->task_queue || ctx->task_queue->stopped() ||
-        ctx->stop_processing.load(std::memory_order_acquire)) {
-      return;
-    }
-    if (!ctx->task_queue->maybe_start_next() && ctx->task_queue->pending() > 0) {
-      schedule_serial_queue_retry(ctx);
-    }
-  });
+// Loop thread, once the actor is idle: the counters are final now.
+void finish_realtime_close(RealtimeWsContext& ctx) {
+  if (ctx.session) {
+    ctx.session->on_close();
+  }
+
+  const double duration =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - ctx.connected_at).count();
+  spdlog::info(
+      "RealtimeWS[{}]: connection closed duration={:.1f}s reason={} append_events={} committed={} "
+      "completed={} interim={} speech_started={} speech_stopped={} ping={} invalid={} decode_errors={} "
+      "raw_audio_sec={:.2f} input_audio_sec={:.2f} last_event='{}' last_error='{}' "
+      "max_interevent_gap_sec={:.2f} max_lag_sec={:.2f}",
+      ctx.connection_id, duration, ctx.close_reason, ctx.append_events, ctx.committed_events,
+      ctx.completed_events, ctx.interim_events, ctx.speech_started_events, ctx.speech_stopped_events,
+      ctx.ping_events, ctx.invalid_events, ctx.decode_errors,
+      ctx.realtime.config().input_sample_rate > 0
+          ? static_cast<double>(ctx.raw_input_samples) /
+                static_cast<double>(ctx.realtime.config().input_sample_rate)
+          : 0.0,
+      (ctx.runtime_config && ctx.runtime_config->sample_rate > 0)
+          ? static_cast<double>(ctx.input_samples) / static_cast<double>(ctx.runtime_config->sample_rate)
+          : 0.0,
+      ctx.last_client_event_type, ctx.last_error, ctx.max_interevent_gap_sec, ctx.max_lag_sec);
+
+  if (ctx.metrics_accounted) {
+    ctx.metrics_accounted = false;
+    release_ws_slot();
+    release_tenant(ctx.tenant);
+    ASRMetrics::instance().connection_closed(ctx.close_reason, duration);
+  }
 }
 
-template <typename Context>
-bool enqueue_serial_task(const std::shared_ptr<Context>& ctx, std::function<bool()> start) {
-  if (!ctx || !ctx->task_queue || ctx->stop_processing.load(std::memory_order_acquire)) {
+}  // namespace
+
+bool RealtimeWsContext::submit_drain() {
+  if (!g_asr_executor) {
     return false;
   }
-  const bool accepted = ctx->task_queue->push_or_start(std::move(start));
-  if (accepted && ctx->task_queue->pending() > 0 && !ctx->task_queue->in_flight()) {
-    schedule_serial_queue_retry(ctx);
+  try {
+    return g_asr_executor->try_submit(
+        [this, submitted_at = std::chrono::steady_clock::now()]() {
+          observe_tenant_queue_wait(tenant, submitted_at);
+          run_batch();
+        },
+        tenant);
+  } catch (const std::exception& e) {
+    spdlog::error("RealtimeWS[{}]: failed to enqueue event: {}", connection_id, e.what());
+    ASRMetrics::instance().observe_error("realtime_ws_handler_exception");
+    return false;
   }
-  return accepted;
 }
 
-}  // namespace
+bool RealtimeWsContext::run_front() {
+  run_inbox_front(*this, conn.lock());
+  return inbox.pop();
+}
+
+void RealtimeWsContext::on_closed() {
+  finish_realtime_close(*this);
+}
+
 
 class RealtimeWsController : public drogon::WebSocketController<RealtimeWsController> {
  public:
@@ -295,29 +443,35 @@ class RealtimeWsController : public drogon::WebSocketController<RealtimeWsContro
       return;
     }
 
+    const size_t tenant = resolve_tenant(req);
+    if (const auto admission = admit_tenant(tenant); admission != TenantAdmission::Admitted) {
+      const bool quota = admission == TenantAdmission::QuotaExceeded;
+      ASR_LOG_WARN_EVERY(kCapacityWarnIntervalMs,
+                         "Realtime WS: rejecting connection from {}:{} tenant={}: {}", req->peerAddr().toIp(),
+                         req->peerAddr().toPort(), g_tenants->spec(tenant).name,
+                         quota ? "audio quota exceeded" : "concurrency limit");
+      ASRMetrics::instance().observe_error(quota ? "quota_exceeded" : "capacity_exceeded");
+      conn->shutdown(kCloseTryAgainLater, quota ? "Tenant audio quota exceeded" : "Tenant at capacity");
+      return;
+    }
+    bool tenant_held = true;
+
     try {
-      auto ctx                           = std::make_shared<RealtimeConnectionContext>();
-      ctx->loop                          = drogon::app().getLoop();
-      ctx->task_queue                    = std::make_unique<SerializedTaskQueue>(kRealtimeWsPendingTasks);
-      ctx->connected_at                  = std::chrono::steady_clock::now();
-      ctx->last_event_at                 = ctx->connected_at;
-      ctx->connection_id                 = g_ws_conn_seq.fetch_add(1, std::memory_order_relaxed) + 1;
-      ctx->runtime_config                = std::make_shared<Config>(*g_server_state.config);
-      ctx->runtime_config->max_audio_sec = 0.0F;
-      ctx->runtime_config->live_flush_interval_sec = 5.0F;
-      ctx->realtime =
-          RealtimeSession(ctx->connection_id, make_default_realtime_session_config(*ctx->runtime_config));
-
-      if (ctx->realtime.config().input_sample_rate != ctx->runtime_config->sample_rate) {
-        ctx->resampler = std::make_unique<StreamResampler>(ctx->realtime.config().input_sample_rate,
-                                                           ctx->runtime_config->sample_rate);
-      }
-      const auto vad_cfg = make_realtime_vad_config(*ctx->runtime_config, ctx->realtime.config());
-      ctx->session = std::make_shared<ASRSession>(*g_server_state.recognizer, vad_cfg, *ctx->runtime_config,
-                                                  "realtime_websocket");
+      auto ctx = std::make_shared<RealtimeWsContext>(
+          *g_server_state.recognizer, *g_server_state.config,
+          g_ws_conn_seq.fetch_add(1, std::memory_order_relaxed) + 1, tenant, g_tenants.get(),
+          kRealtimeWsPendingTasks + 2);  // pending events, the one running, and the overflow report
+      ctx->loop              = trantor::EventLoop::getEventLoopOfCurrentThread();
+      ctx->conn              = conn;
       ctx->metrics_accounted = true;
+      if (!g_server_state.config->realtime_record_dir.empty()) {
+        ctx->recorder = RealtimeRecorder::open(g_server_state.config->realtime_record_dir, ctx->connection_id,
+                                               ctx->connected_at,
+                                               g_server_state.config->realtime_record_max_bytes);
+      }
       conn->setContext(ctx);
       slot_guard.release();
+      tenant_held = false;
 
       spdlog::info(
           "RealtimeWS[{}]: connection opened from {}:{} target_sample_rate={} input_format={} input_rate={} "
@@ -331,6 +485,9 @@ class RealtimeWsController : public drogon::WebSocketController<RealtimeWsContro
       ASRMetrics::instance().connection_opened();
     } catch (const std::exception& e) {
       spdlog::error("Realtime WS: failed to initialize connection: {}", e.what());
+      if (tenant_held) {
+        release_tenant(tenant);
+      }
       ASRMetrics::instance().observe_error("internal_error");
       conn->shutdown(drogon::CloseCode::kUnexpectedCondition, "Internal error");
     }
@@ -338,7 +495,8 @@ class RealtimeWsController : public drogon::WebSocketController<RealtimeWsContro
 
   void handleNewMessage(const drogon::WebSocketConnectionPtr& conn, std::string&& msg,
                         const drogon::WebSocketMessageType& type) override {
-    auto ctx = conn->getContext<RealtimeConnectionContext>();
+    const AllocTagScope alloc_scope(AllocTag::Ws);
+    auto ctx = conn->getContext<RealtimeWsContext>();
     if (!ctx || !ctx->session || !ctx->runtime_config) {
       spdlog::error("Realtime WS: No session context");
       return;
@@ -357,256 +515,65 @@ class RealtimeWsController : public drogon::WebSocketController<RealtimeWsContro
     }
     ctx->last_event_at = now;
 
-    if (type == drogon::WebSocketMessageType::Binary) {
-      const std::weak_ptr<drogon::WebSocketConnection> weak_conn = conn;
-      auto payload = std::make_shared<std::string>(std::move(msg));
-      auto start   = [ctx, weak_conn, payload]() -> bool {
-        if (!g_asr_executor) {
-          return false;
-        }
-        return g_asr_executor->try_submit([ctx, weak_conn, payload]() {
-          try {
-            if (auto conn_locked = weak_conn.lock()) {
-              handle_audio_append_binary(conn_locked, *ctx, *payload);
-            }
-          } catch (const RecognizerBusyError& e) {
-            ASRMetrics::instance().observe_error("capacity_exceeded");
-            if (auto conn_locked = weak_conn.lock()) {
-              send_error(conn_locked, *ctx, "server_busy", e.what());
-            }
-          } catch (const AudioError& e) {
-            {
-              const std::scoped_lock lock(ctx->state_mutex);
-              ++ctx->decode_errors;
-            }
-            if (auto conn_locked = weak_conn.lock()) {
-              send_error(conn_locked, *ctx, "audio_decode_error", e.what(), "audio");
-            }
-          } catch (const std::exception& e) {
-            spdlog::error("RealtimeWS[{}]: exception: {}", ctx->connection_id, e.what());
-            ASRMetrics::instance().observe_error("realtime_ws_handler_exception");
-            if (auto conn_locked = weak_conn.lock()) {
-              send_error(conn_locked, *ctx, "internal_error", e.what());
-            }
-          }
-
-          if (ctx->loop) {
-            ctx->loop->queueInLoop([ctx]() { on_serial_task_finished(ctx); });
-          }
-        });
-      };
-
-      if (!enqueue_serial_task(ctx, std::move(start))) {
-        ASRMetrics::instance().observe_error("capacity_exceeded");
-        ASR_LOG_WARN_EVERY(kCapacityWarnIntervalMs, "RealtimeWS[{}]: connection task queue is full",
-                           ctx->connection_id);
-        send_error(conn, *ctx, "server_busy", "Connection queue is full");
-        ctx->close_reason = "capacity_exceeded";
-        ctx->stop_processing.store(true, std::memory_order_release);
-        if (ctx->task_queue) {
-          ctx->task_queue->stop(true);
-        }
-        conn->shutdown(kCloseTryAgainLater, "Connection queue is full");
-      }
-      return;
-    }
-
-    if (type != drogon::WebSocketMessageType::Text) {
+    if (type != drogon::WebSocketMessageType::Binary && type != drogon::WebSocketMessageType::Text) {
       spdlog::debug("RealtimeWS[{}]: ignoring non-text frame type={}", ctx->connection_id,
                     static_cast<int>(type));
       return;
     }
-
-    nlohmann::json event;
-    try {
-      event = nlohmann::json::parse(msg);
-    } catch (const nlohmann::json::exception&) {
-      ++ctx->invalid_events;
-      send_error(conn, *ctx, "invalid_json", "Invalid JSON payload");
-      return;
+    if (ctx->recorder) {
+      ctx->recorder->record(type == drogon::WebSocketMessageType::Binary ? RealtimeRecordKind::Binary
+                                                                          : RealtimeRecordKind::Text,
+                            now, msg);
     }
 
-    if (!event.is_object()) {
-      ++ctx->invalid_events;
-      send_error(conn, *ctx, "invalid_event", "JSON event must be an object");
+    if (ctx->stop_processing.load(std::memory_order_acquire)) {
       return;
     }
 
-    const std::string client_event_id = read_client_event_id(event);
-    if (!event.contains("type") || !event["type"].is_string()) {
-      ++ctx->invalid_events;
-      send_error(conn, *ctx, "invalid_event_type", "Event 'type' must be a string", "type", client_event_id);
+    // The inbox keeps one slot beyond the pending bound, so a message can
+    // always be parsed and an overflow is reported in order by the actor.
+    auto* event = ctx->inbox.back_slot();
+    if (event == nullptr) {
       return;
     }
 
-    const std::string event_type = event["type"].get<std::string>();
-    ctx->last_client_event_type  = event_type;
-
-    if (event_type == "ping" || event_type == "noop") {
-      ++ctx->ping_events;
-      return;
-    }
-
-    const std::weak_ptr<drogon::WebSocketConnection> weak_conn = conn;
-    auto event_ptr           = std::make_shared<nlohmann::json>(std::move(event));
-    auto event_type_ptr      = std::make_shared<const std::string>(event_type);
-    auto client_event_id_ptr = std::make_shared<const std::string>(client_event_id);
-    auto start               = [ctx, weak_conn, event_ptr, event_type_ptr, client_event_id_ptr]() -> bool {
-      try {
-        if (!g_asr_executor) {
-          return false;
-        }
-        return g_asr_executor->try_submit([ctx, weak_conn, event_ptr, event_type_ptr, client_event_id_ptr]() {
-          try {
-            if (auto conn_locked = weak_conn.lock()) {
-              const auto& event_type      = *event_type_ptr;
-              const auto& client_event_id = *client_event_id_ptr;
-              if (event_type == "transcription_session.update" || event_type == "session.update") {
-                handle_session_update(conn_locked, *ctx, *event_ptr, client_event_id);
-              } else if (event_type == "input_audio_buffer.append") {
-                handle_audio_append(conn_locked, *ctx, *event_ptr, client_event_id);
-              } else if (event_type == "input_audio_buffer.commit") {
-                handle_audio_commit(conn_locked, *ctx);
-              } else if (event_type == "input_audio_buffer.clear") {
-                handle_audio_clear(conn_locked, *ctx);
-              } else {
-                {
-                  const std::scoped_lock lock(ctx->state_mutex);
-                  ++ctx->invalid_events;
-                }
-                ASR_LOG_WARN_EVERY(kHotPathWarnIntervalMs,
-                                   "RealtimeWS[{}]: unknown event type='{}' event_id='{}'",
-                                   ctx->connection_id, event_type, client_event_id);
-                send_error(conn_locked, *ctx, "unknown_event_type", "Unsupported event type", "type",
-                           client_event_id);
-              }
-            }
-          } catch (const RecognizerBusyError& e) {
-            ASRMetrics::instance().observe_error("capacity_exceeded");
-            if (auto conn_locked = weak_conn.lock()) {
-              send_error(conn_locked, *ctx, "server_busy", e.what());
-            }
-          } catch (const AudioError& e) {
-            {
-              const std::scoped_lock lock(ctx->state_mutex);
-              ++ctx->decode_errors;
-            }
-            if (auto conn_locked = weak_conn.lock()) {
-              send_error(conn_locked, *ctx, "audio_decode_error", e.what(), "audio", *client_event_id_ptr);
-            }
-          } catch (const std::exception& e) {
-            spdlog::error("RealtimeWS[{}]: exception: {}", ctx->connection_id, e.what());
-            ASRMetrics::instance().observe_error("realtime_ws_handler_exception");
-            if (auto conn_locked = weak_conn.lock()) {
-              send_error(conn_locked, *ctx, "internal_error", e.what(), "", *client_event_id_ptr);
-            }
-          } catch (...) {
-            spdlog::error("RealtimeWS[{}]: exception: unknown", ctx->connection_id);
-            ASRMetrics::instance().observe_error("realtime_ws_handler_exception");
-            if (auto conn_locked = weak_conn.lock()) {
-              send_error(conn_locked, *ctx, "internal_error", "Unknown internal error", "",
-                         *client_event_id_ptr);
-            }
-          }
-
-          if (ctx->loop) {
-            ctx->loop->queueInLoop([ctx]() { on_serial_task_finished(ctx); });
-          }
-        });
-      } catch (const std::exception& e) {
-        spdlog::error("RealtimeWS[{}]: failed to enqueue event '{}': {}", ctx->connection_id, *event_type_ptr,
-                      e.what());
-        ASRMetrics::instance().observe_error("realtime_ws_handler_exception");
-        return false;
-      } catch (...) {
-        spdlog::error("RealtimeWS[{}]: failed to enqueue event '{}': unknown exception", ctx->connection_id,
-                      *event_type_ptr);
-        ASRMetrics::instance().observe_error("realtime_ws_handler_exception");
-        return false;
+    if (type == drogon::WebSocketMessageType::Binary) {
+      set_realtime_binary_event(std::move(msg), *event);
+    } else {
+      const auto status = parse_realtime_client_event(std::move(msg), *event);
+      switch (status) {
+        case RealtimeParseStatus::InvalidJson:
+        case RealtimeParseStatus::NotObject:
+        case RealtimeParseStatus::MissingType:
+          event->type         = RealtimeClientEventType::Invalid;
+          event->parse_status = status;
+          break;
+        case RealtimeParseStatus::Ping:
+          ctx->last_client_event_type.assign(event->event_type);
+          ++ctx->ping_events;
+          return;
+        case RealtimeParseStatus::Ok:
+          ctx->last_client_event_type.assign(event->event_type);
+          break;
       }
-    };
+    }
 
-    if (!enqueue_serial_task(ctx, std::move(start))) {
-      ASRMetrics::instance().observe_error("capacity_exceeded");
-      ASR_LOG_WARN_EVERY(kCapacityWarnIntervalMs, "RealtimeWS[{}]: connection task queue is full",
-                         ctx->connection_id);
-      send_error(conn, *ctx, "server_busy", "Connection queue is full", "", client_event_id);
-      ctx->close_reason = "capacity_exceeded";
-      ctx->stop_processing.store(true, std::memory_order_release);
-      if (ctx->task_queue) {
-        ctx->task_queue->stop(true);
-      }
-      conn->shutdown(kCloseTryAgainLater, "Connection queue is full");
+    event->received_at = now;
+    if (ctx->inbox.size() > kRealtimeWsPendingTasks) {
+      reject_queue_full(ctx, *event);
+      return;
     }
+    ctx->pushed(ctx, ctx->inbox.push());
   }
 
   void handleConnectionClosed(const drogon::WebSocketConnectionPtr& conn) override {
-    auto ctx = conn->getContext<RealtimeConnectionContext>();
-    if (ctx) {
-      ctx->stop_processing.store(true, std::memory_order_release);
-      if (ctx->task_queue) {
-        ctx->task_queue->stop(true);
-      }
-      if (ctx->session) {
-        if (ctx->task_queue && ctx->task_queue->in_flight()) {
-          ctx->session_close_pending = true;
-        } else {
-          ctx->session->on_close();
-        }
-      }
-    }
-
-    const auto   now           = std::chrono::steady_clock::now();
-    const double duration      = ctx ? std::chrono::duration<double>(now - ctx->connected_at).count() : 0.0;
-    std::string  reason        = "normal";
-    uint64_t     append_events = 0;
-    uint64_t     committed_events      = 0;
-    uint64_t     completed_events      = 0;
-    uint64_t     interim_events        = 0;
-    uint64_t     speech_started_events = 0;
-    uint64_t     speech_stopped_events = 0;
-    uint64_t     decode_errors         = 0;
-    uint64_t     raw_input_samples     = 0;
-    uint64_t     input_samples         = 0;
-    std::string  last_error;
-    if (ctx) {
-      const std::scoped_lock lock(ctx->state_mutex);
-      reason                = ctx->close_reason;
-      append_events         = ctx->append_events;
-      committed_events      = ctx->committed_events;
-      completed_events      = ctx->completed_events;
-      interim_events        = ctx->interim_events;
-      speech_started_events = ctx->speech_started_events;
-      speech_stopped_events = ctx->speech_stopped_events;
-      decode_errors         = ctx->decode_errors;
-      raw_input_samples     = ctx->raw_input_samples;
-      input_samples         = ctx->input_samples;
-      last_error            = ctx->last_error;
-    }
-
-    spdlog::info(
-        "RealtimeWS[{}]: connection closed duration={:.1f}s reason={} append_events={} committed={} "
-        "completed={} interim={} speech_started={} speech_stopped={} ping={} invalid={} decode_errors={} "
-        "raw_audio_sec={:.2f} input_audio_sec={:.2f} last_event='{}' last_error='{}' "
-        "max_interevent_gap_sec={:.2f}",
-        ctx ? ctx->connection_id : 0, duration, reason, append_events, committed_events, completed_events,
-        interim_events, speech_started_events, speech_stopped_events, ctx ? ctx->ping_events : 0,
-        ctx ? ctx->invalid_events : 0, decode_errors,
-        (ctx && ctx->realtime.config().input_sample_rate > 0)
-            ? static_cast<double>(raw_input_samples) /
-                  static_cast<double>(ctx->realtime.config().input_sample_rate)
-            : 0.0,
-        (ctx && ctx->runtime_config && ctx->runtime_config->sample_rate > 0)
-            ? static_cast<double>(input_samples) / static_cast<double>(ctx->runtime_config->sample_rate)
-            : 0.0,
-        ctx ? ctx->last_client_event_type : "<none>", ctx ? last_error : "<none>",
-        ctx ? ctx->max_interevent_gap_sec : 0.0);
-
-    if (ctx && ctx->metrics_accounted) {
-      ctx->metrics_accounted = false;
-      release_ws_slot();
-      ASRMetrics::instance().connection_closed(reason, duration);
+    auto ctx = conn->getContext<RealtimeWsContext>();
+    if (!ctx) {
+      spdlog::info("RealtimeWS: connection closed before its context was set up");
+      return;
     }
+    ctx->recorder.reset();
+    ctx->closed();
   }
 
   WS_PATH_LIST_BEGIN
@@ -616,356 +583,18 @@ class RealtimeWsController : public drogon::WebSocketController<RealtimeWsContro
 #pragma GCC diagnostic pop
   WS_PATH_LIST_END
 
- private:
-  static std::string read_client_event_id(const nlohmann::json& event) {
-    if (event.contains("event_id") && event["event_id"].is_string()) {
-      return event["event_id"].get<std::string>();
-    }
-    return {};
-  }
-
-  static void send_error(const drogon::WebSocketConnectionPtr& conn, RealtimeConnectionContext& ctx,
-                         const std::string& code, const std::string& message, const std::string& param = "",
-                         const std::string& client_event_id = "") {
-    {
-      const std::scoped_lock lock(ctx.state_mutex);
-      ctx.last_error = code + ":" + message;
-    }
-    conn->send(ctx.realtime.event_error(code, message, param, client_event_id),
-               drogon::WebSocketMessageType::Text);
-  }
-
-  static void rebuild_pipeline(RealtimeConnectionContext& ctx) {
-    const auto& realtime_cfg = ctx.realtime.config();
-
-    *ctx.runtime_config                         = *g_server_state.config;
-    ctx.runtime_config->max_audio_sec           = 0.0F;
-    ctx.runtime_config->live_flush_interval_sec = 5.0F;
-    if (realtime_cfg.turn_detection.has_value()) {
-      const auto& turn                    = realtime_cfg.turn_detection.value();
-      ctx.runtime_config->vad_threshold   = turn.threshold;
-      ctx.runtime_config->vad_min_silence = static_cast<float>(turn.silence_duration_ms) / 1000.0F;
-    }
-
-    if (realtime_cfg.input_sample_rate != ctx.runtime_config->sample_rate) {
-      ctx.resampler =
-          std::make_unique<StreamResampler>(realtime_cfg.input_sample_rate, ctx.runtime_config->sample_rate);
-    } else {
-      ctx.resampler.reset();
-    }
-
-    if (is_realtime_opus_format(realtime_cfg.input_audio_format)) {
-      ctx.opus_decoder =
-          std::make_unique<RealtimeOpusDecoder>(realtime_cfg.input_sample_rate, 8, true,
-                                                realtime_opus_packet_mode(realtime_cfg.input_audio_format));
-    } else {
-      ctx.opus_decoder.reset();
-    }
-
-    ctx.decoded_audio_bytes.clear();
-    ctx.decoded_audio_samples.clear();
-    ctx.decoded_audio_bytes.reserve(static_cast<size_t>(64U) * static_cast<size_t>(1024U));
-    ctx.decoded_audio_samples.reserve(static_cast<size_t>(ctx.runtime_config->sample_rate));
-
-    const auto vad_cfg = make_realtime_vad_config(*ctx.runtime_config, realtime_cfg);
-    ctx.session       = std::make_shared<ASRSession>(*g_server_state.recognizer, vad_cfg, *ctx.runtime_config,
-                                                     "realtime_websocket");
-    ctx.speech_active = false;
-    ctx.realtime.clear_current_item();
-  }
-
-  static size_t emit_transcription_events(const drogon::WebSocketConnectionPtr&   conn,
-                                          RealtimeConnectionContext&              ctx,
-                                          asr::span<const ASRSession::OutMessage> out_messages) {
-    size_t finals = 0;
-    for (const auto& out : out_messages) {
-      if (out.type != ASRSession::OutMessage::Final) {
-        continue;
-      }
-      if (out.text.empty()) {
-        continue;
-      }
-
-      const auto commit = ctx.realtime.commit_current_item();
-      conn->send(ctx.realtime.event_buffer_committed(commit), drogon::WebSocketMessageType::Text);
-      conn->send(ctx.realtime.event_transcription_completed(commit.item_id, out.text),
-                 drogon::WebSocketMessageType::Text);
-      uint64_t append_events = 0;
-      size_t   input_samples = 0;
-      {
-        const std::scoped_lock lock(ctx.state_mutex);
-        ++ctx.committed_events;
-        ++ctx.completed_events;
-        append_events = ctx.append_events;
-        input_samples = ctx.input_samples;
-      }
-      ++finals;
-      spdlog::debug(
-          "RealtimeWS[{}]: transcription.completed item_id={} previous_item_id={} text_len={} "
-          "append_events={} input_audio_sec={:.2f}",
-          ctx.connection_id, commit.item_id,
-          commit.previous_item_id.empty() ? "<none>" : commit.previous_item_id, out.text.size(),
-          append_events,
-          (ctx.runtime_config && ctx.runtime_config->sample_rate > 0)
-              ? static_cast<double>(input_samples) / static_cast<double>(ctx.runtime_config->sample_rate)
-              : 0.0);
-    }
-    return finals;
-  }
-
-  static void emit_speech_transition_events(const drogon::WebSocketConnectionPtr& conn,
-                                            RealtimeConnectionContext&            ctx) {
-    if (!ctx.realtime.config().turn_detection.has_value()) {
-      return;
-    }
-
-    while (ctx.session->has_speech_transition()) {
-      const auto& transition    = ctx.session->front_speech_transition();
-      const auto  pos_ms        = sample_position_ms(ctx, transition.sample);
-      const auto  item_id       = ctx.realtime.ensure_current_item_id();
-      uint64_t    append_events = 0;
-      if (transition.kind == ASRSession::SpeechTransition::Started) {
-        conn->send(ctx.realtime.event_speech_started(pos_ms), drogon::WebSocketMessageType::Text);
-        ctx.speech_active = true;
-        {
-          const std::scoped_lock lock(ctx.state_mutex);
-          ++ctx.speech_started_events;
-          append_events = ctx.append_events;
-        }
-        spdlog::debug("RealtimeWS[{}]: speech_started item_id={} audio_start_ms={} append_events={}",
-                      ctx.connection_id, item_id, pos_ms, append_events);
-      } else {
-        conn->send(ctx.realtime.event_speech_stopped(pos_ms), drogon::WebSocketMessageType::Text);
-        ctx.speech_active = false;
-        {
-          const std::scoped_lock lock(ctx.state_mutex);
-          ++ctx.speech_stopped_events;
-          append_events = ctx.append_events;
-        }
-        spdlog::debug("RealtimeWS[{}]: speech_stopped item_id={} audio_end_ms={} append_events={}",
-                      ctx.connection_id, item_id, pos_ms, append_events);
-      }
-      ctx.session->pop_speech_transition();
-    }
-  }
-
-  static void handle_session_update(const drogon::WebSocketConnectionPtr& conn,
-                                    RealtimeConnectionContext& ctx, const nlohmann::json& event,
-                                    const std::string& client_event_id) {
-    if (!event.contains("session")) {
-      send_error(conn, ctx, "missing_session", "Event must include 'session' object", "session",
-                 client_event_id);
-      return;
-    }
-
-    std::string error_message;
-    if (!ctx.realtime.apply_session_update(event["session"], &error_message)) {
-      send_error(conn, ctx, "invalid_session_update", error_message, "session", client_event_id);
-      return;
-    }
-
-    rebuild_pipeline(ctx);
-    conn->send(ctx.realtime.event_session_updated(), drogon::WebSocketMessageType::Text);
-    const auto& realtime_cfg = ctx.realtime.config();
-    if (realtime_cfg.turn_detection.has_value()) {
-      const auto& turn = realtime_cfg.turn_detection.value();
-      spdlog::info(
-          "RealtimeWS[{}]: session.update applied event_id='{}' input_format={} input_rate={} "
-          "turn=server_vad threshold={:.3f} prefix_padding_ms={} silence_ms={}",
-          ctx.connection_id, client_event_id, realtime_cfg.input_audio_format, realtime_cfg.input_sample_rate,
-          turn.threshold, turn.prefix_padding_ms, turn.silence_duration_ms);
-    } else {
-      spdlog::info(
-          "RealtimeWS[{}]: session.update applied event_id='{}' input_format={} input_rate={} turn=null",
-          ctx.connection_id, client_event_id, realtime_cfg.input_audio_format,
-          realtime_cfg.input_sample_rate);
-    }
-  }
-
-  static span<const float> decode_append_samples(RealtimeConnectionContext& ctx,
-                                                 span<const uint8_t>        audio_bytes) {
-    const auto& format = ctx.realtime.config().input_audio_format;
-    if (format.empty() || format == "pcm16") {
-      pcm16_to_float32_into(audio_bytes, ctx.decoded_audio_samples);
-      return ctx.decoded_audio_samples;
-    }
-
-    if (is_realtime_opus_format(format)) {
-      if (!ctx.opus_decoder) {
-        ctx.opus_decoder = std::make_unique<RealtimeOpusDecoder>(ctx.realtime.config().input_sample_rate, 8,
-                                                                 true, realtime_opus_packet_mode(format));
-      }
-      return ctx.opus_decoder->decode_packet(audio_bytes);
-    }
-
-    throw AudioError("Unsupported realtime audio format '" + format + "'");
-  }
-
-  static void process_audio_append_samples(const drogon::WebSocketConnectionPtr& conn,
-                                           RealtimeConnectionContext& ctx, span<const float> samples,
-                                           const std::string& client_event_id, const char* payload_label,
-                                           size_t payload_size) {
-    {
-      const std::scoped_lock lock(ctx.state_mutex);
-      ++ctx.append_events;
-      ctx.raw_input_samples += samples.size();
-    }
-
-    asr::span<const ASRSession::OutMessage> out_messages;
-    size_t                                  asr_samples_in = 0;
-    if (ctx.resampler) {
-      auto resampled = ctx.resampler->process(samples);
-      {
-        const std::scoped_lock lock(ctx.state_mutex);
-        ctx.input_samples += resampled.size();
-      }
-      asr_samples_in = resampled.size();
-      out_messages   = ctx.session->on_audio(resampled);
-    } else {
-      {
-        const std::scoped_lock lock(ctx.state_mutex);
-        ctx.input_samples += samples.size();
-      }
-      asr_samples_in = samples.size();
-      out_messages   = ctx.session->on_audio(samples);
-    }
-
-    size_t interim_count = 0;
-    size_t final_count   = 0;
-    for (const auto& out : out_messages) {
-      if (out.type == ASRSession::OutMessage::Interim) {
-        ++interim_count;
-      } else if (out.type == ASRSession::OutMessage::Final) {
-        ++final_count;
-      }
-    }
-    {
-      const std::scoped_lock lock(ctx.state_mutex);
-      ctx.interim_events += interim_count;
-    }
-
-    emit_speech_transition_events(conn, ctx);
-    const size_t emitted_finals = emit_transcription_events(conn, ctx, out_messages);
-
-    uint64_t append_events = 0;
-    size_t   input_samples = 0;
-    {
-      const std::scoped_lock lock(ctx.state_mutex);
-      append_events = ctx.append_events;
-      input_samples = ctx.input_samples;
-    }
-
-    if (append_events == 1 || append_events % 250 == 0 || emitted_finals > 0) {
-      const double input_audio_sec =
-          (ctx.runtime_config && ctx.runtime_config->sample_rate > 0)
-              ? static_cast<double>(input_samples) / static_cast<double>(ctx.runtime_config->sample_rate)
-              : 0.0;
-      uint64_t opus_lost = 0;
-      uint64_t opus_plc  = 0;
-      uint64_t opus_fec  = 0;
-      uint64_t opus_dup  = 0;
-      uint64_t opus_ooo  = 0;
-      if (ctx.opus_decoder && is_realtime_opus_format(ctx.realtime.config().input_audio_format)) {
-        const auto& stats = ctx.opus_decoder->stats();
-        opus_lost         = stats.lost_packets;
-        opus_plc          = stats.plc_packets;
-        opus_fec          = stats.fec_packets;
-        opus_dup          = stats.duplicate_packets;
-        opus_ooo          = stats.out_of_order_packets;
-      }
-
-      spdlog::debug(
-          "RealtimeWS[{}]: append#{} event_id='{}' {}={} decoded_samples={} asr_samples={} "
-          "interim={} final={} speech_active={} input_audio_sec={:.2f} "
-          "opus_lost={} opus_plc={} opus_fec={} opus_dup={} opus_ooo={}",
-          ctx.connection_id, append_events, client_event_id, payload_label, payload_size, samples.size(),
-          asr_samples_in, interim_count, final_count, ctx.speech_active ? "true" : "false", input_audio_sec,
-          opus_lost, opus_plc, opus_fec, opus_dup, opus_ooo);
-    }
-  }
-
-  static void handle_audio_append(const drogon::WebSocketConnectionPtr& conn, RealtimeConnectionContext& ctx,
-                                  const nlohmann::json& event, const std::string& client_event_id) {
-    if (!event.contains("audio") || !event["audio"].is_string()) {
-      send_error(conn, ctx, "invalid_audio", "Event must include base64 string field 'audio'", "audio",
-                 client_event_id);
-      return;
-    }
 
-    const auto& b64_audio = event["audio"].get_ref<const std::string&>();
-    base64_decode_into(b64_audio, ctx.decoded_audio_bytes);
-    auto samples = decode_append_samples(ctx, ctx.decoded_audio_bytes);
-    process_audio_append_samples(conn, ctx, samples, client_event_id, "b64_len", b64_audio.size());
-  }
-
-  static void handle_audio_append_binary(const drogon::WebSocketConnectionPtr& conn,
-                                         RealtimeConnectionContext& ctx, const std::string& payload) {
-    auto bytes   = asr::span<const uint8_t>(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
-    auto samples = decode_append_samples(ctx, bytes);
-    process_audio_append_samples(conn, ctx, samples, "<binary>", "bin_len", payload.size());
-  }
-
-  static void handle_audio_commit(const drogon::WebSocketConnectionPtr& conn,
-                                  RealtimeConnectionContext&            ctx) {
-    uint64_t append_events = 0;
-    {
-      const std::scoped_lock lock(ctx.state_mutex);
-      append_events = ctx.append_events;
-    }
-    spdlog::debug("RealtimeWS[{}]: input_audio_buffer.commit requested append_events={} speech_active={}",
-                  ctx.connection_id, append_events, ctx.speech_active ? "true" : "false");
-
-    size_t finals = 0;
-    if (ctx.resampler) {
-      auto tail = ctx.resampler->flush();
-      if (!tail.empty()) {
-        {
-          const std::scoped_lock lock(ctx.state_mutex);
-          ctx.input_samples += tail.size();
-        }
-        const auto out_messages = ctx.session->on_audio(tail);
-        emit_speech_transition_events(conn, ctx);
-        finals += emit_transcription_events(conn, ctx, out_messages);
-      }
-    }
-
-    const auto recognize_messages = ctx.session->on_recognize();
-    emit_speech_transition_events(conn, ctx);
-    finals += emit_transcription_events(conn, ctx, recognize_messages);
-    if (finals == 0) {
-      const auto commit = ctx.realtime.commit_current_item();
-      conn->send(ctx.realtime.event_buffer_committed(commit), drogon::WebSocketMessageType::Text);
-      {
-        const std::scoped_lock lock(ctx.state_mutex);
-        ++ctx.committed_events;
-      }
-      spdlog::debug("RealtimeWS[{}]: commit without final item_id={} previous_item_id={}", ctx.connection_id,
-                    commit.item_id, commit.previous_item_id.empty() ? "<none>" : commit.previous_item_id);
-    }
-    ctx.speech_active        = false;
-    uint64_t committed_total = 0;
-    uint64_t completed_total = 0;
-    {
-      const std::scoped_lock lock(ctx.state_mutex);
-      committed_total = ctx.committed_events;
-      completed_total = ctx.completed_events;
-    }
-    spdlog::debug("RealtimeWS[{}]: commit completed finals={} committed_total={} completed_total={}",
-                  ctx.connection_id, finals, committed_total, completed_total);
-  }
-
-  static void handle_audio_clear(const drogon::WebSocketConnectionPtr& conn, RealtimeConnectionContext& ctx) {
-    ctx.session->on_reset();
-    if (ctx.resampler) {
-      ctx.resampler->reset();
-    }
-    if (ctx.opus_decoder) {
-      ctx.opus_decoder->reset();
-    }
-    ctx.speech_active = false;
-    ctx.realtime.clear_current_item();
-    conn->send(ctx.realtime.event_buffer_cleared(), drogon::WebSocketMessageType::Text);
-    spdlog::debug("RealtimeWS[{}]: input_audio_buffer.clear applied", ctx.connection_id);
+ private:
+  // Turns the event into an overflow report; the actor skips the events
+  // ahead of it, sends the error and closes the connection.
+  static void reject_queue_full(const std::shared_ptr<RealtimeWsContext>& ctx, RealtimeInboundEvent& event) {
+    ASRMetrics::instance().observe_error("capacity_exceeded");
+    ASR_LOG_WARN_EVERY(kCapacityWarnIntervalMs, "RealtimeWS[{}]: connection task queue is full",
+                       ctx->connection_id);
+    ctx->close_reason = "capacity_exceeded";
+    ctx->stop_processing.store(true, std::memory_order_release);
+    event.type = RealtimeClientEventType::Overflow;
+    ctx->pushed(ctx, ctx->inbox.push());
   }
 };
 
@@ -1008,9 +637,160 @@ struct RequestSemaphore {
 
 RequestSemaphore g_request_sem;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
+void release_request_slot(size_t tenant) {
+  g_request_sem.release();
+  release_tenant(tenant);
+}
+
+// One upload request on the executor, shared by /recognize, /recognize/raw
+// and the Whisper API: decode the body in chunks, recognize each chunk,
+// record metrics and reply through the request's loop. The handler supplies
+// how to decode its body and how to render the transcript and errors.
+struct UploadJob {
+  using Decoder = std::function<AudioStreamStats(const AudioChunkCallback& on_chunk)>;
+  // timings is null unless the client asked for them in the body.
+  using Renderer = std::function<drogon::HttpResponsePtr(const std::string& text, float duration_sec,
+                                                         const RequestTiming* timings)>;
+  // Body only; run_upload_job() records the error metrics.
+  using ErrorRenderer = std::function<drogon::HttpResponsePtr(
+      drogon::HttpStatusCode status, const std::string& detail, const std::string& error_type)>;
+
+  Decoder                                                              decode;
+  Renderer                                                             render;
+  ErrorRenderer                                                        render_error;
+  MetricMode                                                           transport     = MetricMode::Http;
+  size_t                                                               body_bytes    = 0;
+  size_t                                                               tenant        = 0;
+  bool                                                                 timing_fields = false;
+  std::chrono::steady_clock::time_point                                start_ts;
+  std::chrono::steady_clock::time_point                                submitted_at;
+  trantor::EventLoop*                                                  request_loop = nullptr;
+  std::shared_ptr<std::function<void(const drogon::HttpResponsePtr&)>> callback;
+};
+
+void run_upload_job(const Config& config, RecognizerBackend& recognizer, const UploadJob& job) {
+  auto reply = [&job](const drogon::HttpResponsePtr& resp) {
+    job.request_loop->queueInLoop([callback = job.callback, resp]() { (*callback)(resp); });
+  };
+  auto fail = [&job, &reply](drogon::HttpStatusCode status, const std::string& detail,
+                             const std::string& error_type) {
+    auto  resp    = job.render_error(status, detail, error_type);
+    auto& metrics = ASRMetrics::instance();
+    metrics.observe_error(error_type);
+    const auto end = std::chrono::steady_clock::now();
+    metrics.observe_request(std::chrono::duration<double>(end - job.start_ts).count(), 0.0, 0.0, 0, 0, 0.0,
+                            0.0, job.transport, "failed");
+    metrics.session_ended(0.0);
+    release_request_slot(job.tenant);
+    reply(resp);
+  };
+
+  RequestTiming timing;
+  timing.queue_sec = observe_tenant_queue_wait(job.tenant, job.submitted_at);
+  try {
+    std::string           text;
+    double                decode_sec = 0.0;
+    std::optional<double> ttfr_sec;
+
+    UploadNonSpeechFilter nonspeech(config);
+    auto on_chunk = [&config, &recognizer, &job, &text, &decode_sec, &ttfr_sec,
+                     &nonspeech](span<const float> chunk) {
+      if (nonspeech.drop(chunk)) {
+        return;
+      }
+      auto t0       = std::chrono::steady_clock::now();
+      auto chunk_tx = recognizer.recognize(chunk, config.sample_rate);
+      auto t1       = std::chrono::steady_clock::now();
+      decode_sec += std::chrono::duration<double>(t1 - t0).count();
+      if (!ttfr_sec.has_value()) {
+        ttfr_sec = std::chrono::duration<double>(t1 - job.start_ts).count();
+      }
+      append_transcription_chunk(text, chunk_tx);
+    };
+
+    RecognizerWaitScope wait_scope;
+    auto                pipeline_start = std::chrono::steady_clock::now();
+    const auto          audio          = job.decode(on_chunk);
+    auto                pipeline_end   = std::chrono::steady_clock::now();
+    const double        pipeline_sec   = std::chrono::duration<double>(pipeline_end - pipeline_start).count();
+    const double        preprocess_sec = std::max(0.0, pipeline_sec - decode_sec);
+    timing.recognizer_wait_sec         = wait_scope.seconds();
+    timing.resample_sec                = audio.resample_sec;
+    split_decode_time(timing, pipeline_sec, decode_sec);
+
+    auto         end_ts    = std::chrono::steady_clock::now();
+    const double total_sec = std::chrono::duration<double>(end_ts - job.start_ts).count();
+
+    charge_tenant_audio(job.tenant, static_cast<double>(audio.duration_sec));
+
+    auto& metrics = ASRMetrics::instance();
+    if (ttfr_sec.has_value()) {
+      metrics.observe_ttfr(*ttfr_sec, job.transport);
+    }
+    metrics.observe_segment(static_cast<double>(audio.duration_sec), decode_sec);
+    metrics.observe_request(total_sec, static_cast<double>(audio.duration_sec), decode_sec, 1, job.body_bytes,
+                            preprocess_sec, 0.0, job.transport, "success");
+    metrics.record_result(text);
+    metrics.session_ended(total_sec);
+
+    const auto serialize_start = std::chrono::steady_clock::now();
+    if (job.timing_fields) {
+      timing.total_sec = std::chrono::duration<double>(serialize_start - job.start_ts).count();
+    }
+    auto resp = job.render(text, audio.duration_sec, job.timing_fields ? &timing : nullptr);
+    if (config.server_timing) {
+      add_server_timing_header(resp, timing, job.start_ts, serialize_start);
+    }
+    reply(resp);
+  } catch (const RecognizerBusyError& e) {
+    fail(drogon::k503ServiceUnavailable, e.what(), "capacity_exceeded");
+    return;
+  } catch (const AudioError& e) {
+    fail(drogon::k400BadRequest, e.what(), "invalid_audio");
+    return;
+  } catch (const std::exception& e) {
+    fail(drogon::k500InternalServerError, e.what(), "internal_error");
+    return;
+  } catch (...) {
+    fail(drogon::k500InternalServerError, "Unknown internal error", "internal_error");
+    return;
+  }
+
+  release_request_slot(job.tenant);
+}
+
+// {"detail": ...} body of the native /recognize endpoints.
+drogon::HttpResponsePtr detail_error_response(drogon::HttpStatusCode status, const std::string& detail,
+                                              const std::string& /*error_type*/) {
+  nlohmann::json err;
+  err["detail"] = detail;
+  auto resp     = drogon::HttpResponse::newHttpResponse();
+  resp->setStatusCode(status);
+  resp->setBody(err.dump());
+  resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+  return resp;
+}
+
+// {"text", "duration", "timings"?} body of the native /recognize endpoints.
+drogon::HttpResponsePtr transcript_response(const std::string& text, float duration_sec,
+                                            const RequestTiming* timings) {
+  nlohmann::json j;
+  j["text"]     = text;
+  j["duration"] = duration_sec;
+  if (timings != nullptr) {
+    j["timings"] = request_timing_json(*timings);
+  }
+  auto resp = drogon::HttpResponse::newHttpResponse();
+  resp->setStatusCode(drogon::k200OK);
+  resp->setBody(j.dump());
+  resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+  return resp;
+}
+
 }  // namespace
 
-Server::Server(const Config& config, Recognizer& recognizer) : config_(config), recognizer_(recognizer) {
+Server::Server(const Config& config, RecognizerBackend& recognizer)
+    : config_(config), recognizer_(recognizer) {
   vad_config_.model_path           = config.vad_model;
   vad_config_.threshold            = config.vad_threshold;
   vad_config_.min_silence_duration = config.vad_min_silence;
@@ -1028,8 +808,21 @@ Server::Server(const Config& config, Recognizer& recognizer) : config_(config),
 
   // Initialize concurrent request limiter
   g_request_sem.max_count = config.max_concurrent_requests;
-  g_asr_executor          = std::make_unique<BoundedExecutor>(asr_executor_worker_count(config),
-                                                              asr_executor_queue_capacity(config));
+  g_load_tracker          = std::make_unique<LoadStateTracker>(LoadThresholds::from_config(config));
+  g_tenants               = std::make_unique<TenantRegistry>(parse_tenant_specs(config.tenants));
+  g_asr_executor          = std::make_unique<BoundedExecutor>(
+      asr_executor_worker_count(config), asr_executor_queue_capacity(config), g_tenants->weights());
+
+  std::vector<std::string> tenant_names;
+  tenant_names.reserve(g_tenants->size());
+  for (size_t i = 0; i < g_tenants->size(); ++i) {
+    tenant_names.push_back(g_tenants->spec(i).name);
+  }
+  ASRMetrics::instance().register_tenants(tenant_names);
+  recognizer_.set_pressure_source([]() { return g_asr_executor ? g_asr_executor->queued() : 0; });
+  if (g_tenants->size() > 1) {
+    spdlog::info("Tenants: {} configured (plus default), fair-share lanes enabled", g_tenants->size() - 1);
+  }
 }
 
 void Server::install_signal_handlers() {
@@ -1073,23 +866,53 @@ void Server::setup_http_handlers() {
   auto readiness_handler = [this, make_json_response](
                                const drogon::HttpRequestPtr& /*req*/,
                                std::function<void(const drogon::HttpResponsePtr&)>&& callback) {
-    bool        vad_ready = false;
+    bool        vad_ready = g_vad_runtime_ready.load(std::memory_order_acquire);
     std::string vad_error;
-    try {
-      VoiceActivityDetector vad(vad_config_);
-      vad_ready = true;
-    } catch (const std::exception& e) {
-      vad_error = e.what();
+    if (!vad_ready) {
+      try {
+        VoiceActivityDetector vad(vad_config_);
+        vad_ready = true;
+        g_vad_runtime_ready.store(true, std::memory_order_release);
+      } catch (const std::exception& e) {
+        vad_error = e.what();
+      }
     }
 
     const bool recognizer_ready = recognizer_.ready();
-    const bool ready            = recognizer_ready && vad_ready;
+
+    LoadSnapshot snapshot;
+    if (g_asr_executor) {
+      snapshot.queued         = g_asr_executor->queued();
+      snapshot.queue_capacity = g_asr_executor->capacity();
+      snapshot.in_flight      = g_asr_executor->in_flight();
+    }
+    const auto recognizer_load   = recognizer_.load();
+    snapshot.slots_busy          = recognizer_load.slots_busy;
+    snapshot.slots_total         = recognizer_load.slots_total;
+    snapshot.wait_p95_sec        = recognizer_load.wait_p95_sec;
+    snapshot.rss_bytes           = current_rss_bytes();
+    snapshot.memory_budget_bytes = config_.memory_budget_bytes;
+
+    const LoadState load_state = g_load_tracker->update(snapshot);
+    ASRMetrics::instance().set_load_state(static_cast<int>(load_state));
+    const LoadState state = recognizer_ready && vad_ready ? load_state : LoadState::NotReady;
 
     nlohmann::json j;
-    j["status"]           = ready ? "ok" : "not_ready";
+    j["status"]           = load_state_name(state);
     j["provider"]         = config_.provider;
     j["recognizer_ready"] = recognizer_ready;
     j["vad_ready"]        = vad_ready;
+    j["load"]             = {
+        {"state", load_state_name(load_state)},
+        {"queued", snapshot.queued},
+        {"queue_capacity", snapshot.queue_capacity},
+        {"in_flight", snapshot.in_flight},
+        {"slots_busy", snapshot.slots_busy},
+        {"slots_total", snapshot.slots_total},
+        {"wait_p95_ms", static_cast<int64_t>(snapshot.wait_p95_sec * 1000.0)},
+        {"rss_bytes", snapshot.rss_bytes},
+        {"memory_budget_bytes", snapshot.memory_budget_bytes},
+    };
     if (!vad_ready) {
       j["vad_model_path"]        = vad_config_.model_path;
       j["vad_model_file_exists"] = std::filesystem::exists(vad_config_.model_path);
@@ -1098,14 +921,17 @@ void Server::setup_http_handlers() {
       }
     }
 
-    callback(make_json_response(ready ? drogon::k200OK : drogon::k503ServiceUnavailable, j));
+    // Degraded nodes stay in rotation (200) but advertise pressure; only
+    // not_ready is taken out of the balancer pool.
+    const auto status = state == LoadState::NotReady ? drogon::k503ServiceUnavailable : drogon::k200OK;
+    callback(make_json_response(status, j));
   };
 
   // Drogon's registerHandler template keeps lvalue callables as references;
   // pass an owning copy to avoid dangling after setup_http_handlers() returns.
   using ReadinessHandler = std::decay_t<decltype(readiness_handler)>;
 
-  // GET /readyz — deep readiness check (recognizer + VAD runtime)
+  // GET /readyz — deep readiness check (recognizer + VAD runtime + load)
   app.registerHandler("/readyz", ReadinessHandler(readiness_handler), {drogon::Get});
 
   // Backward-compatible readiness alias.
@@ -1115,6 +941,7 @@ void Server::setup_http_handlers() {
   app.registerHandler("/metrics",
                       [](const drogon::HttpRequestPtr& /*req*/,
                          std::function<void(const drogon::HttpResponsePtr&)>&& callback) {
+                        const AllocTagScope              alloc_scope(AllocTag::Metrics);
                         const prometheus::TextSerializer serializer;
                         auto collected = ASRMetrics::instance().registry()->Collect();
                         auto text      = serializer.Serialize(collected);
@@ -1126,6 +953,130 @@ void Server::setup_http_handlers() {
                       },
                       {drogon::Get});
 
+  // GET /admin/profile, /admin/threads, /admin/allocations — in-process profiling, only with ADMIN_TOKEN
+  if (!config_.admin_token.empty()) {
+    app.registerHandler(
+        "/admin/profile",
+        [this, make_json_response](const drogon::HttpRequestPtr&                         req,
+                                   std::function<void(const drogon::HttpResponsePtr&)>&& callback) {
+          if (!admin_authorized(req, config_.admin_token)) {
+            callback(make_json_response(drogon::k401Unauthorized, {{"detail", "Invalid admin token"}}));
+            return;
+          }
+          const auto seconds = query_number(req, "seconds", 10.0, 1.0, kMaxAdminWindowSec);
+          const auto hz      = query_number(req, "hz", 99.0, 1.0, 1000.0);
+          if (!seconds.has_value() || !hz.has_value()) {
+            callback(
+                make_json_response(drogon::k400BadRequest, {{"detail", "seconds and hz must be numbers"}}));
+            return;
+          }
+
+          auto& profiler = SamplingProfiler::instance();
+          if (!profiler.start(static_cast<int>(*hz))) {
+            const bool busy = profiler.running();
+            callback(make_json_response(busy ? drogon::k409Conflict : drogon::k501NotImplemented,
+                                        {{"detail", busy ? "A profile is already running"
+                                                         : "Sampling profiler is not supported here"}}));
+            return;
+          }
+          spdlog::info("Admin: CPU profile started for {:.0f}s at {:.0f} Hz", *seconds, *hz);
+
+          auto request_loop = drogon::app().getLoop();
+          auto callback_ptr =
+              std::make_shared<std::function<void(const drogon::HttpResponsePtr&)>>(std::move(callback));
+          // The timer only ends sampling; folding and symbolizing thousands of
+          // stacks runs on an executor worker so the loop keeps serving.
+          request_loop->runAfter(*seconds, [request_loop, callback_ptr]() {
+            auto run  = std::make_shared<SamplingProfiler::Run>(SamplingProfiler::instance().halt());
+            auto task = [request_loop, callback_ptr, run]() {
+              const auto profile = SamplingProfiler::aggregate(std::move(*run));
+              auto       resp    = drogon::HttpResponse::newHttpResponse();
+              resp->setStatusCode(drogon::k200OK);
+              resp->setBody(render_folded(profile));
+              resp->setContentTypeCode(drogon::CT_TEXT_PLAIN);
+              resp->addHeader("X-Profile-Samples", std::to_string(profile.samples));
+              resp->addHeader("X-Profile-Dropped", std::to_string(profile.dropped));
+              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
+            };
+            bool submitted = false;
+            try {
+              submitted = g_asr_executor != nullptr && g_asr_executor->try_submit(task);
+            } catch (const std::exception& e) {
+              spdlog::error("HTTP /admin/profile: failed to enqueue executor task: {}", e.what());
+            }
+            if (!submitted) {
+              // A full queue is when a profile matters most; finish it here
+              // rather than throw the samples away.
+              spdlog::warn("HTTP /admin/profile: executor queue full, aggregating on the event loop");
+              task();
+            }
+          });
+        },
+        {drogon::Get});
+
+    app.registerHandler(
+        "/admin/threads",
+        [this, make_json_response](const drogon::HttpRequestPtr&                         req,
+                                   std::function<void(const drogon::HttpResponsePtr&)>&& callback) {
+          if (!admin_authorized(req, config_.admin_token)) {
+            callback(make_json_response(drogon::k401Unauthorized, {{"detail", "Invalid admin token"}}));
+            return;
+          }
+          const auto seconds = query_number(req, "seconds", 0.0, 0.0, kMaxAdminWindowSec);
+          if (!seconds.has_value()) {
+            callback(make_json_response(drogon::k400BadRequest, {{"detail", "seconds must be a number"}}));
+            return;
+          }
+          if (*seconds <= 0.0) {
+            callback(make_json_response(drogon::k200OK, thread_cpu_report({}, thread_cpu_times(), 0.0)));
+            return;
+          }
+
+          auto callback_ptr =
+              std::make_shared<std::function<void(const drogon::HttpResponsePtr&)>>(std::move(callback));
+          drogon::app().getLoop()->runAfter(
+              *seconds, [callback_ptr, make_json_response, window = *seconds, before = thread_cpu_times()]() {
+                const auto report = thread_cpu_report(before, thread_cpu_times(), window);
+                (*callback_ptr)(make_json_response(drogon::k200OK, report));
+              });
+        },
+        {drogon::Get});
+
+    app.registerHandler(
+        "/admin/allocations",
+        [this, make_json_response](const drogon::HttpRequestPtr&                         req,
+                                   std::function<void(const drogon::HttpResponsePtr&)>&& callback) {
+          if (!admin_authorized(req, config_.admin_token)) {
+            callback(make_json_response(drogon::k401Unauthorized, {{"detail", "Invalid admin token"}}));
+            return;
+          }
+          const auto before = alloc_snapshot();
+          if (!before.enabled) {
+            callback(make_json_response(drogon::k501NotImplemented,
+                                        {{"detail", "Built without ASR_ENABLE_ALLOC_PROFILER"}}));
+            return;
+          }
+          const auto seconds = query_number(req, "seconds", 0.0, 0.0, kMaxAdminWindowSec);
+          if (!seconds.has_value()) {
+            callback(make_json_response(drogon::k400BadRequest, {{"detail", "seconds must be a number"}}));
+            return;
+          }
+          if (*seconds <= 0.0) {
+            callback(make_json_response(drogon::k200OK, alloc_report({}, before, 0.0)));
+            return;
+          }
+
+          auto callback_ptr =
+              std::make_shared<std::function<void(const drogon::HttpResponsePtr&)>>(std::move(callback));
+          drogon::app().getLoop()->runAfter(
+              *seconds, [callback_ptr, make_json_response, before, window = *seconds]() {
+                const auto report = alloc_report(before, alloc_snapshot(), window);
+                (*callback_ptr)(make_json_response(drogon::k200OK, report));
+              });
+        },
+        {drogon::Get});
+  }
+
   // POST /recognize — file upload
   app.registerHandler(
       "/recognize",
@@ -1145,8 +1096,23 @@ void Server::setup_http_handlers() {
           return resp;
         };
 
+        // Per-tenant concurrency cap and audio quota, then the global request limit
+        const size_t tenant = resolve_tenant(req);
+        if (const auto admission = admit_tenant(tenant); admission != TenantAdmission::Admitted) {
+          if (admission == TenantAdmission::QuotaExceeded) {
+            callback(make_error(drogon::k429TooManyRequests, "Tenant audio quota exceeded, try again later",
+                                "quota_exceeded"));
+          } else {
+            callback(make_error(drogon::k429TooManyRequests,
+                                "Tenant concurrency limit reached, try again later", "capacity_exceeded"));
+          }
+          metrics.observe_request(0.0, 0.0, 0.0, 0, 0, 0.0, 0.0, "http", "failed");
+          return;
+        }
+
         // Concurrent request limiting
         if (!g_request_sem.try_acquire()) {
+          release_tenant(tenant);
           callback(make_error(drogon::k503ServiceUnavailable, "Server at capacity, try again later",
                               "capacity_exceeded"));
           metrics.observe_request(0.0, 0.0, 0.0, 0, 0, 0.0, 0.0, "http", "failed");
@@ -1156,15 +1122,15 @@ void Server::setup_http_handlers() {
         metrics.session_started();
         auto start_ts = std::chrono::steady_clock::now();
 
-        auto make_error_and_release = [&metrics, &make_error, &start_ts](drogon::HttpStatusCode status,
-                                                                         const std::string&     detail,
-                                                                         const std::string&     error_type) {
+        auto make_error_and_release = [&metrics, &make_error, &start_ts, tenant](
+                                          drogon::HttpStatusCode status, const std::string& detail,
+                                          const std::string& error_type) {
           auto resp = make_error(status, detail, error_type);
           auto end  = std::chrono::steady_clock::now();
           metrics.observe_request(std::chrono::duration<double>(end - start_ts).count(), 0.0, 0.0, 0, 0, 0.0,
                                   0.0, "http", "failed");
           metrics.session_ended(0.0);
-          g_request_sem.release();
+          release_request_slot(tenant);
           return resp;
         };
 
@@ -1192,112 +1158,177 @@ void Server::setup_http_handlers() {
           return;
         }
 
-        auto request_loop = drogon::app().getLoop();
         auto callback_ptr =
             std::make_shared<std::function<void(const drogon::HttpResponsePtr&)>>(std::move(callback));
         auto upload_body = std::make_shared<std::string>(file.fileContent());
-        auto file_name   = file.getFileName();
 
         bool submitted = false;
         try {
-          submitted = g_asr_executor != nullptr && g_asr_executor->try_submit([this, start_ts, request_loop,
-                                                                               callback_ptr, upload_body,
-                                                                               file_name]() {
-            auto make_async_error = [start_ts](drogon::HttpStatusCode status, const std::string& detail,
-                                               const std::string& error_type) {
-              nlohmann::json err;
-              err["detail"] = detail;
-              auto resp     = drogon::HttpResponse::newHttpResponse();
-              resp->setStatusCode(status);
-              resp->setBody(err.dump());
-              resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
-              auto& metrics = ASRMetrics::instance();
-              metrics.observe_error(error_type);
-              const auto end = std::chrono::steady_clock::now();
-              metrics.observe_request(std::chrono::duration<double>(end - start_ts).count(), 0.0, 0.0, 0, 0,
-                                      0.0, 0.0, "http", "failed");
-              metrics.session_ended(0.0);
-              g_request_sem.release();
-              return resp;
-            };
+          auto job    = std::make_shared<UploadJob>();
+          job->decode = [this, upload_body,
+                         file_name = file.getFileName()](const AudioChunkCallback& on_chunk) {
+            const auto bytes = span<const uint8_t>(reinterpret_cast<const uint8_t*>(upload_body->data()),
+                                                   upload_body->size());
+            return decode_audio_streamed(bytes, file_name, config_.sample_rate,
+                                         http_chunk_samples(config_.sample_rate), on_chunk,
+                                         config_.opus_decode_threads);
+          };
+          job->render        = transcript_response;
+          job->render_error  = detail_error_response;
+          job->transport     = MetricMode::Http;
+          job->body_bytes    = upload_body->size();
+          job->tenant        = tenant;
+          job->timing_fields = config_.server_timing && wants_timing_fields(req);
+          job->start_ts      = start_ts;
+          job->submitted_at  = std::chrono::steady_clock::now();
+          job->request_loop  = drogon::app().getLoop();
+          job->callback      = callback_ptr;
+
+          auto task = [this, job]() { run_upload_job(config_, recognizer_, *job); };
+          submitted = g_asr_executor != nullptr && g_asr_executor->try_submit(std::move(task), tenant);
+        } catch (const std::exception& e) {
+          submitted = false;
+          spdlog::error("HTTP /recognize: failed to enqueue executor task: {}", e.what());
+        } catch (...) {
+          submitted = false;
+          spdlog::error("HTTP /recognize: failed to enqueue executor task: unknown exception");
+        }
 
-            try {
-              auto file_bytes = asr::span<const uint8_t>(
-                  reinterpret_cast<const uint8_t*>(upload_body->data()), upload_body->size());
-
-              std::string           text;
-              double                decode_sec = 0.0;
-              std::optional<double> ttfr_sec;
-
-              auto       pipeline_start = std::chrono::steady_clock::now();
-              const auto audio          = decode_audio_streamed(
-                  file_bytes, file_name, config_.sample_rate, http_chunk_samples(config_.sample_rate),
-                  [this, &text, &decode_sec, &ttfr_sec, &start_ts](span<const float> chunk) {
-                    auto t0       = std::chrono::steady_clock::now();
-                    auto chunk_tx = recognizer_.recognize(chunk, config_.sample_rate);
-                    auto t1       = std::chrono::steady_clock::now();
-                    decode_sec += std::chrono::duration<double>(t1 - t0).count();
-                    if (!ttfr_sec.has_value()) {
-                      ttfr_sec = std::chrono::duration<double>(t1 - start_ts).count();
-                    }
-                    append_transcription_chunk(text, chunk_tx);
-                  });
-              auto         pipeline_end   = std::chrono::steady_clock::now();
-              const double preprocess_sec = std::max(
-                  0.0, std::chrono::duration<double>(pipeline_end - pipeline_start).count() - decode_sec);
-
-              auto         end_ts    = std::chrono::steady_clock::now();
-              const double total_sec = std::chrono::duration<double>(end_ts - start_ts).count();
-
-              auto& metrics = ASRMetrics::instance();
-              if (ttfr_sec.has_value()) {
-                metrics.observe_ttfr(*ttfr_sec, "http");
-              }
-              metrics.observe_segment(static_cast<double>(audio.duration_sec), decode_sec);
-              metrics.observe_request(total_sec, static_cast<double>(audio.duration_sec), decode_sec, 1,
-                                      upload_body->size(), preprocess_sec, 0.0, "http", "success");
-              metrics.record_result(text);
-              metrics.session_ended(total_sec);
-
-              nlohmann::json j;
-              j["text"]     = text;
-              j["duration"] = audio.duration_sec;
-              auto resp     = drogon::HttpResponse::newHttpResponse();
-              resp->setStatusCode(drogon::k200OK);
-              resp->setBody(j.dump());
-              resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+        if (!submitted) {
+          metrics.observe_tenant_rejection(tenant, "queue_full");
+          auto resp = make_error_and_release(drogon::k503ServiceUnavailable, "ASR executor queue is full",
+                                             "capacity_exceeded");
+          (*callback_ptr)(resp);
+        }
+      },
+      {drogon::Post});
 
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-            } catch (const RecognizerBusyError& e) {
-              auto resp = make_async_error(drogon::k503ServiceUnavailable, e.what(), "capacity_exceeded");
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-              return;
-            } catch (const AudioError& e) {
-              auto resp = make_async_error(drogon::k400BadRequest, e.what(), "invalid_audio");
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-              return;
-            } catch (const std::exception& e) {
-              auto resp = make_async_error(drogon::k500InternalServerError, e.what(), "internal_error");
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-              return;
-            } catch (...) {
-              auto resp = make_async_error(drogon::k500InternalServerError, "Unknown internal error",
-                                           "internal_error");
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-              return;
-            }
+  // POST /recognize/raw — the request body is the audio itself (no multipart parsing, no body copy)
+  app.registerHandler(
+      "/recognize/raw",
+      [this](const drogon::HttpRequestPtr&                         req,
+             std::function<void(const drogon::HttpResponsePtr&)>&& callback) {
+        auto& metrics = ASRMetrics::instance();
 
-            g_request_sem.release();
-          });
+        auto make_error = [&metrics](drogon::HttpStatusCode status, const std::string& detail,
+                                     const std::string& error_type) {
+          nlohmann::json err;
+          err["detail"] = detail;
+          auto resp     = drogon::HttpResponse::newHttpResponse();
+          resp->setStatusCode(status);
+          resp->setBody(err.dump());
+          resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+          metrics.observe_error(error_type);
+          return resp;
+        };
+
+        const size_t tenant = resolve_tenant(req);
+        if (const auto admission = admit_tenant(tenant); admission != TenantAdmission::Admitted) {
+          if (admission == TenantAdmission::QuotaExceeded) {
+            callback(make_error(drogon::k429TooManyRequests, "Tenant audio quota exceeded, try again later",
+                                "quota_exceeded"));
+          } else {
+            callback(make_error(drogon::k429TooManyRequests,
+                                "Tenant concurrency limit reached, try again later", "capacity_exceeded"));
+          }
+          metrics.observe_request(0.0, 0.0, 0.0, 0, 0, 0.0, 0.0, "http", "failed");
+          return;
+        }
+
+        if (!g_request_sem.try_acquire()) {
+          release_tenant(tenant);
+          callback(make_error(drogon::k503ServiceUnavailable, "Server at capacity, try again later",
+                              "capacity_exceeded"));
+          metrics.observe_request(0.0, 0.0, 0.0, 0, 0, 0.0, 0.0, "http", "failed");
+          return;
+        }
+
+        metrics.session_started();
+        auto start_ts = std::chrono::steady_clock::now();
+
+        auto make_error_and_release = [&metrics, &make_error, &start_ts, tenant](
+                                          drogon::HttpStatusCode status, const std::string& detail,
+                                          const std::string& error_type) {
+          auto resp = make_error(status, detail, error_type);
+          auto end  = std::chrono::steady_clock::now();
+          metrics.observe_request(std::chrono::duration<double>(end - start_ts).count(), 0.0, 0.0, 0, 0, 0.0,
+                                  0.0, "http", "failed");
+          metrics.session_ended(0.0);
+          release_request_slot(tenant);
+          return resp;
+        };
+
+        // Layout parameters: query string wins over X-* headers.
+        std::unordered_map<std::string, std::string> params;
+        for (const auto& [key, header] : {std::pair{"encoding", "x-audio-encoding"},
+                                          std::pair{"sample_rate", "x-sample-rate"},
+                                          std::pair{"channels", "x-channels"}}) {
+          const auto& query_value = req->getParameter(key);
+          params.emplace(key, query_value.empty() ? req->getHeader(header) : query_value);
+        }
+
+        RawAudioRequest raw_request;
+        if (auto parse_error = parse_raw_audio_request(req->getHeader("content-type"), params, &raw_request);
+            parse_error.has_value()) {
+          callback(make_error_and_release(parse_error->unsupported_media_type
+                                              ? drogon::k415UnsupportedMediaType
+                                              : drogon::k400BadRequest,
+                                          parse_error->message, "invalid_param"));
+          return;
+        }
+
+        const auto body = req->body();
+        if (body.empty()) {
+          callback(make_error_and_release(drogon::k400BadRequest, "Empty request body", "empty_file"));
+          return;
+        }
+        if (body.size() > config_.max_upload_bytes) {
+          callback(
+              make_error_and_release(drogon::k413RequestEntityTooLarge, "Body too large", "file_too_large"));
+          return;
+        }
+
+        auto callback_ptr =
+            std::make_shared<std::function<void(const drogon::HttpResponsePtr&)>>(std::move(callback));
+
+        bool submitted = false;
+        try {
+          auto job = std::make_shared<UploadJob>();
+          // The job holds the request itself, so the body is decoded in place.
+          job->decode = [this, req, raw_request](const AudioChunkCallback& on_chunk) {
+            const auto body       = req->body();
+            const auto body_bytes =
+                span<const uint8_t>(reinterpret_cast<const uint8_t*>(body.data()), body.size());
+            return raw_request.encoding == RawAudioEncoding::Pcm16
+                       ? decode_pcm16_streamed(body_bytes, raw_request.pcm, config_.sample_rate,
+                                               http_chunk_samples(config_.sample_rate), on_chunk)
+                       : decode_audio_streamed(body_bytes, raw_audio_file_name(raw_request.encoding),
+                                               config_.sample_rate, http_chunk_samples(config_.sample_rate),
+                                               on_chunk, config_.opus_decode_threads);
+          };
+          job->render        = transcript_response;
+          job->render_error  = detail_error_response;
+          job->transport     = MetricMode::Http;
+          job->body_bytes    = body.size();
+          job->tenant        = tenant;
+          job->timing_fields = config_.server_timing && wants_timing_fields(req);
+          job->start_ts      = start_ts;
+          job->submitted_at  = std::chrono::steady_clock::now();
+          job->request_loop  = drogon::app().getLoop();
+          job->callback      = callback_ptr;
+
+          auto task = [this, job]() { run_upload_job(config_, recognizer_, *job); };
+          submitted = g_asr_executor != nullptr && g_asr_executor->try_submit(std::move(task), tenant);
         } catch (const std::exception& e) {
           submitted = false;
-          spdlog::error("HTTP /recognize: failed to enqueue executor task: {}", e.what());
+          spdlog::error("HTTP /recognize/raw: failed to enqueue executor task: {}", e.what());
         } catch (...) {
           submitted = false;
-          spdlog::error("HTTP /recognize: failed to enqueue executor task: unknown exception");
+          spdlog::error("HTTP /recognize/raw: failed to enqueue executor task: unknown exception");
         }
 
         if (!submitted) {
+          metrics.observe_tenant_rejection(tenant, "queue_full");
           auto resp = make_error_and_release(drogon::k503ServiceUnavailable, "ASR executor queue is full",
                                              "capacity_exceeded");
           (*callback_ptr)(resp);
@@ -1321,7 +1352,23 @@ void Server::setup_http_handlers() {
       return resp;
     };
 
+    const size_t tenant = resolve_tenant(req);
+    if (const auto admission = admit_tenant(tenant); admission != TenantAdmission::Admitted) {
+      if (admission == TenantAdmission::QuotaExceeded) {
+        callback(make_whisper_error(drogon::k429TooManyRequests,
+                                    "Tenant audio quota exceeded, try again later", "quota_exceeded",
+                                    "rate_limit_error", "", "insufficient_quota"));
+      } else {
+        callback(make_whisper_error(drogon::k429TooManyRequests,
+                                    "Tenant concurrency limit reached, try again later", "capacity_exceeded",
+                                    "rate_limit_error", "", "rate_limit_exceeded"));
+      }
+      metrics.observe_request(0.0, 0.0, 0.0, 0, 0, 0.0, 0.0, "whisper_api", "failed");
+      return;
+    }
+
     if (!g_request_sem.try_acquire()) {
+      release_tenant(tenant);
       callback(make_whisper_error(drogon::k503ServiceUnavailable, "Server at capacity, try again later",
                                   "capacity_exceeded", "server_error", "", "capacity_exceeded"));
       metrics.observe_request(0.0, 0.0, 0.0, 0, 0, 0.0, 0.0, "whisper_api", "failed");
@@ -1331,7 +1378,7 @@ void Server::setup_http_handlers() {
     metrics.session_started();
     auto start_ts = std::chrono::steady_clock::now();
 
-    auto make_error_and_release = [&metrics, &make_whisper_error, &start_ts](
+    auto make_error_and_release = [&metrics, &make_whisper_error, &start_ts, tenant](
                                       drogon::HttpStatusCode status, const std::string& detail,
                                       const std::string& metrics_error_type,
                                       const std::string& api_error_type, const std::string& api_param,
@@ -1341,7 +1388,7 @@ void Server::setup_http_handlers() {
       metrics.observe_request(std::chrono::duration<double>(end - start_ts).count(), 0.0, 0.0, 0, 0, 0.0, 0.0,
                               "whisper_api", "failed");
       metrics.session_ended(0.0);
-      g_request_sem.release();
+      release_request_slot(tenant);
       return resp;
     };
 
@@ -1399,116 +1446,64 @@ void Server::setup_http_handlers() {
       return;
     }
 
-    auto request_loop = drogon::app().getLoop();
     auto callback_ptr =
         std::make_shared<std::function<void(const drogon::HttpResponsePtr&)>>(std::move(callback));
-    auto upload_body          = std::make_shared<std::string>(upload_file_content);
-    auto upload_file_name_ptr = std::make_shared<const std::string>(upload_file_name);
-    auto whisper_request_ptr  = std::make_shared<const WhisperTranscriptionRequest>(whisper_request);
+    auto upload_body         = std::make_shared<std::string>(upload_file_content);
+    auto whisper_request_ptr = std::make_shared<const WhisperTranscriptionRequest>(whisper_request);
 
     bool submitted = false;
     try {
-      submitted =
-          g_asr_executor != nullptr &&
-          g_asr_executor->try_submit([this, start_ts, request_loop, callback_ptr, upload_body,
-                                      upload_file_name_ptr, whisper_request_ptr]() {
-            auto make_async_error = [start_ts](drogon::HttpStatusCode status, const std::string& detail,
-                                               const std::string& metrics_error_type,
-                                               const std::string& api_error_type,
-                                               const std::string& api_param, const std::string& api_code) {
-              auto resp = drogon::HttpResponse::newHttpResponse();
-              resp->setStatusCode(status);
-              resp->setBody(build_whisper_api_error_json(detail, api_error_type, api_param, api_code));
-              resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
-              auto& metrics = ASRMetrics::instance();
-              metrics.observe_error(metrics_error_type);
-              const auto end = std::chrono::steady_clock::now();
-              metrics.observe_request(std::chrono::duration<double>(end - start_ts).count(), 0.0, 0.0, 0, 0,
-                                      0.0, 0.0, "whisper_api", "failed");
-              metrics.session_ended(0.0);
-              g_request_sem.release();
-              return resp;
-            };
-
-            try {
-              auto file_bytes = asr::span<const uint8_t>(
-                  reinterpret_cast<const uint8_t*>(upload_body->data()), upload_body->size());
-
-              std::string           text;
-              double                decode_sec = 0.0;
-              std::optional<double> ttfr_sec;
-
-              auto       pipeline_start = std::chrono::steady_clock::now();
-              const auto audio          = decode_audio_streamed(
-                  file_bytes, *upload_file_name_ptr, config_.sample_rate,
-                  http_chunk_samples(config_.sample_rate),
-                  [this, &text, &decode_sec, &ttfr_sec, &start_ts](span<const float> chunk) {
-                    auto t0       = std::chrono::steady_clock::now();
-                    auto chunk_tx = recognizer_.recognize(chunk, config_.sample_rate);
-                    auto t1       = std::chrono::steady_clock::now();
-                    decode_sec += std::chrono::duration<double>(t1 - t0).count();
-                    if (!ttfr_sec.has_value()) {
-                      ttfr_sec = std::chrono::duration<double>(t1 - start_ts).count();
-                    }
-                    append_transcription_chunk(text, chunk_tx);
-                  });
-              auto         pipeline_end   = std::chrono::steady_clock::now();
-              const double preprocess_sec = std::max(
-                  0.0, std::chrono::duration<double>(pipeline_end - pipeline_start).count() - decode_sec);
-
-              auto         end_ts    = std::chrono::steady_clock::now();
-              const double total_sec = std::chrono::duration<double>(end_ts - start_ts).count();
-
-              auto& metrics = ASRMetrics::instance();
-              if (ttfr_sec.has_value()) {
-                metrics.observe_ttfr(*ttfr_sec, "whisper_api");
-              }
-              metrics.observe_segment(static_cast<double>(audio.duration_sec), decode_sec);
-              metrics.observe_request(total_sec, static_cast<double>(audio.duration_sec), decode_sec, 1,
-                                      upload_body->size(), preprocess_sec, 0.0, "whisper_api", "success");
-              metrics.record_result(text);
-              metrics.session_ended(total_sec);
-
-              WhisperTranscriptionResponsePayload payload;
-              payload.text         = text;
-              payload.duration_sec = audio.duration_sec;
-              payload.language     = canonical_whisper_response_language(whisper_request_ptr->language);
-
-              auto rendered = render_whisper_transcription_response(*whisper_request_ptr, payload);
-              auto resp     = drogon::HttpResponse::newHttpResponse();
-              resp->setStatusCode(drogon::k200OK);
-              resp->setBody(std::move(rendered.body));
-              if (rendered.content_type == "application/json") {
-                resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
-              } else {
-                resp->setContentTypeString(rendered.content_type);
-              }
-
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-            } catch (const RecognizerBusyError& e) {
-              auto resp = make_async_error(drogon::k503ServiceUnavailable, e.what(), "capacity_exceeded",
-                                           "server_error", "", "capacity_exceeded");
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-              return;
-            } catch (const AudioError& e) {
-              auto resp = make_async_error(drogon::k400BadRequest, e.what(), "invalid_audio",
-                                           "invalid_request_error", "file", "invalid_audio");
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-              return;
-            } catch (const std::exception& e) {
-              auto resp = make_async_error(drogon::k500InternalServerError, e.what(), "internal_error",
-                                           "server_error", "", "internal_error");
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-              return;
-            } catch (...) {
-              auto resp = make_async_error(drogon::k500InternalServerError, "Unknown internal error",
-                                           "internal_error", "server_error", "", "internal_error");
-              request_loop->queueInLoop([callback_ptr, resp]() { (*callback_ptr)(resp); });
-              return;
-            }
-
-            g_request_sem.release();
-          });
+      auto job    = std::make_shared<UploadJob>();
+      job->decode = [this, upload_body, upload_file_name](const AudioChunkCallback& on_chunk) {
+        const auto bytes = span<const uint8_t>(reinterpret_cast<const uint8_t*>(upload_body->data()),
+                                               upload_body->size());
+        return decode_audio_streamed(bytes, upload_file_name, config_.sample_rate,
+                                     http_chunk_samples(config_.sample_rate), on_chunk,
+                                     config_.opus_decode_threads);
+      };
+      job->render = [whisper_request_ptr](const std::string& text, float duration_sec,
+                                          const RequestTiming* timings) {
+        WhisperTranscriptionResponsePayload payload;
+        payload.text         = text;
+        payload.duration_sec = duration_sec;
+        payload.language     = canonical_whisper_response_language(whisper_request_ptr->language);
+        if (timings != nullptr) {
+          payload.timings = *timings;
+        }
+        auto rendered = render_whisper_transcription_response(*whisper_request_ptr, payload);
+        auto resp     = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k200OK);
+        resp->setBody(std::move(rendered.body));
+        if (rendered.content_type == "application/json") {
+          resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+        } else {
+          resp->setContentTypeString(rendered.content_type);
+        }
+        return resp;
+      };
+      // The API code is the metrics error type; only a bad file is the client's fault.
+      job->render_error = [](drogon::HttpStatusCode status, const std::string& detail,
+                             const std::string& error_type) {
+        const bool invalid_audio = error_type == "invalid_audio";
+        auto       resp          = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(status);
+        resp->setBody(build_whisper_api_error_json(
+            detail, invalid_audio ? "invalid_request_error" : "server_error", invalid_audio ? "file" : "",
+            error_type));
+        resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+        return resp;
+      };
+      job->transport     = MetricMode::WhisperApi;
+      job->body_bytes    = upload_body->size();
+      job->tenant        = tenant;
+      job->timing_fields = config_.server_timing && wants_timing_fields(req);
+      job->start_ts      = start_ts;
+      job->submitted_at  = std::chrono::steady_clock::now();
+      job->request_loop  = drogon::app().getLoop();
+      job->callback      = callback_ptr;
+
+      auto task = [this, job]() { run_upload_job(config_, recognizer_, *job); };
+      submitted = g_asr_executor != nullptr && g_asr_executor->try_submit(std::move(task), tenant);
     } catch (const std::exception& e) {
       submitted = false;
       spdlog::error("HTTP whisper_api: failed to enqueue executor task: {}", e.what());
@@ -1518,6 +1513,7 @@ void Server::setup_http_handlers() {
     }
 
     if (!submitted) {
+      metrics.observe_tenant_rejection(tenant, "queue_full");
       auto resp = make_error_and_release(drogon::k503ServiceUnavailable, "ASR executor queue is full",
                                          "capacity_exceeded", "server_error", "", "capacity_exceeded");
       (*callback_ptr)(resp);
@@ -1559,6 +1555,16 @@ void Server::run() {
     }
   });
 
+  // Export the most lagging realtime connections; unused ranks read 0.
+  drogon::app().getLoop()->runEvery(1.0, []() {
+    const auto worst = RealtimeLagBoard::instance().worst(ASRMetrics::kRealtimeLagRanks);
+    for (size_t rank = 1; rank <= ASRMetrics::kRealtimeLagRanks; ++rank) {
+      ASRMetrics::instance().set_realtime_worst_lag(rank, rank <= worst.size() ? worst[rank - 1] : 0.0);
+    }
+  });
+
+  set_alloc_sample_bytes(config_.alloc_sample_bytes);
+  set_current_thread_role(kThreadRoleMain);
   drogon::app().run();
 
   if (g_asr_executor) {
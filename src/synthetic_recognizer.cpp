@@ -0,0 +1,144 @@
+#include "asr/synthetic_recognizer.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "asr/alloc_profiler.h"
+#include "asr/config.h"
+#include "asr/metrics.h"
+#include "asr/request_timing.h"
+#include "asr/span.h"
+
+namespace asr {
+
+namespace {
+
+void burn_until(std::chrono::steady_clock::time_point deadline) {
+  volatile uint64_t sink = 0;  // keeps the arithmetic from being optimized away
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (int i = 0; i < 1024; ++i) {
+      sink = sink * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+  }
+}
+
+}  // namespace
+
+double SyntheticCostModel::base_cost_sec(double audio_sec) const noexcept {
+  return std::max(0.0, call_ms + ms_per_audio_sec * audio_sec) / 1000.0;
+}
+
+SyntheticRecognizer::SyntheticRecognizer(size_t pool_size, SyntheticCostModel model, size_t wait_timeout_ms,
+                                         uint64_t seed, size_t realtime_slots)
+    : model_(model),
+      slots_total_(std::max<size_t>(1, pool_size)),
+      realtime_slots_(std::min(realtime_slots, slots_total_ - 1)),
+      wait_timeout_ms_(wait_timeout_ms),
+      rng_(seed) {
+  spdlog::info(
+      "Synthetic recognizer: pool_size={}, realtime_slots={}, call_ms={}, ms_per_audio_sec={}, jitter_ms={}, "
+      "mode={}",
+      slots_total_, realtime_slots_, model_.call_ms, model_.ms_per_audio_sec, model_.jitter_ms,
+      model_.burn_cpu ? "burn_cpu" : "sleep");
+}
+
+SyntheticRecognizer::SyntheticRecognizer(const Config& cfg)
+    : SyntheticRecognizer(static_cast<size_t>(std::max(cfg.recognizer_pool_size, 1)),
+                          SyntheticCostModel{cfg.synthetic_call_ms, cfg.synthetic_ms_per_audio_sec,
+                                             cfg.synthetic_jitter_ms, cfg.synthetic_burn_cpu},
+                          cfg.recognizer_wait_timeout_ms, 1, cfg.recognizer_realtime_slots) {}
+
+double SyntheticRecognizer::next_cost_sec(double audio_sec) {
+  double jitter_sec = 0.0;
+  if (model_.jitter_ms > 0.0) {
+    std::uniform_real_distribution<double> jitter(-model_.jitter_ms, model_.jitter_ms);
+    jitter_sec = jitter(rng_) / 1000.0;
+  }
+  return std::max(0.0, model_.base_cost_sec(audio_sec) + jitter_sec);
+}
+
+std::string SyntheticRecognizer::recognize(span<const float> audio, int sample_rate, SlotClass slot_class) {
+  if (audio.empty()) {
+    return {};
+  }
+  const AllocTagScope alloc_scope(AllocTag::Asr);
+  const double audio_sec = sample_rate > 0 ? static_cast<double>(audio.size()) / sample_rate : 0.0;
+
+  double     cost_sec     = 0.0;
+  bool       reserved     = false;  // holding one of the realtime-only slots
+  const auto wait_started = std::chrono::steady_clock::now();
+  {
+    std::unique_lock lock(mutex_);
+    // Same order as Recognizer: realtime takes reserved slots first.
+    const bool acquired =
+        cv_.wait_for(lock, std::chrono::milliseconds(wait_timeout_ms_), [this, slot_class, &reserved]() {
+          reserved = slot_class == SlotClass::Realtime && realtime_busy_ < realtime_slots_;
+          return reserved || slots_busy_ - realtime_busy_ < slots_total_ - realtime_slots_;
+        });
+    const auto wait_sec =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wait_started).count();
+    ASRMetrics::instance().observe_recognizer_wait(wait_sec, !acquired, slot_class);
+    record_recognizer_wait(wait_sec);
+    recent_waits_.record(wait_sec);
+    if (!acquired) {
+      throw RecognizerBusyError("Recognizer pool is saturated");
+    }
+    ++slots_busy_;
+    realtime_busy_ += reserved ? 1 : 0;
+    ++decodes_;
+    cost_sec = next_cost_sec(audio_sec);
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(cost_sec));
+  if (model_.burn_cpu) {
+    burn_until(deadline);
+  } else {
+    std::this_thread::sleep_until(deadline);
+  }
+
+  {
+    const std::scoped_lock lock(mutex_);
+    --slots_busy_;
+    realtime_busy_ -= reserved ? 1 : 0;
+  }
+  if (realtime_slots_ > 0) {
+    cv_.notify_all();
+  } else {
+    cv_.notify_one();
+  }
+
+  char text[48];
+  std::snprintf(text, sizeof(text), "synthetic %.2fs", audio_sec);
+  return text;
+}
+
+bool SyntheticRecognizer::ready() const noexcept {
+  return true;
+}
+
+RecognizerLoad SyntheticRecognizer::load() const {
+  RecognizerLoad         load;
+  const std::scoped_lock lock(mutex_);
+  load.slots_total  = slots_total_;
+  load.slots_busy   = slots_busy_;
+  load.wait_p95_sec = recent_waits_.percentile(0.95);
+  return load;
+}
+
+const SyntheticCostModel& SyntheticRecognizer::cost_model() const noexcept {
+  return model_;
+}
+
+size_t SyntheticRecognizer::decodes() const {
+  const std::scoped_lock lock(mutex_);
+  return decodes_;
+}
+
+}  // namespace asr
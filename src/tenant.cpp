@@ -0,0 +1,238 @@
+#include "asr/tenant.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include "asr/config.h"
+#include "asr/string_utils.h"
+
+namespace asr {
+
+namespace {
+
+std::vector<std::string> split(std::string_view input, char sep) {
+  std::vector<std::string> parts;
+  size_t                   start = 0;
+  for (;;) {
+    const auto pos = input.find(sep, start);
+    parts.push_back(trim_ascii(input.substr(start, pos == std::string_view::npos ? pos : pos - start)));
+    if (pos == std::string_view::npos) {
+      return parts;
+    }
+    start = pos + 1;
+  }
+}
+
+template <typename T, typename Parse>
+T parse_field(const std::string& value, const std::string& entry, const char* field, Parse parse) {
+  try {
+    size_t consumed = 0;
+    auto   parsed   = parse(value, &consumed);
+    if (consumed != value.size()) {
+      throw std::invalid_argument("trailing characters");
+    }
+    return static_cast<T>(parsed);
+  } catch (const std::exception&) {
+    throw ConfigError("TENANTS entry '" + entry + "': invalid " + field + " '" + value + "'");
+  }
+}
+
+long long parse_integer(const std::string& value, size_t* consumed) {  // NOLINT(google-runtime-int)
+  return std::stoll(value, consumed);
+}
+
+unsigned long long parse_unsigned(const std::string& value, size_t* consumed) {  // NOLINT(google-runtime-int)
+  if (!value.empty() && value.front() == '-') {
+    throw std::invalid_argument("negative value");
+  }
+  return std::stoull(value, consumed);
+}
+
+double parse_double(const std::string& value, size_t* consumed) {
+  return std::stod(value, consumed);
+}
+
+}  // namespace
+
+std::vector<TenantSpec> parse_tenant_specs(std::string_view spec) {
+  std::vector<TenantSpec> specs;
+  if (trim_ascii(spec).empty()) {
+    return specs;
+  }
+
+  for (const auto& entry : split(spec, ';')) {
+    if (entry.empty()) {
+      continue;
+    }
+    const auto fields = split(entry, ':');
+    if (fields.size() < 3 || fields.size() > 5) {
+      throw ConfigError("TENANTS entry '" + entry +
+                        "' must be name:api_key:weight[:max_concurrent[:audio_sec_per_min]]");
+    }
+
+    TenantSpec t;
+    t.name    = fields[0];
+    t.api_key = fields[1];
+    if (t.name.empty()) {
+      throw ConfigError("TENANTS entry '" + entry + "': empty tenant name");
+    }
+    if (t.api_key.empty() && t.name != "default") {
+      throw ConfigError("TENANTS entry '" + entry + "': empty api key");
+    }
+
+    const auto weight = parse_field<long long>(fields[2], entry, "weight", parse_integer);
+    if (weight < 1 || weight > 1000) {
+      throw ConfigError("TENANTS entry '" + entry + "': weight must be in [1, 1000]");
+    }
+    t.weight = static_cast<uint32_t>(weight);
+
+    if (fields.size() > 3 && !fields[3].empty()) {
+      t.max_concurrent = parse_field<size_t>(fields[3], entry, "max_concurrent", parse_unsigned);
+    }
+    if (fields.size() > 4 && !fields[4].empty()) {
+      t.audio_sec_per_min = parse_field<double>(fields[4], entry, "audio_sec_per_min", parse_double);
+      if (t.audio_sec_per_min < 0.0) {
+        throw ConfigError("TENANTS entry '" + entry + "': audio_sec_per_min must be >= 0");
+      }
+    }
+
+    const auto duplicate = std::find_if(specs.begin(), specs.end(), [&t](const TenantSpec& other) {
+      return other.name == t.name || (!t.api_key.empty() && other.api_key == t.api_key);
+    });
+    if (duplicate != specs.end()) {
+      throw ConfigError("TENANTS entry '" + entry + "': duplicate tenant name or api key");
+    }
+    specs.push_back(std::move(t));
+  }
+  return specs;
+}
+
+TokenBucket::TokenBucket(double rate_per_sec, double burst, Clock::time_point now)
+    : rate_per_sec_(rate_per_sec), burst_(burst), tokens_(burst), last_refill_(now) {}
+
+void TokenBucket::refill(Clock::time_point now) {
+  if (now <= last_refill_) {
+    return;
+  }
+  const double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+  tokens_              = std::min(burst_, tokens_ + elapsed * rate_per_sec_);
+  last_refill_         = now;
+}
+
+bool TokenBucket::has_tokens(Clock::time_point now) {
+  refill(now);
+  return tokens_ > 0.0;
+}
+
+void TokenBucket::charge(double amount, Clock::time_point now) {
+  refill(now);
+  tokens_ -= amount;
+}
+
+double TokenBucket::available(Clock::time_point now) {
+  refill(now);
+  return tokens_;
+}
+
+TenantRegistry::TenantRegistry(const std::vector<TenantSpec>& specs) {
+  auto make_state = [](const TenantSpec& spec) {
+    auto state  = std::make_unique<State>();
+    state->spec = spec;
+    if (spec.audio_sec_per_min > 0.0) {
+      // One minute worth of audio is the burst: a tenant may submit a
+      // minute-long file at once but not sustain more than its rate.
+      state->bucket = std::make_unique<TokenBucket>(spec.audio_sec_per_min / 60.0, spec.audio_sec_per_min);
+    }
+    return state;
+  };
+
+  TenantSpec default_spec;
+  default_spec.name = "default";
+  const auto it =
+      std::find_if(specs.begin(), specs.end(), [](const TenantSpec& s) { return s.name == "default"; });
+  if (it != specs.end()) {
+    default_spec         = *it;
+    default_spec.api_key = {};
+  }
+  tenants_.push_back(make_state(default_spec));
+
+  for (const auto& spec : specs) {
+    if (spec.name == "default") {
+      continue;
+    }
+    by_key_.emplace(spec.api_key, tenants_.size());
+    tenants_.push_back(make_state(spec));
+  }
+}
+
+size_t TenantRegistry::resolve(std::string_view api_key) const {
+  if (api_key.empty() || by_key_.empty()) {
+    return kDefaultTenant;
+  }
+  const auto it = by_key_.find(std::string(api_key));
+  return it != by_key_.end() ? it->second : kDefaultTenant;
+}
+
+size_t TenantRegistry::size() const noexcept {
+  return tenants_.size();
+}
+
+const TenantSpec& TenantRegistry::spec(size_t tenant) const {
+  return tenants_.at(tenant)->spec;
+}
+
+std::vector<uint32_t> TenantRegistry::weights() const {
+  std::vector<uint32_t> out;
+  out.reserve(tenants_.size());
+  for (const auto& t : tenants_) {
+    out.push_back(t->spec.weight);
+  }
+  return out;
+}
+
+TenantAdmission TenantRegistry::try_admit(size_t tenant) {
+  auto& state = *tenants_.at(tenant);
+  if (!has_audio_quota(tenant)) {
+    return TenantAdmission::QuotaExceeded;
+  }
+
+  const size_t limit   = state.spec.max_concurrent;
+  size_t       current = state.active.load(std::memory_order_relaxed);
+  do {
+    if (limit > 0 && current >= limit) {
+      return TenantAdmission::ConcurrencyLimit;
+    }
+  } while (!state.active.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel,
+                                               std::memory_order_relaxed));
+  return TenantAdmission::Admitted;
+}
+
+void TenantRegistry::release(size_t tenant) {
+  tenants_.at(tenant)->active.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void TenantRegistry::charge_audio(size_t tenant, double audio_sec) {
+  auto& state = *tenants_.at(tenant);
+  if (!state.bucket || audio_sec <= 0.0) {
+    return;
+  }
+  const std::scoped_lock lock(state.bucket_mutex);
+  state.bucket->charge(audio_sec);
+}
+
+bool TenantRegistry::has_audio_quota(size_t tenant) {
+  auto& state = *tenants_.at(tenant);
+  if (!state.bucket) {
+    return true;
+  }
+  const std::scoped_lock lock(state.bucket_mutex);
+  return state.bucket->has_tokens();
+}
+
+size_t TenantRegistry::active(size_t tenant) const {
+  return tenants_.at(tenant)->active.load(std::memory_order_relaxed);
+}
+
+}  // namespace asr
@@ -7,11 +7,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <exception>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
+#include "asr/alloc_profiler.h"
 #include "asr/span.h"
 
 namespace asr {
@@ -82,71 +85,95 @@ VoiceActivityDetector::VoiceActivityDetector(const VadConfig& config)
                     0.0f);
   context_.resize(static_cast<size_t>(config_.context_size), 0.0f);
   sr_tensor_ = static_cast<int64_t>(config_.sample_rate);
-  state_.fill(0.0f);
+  for (auto& state : states_) {
+    state.fill(0.0f);
+  }
+  bind_tensors();
   prefix_padding_samples_ =
       std::max<int64_t>(0, static_cast<int64_t>(config_.prefix_padding_ms) * config_.sample_rate / 1000);
   pre_roll_.reserve(static_cast<size_t>(prefix_padding_samples_));
   speech_buf_.reserve(
       static_cast<size_t>(config_.max_speech_duration * static_cast<float>(config_.sample_rate)) +
       static_cast<size_t>(prefix_padding_samples_));
+  window_probs_.reserve(
+      static_cast<size_t>(config_.max_speech_duration * static_cast<float>(config_.sample_rate)) /
+          static_cast<size_t>(config_.window_size) +
+      1);
 
   spdlog::info("VAD initialized: threshold={}, window={}, context={}", config_.threshold, config_.window_size,
                config_.context_size);
 }
 
+void VoiceActivityDetector::bind_tensors() {
+  const auto                   input_len   = static_cast<int64_t>(config_.context_size + config_.window_size);
+  const std::array<int64_t, 2> input_shape = {1, input_len};
+  const std::array<int64_t, 3> state_shape = {2, 1, 128};
+  const std::array<int64_t, 1> sr_shape    = {1};
+  const std::array<int64_t, 2> prob_shape  = {1, 1};
+
+  const auto& memory_info = runtime_->memory_info;
+  for (size_t i = 0; i < bindings_.size(); ++i) {
+    auto& binding = bindings_[i];
+    auto& state   = states_[i];
+    auto& next    = states_[1 - i];
+
+    binding = Ort::IoBinding(runtime_->session);
+    binding.BindInput("input", Ort::Value::CreateTensor<float>(memory_info, input_buf_.data(),
+                                                               input_buf_.size(), input_shape.data(), 2));
+    binding.BindInput("state", Ort::Value::CreateTensor<float>(memory_info, state.data(), state.size(),
+                                                               state_shape.data(), 3));
+    binding.BindInput("sr",
+                      Ort::Value::CreateTensor<int64_t>(memory_info, &sr_tensor_, 1, sr_shape.data(), 1));
+    binding.BindOutput("output",
+                       Ort::Value::CreateTensor<float>(memory_info, &prob_, 1, prob_shape.data(), 2));
+    binding.BindOutput("stateN", Ort::Value::CreateTensor<float>(memory_info, next.data(), next.size(),
+                                                                 state_shape.data(), 3));
+  }
+}
+
 float VoiceActivityDetector::infer(span<const float> samples) {
   if (static_cast<int>(samples.size()) != config_.window_size) {
     throw std::invalid_argument("infer: expected " + std::to_string(config_.window_size) + " samples, got " +
                                 std::to_string(samples.size()));
   }
 
-  // Build input: [context | samples]
+  // Build input: [context | samples] in the bound buffer
   std::memcpy(input_buf_.data(), context_.data(), static_cast<size_t>(config_.context_size) * sizeof(float));
   std::memcpy(input_buf_.data() + config_.context_size, samples.data(),
               static_cast<size_t>(config_.window_size) * sizeof(float));
 
-  // Create tensors from pre-allocated buffers
-  std::array<int64_t, 2> input_shape = {1, static_cast<int64_t>(config_.context_size + config_.window_size)};
-  std::array<int64_t, 3> state_shape = {2, 1, 128};
-  std::array<int64_t, 1> sr_shape    = {1};
-
-  auto input_tensor = Ort::Value::CreateTensor<float>(runtime_->memory_info, input_buf_.data(),
-                                                      input_buf_.size(), input_shape.data(), 2);
-  auto state_tensor = Ort::Value::CreateTensor<float>(runtime_->memory_info, state_.data(), state_.size(),
-                                                      state_shape.data(), 3);
-  auto sr_tensor =
-      Ort::Value::CreateTensor<int64_t>(runtime_->memory_info, &sr_tensor_, 1, sr_shape.data(), 1);
-
-  std::array<Ort::Value, 3> inputs;
-  inputs[0] = std::move(input_tensor);
-  inputs[1] = std::move(state_tensor);
-  inputs[2] = std::move(sr_tensor);
-
-  // Run inference
-  auto outputs =
-      runtime_->session.Run(run_options_, kInputNames, inputs.data(), inputs.size(), kOutputNames, 2);
-
-  // Extract probability
-  const float prob = outputs[0].GetTensorData<float>()[0];
-
-  // Update state from output
-  const auto* new_state = outputs[1].GetTensorData<float>();
-  std::memcpy(state_.data(), new_state, kStateSize * sizeof(float));
+  // Run inference: outputs land in prob_ and the other state buffer
+  runtime_->session.Run(run_options_, bindings_[state_idx_]);
+  state_idx_ = 1 - state_idx_;
 
   // Update context with last context_size samples from input
   std::memcpy(context_.data(), samples.data() + (config_.window_size - config_.context_size),
               static_cast<size_t>(config_.context_size) * sizeof(float));
 
-  return prob;
+  return prob_;
 }
 
 void VoiceActivityDetector::accept_waveform(span<const float> samples) {
+  const AllocTagScope alloc_scope(AllocTag::Vad);
   if (static_cast<int>(samples.size()) != config_.window_size) {
     throw std::invalid_argument("accept_waveform: expected " + std::to_string(config_.window_size) +
                                 " samples, got " + std::to_string(samples.size()));
   }
+  accept_window(samples, infer(samples));
+}
+
+float VoiceActivityDetector::speech_probability(span<const float> samples) {
+  const AllocTagScope alloc_scope(AllocTag::Vad);
+  return infer(samples);
+}
+
+void VoiceActivityDetector::accept_window(span<const float> samples, float prob) {
+  const AllocTagScope alloc_scope(AllocTag::Vad);
+  if (static_cast<int>(samples.size()) != config_.window_size) {
+    throw std::invalid_argument("accept_window: expected " + std::to_string(config_.window_size) +
+                                " samples, got " + std::to_string(samples.size()));
+  }
 
-  const float   prob           = infer(samples);
   const int64_t window_samples = config_.window_size;
   const int64_t window_start   = total_samples_seen_;
   const int64_t window_end     = window_start + window_samples;
@@ -161,8 +188,10 @@ void VoiceActivityDetector::accept_waveform(span<const float> samples) {
       in_speech_            = true;
       speech_start_samples_ = 0;
       speech_buf_.clear();
+      window_probs_.clear();
       current_start_sample_ = std::max<int64_t>(0, window_start - static_cast<int64_t>(pre_roll_.size()));
       current_end_sample_   = window_end;
+      speech_buf_head_      = pre_roll_.size();
       if (!pre_roll_.empty()) {
         speech_buf_.insert(speech_buf_.end(), pre_roll_.begin(), pre_roll_.end());
       }
@@ -170,6 +199,7 @@ void VoiceActivityDetector::accept_waveform(span<const float> samples) {
     }
     silence_samples_ = 0;
     speech_buf_.insert(speech_buf_.end(), samples.begin(), samples.end());
+    window_probs_.push_back(prob);
     speech_start_samples_ += window_samples;
     current_end_sample_ = window_end;
 
@@ -183,6 +213,7 @@ void VoiceActivityDetector::accept_waveform(span<const float> samples) {
     if (in_speech_) {
       silence_samples_ += window_samples;
       speech_buf_.insert(speech_buf_.end(), samples.begin(), samples.end());
+      window_probs_.push_back(prob);
       speech_start_samples_ += window_samples;
       current_end_sample_ = std::max<int64_t>(current_start_sample_, window_end - silence_samples_);
 
@@ -202,6 +233,10 @@ void VoiceActivityDetector::accept_waveform(span<const float> samples) {
 }
 
 void VoiceActivityDetector::finalize_segment() {
+  const bool split_remainder = split_remainder_;
+  split_remainder_           = false;
+  speech_buf_head_           = 0;
+  window_probs_.clear();
   if (speech_buf_.empty()) {
     in_speech_            = false;
     silence_samples_      = 0;
@@ -212,11 +247,21 @@ void VoiceActivityDetector::finalize_segment() {
   const size_t trailing_silence = silence_samples_ > 0 ? static_cast<size_t>(silence_samples_) : 0U;
   if (trailing_silence > 0 && trailing_silence < speech_buf_.size()) {
     speech_buf_.resize(speech_buf_.size() - trailing_silence);
+  } else if (split_remainder && trailing_silence >= speech_buf_.size()) {
+    // Only silence was left after the last split: close the speech run
+    // started before it without queueing an empty segment.
+    transitions_.push_back({SpeechTransition::Stopped, current_end_sample_});
+    in_speech_            = false;
+    silence_samples_      = 0;
+    speech_start_samples_ = 0;
+    speech_buf_.clear();
+    return;
   }
 
-  // Check minimum speech duration
+  // Check minimum speech duration; the tail of a split segment is kept
+  // however short, its speech started long before the cut.
   float duration = static_cast<float>(speech_buf_.size()) / static_cast<float>(config_.sample_rate);
-  if (duration < config_.min_speech_duration) {
+  if (!split_remainder && duration < config_.min_speech_duration) {
     spdlog::debug("VAD: discarding short segment ({:.3f}s < {:.3f}s)", duration, config_.min_speech_duration);
     in_speech_            = false;
     silence_samples_      = 0;
@@ -261,11 +306,92 @@ bool VoiceActivityDetector::is_speech() const {
 }
 
 void VoiceActivityDetector::flush() {
+  const AllocTagScope alloc_scope(AllocTag::Vad);
   if (in_speech_ && !speech_buf_.empty()) {
     finalize_segment();
   }
 }
 
+bool VoiceActivityDetector::split_open_segment(int64_t lookback_samples) {
+  const AllocTagScope alloc_scope(AllocTag::Vad);
+  if (!in_speech_ || window_probs_.empty()) {
+    return false;
+  }
+
+  const auto window  = static_cast<size_t>(config_.window_size);
+  const auto windows = window_probs_.size();
+  const auto min_speech_samples =
+      static_cast<size_t>(config_.min_speech_duration * static_cast<float>(config_.sample_rate));
+  const auto lookback_windows =
+      std::max<size_t>(1, static_cast<size_t>(std::max<int64_t>(0, lookback_samples)) / window);
+
+  // Cutting after window k leaves speech_buf_head_ + (k + 1) * window samples
+  // in the head. Only the recent tail is searched, and the head must be long
+  // enough to survive as a segment of its own.
+  size_t first = windows > lookback_windows ? windows - lookback_windows : 0;
+  if (min_speech_samples > speech_buf_head_) {
+    const size_t min_windows = (min_speech_samples - speech_buf_head_ + window - 1) / window;
+    first                    = std::max(first, min_windows - 1);
+  }
+  if (first >= windows) {
+    return false;
+  }
+  size_t cut = first;
+  for (size_t k = first + 1; k < windows; ++k) {
+    if (window_probs_[k] <= window_probs_[cut]) {  // ties go to the later boundary
+      cut = k;
+    }
+  }
+
+  const size_t head = speech_buf_head_ + (cut + 1) * window;
+  const size_t rest = speech_buf_.size() - head;
+
+  SpeechSegment segment;
+  segment.start_sample = current_start_sample_;
+  segment.end_sample   = current_start_sample_ + static_cast<int64_t>(head);
+  segment.samples      = std::move(speech_buf_);
+  // cppcheck-suppress accessMoved  ; reserve() on moved-from vector is valid per C++ standard
+  speech_buf_.reserve(
+      static_cast<size_t>(config_.max_speech_duration * static_cast<float>(config_.sample_rate)) +
+      static_cast<size_t>(prefix_padding_samples_));
+  speech_buf_.assign(segment.samples.begin() + static_cast<ptrdiff_t>(head), segment.samples.end());
+  segment.samples.resize(head);
+  spdlog::debug("VAD: split open segment at sample {} (p={:.3f}), {} samples stay open", segment.end_sample,
+                window_probs_[cut], rest);
+
+  window_probs_.erase(window_probs_.begin(), window_probs_.begin() + static_cast<ptrdiff_t>(cut + 1));
+  speech_buf_head_      = 0;
+  split_remainder_      = true;
+  current_start_sample_ = segment.end_sample;
+  current_end_sample_   = std::max(current_end_sample_, current_start_sample_);
+  speech_start_samples_ = static_cast<int64_t>(rest);
+  silence_samples_      = std::min(silence_samples_, static_cast<int64_t>(rest));
+  segments_.push_back(std::move(segment));
+  return true;
+}
+
+span<const float> VoiceActivityDetector::open_speech() const {
+  if (!in_speech_) {
+    return {};
+  }
+  const auto silence =
+      std::min(static_cast<size_t>(std::max<int64_t>(0, silence_samples_)), speech_buf_.size());
+  return {speech_buf_.data(), speech_buf_.size() - silence};
+}
+
+int64_t VoiceActivityDetector::open_start_sample() const {
+  return current_start_sample_;
+}
+
+float VoiceActivityDetector::silence_progress() const {
+  const auto min_silence_samples =
+      static_cast<int64_t>(config_.min_silence_duration * static_cast<float>(config_.sample_rate));
+  if (!in_speech_ || min_silence_samples <= 0) {
+    return 0.0f;
+  }
+  return static_cast<float>(silence_samples_) / static_cast<float>(min_silence_samples);
+}
+
 void VoiceActivityDetector::reset() {
   in_speech_            = false;
   silence_samples_      = 0;
@@ -273,12 +399,22 @@ void VoiceActivityDetector::reset() {
   total_samples_seen_   = 0;
   current_start_sample_ = 0;
   current_end_sample_   = 0;
+  speech_buf_head_      = 0;
+  split_remainder_      = false;
   speech_buf_.clear();
+  window_probs_.clear();
   pre_roll_.clear();
   segments_.clear();
   transitions_.clear();
   context_.assign(static_cast<size_t>(config_.context_size), 0.0f);
-  state_.fill(0.0f);
+  for (auto& state : states_) {
+    state.fill(0.0f);
+  }
+  state_idx_ = 0;
+}
+
+void VoiceActivityDetector::set_threshold(float threshold) {
+  config_.threshold = threshold;
 }
 
 bool VoiceActivityDetector::has_transition() const {
@@ -313,4 +449,112 @@ void VoiceActivityDetector::append_pre_roll(span<const float> samples) {
   pre_roll_.insert(pre_roll_.end(), samples.begin(), samples.end());
 }
 
+namespace {
+
+constexpr float kOfflineShardMinSec    = 30.0f;
+constexpr float kOfflineShardWarmupSec = 2.0f;
+
+}  // namespace
+
+std::vector<VadShard> plan_vad_shards(size_t windows, size_t max_shards, size_t min_shard_windows,
+                                      size_t warmup_windows) {
+  const size_t count =
+      std::max<size_t>(1, std::min(max_shards, windows / std::max<size_t>(1, min_shard_windows)));
+  std::vector<VadShard> shards(count);
+  for (size_t k = 0; k < count; ++k) {
+    shards[k].begin        = windows * k / count;
+    shards[k].end          = windows * (k + 1) / count;
+    shards[k].warmup_begin = shards[k].begin - std::min(warmup_windows, shards[k].begin);
+  }
+  return shards;
+}
+
+std::vector<SpeechSegment> segment_speech(const VadConfig& config, span<const float> audio, size_t threads) {
+  const AllocTagScope   alloc_scope(AllocTag::Vad);
+  VoiceActivityDetector vad(config);
+  const auto            window  = static_cast<size_t>(config.window_size);
+  const size_t          windows = (audio.size() + window - 1) / window;
+
+  std::vector<float> tail;
+  if (audio.size() % window != 0) {
+    tail.assign(audio.begin() + static_cast<ptrdiff_t>((windows - 1) * window), audio.end());
+    tail.resize(window, 0.0f);
+  }
+  const auto window_at = [&](size_t i) -> span<const float> {
+    return (i + 1) * window <= audio.size() ? audio.subspan(i * window, window) : span<const float>(tail);
+  };
+
+  std::vector<SpeechSegment> segments;
+  const auto                 drain = [&vad, &segments]() {
+    while (!vad.empty()) {
+      segments.push_back(vad.front());
+      vad.pop();
+    }
+    while (vad.has_transition()) {
+      vad.pop_transition();
+    }
+  };
+
+  const auto per_sec = static_cast<float>(config.sample_rate) / static_cast<float>(window);
+  const auto shards  = plan_vad_shards(windows, threads, static_cast<size_t>(kOfflineShardMinSec * per_sec),
+                                       static_cast<size_t>(kOfflineShardWarmupSec * per_sec));
+  if (shards.size() == 1) {
+    for (size_t i = 0; i < windows; ++i) {
+      vad.accept_waveform(window_at(i));
+      drain();
+    }
+    vad.flush();
+    drain();
+    return segments;
+  }
+
+  // Shard 0 is scored on the segmenter's own detector: accept_window() does
+  // not touch the model state, so the two never interfere.
+  std::vector<float>              probs(windows);
+  std::vector<std::exception_ptr> errors(shards.size());
+  const auto score = [&](VoiceActivityDetector& detector, size_t k) {
+    const auto& shard = shards[k];
+    for (size_t i = shard.warmup_begin; i < shard.begin; ++i) {
+      (void)detector.speech_probability(window_at(i));
+    }
+    for (size_t i = shard.begin; i < shard.end; ++i) {
+      probs[i] = detector.speech_probability(window_at(i));
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(shards.size() - 1);
+  for (size_t k = 1; k < shards.size(); ++k) {
+    workers.emplace_back([&config, &score, &errors, k]() {
+      const AllocTagScope worker_scope(AllocTag::Vad);
+      try {
+        VoiceActivityDetector detector(config);
+        score(detector, k);
+      } catch (...) {
+        errors[k] = std::current_exception();
+      }
+    });
+  }
+  try {
+    score(vad, 0);
+  } catch (...) {
+    errors[0] = std::current_exception();
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  for (size_t i = 0; i < windows; ++i) {
+    vad.accept_window(window_at(i), probs[i]);
+    drain();
+  }
+  vad.flush();
+  drain();
+  return segments;
+}
+
 }  // namespace asr
@@ -0,0 +1,83 @@
+#include "asr/vad_threshold.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "asr/span.h"
+
+namespace asr {
+
+namespace {
+
+constexpr double kNoiseFallRate = 0.2;   // per window below the estimate
+constexpr double kNoiseRiseRate = 0.01;  // per window above it, ~9 s to settle on a 40 dB rise
+constexpr double kMinPower      = 1e-12;
+
+}  // namespace
+
+AdaptiveVadThreshold::AdaptiveVadThreshold(float base, float max)
+    : base_(base), max_(std::max(base, max)), threshold_(base) {}
+
+void AdaptiveVadThreshold::on_window(span<const float> samples, bool speech) {
+  if (speech || samples.empty()) {
+    return;
+  }
+  double sum = 0.0;
+  for (const float s : samples) {
+    sum += static_cast<double>(s) * static_cast<double>(s);
+  }
+  const double level_db = 10.0 * std::log10(std::max(sum / static_cast<double>(samples.size()), kMinPower));
+  if (!has_noise_) {
+    noise_db_  = level_db;
+    has_noise_ = true;
+  } else {
+    noise_db_ += (level_db < noise_db_ ? kNoiseFallRate : kNoiseRiseRate) * (level_db - noise_db_);
+  }
+  update();
+}
+
+bool AdaptiveVadThreshold::on_decode(bool empty) {
+  outcomes_[outcome_next_] = empty;
+  outcome_next_            = (outcome_next_ + 1) % kHistory;
+  outcome_count_           = std::min(outcome_count_ + 1, kHistory);
+
+  const float ratio = empty_ratio();
+  float       lift  = decode_lift_;
+  if (outcome_count_ >= kMinDecodes && ratio >= 0.5f) {
+    lift += kStep;
+  } else if (outcome_count_ == kHistory && ratio <= 1.0f / static_cast<float>(kHistory)) {
+    lift -= kStep;
+  } else {
+    return false;
+  }
+  lift           = std::clamp(lift, 0.0f, max_ - base_);
+  outcome_count_ = 0;
+  outcome_next_  = 0;
+  if (lift == decode_lift_) {
+    return false;
+  }
+  decode_lift_ = lift;
+  update();
+  return true;
+}
+
+float AdaptiveVadThreshold::noise_floor_dbfs() const noexcept {
+  return has_noise_ ? static_cast<float>(noise_db_) : kQuietDbfs;
+}
+
+float AdaptiveVadThreshold::empty_ratio() const noexcept {
+  if (outcome_count_ == 0) {
+    return 0.0f;
+  }
+  const auto empties =
+      std::count(outcomes_.begin(), outcomes_.begin() + static_cast<std::ptrdiff_t>(outcome_count_), true);
+  return static_cast<float>(empties) / static_cast<float>(outcome_count_);
+}
+
+void AdaptiveVadThreshold::update() {
+  const float noisy = std::clamp((noise_floor_dbfs() - kQuietDbfs) / (kNoisyDbfs - kQuietDbfs), 0.0f, 1.0f);
+  threshold_        = std::min(max_, base_ + 0.5f * noisy * (max_ - base_) + decode_lift_);
+}
+
+}  // namespace asr
@@ -14,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "asr/request_timing.h"
 #include "asr/string_utils.h"
 #include "nlohmann/detail/json_ref.hpp"
 
@@ -332,7 +333,10 @@ WhisperRenderedResponse render_whisper_transcription_response(
 
   if (request.response_format == WhisperResponseFormat::Json) {
     nlohmann::json j;
-    j["text"]             = payload.text;
+    j["text"] = payload.text;
+    if (payload.timings.has_value()) {
+      j["timings"] = request_timing_json(*payload.timings);
+    }
     rendered.body         = j.dump();
     rendered.content_type = "application/json";
     return rendered;
@@ -379,6 +383,9 @@ WhisperRenderedResponse render_whisper_transcription_response(
   if (contains_timestamp_granularity(granularities, WhisperTimestampGranularity::Segment)) {
     j["segments"] = nlohmann::json::array({build_verbose_segment(payload)});
   }
+  if (payload.timings.has_value()) {
+    j["timings"] = request_timing_json(*payload.timings);
+  }
 
   rendered.body         = j.dump();
   rendered.content_type = "application/json";
@@ -0,0 +1,52 @@
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<size_t> g_alloc_count{0};
+std::atomic<size_t> g_alloc_bytes{0};
+thread_local bool   g_counting = false;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+void* operator new(std::size_t size) {
+  if (g_counting) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+  void* p = std::malloc(size);  // NOLINT(cppcoreguidelines-no-malloc)
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](std::size_t size) {
+  if (g_counting) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+  void* p = std::malloc(size);  // NOLINT(cppcoreguidelines-no-malloc)
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+void operator delete[](void* p, std::size_t /*size*/) noexcept {
+  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
+}
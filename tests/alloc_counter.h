@@ -0,0 +1,16 @@
+#pragma once
+
+// Global operator new/new[] replacement shared by the allocation-counting
+// benchmarks, built once as the asr_alloc_counter object library. Counting
+// is per thread and off until a measurement sets g_counting; the totals are
+// process-wide. A binary that links it cannot also link an asr_core built
+// with the allocation sampler, which replaces the same operators.
+
+#include <atomic>
+#include <cstddef>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+extern std::atomic<size_t> g_alloc_count;
+extern std::atomic<size_t> g_alloc_bytes;
+extern thread_local bool   g_counting;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
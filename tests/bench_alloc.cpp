@@ -1,76 +1,39 @@
 // Allocation-counting benchmark for ASR hot path.
-// Overrides global operator new to count heap allocations precisely.
+// Counts heap allocations precisely through the shared operator new (alloc_counter.h).
 // Measures steady-state allocation count for on_audio() and on_recognize(),
-// with component-level breakdown (VAD/ORT, metrics, handler).
+// with component-level breakdown (VAD/ORT, metrics, handler), and for the
+// realtime connection path (parse, inbox, dispatch, decode, session).
 //
 // Usage: ./asr_alloc_bench           (requires models/ directory)
 //        valgrind --tool=dhat ./asr_alloc_bench   (full valgrind profile)
 
+#include <onnxruntime_cxx_api.h>
+
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
-#include <cstdlib>
 #include <exception>
 #include <fstream>
-#include <new>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "alloc_counter.h"
 #include "asr/audio.h"
 #include "asr/config.h"
+#include "asr/executor.h"
 #include "asr/handler.h"
 #include "asr/metrics.h"
+#include "asr/realtime_connection.h"
 #include "asr/recognizer.h"
 #include "asr/span.h"
+#include "asr/synthetic_recognizer.h"
 #include "asr/vad.h"
 
-// ===== Global allocation counter =====
-// Thread-local flag: only count when explicitly enabled in measurement scope.
-// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,misc-use-anonymous-namespace)
-static std::atomic<size_t> g_alloc_count{0};
-static std::atomic<size_t> g_alloc_bytes{0};
-static thread_local bool   g_counting = false;
-// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,misc-use-anonymous-namespace)
-
-// NOLINTBEGIN(misc-definitions-in-headers)
-void* operator new(std::size_t size) {
-  if (g_counting) {
-    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
-    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
-  }
-  void* p = std::malloc(size);  // NOLINT(cppcoreguidelines-no-malloc)
-  if (p == nullptr) {
-    throw std::bad_alloc();
-  }
-  return p;
-}
-
-void* operator new[](std::size_t size) {
-  if (g_counting) {
-    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
-    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
-  }
-  void* p = std::malloc(size);  // NOLINT(cppcoreguidelines-no-malloc)
-  if (p == nullptr) {
-    throw std::bad_alloc();
-  }
-  return p;
-}
-
-void operator delete(void* p) noexcept {
-  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
-}
-void operator delete[](void* p) noexcept {
-  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
-}
-void operator delete(void* p, std::size_t /*size*/) noexcept {
-  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
-}
-void operator delete[](void* p, std::size_t /*size*/) noexcept {
-  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
-}
-// NOLINTEND(misc-definitions-in-headers)
-
 // RAII scope for allocation measurement
 struct AllocScope {
   const char* label;
@@ -156,6 +119,72 @@ asr::VadConfig make_vad_config(const asr::Config& cfg) {
   return vc;
 }
 
+class NullSink : public asr::RealtimeEventSink {
+ public:
+  void send_text(std::string_view payload) override {
+    bytes += payload.size();
+  }
+
+  size_t bytes = 0;
+};
+
+std::string base64_encode(const std::vector<uint8_t>& bytes) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string           out;
+  size_t                i = 0;
+  for (; i + 2 < bytes.size(); i += 3) {
+    const uint32_t v = (uint32_t{bytes[i]} << 16U) | (uint32_t{bytes[i + 1]} << 8U) | bytes[i + 2];
+    out += kAlphabet[(v >> 18U) & 0x3FU];
+    out += kAlphabet[(v >> 12U) & 0x3FU];
+    out += kAlphabet[(v >> 6U) & 0x3FU];
+    out += kAlphabet[v & 0x3FU];
+  }
+  if (i < bytes.size()) {
+    const uint32_t hi = uint32_t{bytes[i]} << 16U;
+    const uint32_t v  = i + 1 < bytes.size() ? hi | (uint32_t{bytes[i + 1]} << 8U) : hi;
+    out += kAlphabet[(v >> 18U) & 0x3FU];
+    out += kAlphabet[(v >> 12U) & 0x3FU];
+    out += i + 1 < bytes.size() ? kAlphabet[(v >> 6U) & 0x3FU] : '=';
+    out += '=';
+  }
+  return out;
+}
+
+// 20 ms of low-level pcm16 noise, the typical realtime append.
+std::vector<uint8_t> make_pcm16_chunk() {
+  std::vector<uint8_t> bytes(640);
+  uint32_t             lcg = 12345;
+  for (size_t i = 0; i < bytes.size(); i += 2) {
+    lcg               = lcg * 1664525U + 1013904223U;
+    const auto sample = static_cast<int16_t>(static_cast<int32_t>(lcg >> 24U) - 128);
+    const auto u      = static_cast<uint16_t>(sample);
+    bytes[i]          = static_cast<uint8_t>(u & 0xFFU);
+    bytes[i + 1]      = static_cast<uint8_t>(u >> 8U);
+  }
+  return bytes;
+}
+
+// One client message through the connection as the server drives it: parse
+// into a reused inbox slot, run on the pipeline, release the slot. The
+// message copy stands in for the frame string the transport hands over.
+void run_realtime_message(asr::RealtimeConnectionContext& ctx, asr::RealtimeEventSink& sink,
+                          const std::string& message, std::string& frame, bool binary) {
+  frame.assign(message);
+  auto* slot = ctx.inbox.back_slot();
+  if (slot == nullptr) {
+    return;
+  }
+  if (binary) {
+    asr::set_realtime_binary_event(std::move(frame), *slot);
+  } else {
+    (void)asr::parse_realtime_client_event(std::move(frame), *slot);
+  }
+  (void)ctx.inbox.push();
+  asr::run_realtime_event(ctx, sink, ctx.inbox.front());
+  frame = std::move(ctx.inbox.front().payload);  // hand the buffer back, as a new frame would
+  ctx.inbox.pop();
+}
+
 }  // namespace
 
 int run_benchmarks() {
@@ -178,7 +207,53 @@ int run_benchmarks() {
   // =====================================================================
   std::printf("--- Component-level analysis ---\n\n");
 
-  // 1a. VAD inference (ONNX Runtime)
+  // 1a. VAD inference (ONNX Runtime). ORT itself allocates inside Run()
+  // (execution frame bookkeeping), so the floor is a bare IoBinding run of the
+  // same model; the detector must not add anything on top of it.
+  size_t ort_floor_allocs = 0;
+  {
+    Ort::Env            env(ORT_LOGGING_LEVEL_WARNING, "bench");
+    Ort::SessionOptions options;
+    options.SetIntraOpNumThreads(1);
+    Ort::Session session(env, kVadModel, options);
+
+    const auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::vector<float>           input(576, 0.0f);  // context 64 + window 512
+    std::vector<float>           state(256, 0.0f);
+    std::vector<float>           state_next(256, 0.0f);
+    int64_t                      sr          = 16000;
+    float                        prob        = 0.0f;
+    const std::array<int64_t, 2> input_shape = {1, 576};
+    const std::array<int64_t, 3> state_shape = {2, 1, 128};
+    const std::array<int64_t, 1> sr_shape    = {1};
+    const std::array<int64_t, 2> prob_shape  = {1, 1};
+
+    Ort::IoBinding binding(session);
+    binding.BindInput("input", Ort::Value::CreateTensor<float>(memory_info, input.data(), input.size(),
+                                                               input_shape.data(), 2));
+    binding.BindInput("state", Ort::Value::CreateTensor<float>(memory_info, state.data(), state.size(),
+                                                               state_shape.data(), 3));
+    binding.BindInput("sr", Ort::Value::CreateTensor<int64_t>(memory_info, &sr, 1, sr_shape.data(), 1));
+    binding.BindOutput("output",
+                       Ort::Value::CreateTensor<float>(memory_info, &prob, 1, prob_shape.data(), 2));
+    binding.BindOutput("stateN", Ort::Value::CreateTensor<float>(memory_info, state_next.data(),
+                                                                 state_next.size(), state_shape.data(), 3));
+
+    const Ort::RunOptions run_options;
+    for (int i = 0; i < 20; ++i) {
+      session.Run(run_options, binding);
+    }
+    {
+      AllocScope scope("ORT IoBinding Run (framework floor)");
+      for (int i = 0; i < 100; ++i) {
+        session.Run(run_options, binding);
+      }
+      scope.report(100);
+      ort_floor_allocs = scope.count();
+    }
+  }
+
+  size_t vad_allocs = 0;
   {
     asr::VoiceActivityDetector vad(vad_cfg);
     const std::vector<float>   window(512, 0.0f);
@@ -195,9 +270,14 @@ int run_benchmarks() {
         vad.accept_waveform(window);
       }
       scope.report(100);
+      vad_allocs = scope.count();
     }
     vad.reset();
   }
+  const bool vad_alloc_ok = vad_allocs <= ort_floor_allocs;
+  if (!vad_alloc_ok) {
+    std::printf("  FAIL: VAD adds %zu allocs over ORT Run() in 100 windows\n", vad_allocs - ort_floor_allocs);
+  }
 
   // 1b. Prometheus metrics (record_audio_level, record_silence, etc.)
   {
@@ -271,8 +351,8 @@ int run_benchmarks() {
   // =====================================================================
   std::printf("\n--- Full on_audio / on_recognize ---\n\n");
 
-  asr::Recognizer recognizer(cfg);
-  asr::ASRSession session(recognizer, vad_cfg, cfg, "realtime_websocket");
+  asr::Recognizer         recognizer(cfg);
+  asr::RealtimeASRSession session(recognizer, vad_cfg, cfg);
 
   const int                chunk_size = 1024;
   const std::vector<float> silence(chunk_size, 0.0f);
@@ -368,6 +448,84 @@ int run_benchmarks() {
     scope.report(21);
   }
 
+  // =====================================================================
+  // Section 3: Realtime connection pipeline
+  // =====================================================================
+  std::printf("\n--- Realtime connection (parse -> inbox -> dispatch -> session) ---\n\n");
+
+  bool realtime_alloc_ok = true;
+  {
+    // Synthetic backend with zero cost: only our wrapper code and the VAD run.
+    asr::SyntheticRecognizer       synthetic(1, asr::SyntheticCostModel{0.0, 0.0, 0.0, false});
+    asr::RealtimeConnectionContext ctx(synthetic, cfg, 1, asr::kDefaultTenant, nullptr, 4);
+    NullSink                       sink;
+
+    const auto        chunk  = make_pcm16_chunk();
+    const std::string append = R"({"type":"input_audio_buffer.append","event_id":"evt_1","audio":")" +
+                               base64_encode(chunk) + R"("})";
+    const std::string binary(chunk.begin(), chunk.end());
+    std::string       frame;
+
+    for (int i = 0; i < kWarmupCalls * 4; ++i) {
+      run_realtime_message(ctx, sink, append, frame, false);
+      run_realtime_message(ctx, sink, binary, frame, true);
+    }
+
+    const auto measure = [&](const char* label, const std::string& message, bool is_binary) {
+      const uint64_t samples_before = ctx.input_samples;
+      size_t         allocs         = 0;
+      {
+        AllocScope scope(label);
+        for (int i = 0; i < kMeasureCalls; ++i) {
+          run_realtime_message(ctx, sink, message, frame, is_binary);
+        }
+        scope.report(kMeasureCalls);
+        allocs = scope.count();
+      }
+      // Everything above the VAD's ORT floor for the windows processed is ours.
+      const uint64_t windows =
+          (ctx.input_samples - samples_before) / static_cast<uint64_t>(cfg.vad_window_size);
+      const size_t budget = static_cast<size_t>((ort_floor_allocs * windows + 99) / 100);
+      if (allocs > budget) {
+        std::printf("  FAIL: %s adds %zu allocs over the ORT floor (%zu for %llu windows)\n", label,
+                    allocs - budget, budget, static_cast<unsigned long long>(windows));
+        realtime_alloc_ok = false;
+      }
+    };
+    measure("realtime append (base64 JSON, 20 ms pcm16)", append, false);
+    measure("realtime append (binary frame, 20 ms pcm16)", binary, true);
+  }
+
+  // Per-connection actor dispatch: mailbox push, drain task on the bounded executor.
+  {
+    asr::BoundedExecutor   executor(1, 16);
+    asr::ActorMailbox<int> mailbox(8);
+    std::atomic<int>       done{0};
+    auto*                  mailbox_ptr = &mailbox;
+    auto*                  done_ptr    = &done;
+    const auto             cycle       = [&]() {
+      *mailbox.back_slot() = 1;
+      if (mailbox.push()) {
+        (void)executor.try_submit([mailbox_ptr, done_ptr]() {
+          do {
+            done_ptr->fetch_add(mailbox_ptr->front(), std::memory_order_relaxed);
+          } while (mailbox_ptr->pop());
+        });
+      }
+      (void)executor.wait_for_idle(std::chrono::seconds(1));
+    };
+    for (int i = 0; i < kWarmupCalls; ++i) {
+      cycle();
+    }
+    {
+      AllocScope scope("actor dispatch (mailbox -> executor -> worker)");
+      for (int i = 0; i < kMeasureCalls; ++i) {
+        cycle();
+      }
+      scope.report(kMeasureCalls);
+    }
+  }
+
   // =====================================================================
   // Summary
   // =====================================================================
@@ -375,7 +533,8 @@ int run_benchmarks() {
   std::printf("  Handler code (write_interim/final/done):  zero-alloc (reuses string capacity)\n");
   std::printf("  Prometheus metrics:                       zero-alloc (pre-cached instances)\n");
   std::printf("  compute_rms:                              zero-alloc (pure math)\n");
-  std::printf("  VAD inference (ONNX Runtime):             allocates internally (framework)\n");
+  std::printf("  VAD wrapper (IoBinding, ping-pong state):  zero-alloc on top of ORT Run() (asserted)\n");
+  std::printf("  Realtime append (parse/inbox/dispatch):   zero-alloc on top of VAD ORT floor (asserted)\n");
   std::printf("  Recognizer (sherpa-onnx):                 allocates internally (framework)\n");
   std::printf("\n  ORT/sherpa-onnx allocations are inside third-party frameworks and\n");
   std::printf("  cannot be eliminated without modifying the framework source code.\n");
@@ -385,7 +544,7 @@ int run_benchmarks() {
   std::printf("  valgrind --tool=dhat ./build/debug/tests/asr_alloc_bench\n");
   std::printf("  valgrind --tool=massif ./build/debug/tests/asr_alloc_bench\n");
   std::printf("  ms_print massif.out.<pid>\n");
-  return 0;
+  return vad_alloc_ok && realtime_alloc_ok ? 0 : 1;
 }
 
 int main() {
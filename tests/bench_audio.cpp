@@ -0,0 +1,372 @@
+// Audio decode and resample throughput benchmark.
+// Generates in-memory fixtures and measures each decode path:
+//   1. decode_audio_streamed on WAV (PCM16/PCM24/float32, mono/stereo, 8/16/44.1/48 kHz)
+//   2. decode_audio_streamed on Ogg Opus (when built with libopusfile)
+//   3. chunk size sweep through the streaming chunker (160/1600/16000 samples)
+//   4. decode_pcm16_streamed on headerless PCM16
+//   5. RealtimeOpusDecoder on a 20 ms packet stream
+//   6. StreamResampler 8/44.1/48 kHz -> 16 kHz in 20 ms chunks
+// reporting input MB/s, input samples/s (per channel), x-realtime, heap
+// allocations per call and process peak RSS while the case ran.
+//
+// Usage: ./asr_audio_bench [--quick]   (no model files needed)
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "asr/audio.h"
+#include "asr/span.h"
+#include "ogg_opus_fixture.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int    kTargetRate = 16000;
+constexpr size_t kChunk      = 1600;  // 100 ms at 16 kHz, what the offline path feeds to VAD
+constexpr double kPi         = 3.14159265358979323846;
+
+enum class WavFormat { Pcm16, Pcm24, Float32 };
+
+const char* wav_format_name(WavFormat f) {
+  switch (f) {
+    case WavFormat::Pcm16:
+      return "pcm16";
+    case WavFormat::Pcm24:
+      return "pcm24";
+    case WavFormat::Float32:
+      return "f32";
+  }
+  return "?";
+}
+
+struct AudioBenchResult {
+  double mb_per_sec       = 0.0;  // input bytes
+  double msamples_per_sec = 0.0;  // input frames (per channel), millions
+  double realtime_factor  = 0.0;  // audio seconds processed per wall second
+  double allocs_per_call  = 0.0;
+  double kb_per_call      = 0.0;
+  double peak_rss_mb      = 0.0;
+};
+
+// Harmonic, speech-like signal with a little noise; channel c is phase shifted
+// so stereo downmix does real work.
+std::vector<float> make_signal(int sample_rate, int channels, double seconds) {
+  const auto         frames = static_cast<size_t>(seconds * sample_rate);
+  std::vector<float> out(frames * static_cast<size_t>(channels));
+  uint32_t           lcg = 12345;
+  for (size_t i = 0; i < frames; ++i) {
+    const double t = static_cast<double>(i) / sample_rate;
+    for (int c = 0; c < channels; ++c) {
+      double voiced = 0.0;
+      for (int k = 1; k <= 4; ++k) {
+        voiced += std::sin(2.0 * kPi * 140.0 * k * t + 0.3 * c) / k;
+      }
+      lcg                   = lcg * 1664525U + 1013904223U;
+      const double noise    = (static_cast<double>(lcg >> 8) / 16777216.0 - 0.5) * 0.01;
+      out[i * channels + c] = static_cast<float>(0.3 * voiced + noise);
+    }
+  }
+  return out;
+}
+
+using asr::fixtures::encode_opus_packets;
+using asr::fixtures::make_ogg_opus;
+using asr::fixtures::put_tag;
+using asr::fixtures::put_u16;
+using asr::fixtures::put_u32;
+
+std::vector<uint8_t> make_wav(const std::vector<float>& interleaved, int sample_rate, int channels,
+                              WavFormat format) {
+  const uint32_t bytes_per_sample = format == WavFormat::Pcm16 ? 2 : format == WavFormat::Pcm24 ? 3 : 4;
+  const auto     data_bytes       = static_cast<uint32_t>(interleaved.size() * bytes_per_sample);
+  const auto     block_align      = static_cast<uint32_t>(channels) * bytes_per_sample;
+
+  std::vector<uint8_t> out;
+  out.reserve(44 + data_bytes);
+  put_tag(out, "RIFF");
+  put_u32(out, 36 + data_bytes);
+  put_tag(out, "WAVE");
+  put_tag(out, "fmt ");
+  put_u32(out, 16);
+  put_u16(out, format == WavFormat::Float32 ? 3 : 1);  // WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM
+  put_u16(out, static_cast<uint32_t>(channels));
+  put_u32(out, static_cast<uint32_t>(sample_rate));
+  put_u32(out, static_cast<uint32_t>(sample_rate) * block_align);
+  put_u16(out, block_align);
+  put_u16(out, bytes_per_sample * 8);
+  put_tag(out, "data");
+  put_u32(out, data_bytes);
+  for (const float s : interleaved) {
+    const double clamped = std::clamp(static_cast<double>(s), -1.0, 1.0);
+    if (format == WavFormat::Float32) {
+      uint32_t bits = 0;
+      std::memcpy(&bits, &s, sizeof(bits));
+      put_u32(out, bits);
+    } else if (format == WavFormat::Pcm16) {
+      put_u16(out, static_cast<uint16_t>(static_cast<int16_t>(std::lround(clamped * 32767.0))));
+    } else {
+      const auto v = static_cast<uint32_t>(static_cast<int32_t>(std::lround(clamped * 8388607.0)));
+      out.push_back(static_cast<uint8_t>(v & 0xFFU));
+      out.push_back(static_cast<uint8_t>((v >> 8) & 0xFFU));
+      out.push_back(static_cast<uint8_t>((v >> 16) & 0xFFU));
+    }
+  }
+  return out;
+}
+
+std::vector<uint8_t> make_pcm16(const std::vector<float>& interleaved) {
+  std::vector<uint8_t> out;
+  out.reserve(interleaved.size() * 2);
+  for (const float s : interleaved) {
+    const double clamped = std::clamp(static_cast<double>(s), -1.0, 1.0);
+    put_u16(out, static_cast<uint16_t>(static_cast<int16_t>(std::lround(clamped * 32767.0))));
+  }
+  return out;
+}
+
+// Peak RSS is reset per case via clear_refs where the kernel allows it, so
+// each row shows the high-water mark of that case rather than of the process.
+void reset_peak_rss() {
+  std::ofstream clear("/proc/self/clear_refs");
+  if (clear) {
+    clear << "5";
+  }
+}
+
+double peak_rss_mb() {
+  std::ifstream status("/proc/self/status");
+  std::string   line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::strtod(line.c_str() + 6, nullptr) / 1024.0;
+    }
+  }
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_maxrss) / 1024.0;
+}
+
+// Runs `call` once to warm up, then `reps` times under allocation counting.
+// `input_bytes` and `input_frames` describe one call.
+AudioBenchResult measure(size_t reps, size_t input_bytes, size_t input_frames, int input_rate,
+                         const std::function<void()>& call) {
+  call();
+  reset_peak_rss();
+  g_alloc_count.store(0, std::memory_order_relaxed);
+  g_alloc_bytes.store(0, std::memory_order_relaxed);
+  g_counting       = true;
+  const auto start = Clock::now();
+  for (size_t i = 0; i < reps; ++i) {
+    call();
+  }
+  const auto end = Clock::now();
+  g_counting     = false;
+
+  const double     elapsed = std::chrono::duration<double>(end - start).count();
+  const double     calls   = static_cast<double>(reps);
+  AudioBenchResult r;
+  r.mb_per_sec       = static_cast<double>(input_bytes) * calls / elapsed / 1e6;
+  r.msamples_per_sec = static_cast<double>(input_frames) * calls / elapsed / 1e6;
+  r.realtime_factor  = static_cast<double>(input_frames) / input_rate * calls / elapsed;
+  r.allocs_per_call  = static_cast<double>(g_alloc_count.load()) / calls;
+  r.kb_per_call      = static_cast<double>(g_alloc_bytes.load()) / calls / 1024.0;
+  r.peak_rss_mb      = peak_rss_mb();
+  return r;
+}
+
+// Consumes chunks the way a caller would without allocating.
+struct ChunkSink {
+  double sum    = 0.0;
+  size_t chunks = 0;
+
+  void operator()(asr::span<const float> chunk) {
+    sum += chunk.empty() ? 0.0 : chunk[0];
+    ++chunks;
+  }
+};
+
+AudioBenchResult bench_streamed(const std::vector<uint8_t>& file, const char* file_name, size_t frames,
+                                int input_rate, size_t chunk_samples, size_t reps) {
+  ChunkSink                      sink;
+  const asr::AudioChunkCallback  on_chunk = [&sink](asr::span<const float> chunk) { sink(chunk); };
+  const asr::span<const uint8_t> data(file.data(), file.size());
+  return measure(reps, file.size(), frames, input_rate, [&]() {
+    (void)asr::decode_audio_streamed(data, file_name, kTargetRate, chunk_samples, on_chunk);
+  });
+}
+
+void print_header() {
+  std::printf("%-34s %9s %10s %10s %10s %10s %9s\n", "case", "MB/s", "Msamp/s", "x-realtime", "alloc/call",
+              "KB/call", "peak MB");
+}
+
+void print_row(const char* label, const AudioBenchResult& r) {
+  std::printf("%-34s %9.1f %10.2f %10.0f %10.1f %10.1f %9.1f\n", label, r.mb_per_sec, r.msamples_per_sec,
+              r.realtime_factor, r.allocs_per_call, r.kb_per_call, r.peak_rss_mb);
+}
+
+constexpr int       kRates[]   = {8000, 16000, 44100, 48000};                             // NOLINT
+constexpr WavFormat kFormats[] = {WavFormat::Pcm16, WavFormat::Pcm24, WavFormat::Float32};  // NOLINT
+
+void run_wav(const std::vector<double>& lengths, size_t reps) {
+  std::printf("\n--- WAV -> decode_audio_streamed -> 16 kHz, %zu-sample chunks ---\n", kChunk);
+  print_header();
+  for (const double seconds : lengths) {
+    for (const int rate : kRates) {
+      for (const int channels : {1, 2}) {
+        const auto signal = make_signal(rate, channels, seconds);
+        for (const auto format : kFormats) {
+          const auto wav = make_wav(signal, rate, channels, format);
+          char       label[64];
+          std::snprintf(label, sizeof(label), "%s %dch %5d Hz %3.0fs", wav_format_name(format), channels,
+                        rate, seconds);
+          print_row(label, bench_streamed(wav, "bench.wav", signal.size() / channels, rate, kChunk, reps));
+        }
+      }
+    }
+  }
+}
+
+void run_chunk_sweep(double seconds, size_t reps) {
+  std::printf("\n--- Chunk size sweep (pcm16 1ch 16000 Hz %.0fs) ---\n", seconds);
+  print_header();
+  const auto signal = make_signal(kTargetRate, 1, seconds);
+  const auto wav    = make_wav(signal, kTargetRate, 1, WavFormat::Pcm16);
+  for (const size_t chunk : {size_t{160}, size_t{1600}, size_t{16000}}) {
+    char label[64];
+    std::snprintf(label, sizeof(label), "chunk=%zu", chunk);
+    print_row(label, bench_streamed(wav, "bench.wav", signal.size(), kTargetRate, chunk, reps));
+  }
+}
+
+void run_ogg_opus(const std::vector<double>& lengths, size_t reps) {
+#ifdef ASR_HAS_OPUSFILE
+  std::printf("\n--- Ogg Opus -> decode_audio_streamed -> 16 kHz ---\n");
+  print_header();
+  for (const double seconds : lengths) {
+    for (const int channels : {1, 2}) {
+      const auto signal = make_signal(48000, channels, seconds);
+      const auto ogg    = make_ogg_opus(signal, channels);
+      char       label[64];
+      std::snprintf(label, sizeof(label), "opus %dch 48000 Hz %3.0fs", channels, seconds);
+      print_row(label, bench_streamed(ogg, "bench.opus", signal.size() / channels, 48000, kChunk, reps));
+    }
+  }
+#else
+  (void)lengths;
+  (void)reps;
+  std::printf("\n--- Ogg Opus: skipped (built without libopusfile) ---\n");
+#endif
+}
+
+void run_raw_pcm16(double seconds, size_t reps) {
+  std::printf("\n--- Headerless PCM16 -> decode_pcm16_streamed -> 16 kHz ---\n");
+  print_header();
+  ChunkSink                     sink;
+  const asr::AudioChunkCallback on_chunk = [&sink](asr::span<const float> chunk) { sink(chunk); };
+  for (const int rate : {16000, 48000}) {
+    for (const int channels : {1, 2}) {
+      const auto         signal = make_signal(rate, channels, seconds);
+      const auto         body   = make_pcm16(signal);
+      asr::RawPcmFormat  format;
+      format.sample_rate = rate;
+      format.channels    = channels;
+      const asr::span<const uint8_t> data(body.data(), body.size());
+      char                           label[64];
+      std::snprintf(label, sizeof(label), "raw %dch %5d Hz %3.0fs", channels, rate, seconds);
+      print_row(label, measure(reps, body.size(), signal.size() / channels, rate, [&]() {
+                  (void)asr::decode_pcm16_streamed(data, format, kTargetRate, kChunk, on_chunk);
+                }));
+    }
+  }
+}
+
+void run_realtime_opus(double seconds, size_t reps) {
+  std::printf("\n--- RealtimeOpusDecoder, 20 ms packets -> 16 kHz ---\n");
+  print_header();
+  const auto signal   = make_signal(48000, 1, seconds);
+  int        pre_skip = 0;
+  const auto packets  = encode_opus_packets(signal, 1, &pre_skip);
+  size_t     bytes    = 0;
+  for (const auto& p : packets) {
+    bytes += p.size();
+  }
+  asr::RealtimeOpusDecoder decoder(kTargetRate, 8, true, asr::OpusPacketMode::Raw);
+  double                   sink = 0.0;
+  char                     label[64];
+  std::snprintf(label, sizeof(label), "opus 1ch %3.0fs, %zu packets", seconds, packets.size());
+  print_row(label, measure(reps, bytes, packets.size() * 960, 48000, [&]() {
+              decoder.reset();
+              for (const auto& p : packets) {
+                const auto pcm = decoder.decode_packet(asr::span<const uint8_t>(p.data(), p.size()));
+                sink += pcm.empty() ? 0.0 : pcm[0];
+              }
+            }));
+  (void)sink;
+}
+
+void run_resampler(double seconds, size_t reps) {
+  std::printf("\n--- StreamResampler -> 16 kHz, 20 ms chunks ---\n");
+  print_header();
+  for (const int rate : {8000, 44100, 48000}) {
+    const auto           signal = make_signal(rate, 1, seconds);
+    const auto           chunk  = static_cast<size_t>(rate / 50);
+    asr::StreamResampler resampler(rate, kTargetRate);
+    double               sink = 0.0;
+    char                 label[64];
+    std::snprintf(label, sizeof(label), "%5d -> 16000 Hz %3.0fs", rate, seconds);
+    print_row(label, measure(reps, signal.size() * sizeof(float), signal.size(), rate, [&]() {
+                for (size_t pos = 0; pos < signal.size(); pos += chunk) {
+                  const size_t n   = std::min(chunk, signal.size() - pos);
+                  const auto   out = resampler.process(asr::span<const float>(signal.data() + pos, n));
+                  sink += out.empty() ? 0.0 : out[0];
+                }
+                (void)resampler.flush();
+              }));
+    (void)sink;
+  }
+}
+
+int run_benchmarks(bool quick) {
+  const std::vector<double> lengths = quick ? std::vector<double>{2.0} : std::vector<double>{10.0, 60.0};
+  const size_t              reps    = quick ? 1 : 5;
+  const double              fixed   = lengths.front();
+
+  std::printf("=== Audio Decode / Resample Throughput Benchmark ===\n");
+  run_wav(lengths, reps);
+  run_chunk_sweep(fixed, reps);
+  run_ogg_opus(lengths, reps);
+  run_raw_pcm16(fixed, reps);
+  run_realtime_opus(fixed, reps);
+  run_resampler(fixed, reps);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+  try {
+    return run_benchmarks(quick);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "bench_audio failed: %s\n", e.what());
+    return 1;
+  } catch (...) {
+    std::fputs("bench_audio failed: unknown exception\n", stderr);
+    return 1;
+  }
+}
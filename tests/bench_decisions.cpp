@@ -8,7 +8,6 @@
 
 #include <algorithm>
 #include <array>
-#include <atomic>
 #include <charconv>
 #include <chrono>
 #include <cstddef>
@@ -16,7 +15,6 @@
 #include <cstdio>
 #include <cstdlib>
 #include <exception>
-#include <new>
 #include <nlohmann/json.hpp>
 #include <ratio>
 #include <string>
@@ -24,52 +22,10 @@
 #include <system_error>
 #include <vector>
 
-// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,misc-use-anonymous-namespace)
-static std::size_t         g_sink_bytes = 0;
-static std::atomic<size_t> g_alloc_count{0};
-static std::atomic<size_t> g_alloc_bytes{0};
-static thread_local bool   g_counting_allocs = false;
-// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,misc-use-anonymous-namespace)
-
-void* operator new(std::size_t size) {
-  if (g_counting_allocs) {
-    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
-    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
-  }
-  void* p = std::malloc(size);  // NOLINT(cppcoreguidelines-no-malloc)
-  if (p == nullptr) {
-    throw std::bad_alloc();
-  }
-  return p;
-}
-
-void* operator new[](std::size_t size) {
-  if (g_counting_allocs) {
-    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
-    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
-  }
-  void* p = std::malloc(size);  // NOLINT(cppcoreguidelines-no-malloc)
-  if (p == nullptr) {
-    throw std::bad_alloc();
-  }
-  return p;
-}
+#include "alloc_counter.h"
 
-void operator delete(void* p) noexcept {
-  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
-}
-
-void operator delete[](void* p) noexcept {
-  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
-}
-
-void operator delete(void* p, std::size_t /*size*/) noexcept {
-  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
-}
-
-void operator delete[](void* p, std::size_t /*size*/) noexcept {
-  std::free(p);  // NOLINT(cppcoreguidelines-no-malloc)
-}
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables,misc-use-anonymous-namespace)
+static std::size_t g_sink_bytes = 0;
 
 namespace {
 
@@ -96,7 +52,7 @@ BenchResult run_benchmark(int iterations, int repeats, Fn&& fn) {
   for (int repeat = 0; repeat < repeats; ++repeat) {
     g_alloc_count.store(0, std::memory_order_relaxed);
     g_alloc_bytes.store(0, std::memory_order_relaxed);
-    g_counting_allocs = true;
+    g_counting = true;
 
     const auto start = Clock::now();
     for (int i = 0; i < iterations; ++i) {
@@ -104,7 +60,7 @@ BenchResult run_benchmark(int iterations, int repeats, Fn&& fn) {
     }
     const auto end = Clock::now();
 
-    g_counting_allocs = false;
+    g_counting = false;
     total_allocs += g_alloc_count.load(std::memory_order_relaxed);
     total_bytes += g_alloc_bytes.load(std::memory_order_relaxed);
     samples_ns.push_back(std::chrono::duration<double, std::nano>(end - start).count() /
@@ -0,0 +1,269 @@
+// VAD throughput benchmark.
+// Measures VoiceActivityDetector::accept_waveform() per window for
+//   1. one detector across window/context layouts and speech ratios
+//   2. N detectors on N threads sharing one SharedVadRuntime (ORT session)
+//   3. segment_speech() over one long file, sequential vs sharded
+// reporting ns/window, windows/s, x-realtime and heap allocations per window.
+//
+// Usage: ./asr_vad_bench [--quick]   (requires models/silero_vad.onnx)
+// Exit code 77 (ctest SKIP) when the model is missing.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "asr/span.h"
+#include "asr/vad.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kVadModel     = "models/silero_vad.onnx";
+constexpr int         kSkipExitCode = 77;
+constexpr double      kPi           = 3.14159265358979323846;
+
+struct Layout {
+  int sample_rate;
+  int window_size;
+  int context_size;
+};
+
+// Silero VAD accepts 512/64 at 16 kHz and 256/32 at 8 kHz.
+constexpr Layout kLayouts[] = {{16000, 512, 64}, {8000, 256, 32}};  // NOLINT
+constexpr double kSpeechRatios[] = {0.0, 0.5, 1.0};                   // NOLINT
+
+struct VadBenchResult {
+  double ns_per_window     = 0.0;
+  double windows_per_sec   = 0.0;
+  double realtime_factor   = 0.0;  // audio seconds processed per wall second
+  double allocs_per_window = 0.0;
+  double bytes_per_window  = 0.0;
+};
+
+asr::VadConfig make_vad_config(const Layout& layout) {
+  asr::VadConfig vc;
+  vc.model_path   = kVadModel;
+  vc.sample_rate  = layout.sample_rate;
+  vc.window_size  = layout.window_size;
+  vc.context_size = layout.context_size;
+  return vc;
+}
+
+// Ten seconds of audio where the first speech_ratio of every second is a
+// voiced, speech-like harmonic signal and the rest is near silence.
+std::vector<float> make_stream(int sample_rate, double speech_ratio) {
+  const auto         n = static_cast<size_t>(sample_rate) * 10;
+  std::vector<float> audio(n);
+  uint32_t           lcg = 12345;
+  for (size_t i = 0; i < n; ++i) {
+    const double t      = static_cast<double>(i) / sample_rate;
+    const double in_sec = t - std::floor(t);
+    lcg                 = lcg * 1664525U + 1013904223U;
+    const float noise   = (static_cast<float>(lcg >> 8) / 16777216.0f - 0.5f) * 0.002f;
+    if (in_sec < speech_ratio) {
+      double voiced = 0.0;
+      for (int k = 1; k <= 8; ++k) {
+        voiced += std::sin(2.0 * kPi * 140.0 * k * t) / k;
+      }
+      audio[i] = static_cast<float>(0.2 * voiced * (0.6 + 0.4 * std::sin(2.0 * kPi * 5.0 * t))) + noise;
+    } else {
+      audio[i] = noise;
+    }
+  }
+  return audio;
+}
+
+// Feeds `windows` windows from the looping stream; segments and transitions
+// are drained as a session would, so queues do not grow.
+void feed(asr::VoiceActivityDetector& vad, const std::vector<float>& stream, int window_size, size_t windows,
+          size_t* offset) {
+  const auto w = static_cast<size_t>(window_size);
+  for (size_t i = 0; i < windows; ++i) {
+    if (*offset + w > stream.size()) {
+      *offset = 0;
+    }
+    vad.accept_waveform(asr::span<const float>(stream.data() + *offset, w));
+    *offset += w;
+    while (!vad.empty()) {
+      vad.pop();
+    }
+    while (vad.has_transition()) {
+      vad.pop_transition();
+    }
+  }
+}
+
+VadBenchResult run_single(const Layout& layout, double speech_ratio, size_t windows) {
+  asr::VoiceActivityDetector vad(make_vad_config(layout));
+  const auto                 stream = make_stream(layout.sample_rate, speech_ratio);
+  size_t                     offset = 0;
+
+  feed(vad, stream, layout.window_size, std::max<size_t>(64, windows / 8), &offset);  // warm-up
+
+  g_alloc_count.store(0, std::memory_order_relaxed);
+  g_alloc_bytes.store(0, std::memory_order_relaxed);
+  g_counting       = true;
+  const auto start = Clock::now();
+  feed(vad, stream, layout.window_size, windows, &offset);
+  const auto end = Clock::now();
+  g_counting     = false;
+
+  const double   elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+  const double   window_sec = static_cast<double>(layout.window_size) / layout.sample_rate;
+  VadBenchResult r;
+  r.ns_per_window     = elapsed_ns / static_cast<double>(windows);
+  r.windows_per_sec   = 1e9 / r.ns_per_window;
+  r.realtime_factor   = r.windows_per_sec * window_sec;
+  r.allocs_per_window = static_cast<double>(g_alloc_count.load()) / static_cast<double>(windows);
+  r.bytes_per_window  = static_cast<double>(g_alloc_bytes.load()) / static_cast<double>(windows);
+  return r;
+}
+
+// N threads, one detector each, all sharing the process-wide VAD runtime.
+VadBenchResult run_shared(const Layout& layout, size_t threads, size_t windows_per_thread) {
+  std::vector<std::unique_ptr<asr::VoiceActivityDetector>> detectors;
+  detectors.reserve(threads);
+  for (size_t t = 0; t < threads; ++t) {
+    detectors.push_back(std::make_unique<asr::VoiceActivityDetector>(make_vad_config(layout)));
+  }
+  const auto stream = make_stream(layout.sample_rate, 0.5);
+
+  g_alloc_count.store(0, std::memory_order_relaxed);
+  g_alloc_bytes.store(0, std::memory_order_relaxed);
+  std::atomic<size_t>      ready{0};
+  std::atomic<bool>        go{false};
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t]() {
+      size_t offset = (t * 7919 * static_cast<size_t>(layout.window_size)) % stream.size();
+      feed(*detectors[t], stream, layout.window_size, std::max<size_t>(64, windows_per_thread / 8), &offset);
+      ready.fetch_add(1, std::memory_order_acq_rel);
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      g_counting = true;
+      feed(*detectors[t], stream, layout.window_size, windows_per_thread, &offset);
+      g_counting = false;
+    });
+  }
+  while (ready.load(std::memory_order_acquire) < threads) {
+    std::this_thread::yield();
+  }
+  const auto start = Clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& w : workers) {
+    w.join();
+  }
+  const auto end = Clock::now();
+
+  const double   total_windows = static_cast<double>(threads * windows_per_thread);
+  const double   elapsed_ns    = std::chrono::duration<double, std::nano>(end - start).count();
+  const double   window_sec    = static_cast<double>(layout.window_size) / layout.sample_rate;
+  VadBenchResult r;
+  r.ns_per_window     = elapsed_ns / total_windows;  // wall time per window, aggregate
+  r.windows_per_sec   = 1e9 / r.ns_per_window;
+  r.realtime_factor   = r.windows_per_sec * window_sec;
+  r.allocs_per_window = static_cast<double>(g_alloc_count.load()) / total_windows;
+  r.bytes_per_window  = static_cast<double>(g_alloc_bytes.load()) / total_windows;
+  return r;
+}
+
+// One long file through segment_speech(); the stream loops the 10 s pattern.
+VadBenchResult run_segment(const Layout& layout, size_t threads, double file_sec, size_t* segments) {
+  const auto         pattern = make_stream(layout.sample_rate, 0.5);
+  std::vector<float> audio(static_cast<size_t>(file_sec * layout.sample_rate));
+  for (size_t i = 0; i < audio.size(); ++i) {
+    audio[i] = pattern[i % pattern.size()];
+  }
+
+  const auto start = Clock::now();
+  *segments        = asr::segment_speech(make_vad_config(layout), audio, threads).size();
+  const auto end   = Clock::now();
+
+  const double   windows    = static_cast<double>(audio.size()) / layout.window_size;
+  const double   elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+  const double   window_sec = static_cast<double>(layout.window_size) / layout.sample_rate;
+  VadBenchResult r;
+  r.ns_per_window   = elapsed_ns / windows;
+  r.windows_per_sec = 1e9 / r.ns_per_window;
+  r.realtime_factor = r.windows_per_sec * window_sec;
+  return r;
+}
+
+void print_header() {
+  std::printf("%-36s %12s %12s %10s %10s %10s\n", "case", "ns/window", "windows/s", "x-realtime", "alloc/win",
+              "B/win");
+}
+
+void print_row(const char* label, const VadBenchResult& r) {
+  std::printf("%-36s %12.0f %12.0f %10.0f %10.2f %10.0f\n", label, r.ns_per_window, r.windows_per_sec,
+              r.realtime_factor, r.allocs_per_window, r.bytes_per_window);
+}
+
+int run_benchmarks(bool quick) {
+  if (!std::ifstream(kVadModel).good()) {
+    std::printf("SKIP: %s not found\n", kVadModel);
+    return kSkipExitCode;
+  }
+  const size_t windows = quick ? 500 : 5000;
+
+  std::printf("=== VAD Throughput Benchmark ===\n\n--- Single detector ---\n");
+  print_header();
+  for (const auto& layout : kLayouts) {
+    for (const double ratio : kSpeechRatios) {
+      char label[64];
+      std::snprintf(label, sizeof(label), "%d Hz w=%d ctx=%d speech=%.0f%%", layout.sample_rate,
+                    layout.window_size, layout.context_size, ratio * 100.0);
+      print_row(label, run_single(layout, ratio, windows));
+    }
+  }
+
+  std::printf("\n--- N detectors / N threads, shared runtime (16 kHz, speech=50%%) ---\n");
+  print_header();
+  const size_t max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  for (size_t threads = 1; threads <= std::min<size_t>(max_threads, quick ? 2 : 16); threads *= 2) {
+    char label[64];
+    std::snprintf(label, sizeof(label), "threads=%zu", threads);
+    print_row(label, run_shared(kLayouts[0], threads, windows));
+  }
+
+  const double file_sec = quick ? 120.0 : 600.0;
+  std::printf("\n--- segment_speech, %.0f s file (16 kHz, speech=50%%) ---\n", file_sec);
+  print_header();
+  for (size_t threads = 1; threads <= std::min<size_t>(max_threads, quick ? 2 : 16); threads *= 2) {
+    size_t     segments = 0;
+    const auto result   = run_segment(kLayouts[0], threads, file_sec, &segments);
+    char       label[64];
+    std::snprintf(label, sizeof(label), "threads=%zu segments=%zu", threads, segments);
+    print_row(label, result);
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+  try {
+    return run_benchmarks(quick);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "bench_vad failed: %s\n", e.what());
+    return 1;
+  } catch (...) {
+    std::fputs("bench_vad failed: unknown exception\n", stderr);
+    return 1;
+  }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+// In-memory Ogg Opus files for tests and benchmarks, so decode paths can be
+// exercised without checked-in fixtures. Header-only; needs libopus, which
+// asr_core links publicly.
+
+#include <opus/opus.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace asr::fixtures {
+
+inline void put_u16(std::vector<uint8_t>& out, uint32_t v) {
+  out.push_back(static_cast<uint8_t>(v & 0xFFU));
+  out.push_back(static_cast<uint8_t>((v >> 8) & 0xFFU));
+}
+
+inline void put_u32(std::vector<uint8_t>& out, uint32_t v) {
+  put_u16(out, v & 0xFFFFU);
+  put_u16(out, v >> 16);
+}
+
+inline void put_tag(std::vector<uint8_t>& out, const char* tag) {
+  out.insert(out.end(), tag, tag + std::strlen(tag));
+}
+
+// 20 ms Opus packets at 48 kHz; *pre_skip receives the encoder lookahead.
+inline std::vector<std::vector<uint8_t>> encode_opus_packets(const std::vector<float>& interleaved,
+                                                             int channels, int* pre_skip) {
+  constexpr int kFrame = 960;
+  int           error  = OPUS_OK;
+  OpusEncoder*  enc    = opus_encoder_create(48000, channels, OPUS_APPLICATION_VOIP, &error);
+  if (enc == nullptr || error != OPUS_OK) {
+    throw std::runtime_error("opus_encoder_create failed");
+  }
+  (void)opus_encoder_ctl(enc, OPUS_SET_BITRATE(channels * 32000));
+  opus_int32 lookahead = 0;
+  (void)opus_encoder_ctl(enc, OPUS_GET_LOOKAHEAD(&lookahead));
+  *pre_skip = lookahead;
+
+  const size_t                      frames = interleaved.size() / static_cast<size_t>(channels);
+  std::vector<float>                pcm(static_cast<size_t>(kFrame * channels), 0.0f);
+  std::vector<std::vector<uint8_t>> packets;
+  std::array<uint8_t, 1500>         buf{};
+  for (size_t pos = 0; pos < frames; pos += kFrame) {
+    const size_t n = std::min<size_t>(kFrame, frames - pos);
+    std::fill(pcm.begin(), pcm.end(), 0.0f);
+    std::copy_n(interleaved.begin() + static_cast<ptrdiff_t>(pos * channels), n * channels, pcm.begin());
+    const int bytes =
+        opus_encode_float(enc, pcm.data(), kFrame, buf.data(), static_cast<opus_int32>(buf.size()));
+    if (bytes <= 0) {
+      opus_encoder_destroy(enc);
+      throw std::runtime_error("opus_encode_float failed");
+    }
+    packets.emplace_back(buf.begin(), buf.begin() + bytes);
+  }
+  opus_encoder_destroy(enc);
+  return packets;
+}
+
+inline uint32_t ogg_crc(const uint8_t* data, size_t size) {
+  static const auto table = []() {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t r = i << 24;
+      for (int b = 0; b < 8; ++b) {
+        r = (r & 0x80000000U) != 0 ? (r << 1) ^ 0x04C11DB7U : r << 1;
+      }
+      t[i] = r;
+    }
+    return t;
+  }();
+  uint32_t crc = 0;
+  for (size_t i = 0; i < size; ++i) {
+    crc = (crc << 8) ^ table[((crc >> 24) ^ data[i]) & 0xFFU];
+  }
+  return crc;
+}
+
+// One packet per page, which is what a naive muxer produces and the most
+// page overhead the demuxer will see.
+inline void put_ogg_page(std::vector<uint8_t>& out, const std::vector<uint8_t>& packet, uint64_t granule,
+                         uint32_t seq, uint8_t flags) {
+  const size_t start = out.size();
+  put_tag(out, "OggS");
+  out.push_back(0);
+  out.push_back(flags);
+  put_u32(out, static_cast<uint32_t>(granule & 0xFFFFFFFFU));
+  put_u32(out, static_cast<uint32_t>(granule >> 32));
+  put_u32(out, 0x41535200U);  // stream serial
+  put_u32(out, seq);
+  put_u32(out, 0);  // CRC, patched below
+  out.push_back(static_cast<uint8_t>(packet.size() / 255 + 1));
+  out.insert(out.end(), packet.size() / 255, 255);
+  out.push_back(static_cast<uint8_t>(packet.size() % 255));
+  out.insert(out.end(), packet.begin(), packet.end());
+  const uint32_t crc = ogg_crc(out.data() + start, out.size() - start);
+  for (int i = 0; i < 4; ++i) {
+    out[start + 22 + static_cast<size_t>(i)] = static_cast<uint8_t>((crc >> (8 * i)) & 0xFFU);
+  }
+}
+
+// Interleaved 48 kHz float samples -> a complete Ogg Opus file.
+inline std::vector<uint8_t> make_ogg_opus(const std::vector<float>& interleaved, int channels) {
+  int        pre_skip = 0;
+  const auto packets  = encode_opus_packets(interleaved, channels, &pre_skip);
+
+  std::vector<uint8_t> head;
+  put_tag(head, "OpusHead");
+  head.push_back(1);
+  head.push_back(static_cast<uint8_t>(channels));
+  put_u16(head, static_cast<uint32_t>(pre_skip));
+  put_u32(head, 48000);
+  put_u16(head, 0);   // output gain
+  head.push_back(0);  // mapping family 0: mono/stereo
+  std::vector<uint8_t> tags;
+  put_tag(tags, "OpusTags");
+  put_u32(tags, 9);
+  put_tag(tags, "asr-bench");
+  put_u32(tags, 0);
+
+  std::vector<uint8_t> out;
+  uint32_t             seq = 0;
+  put_ogg_page(out, head, 0, seq++, 0x02);
+  put_ogg_page(out, tags, 0, seq++, 0x00);
+  uint64_t granule = static_cast<uint64_t>(pre_skip);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    granule += 960;
+    put_ogg_page(out, packets[i], granule, seq++, i + 1 == packets.size() ? 0x04 : 0x00);
+  }
+  return out;
+}
+
+}  // namespace asr::fixtures
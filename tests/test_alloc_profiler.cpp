@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "asr/alloc_profiler.h"
+
+namespace asr {
+namespace {
+
+const AllocTagStats& stats(const AllocSnapshot& snap, AllocTag tag) {
+  return snap.tags[static_cast<size_t>(tag)];
+}
+
+TEST(AllocProfiler, ChargesAllocationsToTheScopeTag) {
+  const auto before = alloc_snapshot();
+  if (!before.enabled) {
+    GTEST_SKIP() << "built without ASR_ENABLE_ALLOC_PROFILER";
+  }
+  set_alloc_sample_bytes(4096);  // every block below crosses the interval
+
+  constexpr size_t                     kBlocks     = 64;
+  constexpr size_t                     kBlockBytes = 64 * 1024;
+  std::vector<std::unique_ptr<char[]>> blocks;
+  blocks.reserve(kBlocks + 1);
+  {
+    const AllocTagScope decode(AllocTag::Decode);
+    for (size_t i = 0; i < kBlocks; ++i) {
+      blocks.emplace_back(new char[kBlockBytes]);
+    }
+    {
+      const AllocTagScope vad(AllocTag::Vad);
+      blocks.emplace_back(new char[kBlockBytes]);
+    }
+  }
+  const auto during = alloc_snapshot();
+
+  const auto& decode_before = stats(before, AllocTag::Decode);
+  const auto& decode_during = stats(during, AllocTag::Decode);
+  EXPECT_GE(decode_during.alloc_bytes - decode_before.alloc_bytes, kBlocks * kBlockBytes);
+  EXPECT_GE(decode_during.allocs - decode_before.allocs, kBlocks);
+  // Each block crosses the interval and is sampled; the table may still turn one away.
+  EXPECT_GE(decode_during.live_bytes - decode_before.live_bytes,
+            static_cast<int64_t>((kBlocks - 1) * kBlockBytes));
+  EXPECT_GE(stats(during, AllocTag::Vad).alloc_bytes - stats(before, AllocTag::Vad).alloc_bytes, kBlockBytes);
+
+  blocks.clear();
+  const auto after = alloc_snapshot();
+  EXPECT_EQ(stats(after, AllocTag::Decode).live_bytes, decode_before.live_bytes);
+  EXPECT_EQ(stats(after, AllocTag::Vad).live_bytes, stats(before, AllocTag::Vad).live_bytes);
+
+  set_alloc_sample_bytes(before.sample_bytes);
+}
+
+TEST(AllocProfiler, ReportTakesRatesOverTheWindow) {
+  AllocSnapshot before;
+  AllocSnapshot after;
+  after.enabled      = true;
+  after.sample_bytes = 1024;
+  before.tags[static_cast<size_t>(AllocTag::Asr)] = {1000, 10, 0};
+  after.tags[static_cast<size_t>(AllocTag::Asr)]  = {5000, 30, 2048};
+
+  const auto report = alloc_report(before, after, 2.0);
+  EXPECT_TRUE(report["enabled"].get<bool>());
+  EXPECT_EQ(report["sample_bytes"].get<size_t>(), 1024U);
+  ASSERT_EQ(report["tags"].size(), kAllocTagCount);
+  for (const char* name : {"other", "decode", "vad", "asr", "ws", "metrics"}) {
+    EXPECT_TRUE(report["tags"].contains(name)) << name;
+  }
+  const auto& asr_tag = report["tags"]["asr"];
+  EXPECT_EQ(asr_tag["alloc_bytes"].get<uint64_t>(), 5000U);
+  EXPECT_EQ(asr_tag["live_bytes"].get<int64_t>(), 2048);
+  EXPECT_DOUBLE_EQ(asr_tag["alloc_bytes_per_sec"].get<double>(), 2000.0);
+  EXPECT_DOUBLE_EQ(asr_tag["allocs_per_sec"].get<double>(), 10.0);
+
+  const auto cumulative = alloc_report({}, after, 0.0);
+  EXPECT_TRUE(cumulative["window_sec"].is_null());
+  EXPECT_FALSE(cumulative["tags"]["asr"].contains("alloc_bytes_per_sec"));
+}
+
+}  // namespace
+}  // namespace asr
@@ -11,6 +11,7 @@
 
 #include "asr/audio.h"
 #include "asr/span.h"
+#include "ogg_opus_fixture.h"
 
 // Include dr_wav for creating test WAV data
 #include "dr_wav.h"
@@ -305,5 +306,145 @@ TEST(Audio, Pcm16ToFloat32IntoReuseBuffer) {
   EXPECT_NEAR(out[2], 32767.0F / 32768.0F, 1e-6F);
 }
 
+TEST(Audio, DecodePcm16StreamedLittleAndBigEndian) {
+  const std::vector<uint8_t> le = {0x00, 0x80, 0x00, 0x40, 0xFF, 0x7F};
+  const std::vector<uint8_t> be = {0x80, 0x00, 0x40, 0x00, 0x7F, 0xFF};
+
+  for (const bool big_endian : {false, true}) {
+    RawPcmFormat format;
+    format.big_endian = big_endian;
+
+    std::vector<float> streamed;
+    const auto         stats = decode_pcm16_streamed(
+        big_endian ? be : le, format, 16000, 2U,
+        [&streamed](span<const float> chunk) { streamed.insert(streamed.end(), chunk.begin(), chunk.end()); });
+
+    ASSERT_EQ(streamed.size(), 3U);
+    EXPECT_FLOAT_EQ(streamed[0], -1.0F);
+    EXPECT_FLOAT_EQ(streamed[1], 0.5F);
+    EXPECT_NEAR(streamed[2], 32767.0F / 32768.0F, 1e-6F);
+    EXPECT_EQ(stats.samples, 3U);
+  }
+}
+
+TEST(Audio, DecodePcm16StreamedDownmixesInterleavedChannels) {
+  // Two stereo frames: (0.5, -0.5) and (0.25, 0.25).
+  const std::vector<uint8_t> pcm = {0x00, 0x40, 0x00, 0xC0, 0x00, 0x20, 0x00, 0x20};
+  RawPcmFormat               format;
+  format.channels = 2;
+
+  std::vector<float> streamed;
+  const auto         stats = decode_pcm16_streamed(
+      pcm, format, 16000, 4096U,
+      [&streamed](span<const float> chunk) { streamed.insert(streamed.end(), chunk.begin(), chunk.end()); });
+
+  ASSERT_EQ(streamed.size(), 2U);
+  EXPECT_FLOAT_EQ(streamed[0], 0.0F);
+  EXPECT_FLOAT_EQ(streamed[1], 0.25F);
+  EXPECT_NEAR(stats.duration_sec, 2.0F / 16000.0F, 1e-7F);
+  EXPECT_DOUBLE_EQ(stats.resample_sec, 0.0);
+}
+
+TEST(Audio, DecodePcm16StreamedRejectsPartialFrames) {
+  const std::vector<uint8_t> partial = {0x00, 0x00, 0x00};
+  const std::vector<uint8_t> empty;
+  RawPcmFormat               format;
+  format.channels = 2;
+  auto noop       = [](span<const float> /*chunk*/) {};
+
+  EXPECT_THROW(decode_pcm16_streamed(partial, format, 16000, 16U, noop), AudioError);
+  EXPECT_THROW(decode_pcm16_streamed(empty, format, 16000, 16U, noop), AudioError);
+}
+
+TEST(Audio, DecodePcm16StreamedResamples) {
+  const auto           sine = make_sine(440.0f, 1.0f, 8000);
+  std::vector<uint8_t> pcm;
+  pcm.reserve(sine.size() * 2U);
+  for (const float sample : sine) {
+    const auto value = static_cast<uint16_t>(static_cast<int16_t>(sample * 32767.0F));
+    pcm.push_back(static_cast<uint8_t>(value & 0xFFU));
+    pcm.push_back(static_cast<uint8_t>(value >> 8U));
+  }
+  RawPcmFormat format;
+  format.sample_rate = 8000;
+
+  size_t     streamed = 0;
+  const auto stats    = decode_pcm16_streamed(pcm, format, 16000, 4096U,
+                                              [&streamed](span<const float> chunk) { streamed += chunk.size(); });
+
+  EXPECT_EQ(stats.samples, streamed);
+  EXPECT_NEAR(stats.duration_sec, 1.0f, 0.02f);
+  EXPECT_GT(stats.resample_sec, 0.0);
+}
+
+#ifdef ASR_HAS_OPUSFILE
+// 48 kHz mono harmonics on a pitch that never repeats, so output that is off
+// by even one sample no longer lines up with the reference.
+std::vector<float> make_gliding_voice(double seconds) {
+  constexpr double   kTau = 2.0 * M_PI;
+  std::vector<float> samples(static_cast<size_t>(seconds * 48000.0));
+  double             phase = 0.0;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const double t = static_cast<double>(i) / 48000.0;
+    phase += kTau * (150.0 + 50.0 * std::sin(kTau * 0.37 * t)) / 48000.0;
+    double v = 0.0;
+    for (int k = 1; k <= 5; ++k) {
+      v += std::sin(static_cast<double>(k) * phase) / k;
+    }
+    samples[i] = static_cast<float>(0.2 * (0.65 + 0.35 * std::sin(kTau * 0.9 * t)) * v);
+  }
+  return samples;
+}
+
+struct StreamedOpus {
+  std::vector<float>  samples;
+  std::vector<size_t> chunk_sizes;
+  AudioStreamStats    stats;
+};
+
+StreamedOpus decode_opus_chunks(const std::vector<uint8_t>& ogg, size_t chunk_samples, size_t threads) {
+  StreamedOpus out;
+  out.stats = decode_audio_streamed(
+      ogg, "long.opus", 16000, chunk_samples,
+      [&out](span<const float> chunk) {
+        out.samples.insert(out.samples.end(), chunk.begin(), chunk.end());
+        out.chunk_sizes.push_back(chunk.size());
+      },
+      threads);
+  return out;
+}
+
+TEST(Audio, DecodeOpusStreamedRangesMatchSerialDecode) {
+  constexpr size_t kChunk  = 16000;
+  constexpr size_t kWindow = 1600;  // 100 ms
+  // Long enough for three one-minute ranges, with boundaries near 63 s and 127 s.
+  const auto ogg      = fixtures::make_ogg_opus(make_gliding_voice(190.0), 1);
+  const auto serial   = decode_opus_chunks(ogg, kChunk, 1);
+  const auto parallel = decode_opus_chunks(ogg, kChunk, 3);
+
+  ASSERT_GT(serial.samples.size(), size_t{189} * 16000);
+  EXPECT_NEAR(static_cast<double>(parallel.samples.size()), static_cast<double>(serial.samples.size()), 2.0);
+  EXPECT_EQ(parallel.stats.samples, parallel.samples.size());
+  ASSERT_EQ(parallel.chunk_sizes.size(), serial.chunk_sizes.size());
+  for (size_t i = 0; i + 1 < parallel.chunk_sizes.size(); ++i) {
+    ASSERT_EQ(parallel.chunk_sizes[i], kChunk) << "chunk " << i;
+  }
+
+  // Every 100 ms window, the range boundaries included, matches the serial
+  // decode up to what a re-primed decoder and resampler leave behind.
+  const size_t n = std::min(serial.samples.size(), parallel.samples.size());
+  for (size_t begin = 0; begin + kWindow <= n; begin += kWindow) {
+    double diff = 0.0;
+    double ref  = 0.0;
+    for (size_t i = begin; i < begin + kWindow; ++i) {
+      const double d = static_cast<double>(parallel.samples[i]) - static_cast<double>(serial.samples[i]);
+      diff += d * d;
+      ref += static_cast<double>(serial.samples[i]) * static_cast<double>(serial.samples[i]);
+    }
+    ASSERT_LE(std::sqrt(diff), 0.1 * std::sqrt(ref) + 1e-3) << "window at sample " << begin;
+  }
+}
+#endif  // ASR_HAS_OPUSFILE
+
 }  // namespace
 }  // namespace asr
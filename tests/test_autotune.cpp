@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "asr/autotune.h"
+#include "asr/config.h"
+
+namespace asr {
+namespace {
+
+AutotuneResult make_result(const std::string& encoder, int pool, double throughput, double p95) {
+  AutotuneResult r;
+  r.layout          = {encoder, pool, 4 / pool};
+  r.throughput      = throughput;
+  r.p95_latency_sec = p95;
+  return r;
+}
+
+TEST(Autotune, CandidatesCoverEncodersAndPowerOfTwoPools) {
+  const auto candidates = autotune_candidates({"encoder.int8.onnx", "encoder.onnx"}, 4);
+  ASSERT_EQ(candidates.size(), 6u);
+  EXPECT_EQ(candidates[0].encoder_file, "encoder.int8.onnx");
+  EXPECT_EQ(candidates[0].pool_size, 1);
+  EXPECT_EQ(candidates[0].threads_per_slot, 4);
+  EXPECT_EQ(candidates[2].pool_size, 4);
+  EXPECT_EQ(candidates[2].threads_per_slot, 1);
+  EXPECT_EQ(candidates[3].encoder_file, "encoder.onnx");
+
+  EXPECT_EQ(autotune_candidates({"encoder.int8.onnx"}, 64).back().pool_size, 8);
+  EXPECT_TRUE(autotune_candidates({}, 4).empty());
+}
+
+TEST(Autotune, PicksBestThroughputWithinLatencyTarget) {
+  const std::vector<AutotuneResult> results{
+      make_result("encoder.int8.onnx", 1, 10.0, 0.3),
+      make_result("encoder.int8.onnx", 4, 25.0, 1.5),  // fastest overall, misses the target
+      make_result("encoder.onnx", 2, 14.0, 0.8),
+  };
+  auto best = pick_autotune_result(results, 1.0);
+  ASSERT_TRUE(best.has_value());
+  EXPECT_EQ(best->layout.encoder_file, "encoder.onnx");
+  EXPECT_EQ(best->layout.pool_size, 2);
+
+  // Nothing meets the target: lowest latency wins.
+  best = pick_autotune_result(results, 0.1);
+  ASSERT_TRUE(best.has_value());
+  EXPECT_EQ(best->layout.pool_size, 1);
+
+  EXPECT_FALSE(pick_autotune_result({}, 1.0).has_value());
+}
+
+TEST(Autotune, SplitsBudgetAndSkipsFailingLayouts) {
+  const auto          candidates = autotune_candidates({"encoder.int8.onnx", "encoder.onnx"}, 2);
+  std::vector<double> budgets;
+  const auto          best =
+      autotune_layouts(candidates, 8.0, 1.0, [&budgets](const AutotuneLayout& layout, double budget_sec) {
+        budgets.push_back(budget_sec);
+        if (layout.encoder_file == "encoder.onnx") {
+          throw std::runtime_error("load failed");
+        }
+        return make_result(layout.encoder_file, layout.pool_size, layout.pool_size * 5.0, 0.2);
+      });
+  ASSERT_EQ(budgets.size(), 4u);
+  EXPECT_DOUBLE_EQ(budgets[0], 2.0);
+  ASSERT_TRUE(best.has_value());
+  EXPECT_EQ(best->layout.encoder_file, "encoder.int8.onnx");
+  EXPECT_EQ(best->layout.pool_size, 2);
+}
+
+TEST(Autotune, CacheRoundTripKeepsOtherHosts) {
+  const std::string path = testing::TempDir() + "asr_autotune_cache.json";
+  std::remove(path.c_str());
+
+  EXPECT_FALSE(load_autotune_cache(path, "host-a").has_value());
+  ASSERT_TRUE(save_autotune_cache(path, "host-a", make_result("encoder.onnx", 2, 12.0, 0.5)));
+  ASSERT_TRUE(save_autotune_cache(path, "host-b", make_result("encoder.int8.onnx", 4, 30.0, 0.4)));
+
+  const auto a = load_autotune_cache(path, "host-a");
+  ASSERT_TRUE(a.has_value());
+  EXPECT_EQ(a->encoder_file, "encoder.onnx");
+  EXPECT_EQ(a->pool_size, 2);
+  EXPECT_EQ(a->threads_per_slot, 2);
+  const auto b = load_autotune_cache(path, "host-b");
+  ASSERT_TRUE(b.has_value());
+  EXPECT_EQ(b->pool_size, 4);
+  EXPECT_FALSE(load_autotune_cache(path, "host-c").has_value());
+
+  {
+    std::ofstream out(path, std::ios::trunc);
+    out << "{not json";
+  }
+  EXPECT_FALSE(load_autotune_cache(path, "host-a").has_value());
+  std::remove(path.c_str());
+}
+
+TEST(Autotune, ApplyLayoutFollowsAutoConcurrency) {
+  Config cfg;
+  cfg.validate();  // max_concurrent_requests auto-resolves to the pool size
+  apply_autotune_layout(cfg, {"encoder.onnx", 2, 3});
+  EXPECT_EQ(cfg.encoder_file, "encoder.onnx");
+  EXPECT_EQ(cfg.recognizer_pool_size, 2);
+  EXPECT_EQ(cfg.num_threads, 6);
+  EXPECT_EQ(cfg.max_concurrent_requests, 2u);
+
+  cfg.max_concurrent_requests = 1;
+  apply_autotune_layout(cfg, {"encoder.int8.onnx", 4, 1});
+  EXPECT_EQ(cfg.max_concurrent_requests, 1u);
+}
+
+TEST(Autotune, ApplyLayoutReclampsRealtimeReservation) {
+  Config cfg;
+  cfg.recognizer_pool_size      = 8;
+  cfg.recognizer_realtime_slots = 3;
+  cfg.validate();  // auto: the 5 shared slots
+  ASSERT_EQ(cfg.max_concurrent_requests, 5u);
+
+  apply_autotune_layout(cfg, {"encoder.onnx", 6, 1});
+  EXPECT_EQ(cfg.recognizer_realtime_slots, 3u);
+  EXPECT_EQ(cfg.max_concurrent_requests, 3u);
+
+  // The reservation must leave a shared slot; the explicit limit fits the rest.
+  cfg.max_concurrent_requests = 2;
+  apply_autotune_layout(cfg, {"encoder.onnx", 2, 2});
+  EXPECT_EQ(cfg.recognizer_realtime_slots, 1u);
+  EXPECT_EQ(cfg.max_concurrent_requests, 1u);
+}
+
+TEST(Autotune, BenchOpensEverySlotToTheBenchThreads) {
+  Config base;
+  base.recognizer_realtime_slots  = 2;
+  base.recognizer_elastic_threads = true;
+  const auto cfg                  = autotune_bench_config(base, {"encoder.onnx", 4, 2});
+  EXPECT_EQ(cfg.recognizer_pool_size, 4);
+  EXPECT_EQ(cfg.num_threads, 8);
+  EXPECT_EQ(cfg.recognizer_realtime_slots, 0u);
+  EXPECT_FALSE(cfg.recognizer_elastic_threads);
+  // The serving config keeps its reservation.
+  EXPECT_EQ(base.recognizer_realtime_slots, 2u);
+}
+
+TEST(Autotune, FingerprintTracksInputs) {
+  Config     cfg;
+  const auto base = autotune_fingerprint(cfg, {"encoder.int8.onnx"});
+  EXPECT_NE(base.find("cpu="), std::string::npos);
+  EXPECT_NE(base, autotune_fingerprint(cfg, {"encoder.int8.onnx", "encoder.onnx"}));
+  cfg.num_threads = 8;
+  EXPECT_NE(base, autotune_fingerprint(cfg, {"encoder.int8.onnx"}));
+}
+
+}  // namespace
+}  // namespace asr
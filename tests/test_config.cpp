@@ -202,6 +202,14 @@ TEST(ConfigValidation, ClampsTinyLiveFlushInterval) {
   EXPECT_FLOAT_EQ(cfg.live_flush_interval_sec, 0.2f);
 }
 
+TEST(ConfigValidation, ClampsNegativeRealtimeLagAlert) {
+  Config cfg;
+  EXPECT_FLOAT_EQ(cfg.realtime_lag_alert_sec, 0.0f);
+  cfg.realtime_lag_alert_sec = -2.0f;
+  cfg.validate();
+  EXPECT_FLOAT_EQ(cfg.realtime_lag_alert_sec, 0.0f);
+}
+
 TEST(ConfigValidation, ClampsThreads) {
   Config cfg;
   cfg.num_threads = 500;
@@ -216,6 +224,13 @@ TEST(ConfigValidation, ValidateServerThreads) {
   EXPECT_LE(cfg.threads, static_cast<size_t>(256));
 }
 
+TEST(ConfigValidation, ClampsAllocSampleBytes) {
+  Config cfg;
+  cfg.alloc_sample_bytes = 16;
+  cfg.validate();
+  EXPECT_EQ(cfg.alloc_sample_bytes, static_cast<size_t>(4096));
+}
+
 TEST(ConfigValidation, VadMaxSpeechMustExceedMinSpeech) {
   Config cfg;
   cfg.vad_max_speech = 0.1f;
@@ -238,12 +253,53 @@ TEST(ConfigValidation, ClampsMinSpeech) {
   EXPECT_GT(cfg.vad_min_speech, 0.0f);
 }
 
+TEST(ConfigValidation, SpeculativeFractionOutOfRangeDisables) {
+  Config cfg;
+  cfg.speculative_fraction = 0.6f;
+  cfg.validate();
+  EXPECT_FLOAT_EQ(cfg.speculative_fraction, 0.6f);
+  cfg.speculative_fraction = 1.0f;
+  cfg.validate();
+  EXPECT_FLOAT_EQ(cfg.speculative_fraction, 0.0f);
+}
+
+TEST(ConfigValidation, VadThresholdMaxStaysAboveThreshold) {
+  Config cfg;
+  cfg.vad_threshold     = 0.6f;
+  cfg.vad_threshold_max = 0.4f;
+  cfg.validate();
+  EXPECT_FLOAT_EQ(cfg.vad_threshold_max, 0.6f);
+  cfg.vad_threshold_max = 1.5f;
+  cfg.validate();
+  EXPECT_FLOAT_EQ(cfg.vad_threshold_max, 0.99f);
+}
+
+TEST(ConfigValidation, NonSpeechFilterMustBeAKnownMode) {
+  Config cfg;
+  EXPECT_EQ(cfg.nonspeech_filter, "off");
+  cfg.nonspeech_filter = "Drop";
+  EXPECT_NO_THROW(cfg.validate());
+  cfg.nonspeech_filter = "skip";
+  EXPECT_THROW(cfg.validate(), ConfigError);
+}
+
+TEST(ConfigValidation, OpusDecodeThreadsZeroMeansAllCores) {
+  Config cfg;
+  cfg.opus_decode_threads = 3;
+  cfg.validate();
+  EXPECT_EQ(cfg.opus_decode_threads, static_cast<size_t>(3));
+  cfg.opus_decode_threads = 0;
+  cfg.validate();
+  EXPECT_GE(cfg.opus_decode_threads, static_cast<size_t>(1));
+}
+
 TEST(Config, DefaultPoolValues) {
   const Config cfg;
   EXPECT_EQ(cfg.recognizer_pool_size, 1);
   EXPECT_EQ(cfg.max_concurrent_requests, static_cast<size_t>(0));
   EXPECT_EQ(cfg.recognizer_wait_timeout_ms, static_cast<size_t>(30000));
   EXPECT_EQ(cfg.max_ws_connections, static_cast<size_t>(0));
+  EXPECT_FALSE(cfg.recognizer_elastic_threads);
 }
 
 TEST(Config, FromEnvPoolOverrides) {
@@ -251,12 +307,14 @@ TEST(Config, FromEnvPoolOverrides) {
   const ScopedEnv e2("MAX_CONCURRENT_REQUESTS", "16");
   const ScopedEnv e3("RECOGNIZER_WAIT_TIMEOUT_MS", "1234");
   const ScopedEnv e4("MAX_WS_CONNECTIONS", "32");
+  const ScopedEnv e5("RECOGNIZER_ELASTIC_THREADS", "true");
 
   auto cfg = Config::from_env();
   EXPECT_EQ(cfg.recognizer_pool_size, 4);
   EXPECT_EQ(cfg.max_concurrent_requests, static_cast<size_t>(16));
   EXPECT_EQ(cfg.recognizer_wait_timeout_ms, static_cast<size_t>(1234));
   EXPECT_EQ(cfg.max_ws_connections, static_cast<size_t>(32));
+  EXPECT_TRUE(cfg.recognizer_elastic_threads);
 }
 
 TEST(ConfigValidation, PoolSizeAutoDefault) {
@@ -274,6 +332,19 @@ TEST(ConfigValidation, MaxConcurrentAutoDefault) {
   EXPECT_EQ(cfg.max_concurrent_requests, static_cast<size_t>(cfg.recognizer_pool_size));
 }
 
+TEST(ConfigValidation, MaxConcurrentClampedToSharedSlots) {
+  Config cfg;
+  cfg.recognizer_pool_size      = 4;
+  cfg.recognizer_realtime_slots = 1;
+  cfg.max_concurrent_requests   = 16;
+  cfg.validate();
+  EXPECT_EQ(cfg.max_concurrent_requests, static_cast<size_t>(3));
+
+  cfg.max_concurrent_requests = 2;
+  cfg.validate();
+  EXPECT_EQ(cfg.max_concurrent_requests, static_cast<size_t>(2));
+}
+
 TEST(ConfigValidation, RecognizerWaitTimeoutZeroUsesDefault) {
   Config cfg;
   cfg.recognizer_wait_timeout_ms = 0;
@@ -288,5 +359,122 @@ TEST(ConfigValidation, ClampsPoolSize) {
   EXPECT_LE(cfg.recognizer_pool_size, 256);
 }
 
+TEST(Config, FromEnvReadinessOverrides) {
+  const ScopedEnv e1("READY_QUEUE_DEGRADED", "0.25");
+  const ScopedEnv e2("READY_WAIT_P95_NOT_READY_MS", "750");
+  const ScopedEnv e3("MEMORY_BUDGET_BYTES", "1073741824");
+  const ScopedEnv e4("READY_RECOVER_RATIO", "0.6");
+
+  auto cfg = Config::from_env();
+  EXPECT_FLOAT_EQ(cfg.ready_queue_degraded, 0.25f);
+  EXPECT_EQ(cfg.ready_wait_p95_not_ready_ms, static_cast<size_t>(750));
+  EXPECT_EQ(cfg.memory_budget_bytes, static_cast<size_t>(1073741824));
+  EXPECT_FLOAT_EQ(cfg.ready_recover_ratio, 0.6f);
+}
+
+TEST(ConfigValidation, ClampsReadinessThresholds) {
+  Config cfg;
+  cfg.ready_queue_not_ready = -1.0f;
+  cfg.ready_recover_ratio   = 2.0f;
+  cfg.validate();
+  EXPECT_FLOAT_EQ(cfg.ready_queue_not_ready, 0.0f);
+  EXPECT_FLOAT_EQ(cfg.ready_recover_ratio, 1.0f);
+}
+
+TEST(Config, FromEnvTenants) {
+  const ScopedEnv e1("TENANTS", "acme:key-1:3");
+
+  auto cfg = Config::from_env();
+  EXPECT_EQ(cfg.tenants, "acme:key-1:3");
+  EXPECT_NO_THROW(cfg.validate());
+}
+
+TEST(ConfigValidation, RejectsMalformedTenants) {
+  Config cfg;
+  cfg.tenants = "acme:key-1";
+  EXPECT_THROW(cfg.validate(), ConfigError);
+}
+
+TEST(Config, FromEnvDecoding) {
+  const ScopedEnv e1("DECODING_METHOD", "adaptive");
+  const ScopedEnv e2("MAX_ACTIVE_PATHS", "8");
+  const ScopedEnv e3("ADAPTIVE_BEAM_BELOW", "0.1");
+  const ScopedEnv e4("ADAPTIVE_GREEDY_ABOVE", "0.75");
+
+  auto cfg = Config::from_env();
+  EXPECT_EQ(cfg.decoding_method, "adaptive");
+  EXPECT_EQ(cfg.max_active_paths, 8);
+  EXPECT_FLOAT_EQ(cfg.adaptive_beam_below, 0.1f);
+  EXPECT_FLOAT_EQ(cfg.adaptive_greedy_above, 0.75f);
+  EXPECT_NO_THROW(cfg.validate());
+}
+
+TEST(ConfigValidation, DecodingMethod) {
+  Config cfg;
+  cfg.decoding_method = "viterbi";
+  EXPECT_THROW(cfg.validate(), ConfigError);
+
+  cfg.decoding_method     = "modified_beam_search";
+  cfg.max_active_paths    = 0;
+  cfg.adaptive_beam_below = 0.9f;
+  cfg.validate();
+  EXPECT_EQ(cfg.max_active_paths, 1);
+  EXPECT_FLOAT_EQ(cfg.adaptive_beam_below, cfg.adaptive_greedy_above);
+}
+
+TEST(Config, FromEnvAutotune) {
+  const ScopedEnv e1("ENCODER_FILE", "encoder.onnx");
+  const ScopedEnv e2("AUTOTUNE", "yes");
+  const ScopedEnv e3("AUTOTUNE_CACHE", "/var/cache/asr/autotune.json");
+  const ScopedEnv e4("AUTOTUNE_BUDGET_SEC", "30");
+  const ScopedEnv e5("AUTOTUNE_LATENCY_TARGET_MS", "750");
+
+  auto cfg = Config::from_env();
+  EXPECT_EQ(cfg.encoder_file, "encoder.onnx");
+  EXPECT_TRUE(cfg.autotune);
+  EXPECT_EQ(cfg.autotune_cache, "/var/cache/asr/autotune.json");
+  EXPECT_FLOAT_EQ(cfg.autotune_budget_sec, 30.0f);
+  EXPECT_EQ(cfg.autotune_latency_target_ms, 750u);
+  EXPECT_NO_THROW(cfg.validate());
+}
+
+TEST(ConfigValidation, AutotuneAndEncoderFile) {
+  Config cfg;
+  cfg.encoder_file = "../encoder.onnx";
+  EXPECT_THROW(cfg.validate(), ConfigError);
+
+  cfg.encoder_file        = "encoder.onnx";
+  cfg.autotune_budget_sec = 0.0f;
+  cfg.validate();
+  EXPECT_FLOAT_EQ(cfg.autotune_budget_sec, 1.0f);
+
+  cfg.autotune_latency_target_ms = 0;
+  EXPECT_THROW(cfg.validate(), ConfigError);
+}
+
+TEST(Config, FromEnvSyntheticBackend) {
+  const ScopedEnv e1("RECOGNIZER_BACKEND", "Synthetic");
+  const ScopedEnv e2("SYNTHETIC_CALL_MS", "2.5");
+  const ScopedEnv e3("SYNTHETIC_MS_PER_AUDIO_SEC", "40");
+  const ScopedEnv e4("SYNTHETIC_JITTER_MS", "1");
+  const ScopedEnv e5("SYNTHETIC_BURN_CPU", "true");
+  const ScopedEnv e6("AUTOTUNE", "1");
+
+  auto cfg = Config::from_env();
+  cfg.validate();
+  EXPECT_EQ(cfg.recognizer_backend, "synthetic");
+  EXPECT_FLOAT_EQ(cfg.synthetic_call_ms, 2.5f);
+  EXPECT_FLOAT_EQ(cfg.synthetic_ms_per_audio_sec, 40.0f);
+  EXPECT_FLOAT_EQ(cfg.synthetic_jitter_ms, 1.0f);
+  EXPECT_TRUE(cfg.synthetic_burn_cpu);
+  EXPECT_FALSE(cfg.autotune);  // nothing to tune without a model
+}
+
+TEST(ConfigValidation, RejectsUnknownRecognizerBackend) {
+  Config cfg;
+  cfg.recognizer_backend = "whisper";
+  EXPECT_THROW(cfg.validate(), ConfigError);
+}
+
 }  // namespace
 }  // namespace asr
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "asr/config.h"
+#include "asr/decoding_policy.h"
+
+namespace asr {
+namespace {
+
+TEST(DecodingPolicy, ParsesStrategy) {
+  EXPECT_EQ(parse_decoding_strategy("greedy_search"), DecodingStrategy::Greedy);
+  EXPECT_EQ(parse_decoding_strategy(" Greedy "), DecodingStrategy::Greedy);
+  EXPECT_EQ(parse_decoding_strategy("modified_beam_search"), DecodingStrategy::ModifiedBeamSearch);
+  EXPECT_EQ(parse_decoding_strategy("beam"), DecodingStrategy::ModifiedBeamSearch);
+  EXPECT_EQ(parse_decoding_strategy("ADAPTIVE"), DecodingStrategy::Adaptive);
+  EXPECT_THROW(parse_decoding_strategy(""), ConfigError);
+  EXPECT_THROW(parse_decoding_strategy("beam_search"), ConfigError);
+
+  EXPECT_EQ(std::string(decoding_method_name(DecodingMethod::Greedy)), "greedy_search");
+  EXPECT_EQ(std::string(decoding_method_name(DecodingMethod::ModifiedBeamSearch)), "modified_beam_search");
+}
+
+TEST(DecodingPolicy, LoneRequestGetsBeamSearch) {
+  AdaptiveDecodingPolicy policy(0.25, 0.5);
+  EXPECT_EQ(policy.current(), DecodingMethod::ModifiedBeamSearch);
+  EXPECT_EQ(policy.select(0, 0, 1), DecodingMethod::ModifiedBeamSearch);
+  EXPECT_EQ(policy.select(0, 0, 4), DecodingMethod::ModifiedBeamSearch);
+}
+
+TEST(DecodingPolicy, FallsBackToGreedyUnderLoadWithHysteresis) {
+  AdaptiveDecodingPolicy policy(0.25, 0.5);
+
+  EXPECT_EQ(policy.select(2, 0, 4), DecodingMethod::ModifiedBeamSearch);  // 0.5: not above
+  EXPECT_EQ(policy.select(2, 1, 4), DecodingMethod::Greedy);              // 0.75
+  EXPECT_EQ(policy.select(1, 1, 4), DecodingMethod::Greedy);              // 0.5: still loaded
+  EXPECT_EQ(policy.select(3, 0, 8), DecodingMethod::Greedy);              // 0.375: inside the band
+  EXPECT_EQ(policy.select(1, 0, 8), DecodingMethod::ModifiedBeamSearch);  // 0.125
+}
+
+TEST(DecodingPolicy, EmptyPoolCountsAsSaturated) {
+  AdaptiveDecodingPolicy policy(0.25, 0.5);
+  EXPECT_EQ(policy.select(0, 0, 0), DecodingMethod::Greedy);
+}
+
+}  // namespace
+}  // namespace asr
@@ -1,9 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "asr/executor.h"
@@ -56,68 +63,356 @@ TEST(Executor, RejectsWhenQueueCapacityExceeded) {
   EXPECT_TRUE(executor.wait_for_idle(1s));
 }
 
-TEST(Executor, SerializedTaskQueuePreservesOrderAndBackpressure) {
-  SerializedTaskQueue queue(1);
-  std::vector<int>    started;
+TEST(Executor, WeightedLanesShareWorkersByWeight) {
+  BoundedExecutor executor(1, 64, {3, 1});
 
-  ASSERT_TRUE(queue.push_or_start([&started]() {
-    started.push_back(1);
-    return true;
-  }));
-  EXPECT_TRUE(queue.in_flight());
-  EXPECT_TRUE(queue.push_or_start([&started]() {
-    started.push_back(2);
-    return true;
-  }));
-  EXPECT_EQ(queue.pending(), 1U);
-  EXPECT_FALSE(queue.push_or_start([&started]() {
-    started.push_back(3);
-    return true;
+  std::promise<void> started;
+  auto               started_future = started.get_future();
+  std::promise<void> unblock;
+  auto               unblock_future = unblock.get_future().share();
+  ASSERT_TRUE(executor.try_submit([&started, unblock_future]() {
+    started.set_value();
+    unblock_future.wait();
   }));
+  ASSERT_EQ(started_future.wait_for(1s), std::future_status::ready);
 
-  queue.finish_current();
-  ASSERT_TRUE(queue.maybe_start_next());
-  EXPECT_EQ(started, (std::vector<int>{1, 2}));
-  EXPECT_TRUE(queue.in_flight());
+  std::mutex       order_mutex;
+  std::vector<int> order;
+  for (int i = 0; i < 8; ++i) {
+    for (int lane = 0; lane < 2; ++lane) {
+      ASSERT_TRUE(executor.try_submit(
+          [&order_mutex, &order, lane]() {
+            const std::scoped_lock lock(order_mutex);
+            order.push_back(lane);
+          },
+          static_cast<size_t>(lane)));
+    }
+  }
+  EXPECT_EQ(executor.queued(0), 8U);
+  EXPECT_EQ(executor.queued(1), 8U);
+
+  unblock.set_value();
+  ASSERT_TRUE(executor.wait_for_idle(1s));
+
+  // Lane 0 (weight 3) gets three turns per turn of lane 1 while both are backlogged.
+  ASSERT_EQ(order.size(), 16U);
+  const auto heavy_in_first_eight = std::count(order.begin(), order.begin() + 8, 0);
+  EXPECT_EQ(heavy_in_first_eight, 6);
 }
 
-TEST(Executor, SerializedTaskQueueRetriesAfterTransientStartFailure) {
-  SerializedTaskQueue queue(2);
-  int                 attempts = 0;
+TEST(Executor, LaneLimitKeepsOneTenantFromFillingTheQueue) {
+  BoundedExecutor executor(1, 4, {1, 1});
 
-  ASSERT_TRUE(queue.push_or_start([&attempts]() {
-    ++attempts;
-    return false;
-  }));
-  EXPECT_FALSE(queue.in_flight());
-  EXPECT_EQ(queue.pending(), 1U);
+  std::promise<void> started;
+  auto               started_future = started.get_future();
+  std::promise<void> unblock;
+  auto               unblock_future = unblock.get_future().share();
+  ASSERT_TRUE(executor.try_submit(
+      [&started, unblock_future]() {
+        started.set_value();
+        unblock_future.wait();
+      },
+      1));
+  ASSERT_EQ(started_future.wait_for(1s), std::future_status::ready);
 
-  EXPECT_FALSE(queue.maybe_start_next());
-  EXPECT_EQ(attempts, 2);
+  ASSERT_TRUE(executor.try_submit([]() {}, 0));
+  ASSERT_TRUE(executor.try_submit([]() {}, 0));
+  EXPECT_FALSE(executor.try_submit([]() {}, 0));
+  EXPECT_TRUE(executor.try_submit([]() {}, 1));
+  // Unknown lanes fall back to lane 0.
+  EXPECT_FALSE(executor.try_submit([]() {}, 7));
+  EXPECT_EQ(executor.lane_count(), 2U);
 
-  queue.clear();
-  attempts = 0;
-  ASSERT_TRUE(queue.push_or_start([&attempts]() {
-    ++attempts;
-    return attempts >= 2;
-  }));
-  EXPECT_EQ(attempts, 1);
-  EXPECT_FALSE(queue.in_flight());
-  ASSERT_TRUE(queue.maybe_start_next());
-  EXPECT_EQ(attempts, 2);
-  EXPECT_TRUE(queue.in_flight());
+  unblock.set_value();
+  EXPECT_TRUE(executor.wait_for_idle(1s));
+}
+
+TEST(Executor, FixedRingWrapsAndReleasesPoppedSlots) {
+  FixedRing<std::function<void()>> ring(2);
+  auto                             token = std::make_shared<int>(0);
+  std::vector<int>                 order;
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_FALSE(ring.full());
+    ring.push_back([token, &order, i]() { order.push_back(i); });
+    if (ring.full()) {
+      ring.front()();
+      ring.pop_front();
+    }
+  }
+  EXPECT_EQ(ring.size(), 1U);
+  EXPECT_EQ(token.use_count(), 2);
+  ring.clear();
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(token.use_count(), 1);
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
 }
 
-TEST(Executor, SerializedTaskQueueStopRejectsFurtherWork) {
-  SerializedTaskQueue queue(2);
+TEST(Executor, FixedRingHoldsAtLeastOneSlot) {
+  FixedRing<int> ring(0);
+  EXPECT_FALSE(ring.full());
+  ring.push_back(7);
+  EXPECT_TRUE(ring.full());
+  EXPECT_EQ(ring.front(), 7);
+  ring.pop_front();
+  EXPECT_TRUE(ring.empty());
+
+  FixedRing<int> fallback;
+  fallback.push_back(1);
+  EXPECT_TRUE(fallback.full());
+}
 
-  ASSERT_TRUE(queue.push_or_start([]() { return true; }));
-  queue.stop();
-  queue.finish_current();
+TEST(Executor, ActorMailboxHandsTheDrainBackAndForth) {
+  ActorMailbox<int> mailbox(2);
 
-  EXPECT_TRUE(queue.stopped());
-  EXPECT_FALSE(queue.push_or_start([]() { return true; }));
-  EXPECT_FALSE(queue.maybe_start_next());
+  *mailbox.back_slot() = 1;
+  EXPECT_TRUE(mailbox.push());  // empty -> non-empty: the producer owns the drain
+  *mailbox.back_slot() = 2;
+  EXPECT_FALSE(mailbox.push());
+  EXPECT_EQ(mailbox.back_slot(), nullptr);
+  EXPECT_EQ(mailbox.size(), 2U);
+
+  EXPECT_EQ(mailbox.front(), 1);
+  EXPECT_TRUE(mailbox.pop());
+  *mailbox.back_slot() = 3;
+  EXPECT_FALSE(mailbox.push());  // still drained by the current owner
+  EXPECT_EQ(mailbox.front(), 2);
+  EXPECT_TRUE(mailbox.pop());
+  EXPECT_EQ(mailbox.front(), 3);
+  EXPECT_FALSE(mailbox.pop());  // empty: the drain is handed back
+
+  *mailbox.back_slot() = 4;
+  EXPECT_TRUE(mailbox.push());
+  EXPECT_EQ(mailbox.front(), 4);
+  EXPECT_FALSE(mailbox.pop());
+}
+
+TEST(Executor, ActorMailboxRunsEventsInOrderOneDrainAtATime) {
+  constexpr int     kEvents = 20000;
+  BoundedExecutor   executor(4, 64);
+  ActorMailbox<int> mailbox(8);
+  std::vector<int>  seen;
+  std::atomic<int>  draining{0};
+  std::atomic<bool> overlapped{false};
+  seen.reserve(kEvents);
+
+  // Runs a few events per task and resubmits while it still owns the drain.
+  std::function<void()> drain = [&]() {
+    if (draining.fetch_add(1, std::memory_order_acq_rel) != 0) {
+      overlapped.store(true, std::memory_order_relaxed);
+    }
+    bool owned = true;
+    for (int n = 0; owned && n < 3; ++n) {
+      seen.push_back(mailbox.front());
+      owned = mailbox.pop();
+    }
+    draining.fetch_sub(1, std::memory_order_acq_rel);
+    if (owned) {
+      while (!executor.try_submit(drain)) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  for (int i = 0; i < kEvents; ++i) {
+    int* slot = nullptr;
+    while ((slot = mailbox.back_slot()) == nullptr) {
+      std::this_thread::yield();
+    }
+    *slot = i;
+    if (mailbox.push()) {
+      while (!executor.try_submit(drain)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  while (mailbox.size() > 0) {
+    std::this_thread::yield();
+  }
+  ASSERT_TRUE(executor.wait_for_idle(5s));
+
+  EXPECT_FALSE(overlapped.load(std::memory_order_relaxed));
+  ASSERT_EQ(seen.size(), static_cast<size_t>(kEvents));
+  for (int i = 0; i < kEvents; ++i) {
+    ASSERT_EQ(seen[static_cast<size_t>(i)], i);
+  }
+}
+
+// A minimal event loop: one thread running posted and delayed tasks in due
+// order, standing in for a connection's IO loop.
+class TestLoop {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  TestLoop() : thread_([this]() { run(); }) {}
+  ~TestLoop() {
+    {
+      const std::scoped_lock lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  TestLoop(const TestLoop&)            = delete;
+  TestLoop& operator=(const TestLoop&) = delete;
+  TestLoop(TestLoop&&)                 = delete;
+  TestLoop& operator=(TestLoop&&)      = delete;
+
+  void post(std::function<void()> fn, double delay_sec = 0.0) {
+    const std::scoped_lock lock(mutex_);
+    const auto due = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                        std::chrono::duration<double>(delay_sec));
+    tasks_.push_back(Task{due, next_seq_++, std::move(fn)});
+    cv_.notify_all();  // under the lock: the poster may be the last user of this loop
+  }
+
+  [[nodiscard]] bool on_loop() const {
+    return std::this_thread::get_id() == thread_.get_id();
+  }
+
+ private:
+  struct Task {
+    Clock::time_point     due;
+    uint64_t              seq = 0;
+    std::function<void()> fn;
+  };
+
+  void run() {
+    std::unique_lock lock(mutex_);
+    while (!(stopping_ && tasks_.empty())) {
+      if (tasks_.empty()) {
+        cv_.wait(lock);
+        continue;
+      }
+      const auto next = std::min_element(tasks_.begin(), tasks_.end(), [](const Task& a, const Task& b) {
+        return a.due != b.due ? a.due < b.due : a.seq < b.seq;
+      });
+      if (next->due > Clock::now()) {
+        cv_.wait_until(lock, next->due);
+        continue;
+      }
+      auto fn = std::move(next->fn);
+      tasks_.erase(next);
+      lock.unlock();
+      fn();
+      lock.lock();
+    }
+  }
+
+  std::mutex              mutex_;
+  std::condition_variable cv_;
+  std::vector<Task>       tasks_;
+  uint64_t                next_seq_ = 0;
+  bool                    stopping_ = false;
+  std::thread             thread_;
+};
+
+struct ActorTrace {
+  std::vector<int>  ran;  // drain owner only; read once the actor is gone
+  size_t            ran_at_close = 0;
+  std::atomic<int>  closes{0};
+  std::atomic<bool> off_loop{false};  // a loop-side hook ran on another thread
+  std::atomic<int>  ran_on_workers{0};
+};
+
+class LoopBoundActor final : public LoopActor {
+ public:
+  LoopBoundActor(TestLoop& loop, BoundedExecutor& executor, size_t capacity, ActorTrace& trace)
+      : inbox(capacity), loop_(loop), executor_(executor), trace_(trace) {}
+
+  ActorMailbox<int> inbox;
+  int               refuse_submits = 0;  // loop thread
+
+ protected:
+  void post(std::function<void()> fn) override {
+    loop_.post(std::move(fn));
+  }
+  void post_after(double delay_sec, std::function<void()> fn) override {
+    loop_.post(std::move(fn), delay_sec);
+  }
+  bool submit_drain() override {
+    check_loop();
+    if (refuse_submits > 0) {
+      --refuse_submits;
+      return false;
+    }
+    return executor_.try_submit([this]() { run_batch(); });
+  }
+  bool run_front() override {
+    std::this_thread::sleep_for(100us);  // slower than the producer: batches end still owned
+    if (!loop_.on_loop()) {
+      trace_.ran_on_workers.fetch_add(1);
+    }
+    trace_.ran.push_back(inbox.front());
+    return inbox.pop();
+  }
+  void on_closed() override {
+    check_loop();
+    trace_.ran_at_close = trace_.ran.size();
+    trace_.closes.fetch_add(1);
+  }
+
+ private:
+  void check_loop() {
+    if (!loop_.on_loop()) {
+      trace_.off_loop = true;
+    }
+  }
+
+  TestLoop&        loop_;
+  BoundedExecutor& executor_;
+  ActorTrace&      trace_;
+};
+
+TEST(Executor, LoopActorKeepsPushesCompletionsAndRetriesOnItsLoop) {
+  constexpr int kPushes = 20;
+  constexpr int kBurst  = 10;
+
+  ActorTrace trace;
+  {
+    TestLoop        loop;
+    BoundedExecutor executor(2, 8);  // joined first: workers post to the loop
+    auto            actor = std::make_shared<LoopBoundActor>(loop, executor, kPushes * kBurst, trace);
+    std::weak_ptr<LoopActor> weak = actor;
+
+    loop.post([actor]() { actor->refuse_submits = 1; });  // exercises the retry timer
+    // Bursts spaced past the retry delay reach the executor; the last one
+    // closes while its drain is still outstanding, so the close is deferred.
+    for (int p = 0; p < kPushes; ++p) {
+      const bool last = p + 1 == kPushes;
+      loop.post(
+          [actor, p, last]() {
+            for (int k = 0; k < kBurst; ++k) {
+              int* slot = actor->inbox.back_slot();
+              ASSERT_NE(slot, nullptr);
+              *slot = p * kBurst + k;
+              actor->pushed(actor, actor->inbox.push());
+            }
+            if (last) {
+              actor->closed();
+            }
+          },
+          0.02 + 0.002 * p);
+    }
+    actor.reset();
+
+    // The self-reference alone keeps the actor until its last drain settles.
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!weak.expired() && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_TRUE(weak.expired());
+  }
+
+  EXPECT_FALSE(trace.off_loop.load());
+  EXPECT_GT(trace.ran_on_workers.load(), 0);
+  EXPECT_EQ(trace.closes.load(), 1);
+  EXPECT_EQ(trace.ran_at_close, static_cast<size_t>(kPushes * kBurst));
+  ASSERT_EQ(trace.ran.size(), static_cast<size_t>(kPushes * kBurst));
+  for (size_t i = 0; i < trace.ran.size(); ++i) {
+    EXPECT_EQ(trace.ran[i], static_cast<int>(i));
+  }
 }
 
 }  // namespace
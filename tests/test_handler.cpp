@@ -1,13 +1,21 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
+#include <iterator>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "asr/audio.h"
 #include "asr/config.h"
 #include "asr/handler.h"
 #include "asr/recognizer.h"
 #include "asr/span.h"
+#include "asr/synthetic_recognizer.h"
 #include "asr/vad.h"
 
 namespace asr {
@@ -15,6 +23,8 @@ namespace {
 
 constexpr const char* kModelDir = "models/sherpa-onnx-nemo-transducer-punct-giga-am-v3-russian-2025-12-16";
 constexpr const char* kVadModel = "models/silero_vad.onnx";
+constexpr const char* kTestWav =
+    "models/sherpa-onnx-nemo-transducer-punct-giga-am-v3-russian-2025-12-16/test_wavs/example.wav";
 
 bool models_exist() {
   const std::ifstream f1(std::string(kModelDir) + "/encoder.int8.onnx");
@@ -59,10 +69,10 @@ TEST(Handler, OnAudioInterim) {
   if (!models_exist())
     GTEST_SKIP() << "Models not found";
 
-  auto       cfg     = make_test_config();
-  auto       vad_cfg = make_vad_config(cfg);
-  Recognizer rec(cfg);
-  ASRSession session(rec, vad_cfg, cfg, "realtime_websocket");
+  auto             cfg     = make_test_config();
+  auto             vad_cfg = make_vad_config(cfg);
+  Recognizer       rec(cfg);
+  LegacyASRSession session(rec, vad_cfg, cfg);
 
   // Send small silent chunk - should get interim
   std::vector<float> silence(1024, 0.0f);
@@ -72,7 +82,7 @@ TEST(Handler, OnAudioInterim) {
   // First response should be interim for silence
   bool has_interim = false;
   for (const auto& msg : messages) {
-    if (msg.type == ASRSession::OutMessage::Interim) {
+    if (msg.type == ASRSessionMessage::Interim) {
       has_interim = true;
       EXPECT_NE(msg.json.find("\"type\":\"interim\""), std::string::npos);
     }
@@ -84,10 +94,10 @@ TEST(Handler, OnRecognizeFlush) {
   if (!models_exist())
     GTEST_SKIP() << "Models not found";
 
-  auto       cfg     = make_test_config();
-  auto       vad_cfg = make_vad_config(cfg);
-  Recognizer rec(cfg);
-  ASRSession session(rec, vad_cfg, cfg, "realtime_websocket");
+  auto             cfg     = make_test_config();
+  auto             vad_cfg = make_vad_config(cfg);
+  Recognizer       rec(cfg);
+  LegacyASRSession session(rec, vad_cfg, cfg);
 
   // Send some audio then recognize
   std::vector<float> silence(4096, 0.0f);
@@ -97,7 +107,7 @@ TEST(Handler, OnRecognizeFlush) {
   // Should end with done message
   ASSERT_FALSE(messages.empty());
   const auto& last = messages.back();
-  EXPECT_EQ(last.type, ASRSession::OutMessage::Done);
+  EXPECT_EQ(last.type, ASRSessionMessage::Done);
   EXPECT_NE(last.json.find("\"type\":\"done\""), std::string::npos);
 }
 
@@ -105,10 +115,10 @@ TEST(Handler, OnReset) {
   if (!models_exist())
     GTEST_SKIP() << "Models not found";
 
-  auto       cfg     = make_test_config();
-  auto       vad_cfg = make_vad_config(cfg);
-  Recognizer rec(cfg);
-  ASRSession session(rec, vad_cfg, cfg, "realtime_websocket");
+  auto             cfg     = make_test_config();
+  auto             vad_cfg = make_vad_config(cfg);
+  Recognizer       rec(cfg);
+  LegacyASRSession session(rec, vad_cfg, cfg);
 
   std::vector<float> audio(2048, 0.0f);
   session.on_audio(audio);
@@ -125,23 +135,23 @@ TEST(Handler, MultipleSessionsOnConnection) {
   if (!models_exist())
     GTEST_SKIP() << "Models not found";
 
-  auto       cfg     = make_test_config();
-  auto       vad_cfg = make_vad_config(cfg);
-  Recognizer rec(cfg);
-  ASRSession session(rec, vad_cfg, cfg, "realtime_websocket");
+  auto             cfg     = make_test_config();
+  auto             vad_cfg = make_vad_config(cfg);
+  Recognizer       rec(cfg);
+  LegacyASRSession session(rec, vad_cfg, cfg);
 
   // First session
   std::vector<float> silence(2048, 0.0f);
   session.on_audio(silence);
   auto msgs1 = session.on_recognize();
   ASSERT_FALSE(msgs1.empty());
-  EXPECT_EQ(msgs1.back().type, ASRSession::OutMessage::Done);
+  EXPECT_EQ(msgs1.back().type, ASRSessionMessage::Done);
 
   // Second session - should work after done
   session.on_audio(silence);
   auto msgs2 = session.on_recognize();
   ASSERT_FALSE(msgs2.empty());
-  EXPECT_EQ(msgs2.back().type, ASRSession::OutMessage::Done);
+  EXPECT_EQ(msgs2.back().type, ASRSessionMessage::Done);
 }
 
 TEST(Handler, AutoRolloverAfterMaxDurationWithoutReset) {
@@ -151,15 +161,15 @@ TEST(Handler, AutoRolloverAfterMaxDurationWithoutReset) {
   auto cfg          = make_test_config();
   cfg.max_audio_sec = 0.05f;  // force auto-finalize for a single 1024-sample chunk at 16k
 
-  auto       vad_cfg = make_vad_config(cfg);
-  Recognizer rec(cfg);
-  ASRSession session(rec, vad_cfg, cfg, "realtime_websocket");
+  auto             vad_cfg = make_vad_config(cfg);
+  Recognizer       rec(cfg);
+  LegacyASRSession session(rec, vad_cfg, cfg);
 
   std::vector<float> chunk(1024, 0.0f);
 
   auto first_msgs = session.on_audio(chunk);
   ASSERT_FALSE(first_msgs.empty());
-  EXPECT_EQ(first_msgs.back().type, ASRSession::OutMessage::Done);
+  EXPECT_EQ(first_msgs.back().type, ASRSessionMessage::Done);
 
   // No explicit RESET between chunks: session should auto-start again.
   auto second_msgs = session.on_audio(chunk);
@@ -174,9 +184,9 @@ TEST(Handler, LivePeriodicFlushDoesNotEmitDone) {
   cfg.max_audio_sec           = 0.0f;
   cfg.live_flush_interval_sec = 0.2f;
 
-  auto       vad_cfg = make_vad_config(cfg);
-  Recognizer rec(cfg);
-  ASRSession session(rec, vad_cfg, cfg, "realtime_websocket");
+  auto             vad_cfg = make_vad_config(cfg);
+  Recognizer       rec(cfg);
+  LegacyASRSession session(rec, vad_cfg, cfg);
 
   // 4096 samples at 16k = 0.256s, enough to trigger periodic live flush.
   std::vector<float> silence(4096, 0.0f);
@@ -184,9 +194,204 @@ TEST(Handler, LivePeriodicFlushDoesNotEmitDone) {
   ASSERT_FALSE(msgs.empty());
 
   for (const auto& msg : msgs) {
-    EXPECT_NE(msg.type, ASRSession::OutMessage::Done);
+    EXPECT_NE(msg.type, ASRSessionMessage::Done);
   }
 }
 
+TEST(Handler, RealtimeSessionSendsNoInterims) {
+  if (!models_exist())
+    GTEST_SKIP() << "Models not found";
+
+  auto               cfg     = make_test_config();
+  auto               vad_cfg = make_vad_config(cfg);
+  Recognizer         rec(cfg);
+  RealtimeASRSession session(rec, vad_cfg, cfg);
+
+  std::vector<float> silence(1024, 0.0f);
+  EXPECT_TRUE(session.on_audio(silence).empty());
+
+  auto messages = session.on_recognize();
+  ASSERT_FALSE(messages.empty());
+  EXPECT_EQ(messages.back().type, ASRSessionMessage::Done);
+  EXPECT_TRUE(messages.back().json.empty());
+}
+
+TEST(Handler, OfflineSessionSkipsLiveUpdates) {
+  if (!models_exist())
+    GTEST_SKIP() << "Models not found";
+
+  auto cfg                    = make_test_config();
+  cfg.max_audio_sec           = 0.0f;
+  cfg.live_flush_interval_sec = 0.2f;
+
+  auto              vad_cfg = make_vad_config(cfg);
+  Recognizer        rec(cfg);
+  OfflineASRSession session(rec, vad_cfg, cfg);
+
+  // 0.256s of a steady tone well above silence_threshold: past the live
+  // flush interval, where the other policies would run the fallback decode.
+  std::vector<float> tone(4096);
+  for (size_t i = 0; i < tone.size(); ++i) {
+    tone[i] = 0.3f * std::sin(2.0f * 3.14159265f * 440.0f * static_cast<float>(i) / 16000.0f);
+  }
+  EXPECT_TRUE(session.on_audio(tone).empty());
+
+  auto messages = session.on_recognize();
+  ASSERT_FALSE(messages.empty());
+  EXPECT_EQ(messages.back().type, ASRSessionMessage::Done);
+  for (const auto& msg : messages) {
+    EXPECT_NE(msg.type, ASRSessionMessage::Interim);
+  }
+}
+
+// --- Speculative turn-end decodes, on the synthetic backend ---
+//
+// Its transcript is "synthetic <seconds>", so two finals only match when
+// they were decoded from the same audio.
+
+// The model's example recording with its quiet tail cut, so the pause a test
+// appends is the only one after the last word. Empty without the file.
+std::vector<float> load_example_speech() {
+  std::ifstream              f(kTestWav, std::ios::binary);
+  const std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(f), {}};
+  if (bytes.empty()) {
+    return {};
+  }
+  auto   audio = decode_wav(bytes, 16000);
+  size_t end   = audio.samples.size();
+  while (end > 0 && std::fabs(audio.samples[end - 1]) < 0.02f) {
+    --end;
+  }
+  audio.samples.resize(end);
+  return std::move(audio.samples);
+}
+
+Config make_speculation_config(float fraction) {
+  auto cfg                    = make_test_config();
+  cfg.live_flush_interval_sec = 0.0f;
+  cfg.speculative_fraction    = fraction;
+  return cfg;
+}
+
+struct FedAudio {
+  std::vector<std::string> finals;
+  size_t                   decodes          = 0;
+  size_t                   decodes_at_final = 0;  // in the on_audio calls that returned a final
+};
+
+FedAudio feed(LegacyASRSession& session, const SyntheticRecognizer& rec, const std::vector<float>& audio) {
+  FedAudio fed;
+  for (size_t pos = 0; pos < audio.size(); pos += 512) {
+    const size_t n         = std::min<size_t>(512, audio.size() - pos);
+    const size_t before    = rec.decodes();
+    bool         got_final = false;
+    for (const auto& msg : session.on_audio(span<const float>(audio.data() + pos, n))) {
+      if (msg.type == ASRSessionMessage::Final) {
+        fed.finals.push_back(msg.text);
+        got_final = true;
+      }
+    }
+    const size_t spent = rec.decodes() - before;
+    fed.decodes += spent;
+    fed.decodes_at_final += got_final ? spent : 0;
+  }
+  return fed;
+}
+
+// vad_min_silence is 0.5 s: a fraction of 0.3 speculates 150 ms into a
+// pause, which the short pause passes and the long one confirms.
+constexpr size_t kShortPause = 4800;
+constexpr size_t kLongPause  = 16000;
+
+std::vector<float> pause_of(size_t samples) {
+  return std::vector<float>(samples, 0.0f);
+}
+
+TEST(Handler, SpeculativeDecodeServesTheTurnEnd) {
+  const auto speech = load_example_speech();
+  if (!std::ifstream(kVadModel).good() || speech.empty())
+    GTEST_SKIP() << "VAD model or test WAV not found";
+
+  auto                cfg     = make_speculation_config(0.3f);
+  auto                vad_cfg = make_vad_config(cfg);
+  SyntheticRecognizer rec(1, SyntheticCostModel{0.0, 0.0, 0.0, false});
+  LegacyASRSession    session(rec, vad_cfg, cfg);
+  (void)feed(session, rec, speech);
+  const auto turn_end = feed(session, rec, pause_of(kLongPause));
+
+  // Decoded once, before the pause was confirmed.
+  ASSERT_EQ(turn_end.finals.size(), 1U);
+  EXPECT_EQ(turn_end.decodes, 1U);
+  EXPECT_EQ(turn_end.decodes_at_final, 0U);
+
+  auto                plain_cfg = make_speculation_config(0.0f);
+  SyntheticRecognizer plain_rec(1, SyntheticCostModel{0.0, 0.0, 0.0, false});
+  LegacyASRSession    plain(plain_rec, vad_cfg, plain_cfg);
+  (void)feed(plain, plain_rec, speech);
+  const auto plain_end = feed(plain, plain_rec, pause_of(kLongPause));
+  EXPECT_EQ(plain_end.decodes_at_final, 1U);
+  EXPECT_EQ(turn_end.finals, plain_end.finals);
+}
+
+TEST(Handler, SpeculativeDecodeDiscardedWhenSpeechResumes) {
+  const auto speech = load_example_speech();
+  if (!std::ifstream(kVadModel).good() || speech.empty())
+    GTEST_SKIP() << "VAD model or test WAV not found";
+
+  const auto               tail = static_cast<ptrdiff_t>(std::min<size_t>(16000, speech.size()));
+  const std::vector<float> resumed(speech.end() - tail, speech.end());  // its last second again
+
+  auto                cfg     = make_speculation_config(0.3f);
+  auto                vad_cfg = make_vad_config(cfg);
+  SyntheticRecognizer rec(1, SyntheticCostModel{0.0, 0.0, 0.0, false});
+  LegacyASRSession    session(rec, vad_cfg, cfg);
+  (void)feed(session, rec, speech);
+  const auto pause = feed(session, rec, pause_of(kShortPause));
+  EXPECT_TRUE(pause.finals.empty());
+  EXPECT_EQ(pause.decodes, 1U);  // speculated on the pause
+  EXPECT_TRUE(feed(session, rec, resumed).finals.empty());
+  const auto turn_end = feed(session, rec, pause_of(kLongPause));
+
+  auto                plain_cfg = make_speculation_config(0.0f);
+  SyntheticRecognizer plain_rec(1, SyntheticCostModel{0.0, 0.0, 0.0, false});
+  LegacyASRSession    plain(plain_rec, vad_cfg, plain_cfg);
+  (void)feed(plain, plain_rec, speech);
+  (void)feed(plain, plain_rec, pause_of(kShortPause));
+  (void)feed(plain, plain_rec, resumed);
+  const auto plain_end = feed(plain, plain_rec, pause_of(kLongPause));
+
+  // The final covers the resumed speech too, not the audio speculated on.
+  ASSERT_EQ(turn_end.finals.size(), 1U);
+  EXPECT_EQ(turn_end.finals, plain_end.finals);
+}
+
+TEST(Handler, SpeculativeDecodeSkippedWhileThePoolIsBusy) {
+  const auto speech = load_example_speech();
+  if (!std::ifstream(kVadModel).good() || speech.empty())
+    GTEST_SKIP() << "VAD model or test WAV not found";
+
+  auto                cfg     = make_speculation_config(0.3f);
+  auto                vad_cfg = make_vad_config(cfg);
+  SyntheticRecognizer rec(1, SyntheticCostModel{0.0, 50.0, 0.0, false});
+  LegacyASRSession    session(rec, vad_cfg, cfg);
+  (void)feed(session, rec, speech);
+
+  // Another caller holds the only slot for a second while the pause starts.
+  const std::vector<float> held(20 * 16000, 0.1f);
+  std::thread              holder([&rec, &held] { (void)rec.recognize(held, 16000); });
+  while (rec.load().slots_busy == 0) {
+    std::this_thread::yield();
+  }
+  const auto pause = feed(session, rec, pause_of(kShortPause));
+  holder.join();
+  EXPECT_TRUE(pause.finals.empty());
+  EXPECT_EQ(pause.decodes, 0U);
+
+  // Not retried for the same pause: decoded when the turn end is confirmed.
+  const auto turn_end = feed(session, rec, pause_of(kLongPause));
+  ASSERT_EQ(turn_end.finals.size(), 1U);
+  EXPECT_EQ(turn_end.decodes_at_final, 1U);
+}
+
 }  // namespace
 }  // namespace asr
@@ -103,10 +103,10 @@ TEST(Integration, StreamingSimulation) {
   if (!models_exist() || !test_wav_exists())
     GTEST_SKIP() << "Models or test WAV not found";
 
-  auto       cfg     = make_config();
-  auto       vad_cfg = make_vad_config(cfg);
-  Recognizer rec(cfg);
-  ASRSession session(rec, vad_cfg, cfg, "realtime_websocket");
+  auto               cfg     = make_config();
+  auto               vad_cfg = make_vad_config(cfg);
+  Recognizer         rec(cfg);
+  RealtimeASRSession session(rec, vad_cfg, cfg);
 
   // Decode test WAV
   auto wav_data = read_file(kTestWav);
@@ -122,7 +122,7 @@ TEST(Integration, StreamingSimulation) {
     auto         msgs      = session.on_audio(chunk);
 
     for (const auto& msg : msgs) {
-      if (msg.type == ASRSession::OutMessage::Final) {
+      if (msg.type == ASRSessionMessage::Final) {
         got_final = true;
       }
     }
@@ -131,10 +131,10 @@ TEST(Integration, StreamingSimulation) {
   // Finalize
   auto final_msgs = session.on_recognize();
   for (const auto& msg : final_msgs) {
-    if (msg.type == ASRSession::OutMessage::Final) {
+    if (msg.type == ASRSessionMessage::Final) {
       got_final = true;
     }
-    if (msg.type == ASRSession::OutMessage::Done) {
+    if (msg.type == ASRSessionMessage::Done) {
       // Should always get done
       SUCCEED();
     }
@@ -142,7 +142,7 @@ TEST(Integration, StreamingSimulation) {
 
   // We should have gotten at least the done message and a final result
   ASSERT_FALSE(final_msgs.empty());
-  EXPECT_EQ(final_msgs.back().type, ASRSession::OutMessage::Done);
+  EXPECT_EQ(final_msgs.back().type, ASRSessionMessage::Done);
   EXPECT_TRUE(got_final);
 }
 
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "asr/config.h"
+#include "asr/load_monitor.h"
+
+namespace asr {
+namespace {
+
+using namespace std::chrono_literals;
+
+LoadSnapshot idle_snapshot() {
+  LoadSnapshot s;
+  s.queue_capacity = 100;
+  s.slots_total    = 4;
+  return s;
+}
+
+TEST(LoadMonitor, IdleNodeIsOk) {
+  LoadStateTracker tracker{LoadThresholds{}};
+  EXPECT_EQ(tracker.update(idle_snapshot()), LoadState::Ok);
+  EXPECT_STREQ(load_state_name(tracker.state()), "ok");
+}
+
+TEST(LoadMonitor, QueueDepthRaisesStateImmediately) {
+  LoadStateTracker tracker{LoadThresholds{}};
+  auto             s = idle_snapshot();
+
+  s.queued = 60;
+  EXPECT_EQ(tracker.update(s), LoadState::Degraded);
+
+  s.queued = 95;
+  EXPECT_EQ(tracker.update(s), LoadState::NotReady);
+  EXPECT_STREQ(load_state_name(tracker.state()), "not_ready");
+}
+
+TEST(LoadMonitor, HysteresisHoldsStateInsideRecoveryBand) {
+  LoadStateTracker tracker{LoadThresholds{}};
+  auto             s = idle_snapshot();
+
+  s.queued = 95;
+  ASSERT_EQ(tracker.update(s), LoadState::NotReady);
+
+  // Below the 0.9 entry threshold but above 0.9 * 0.8 = 0.72: stays not_ready.
+  s.queued = 80;
+  EXPECT_EQ(tracker.update(s), LoadState::NotReady);
+
+  // Clear of the not_ready band, still inside degraded entry threshold.
+  s.queued = 60;
+  EXPECT_EQ(tracker.update(s), LoadState::Degraded);
+
+  // Below 0.5 but above 0.5 * 0.8 = 0.4: stays degraded.
+  s.queued = 45;
+  EXPECT_EQ(tracker.update(s), LoadState::Degraded);
+
+  s.queued = 10;
+  EXPECT_EQ(tracker.update(s), LoadState::Ok);
+}
+
+TEST(LoadMonitor, WaitP95AndSlotsContribute) {
+  LoadStateTracker tracker{LoadThresholds{}};
+  auto             s = idle_snapshot();
+
+  s.slots_busy = 4;
+  EXPECT_EQ(tracker.update(s), LoadState::Degraded);
+
+  s.wait_p95_sec = 6.0;
+  EXPECT_EQ(tracker.update(s), LoadState::NotReady);
+}
+
+TEST(LoadMonitor, MemoryBudgetIgnoredWhenUnset) {
+  LoadStateTracker tracker{LoadThresholds{}};
+  auto             s = idle_snapshot();
+
+  s.rss_bytes = static_cast<size_t>(8) * 1024 * 1024 * 1024;
+  EXPECT_EQ(tracker.update(s), LoadState::Ok);
+
+  s.memory_budget_bytes = s.rss_bytes;
+  EXPECT_EQ(tracker.update(s), LoadState::NotReady);
+  EXPECT_DOUBLE_EQ(s.memory_utilization(), 1.0);
+}
+
+TEST(LoadMonitor, ZeroThresholdDisablesSignal) {
+  LoadThresholds thresholds;
+  thresholds.queue_degraded  = 0.0;
+  thresholds.queue_not_ready = 0.0;
+  LoadStateTracker tracker{thresholds};
+
+  auto s   = idle_snapshot();
+  s.queued = s.queue_capacity;
+  EXPECT_EQ(tracker.update(s), LoadState::Ok);
+}
+
+TEST(LoadMonitor, ThresholdsFromConfig) {
+  Config cfg;
+  cfg.ready_wait_p95_degraded_ms  = 250;
+  cfg.ready_wait_p95_not_ready_ms = 2000;
+  cfg.ready_recover_ratio         = 0.5f;
+
+  const auto t = LoadThresholds::from_config(cfg);
+  EXPECT_DOUBLE_EQ(t.wait_p95_degraded, 0.25);
+  EXPECT_DOUBLE_EQ(t.wait_p95_not_ready, 2.0);
+  EXPECT_FLOAT_EQ(static_cast<float>(t.recover_ratio), 0.5f);
+}
+
+TEST(LoadMonitor, LatencyWindowPercentile) {
+  RecentLatencyWindow window(100, 30s);
+  const auto          now = RecentLatencyWindow::Clock::now();
+  for (int i = 1; i <= 100; ++i) {
+    window.record(static_cast<double>(i) / 1000.0, now);
+  }
+  EXPECT_DOUBLE_EQ(window.percentile(0.95, now), 0.095);
+  EXPECT_DOUBLE_EQ(window.percentile(1.0, now), 0.1);
+}
+
+TEST(LoadMonitor, LatencyWindowOverwritesOldestAndExpires) {
+  RecentLatencyWindow window(4, 10s);
+  const auto          now = RecentLatencyWindow::Clock::now();
+  for (int i = 0; i < 8; ++i) {
+    window.record(i < 4 ? 10.0 : 0.001, now);
+  }
+  EXPECT_DOUBLE_EQ(window.percentile(0.95, now), 0.001);
+
+  EXPECT_DOUBLE_EQ(window.percentile(0.95, now + 11s), 0.0);
+}
+
+TEST(LoadMonitor, CurrentRssIsReported) {
+#if defined(__linux__) || defined(__APPLE__)
+  EXPECT_GT(current_rss_bytes(), static_cast<size_t>(0));
+#else
+  GTEST_SKIP() << "RSS not available on this platform";
+#endif
+}
+
+}  // namespace
+}  // namespace asr
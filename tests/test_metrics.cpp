@@ -7,6 +7,7 @@
 #include <string_view>
 
 #include "asr/metrics.h"
+#include "asr/recognizer.h"
 
 namespace asr {
 namespace {
@@ -76,8 +77,8 @@ TEST_F(MetricsTest, ObserveRequest) {
 }
 
 TEST_F(MetricsTest, ObserveRecognizerWait) {
-  EXPECT_NO_THROW(ASRMetrics::instance().observe_recognizer_wait(0.012, false));
-  EXPECT_NO_THROW(ASRMetrics::instance().observe_recognizer_wait(0.250, true));
+  EXPECT_NO_THROW(ASRMetrics::instance().observe_recognizer_wait(0.012, false, SlotClass::Shared));
+  EXPECT_NO_THROW(ASRMetrics::instance().observe_recognizer_wait(0.250, true, SlotClass::Realtime));
 }
 
 TEST_F(MetricsTest, PrometheusSerialize) {
@@ -109,7 +110,7 @@ TEST_F(MetricsTest, AllPipelineMetricsRegistered) {
   ASRMetrics::instance().observe_request(1.0, 2.0, 0.5, 10, 16000, 0.01, 0.0, "realtime_websocket",
                                          "success");
   ASRMetrics::instance().observe_request(1.0, 2.0, 0.5, 10, 16000, 0.01, 0.0, "whisper_api", "failed");
-  ASRMetrics::instance().observe_recognizer_wait(0.05, true);
+  ASRMetrics::instance().observe_recognizer_wait(0.05, true, SlotClass::Realtime);
   ASRMetrics::instance().observe_error("test");
 
   auto text = serialize_metrics();
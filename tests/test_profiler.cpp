@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asr/profiler.h"
+
+namespace asr {
+namespace {
+
+void burn_cpu(double cpu_sec) {
+  const std::clock_t until = std::clock() + static_cast<std::clock_t>(cpu_sec * CLOCKS_PER_SEC);
+  volatile double    sink  = 0.0;
+  while (std::clock() < until) {
+    for (int i = 0; i < 10000; ++i) {
+      sink = sink + static_cast<double>(i) * 0.5;
+    }
+  }
+}
+
+TEST(Profiler, SamplesTheBusyThread) {
+  auto& profiler = SamplingProfiler::instance();
+  if (!profiler.start(500)) {
+    GTEST_SKIP() << "SIGPROF timer unavailable";
+  }
+  EXPECT_TRUE(profiler.running());
+  EXPECT_FALSE(profiler.start(100));
+
+  burn_cpu(0.3);
+  const auto profile = profiler.stop();
+  EXPECT_FALSE(profiler.running());
+  EXPECT_EQ(profile.frequency_hz, 500);
+  EXPECT_GT(profile.samples, 10U);
+  ASSERT_FALSE(profile.stacks.empty());
+
+  uint64_t total = 0;
+  for (size_t i = 0; i < profile.stacks.size(); ++i) {
+    total += profile.stacks[i].second;
+    if (i > 0) {
+      EXPECT_LE(profile.stacks[i].second, profile.stacks[i - 1].second);
+    }
+  }
+  EXPECT_LE(total, profile.samples);
+
+  std::istringstream folded(render_folded(profile));
+  std::string        line;
+  size_t             lines = 0;
+  while (std::getline(folded, line)) {
+    const auto space = line.rfind(' ');
+    ASSERT_NE(space, std::string::npos) << line;
+    EXPECT_GT(std::stoull(line.substr(space + 1)), 0U);
+    ++lines;
+  }
+  EXPECT_EQ(lines, profile.stacks.size());
+
+  EXPECT_TRUE(profiler.stop().stacks.empty());
+}
+
+TEST(Profiler, DropsSamplesPastTheBuffer) {
+  auto& profiler = SamplingProfiler::instance();
+  if (!profiler.start(1000, 2)) {
+    GTEST_SKIP() << "SIGPROF timer unavailable";
+  }
+  burn_cpu(0.1);
+  const auto profile = profiler.stop();
+  EXPECT_EQ(profile.samples, 2U);
+  EXPECT_GT(profile.dropped, 0U);
+}
+
+TEST(Profiler, HaltedRunAggregatesWhileTheNextOneSamples) {
+  auto& profiler = SamplingProfiler::instance();
+  if (!profiler.start(500)) {
+    GTEST_SKIP() << "SIGPROF timer unavailable";
+  }
+  burn_cpu(0.2);
+  auto halted = profiler.halt();
+  EXPECT_FALSE(profiler.running());
+  EXPECT_GT(halted.count, 0U);
+
+  ASSERT_TRUE(profiler.start(500));
+  burn_cpu(0.1);
+  const size_t count   = halted.count;
+  const auto   profile = SamplingProfiler::aggregate(std::move(halted));
+  EXPECT_EQ(profile.samples, count);
+  EXPECT_EQ(profile.frequency_hz, 500);
+  EXPECT_FALSE(profile.stacks.empty());
+
+  EXPECT_GT(profiler.stop().samples, 0U);
+  EXPECT_EQ(profiler.halt().count, 0U);
+}
+
+TEST(Profiler, ThreadCpuReportsRegisteredRole) {
+  set_current_thread_role(kThreadRoleExecutor);
+  const auto before = thread_cpu_times();
+  if (before.empty()) {
+    GTEST_SKIP() << "/proc/self/task unavailable";
+  }
+  burn_cpu(0.05);
+  const auto after = thread_cpu_times();
+
+  const auto report = thread_cpu_report(before, after, 0.05);
+  ASSERT_TRUE(report["roles"].contains("executor"));
+  EXPECT_GE(report["roles"]["executor"]["threads"].get<size_t>(), 1U);
+  EXPECT_TRUE(report["roles"]["executor"].contains("cores"));
+  EXPECT_EQ(report["threads"].size(), after.size());
+}
+
+TEST(Profiler, ThreadCpuReportTakesDeltas) {
+  const std::vector<ThreadCpuTime> before = {
+      {10, "DrogonIoLoop", "http_loop", 1.0, 0.5},
+      {11, "asr", "executor", 2.0, 0.0},
+  };
+  const std::vector<ThreadCpuTime> after = {
+      {10, "DrogonIoLoop", "http_loop", 1.5, 0.5},
+      {11, "asr", "executor", 4.0, 1.0},
+      {12, "asr", "executor", 0.5, 0.0},  // started during the window
+  };
+
+  const auto report = thread_cpu_report(before, after, 2.0);
+  EXPECT_DOUBLE_EQ(report["window_sec"].get<double>(), 2.0);
+  EXPECT_DOUBLE_EQ(report["roles"]["http_loop"]["cpu_sec"].get<double>(), 0.5);
+  EXPECT_EQ(report["roles"]["executor"]["threads"].get<size_t>(), 2U);
+  EXPECT_DOUBLE_EQ(report["roles"]["executor"]["cpu_sec"].get<double>(), 3.5);
+  EXPECT_DOUBLE_EQ(report["roles"]["executor"]["cores"].get<double>(), 1.75);
+  EXPECT_EQ(report["threads"][0]["tid"].get<int>(), 11);
+
+  const auto cumulative = thread_cpu_report({}, after, 2.0);
+  EXPECT_TRUE(cumulative["window_sec"].is_null());
+  EXPECT_DOUBLE_EQ(cumulative["roles"]["executor"]["cpu_sec"].get<double>(), 5.5);
+  EXPECT_FALSE(cumulative["roles"]["executor"].contains("cores"));
+}
+
+}  // namespace
+}  // namespace asr
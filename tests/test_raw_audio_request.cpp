@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_map>
+
+#include "asr/raw_audio_request.h"
+
+namespace asr {
+namespace {
+
+using Params = std::unordered_map<std::string, std::string>;
+
+TEST(RawAudioRequest, OctetStreamDefaultsToPcm16At16k) {
+  RawAudioRequest req;
+  ASSERT_FALSE(parse_raw_audio_request("application/octet-stream", {}, &req).has_value());
+  EXPECT_EQ(req.encoding, RawAudioEncoding::Pcm16);
+  EXPECT_EQ(req.pcm.sample_rate, 16000);
+  EXPECT_EQ(req.pcm.channels, 1);
+  EXPECT_FALSE(req.pcm.big_endian);
+
+  ASSERT_FALSE(parse_raw_audio_request("", {}, &req).has_value());
+  EXPECT_EQ(req.encoding, RawAudioEncoding::Pcm16);
+}
+
+TEST(RawAudioRequest, OctetStreamReadsParams) {
+  RawAudioRequest req;
+  const Params    params{{"encoding", "pcm16be"}, {"sample_rate", " 8000 "}, {"channels", "2"}};
+  ASSERT_FALSE(parse_raw_audio_request("application/octet-stream", params, &req).has_value());
+  EXPECT_EQ(req.encoding, RawAudioEncoding::Pcm16);
+  EXPECT_TRUE(req.pcm.big_endian);
+  EXPECT_EQ(req.pcm.sample_rate, 8000);
+  EXPECT_EQ(req.pcm.channels, 2);
+
+  ASSERT_FALSE(parse_raw_audio_request("application/octet-stream", {{"encoding", "WAV"}}, &req).has_value());
+  EXPECT_EQ(req.encoding, RawAudioEncoding::Wav);
+  EXPECT_EQ(raw_audio_file_name(req.encoding), "body.wav");
+}
+
+TEST(RawAudioRequest, L16UsesMediaTypeParameters) {
+  RawAudioRequest req;
+  ASSERT_FALSE(parse_raw_audio_request("audio/L16; rate=8000; channels=2", {}, &req).has_value());
+  EXPECT_EQ(req.encoding, RawAudioEncoding::Pcm16);
+  EXPECT_TRUE(req.pcm.big_endian);
+  EXPECT_EQ(req.pcm.sample_rate, 8000);
+  EXPECT_EQ(req.pcm.channels, 2);
+}
+
+TEST(RawAudioRequest, ContainerMediaTypes) {
+  RawAudioRequest req;
+  ASSERT_FALSE(parse_raw_audio_request("audio/x-wav", {}, &req).has_value());
+  EXPECT_EQ(req.encoding, RawAudioEncoding::Wav);
+  ASSERT_FALSE(parse_raw_audio_request("audio/ogg; codecs=opus", {}, &req).has_value());
+  EXPECT_EQ(req.encoding, RawAudioEncoding::Opus);
+  EXPECT_EQ(raw_audio_file_name(req.encoding), "body.opus");
+}
+
+TEST(RawAudioRequest, RejectsInvalidInput) {
+  RawAudioRequest req;
+
+  auto error = parse_raw_audio_request("multipart/form-data; boundary=x", {}, &req);
+  ASSERT_TRUE(error.has_value());
+  EXPECT_TRUE(error->unsupported_media_type);
+
+  error = parse_raw_audio_request("application/octet-stream", {{"encoding", "mp3"}}, &req);
+  ASSERT_TRUE(error.has_value());
+  EXPECT_EQ(error->param, "encoding");
+  EXPECT_FALSE(error->unsupported_media_type);
+
+  error = parse_raw_audio_request("application/octet-stream", {{"sample_rate", "16k"}}, &req);
+  ASSERT_TRUE(error.has_value());
+  EXPECT_EQ(error->param, "sample_rate");
+
+  error = parse_raw_audio_request("audio/L16;rate=96000", {}, &req);
+  ASSERT_TRUE(error.has_value());
+  EXPECT_EQ(error->param, "rate");
+
+  error = parse_raw_audio_request("application/octet-stream", {{"channels", "0"}}, &req);
+  ASSERT_TRUE(error.has_value());
+  EXPECT_EQ(error->param, "channels");
+}
+
+}  // namespace
+}  // namespace asr
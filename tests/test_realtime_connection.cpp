@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+#include "asr/config.h"
+#include "asr/realtime_connection.h"
+#include "asr/synthetic_recognizer.h"
+
+namespace asr {
+namespace {
+
+constexpr const char* kVadModel = "models/silero_vad.onnx";
+
+class CapturingSink : public RealtimeEventSink {
+ public:
+  void send_text(std::string_view payload) override {
+    events.push_back(nlohmann::json::parse(payload));
+  }
+
+  std::vector<nlohmann::json> events;
+};
+
+TEST(RealtimeConnection, FlatAppendIsScannedInPlace) {
+  RealtimeInboundEvent event;
+  const auto status = parse_realtime_client_event(
+      R"({"type":"input_audio_buffer.append","event_id":"evt_1","audio":"AAD/fw=="})", event);
+
+  ASSERT_EQ(status, RealtimeParseStatus::Ok);
+  EXPECT_EQ(event.type, RealtimeClientEventType::AudioAppend);
+  EXPECT_EQ(event.event_type, "input_audio_buffer.append");
+  EXPECT_EQ(event.client_event_id, "evt_1");
+  EXPECT_TRUE(event.json.is_null());
+  ASSERT_TRUE(event.has_audio);
+  EXPECT_EQ(event.audio, "AAD/fw==");
+  EXPECT_GE(event.audio.data(), event.payload.data());
+  EXPECT_LE(event.audio.data() + event.audio.size(), event.payload.data() + event.payload.size());
+}
+
+TEST(RealtimeConnection, EscapedOrNestedEventsUseFullParser) {
+  RealtimeInboundEvent event;
+  const std::string escaped =
+      R"({ "type" : "input_audio_buffer.append", "event_id": "a\"b", "audio": "AAD/fw==" })";
+  ASSERT_EQ(parse_realtime_client_event(std::string(escaped), event), RealtimeParseStatus::Ok);
+  EXPECT_EQ(event.type, RealtimeClientEventType::AudioAppend);
+  EXPECT_EQ(event.client_event_id, "a\"b");
+  EXPECT_FALSE(event.json.is_null());
+  EXPECT_EQ(event.audio, "AAD/fw==");
+
+  ASSERT_EQ(parse_realtime_client_event(
+                R"({"type":"session.update","session":{"input_audio_format":"pcm16"}})", event),
+            RealtimeParseStatus::Ok);
+  EXPECT_EQ(event.type, RealtimeClientEventType::SessionUpdate);
+  EXPECT_FALSE(event.has_audio);
+  ASSERT_TRUE(event.json.contains("session"));
+}
+
+TEST(RealtimeConnection, ReportsParseFailures) {
+  RealtimeInboundEvent event;
+  EXPECT_EQ(parse_realtime_client_event(R"({"type":"ping"})", event), RealtimeParseStatus::Ping);
+  EXPECT_EQ(parse_realtime_client_event(R"({"type":"noop","n":1})", event), RealtimeParseStatus::Ping);
+  EXPECT_EQ(parse_realtime_client_event(R"({"type":"input_audio_buffer.commit")", event),
+            RealtimeParseStatus::InvalidJson);
+  EXPECT_EQ(parse_realtime_client_event("[1,2]", event), RealtimeParseStatus::NotObject);
+  EXPECT_EQ(parse_realtime_client_event(R"({"event_id":"evt_9"})", event), RealtimeParseStatus::MissingType);
+  EXPECT_EQ(event.client_event_id, "evt_9");
+  EXPECT_EQ(parse_realtime_client_event("{}", event), RealtimeParseStatus::MissingType);
+
+  ASSERT_EQ(parse_realtime_client_event(R"({"type":"response.create"})", event), RealtimeParseStatus::Ok);
+  EXPECT_EQ(event.type, RealtimeClientEventType::Unknown);
+  EXPECT_TRUE(event.client_event_id.empty());
+}
+
+TEST(RealtimeConnection, InboxWrapsAndReportsFull) {
+  RealtimeInbox inbox(2);
+  for (int round = 0; round < 3; ++round) {
+    auto* first = inbox.back_slot();
+    ASSERT_NE(first, nullptr);
+    set_realtime_binary_event(std::string(4, static_cast<char>('a' + round)), *first);
+    EXPECT_TRUE(inbox.push());  // starts the drain
+    auto* second = inbox.back_slot();
+    ASSERT_NE(second, nullptr);
+    ASSERT_EQ(parse_realtime_client_event(R"({"type":"input_audio_buffer.clear"})", *second),
+              RealtimeParseStatus::Ok);
+    EXPECT_FALSE(inbox.push());
+    EXPECT_EQ(inbox.back_slot(), nullptr);
+    EXPECT_EQ(inbox.size(), 2U);
+
+    EXPECT_EQ(inbox.front().type, RealtimeClientEventType::BinaryAudio);
+    EXPECT_EQ(inbox.front().payload, std::string(4, static_cast<char>('a' + round)));
+    EXPECT_TRUE(inbox.pop());
+    EXPECT_EQ(inbox.front().type, RealtimeClientEventType::AudioClear);
+    EXPECT_FALSE(inbox.pop());
+    EXPECT_EQ(inbox.size(), 0U);
+  }
+}
+
+TEST(RealtimeConnection, RunsEventsAgainstThePipeline) {
+  if (!std::ifstream(kVadModel).good()) {
+    GTEST_SKIP() << "VAD model not found";
+  }
+  Config cfg;
+  cfg.vad_model   = kVadModel;
+  cfg.sample_rate = 16000;
+  SyntheticRecognizer       recognizer(1, SyntheticCostModel{0.0, 0.0, 0.0, false});
+  RealtimeConnectionContext ctx(recognizer, cfg, 7, kDefaultTenant, nullptr, 4);
+  CapturingSink             sink;
+  RealtimeInboundEvent      event;
+
+  // 20 ms of pcm16 silence per append.
+  set_realtime_binary_event(std::string(640, '\0'), event);
+  for (int i = 0; i < 10; ++i) {
+    run_realtime_event(ctx, sink, event);
+  }
+  EXPECT_EQ(ctx.append_events, 10U);
+  EXPECT_EQ(ctx.input_samples, 3200U);
+  EXPECT_TRUE(sink.events.empty());
+
+  ASSERT_EQ(parse_realtime_client_event(R"({"type":"input_audio_buffer.append","audio":"@@"})", event),
+            RealtimeParseStatus::Ok);
+  run_realtime_event(ctx, sink, event);
+  ASSERT_EQ(sink.events.size(), 1U);
+  EXPECT_EQ(sink.events.back().at("type"), "error");
+  EXPECT_EQ(ctx.decode_errors, 1U);
+
+  ASSERT_EQ(parse_realtime_client_event(R"({"type":"input_audio_buffer.commit"})", event),
+            RealtimeParseStatus::Ok);
+  run_realtime_event(ctx, sink, event);
+  ASSERT_EQ(sink.events.size(), 2U);
+  EXPECT_EQ(sink.events.back().at("type"), "input_audio_buffer.committed");
+  EXPECT_EQ(ctx.committed_events, 1U);
+
+  ASSERT_EQ(parse_realtime_client_event(R"({"type":"response.create","event_id":"evt_x"})", event),
+            RealtimeParseStatus::Ok);
+  run_realtime_event(ctx, sink, event);
+  ASSERT_EQ(sink.events.size(), 3U);
+  EXPECT_EQ(sink.events.back().at("error").at("code"), "unknown_event_type");
+  EXPECT_EQ(sink.events.back().at("error").at("event_id"), "evt_x");
+  EXPECT_EQ(ctx.invalid_events, 1U);
+
+  // Frames the transport rejected are reported by the actor.
+  ASSERT_EQ(parse_realtime_client_event(R"({"event_id":"evt_y"})", event), RealtimeParseStatus::MissingType);
+  event.type         = RealtimeClientEventType::Invalid;
+  event.parse_status = RealtimeParseStatus::MissingType;
+  run_realtime_event(ctx, sink, event);
+  ASSERT_EQ(sink.events.size(), 4U);
+  EXPECT_EQ(sink.events.back().at("error").at("code"), "invalid_event_type");
+  EXPECT_EQ(sink.events.back().at("error").at("event_id"), "evt_y");
+  EXPECT_EQ(ctx.invalid_events, 2U);
+  EXPECT_EQ(ctx.last_error, "invalid_event_type:Event 'type' must be a string");
+}
+
+}  // namespace
+}  // namespace asr
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "asr/realtime_lag.h"
+
+namespace asr {
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = RealtimeLagTracker::Clock;
+
+constexpr int64_t kRate  = 16000;
+constexpr int64_t kChunk = kRate / 50;  // 20 ms
+
+TEST(RealtimeLag, RealTimeClientProcessedPromptlyHasNoLag) {
+  RealtimeLagTracker lag(16000);
+  const auto         t0 = Clock::now();
+  for (int64_t i = 0; i < 100; ++i) {
+    const auto arrived = t0 + i * 20ms;
+    lag.on_received(i * kChunk, arrived);
+    EXPECT_DOUBLE_EQ(lag.on_processed((i + 1) * kChunk, arrived + 2ms), 0.0);
+  }
+  EXPECT_DOUBLE_EQ(lag.max_lag_sec(), 0.0);
+}
+
+TEST(RealtimeLag, QueuedChunksReportHowFarTheyTrail) {
+  RealtimeLagTracker lag(16000);
+  const auto         t0 = Clock::now();
+  lag.on_received(0, t0);
+  (void)lag.on_processed(kChunk, t0 + 1ms);
+
+  // One second of audio arrived in real time, but was processed only after a
+  // 1.5 s stall that started with the second chunk.
+  const auto stall_end = t0 + 1520ms;
+  for (int64_t i = 1; i < 50; ++i) {
+    lag.on_received(i * kChunk, t0 + i * 20ms);
+    (void)lag.on_processed((i + 1) * kChunk, stall_end);
+  }
+  EXPECT_NEAR(lag.lag_sec(), 0.52, 1e-3);
+  EXPECT_NEAR(lag.max_lag_sec(), 1.48, 1e-3);
+}
+
+TEST(RealtimeLag, ClientPausesAndBurstsAreNotServerLag) {
+  RealtimeLagTracker lag(16000);
+  const auto         t0 = Clock::now();
+  lag.on_received(0, t0);
+  (void)lag.on_processed(kChunk, t0);
+
+  // The client goes quiet for 5 s, then resumes: the clock re-anchors.
+  lag.on_received(kChunk, t0 + 5s);
+  EXPECT_DOUBLE_EQ(lag.on_processed(2 * kChunk, t0 + 5s + 5ms), 0.0);
+
+  // A burst of 10 s of audio in 100 ms runs ahead of the clock.
+  lag.on_received(2 * kChunk, t0 + 5s + 10ms);
+  EXPECT_DOUBLE_EQ(lag.on_processed(2 * kChunk + 10 * kRate, t0 + 5s + 110ms), 0.0);
+}
+
+TEST(RealtimeLag, FinalLatencyIsMeasuredFromSpeechEnd) {
+  RealtimeLagTracker lag(16000);
+  const auto         t0 = Clock::now();
+  lag.on_received(0, t0);
+
+  // Segment origin at 2 s of stream; speech ends 1 s into the segment.
+  lag.set_segment_origin(2 * kRate);
+  lag.on_speech_end(kRate);
+  EXPECT_NEAR(lag.on_final(4 * kRate, t0 + 3800ms), 0.8, 1e-3);
+
+  // Without a speech end (commit), latency runs from the processed end.
+  EXPECT_NEAR(lag.on_final(4 * kRate, t0 + 4100ms), 0.1, 1e-3);
+
+  // A reset drops a speech end that never produced a final.
+  lag.on_speech_end(kRate / 2);
+  lag.set_segment_origin(4 * kRate);
+  EXPECT_DOUBLE_EQ(lag.on_final(4 * kRate, t0 + 4s), 0.0);
+}
+
+TEST(RealtimeLag, AlertsAreEdgeTriggeredWithHysteresis) {
+  RealtimeLagTracker lag(16000);
+  const auto         t0 = Clock::now();
+  lag.on_received(0, t0);
+
+  const auto at_lag = [&lag, t0](double sec) {
+    (void)lag.on_processed(kRate, t0 + 1s + std::chrono::duration_cast<Clock::duration>(
+                                                 std::chrono::duration<double>(sec)));
+  };
+  at_lag(0.5);
+  EXPECT_EQ(lag.check_alert(0.0), LagAlert::None);
+  EXPECT_EQ(lag.check_alert(1.0), LagAlert::None);
+  at_lag(1.2);
+  EXPECT_EQ(lag.check_alert(1.0), LagAlert::Lagging);
+  EXPECT_TRUE(lag.lagging());
+  at_lag(1.5);
+  EXPECT_EQ(lag.check_alert(1.0), LagAlert::None);
+  at_lag(0.7);
+  EXPECT_EQ(lag.check_alert(1.0), LagAlert::None);
+  at_lag(0.4);
+  EXPECT_EQ(lag.check_alert(1.0), LagAlert::Recovered);
+  EXPECT_FALSE(lag.lagging());
+}
+
+TEST(RealtimeLag, BoardReportsWorstOpenConnections) {
+  auto&        board = RealtimeLagBoard::instance();
+  const size_t a     = board.acquire();
+  const size_t b     = board.acquire();
+  const size_t c     = board.acquire();
+  board.publish(a, 0.5);
+  board.publish(b, 3.0);
+  board.publish(c, 1.5);
+
+  EXPECT_EQ(board.worst(2), (std::vector<double>{3.0, 1.5}));
+  board.release(b);
+  EXPECT_EQ(board.worst(5), (std::vector<double>{1.5, 0.5}));
+
+  const size_t reused = board.acquire();
+  EXPECT_EQ(reused, b);
+  EXPECT_EQ(board.worst(5), (std::vector<double>{1.5, 0.5, 0.0}));
+  board.release(a);
+  board.release(c);
+  board.release(reused);
+  EXPECT_TRUE(board.worst(5).empty());
+}
+
+TEST(RealtimeLag, BoardPublishesWhileSlotsGrowAcrossChunks) {
+  auto&             board = RealtimeLagBoard::instance();
+  const size_t      first = board.acquire();
+  std::atomic<bool> stop{false};
+  std::thread       publisher([&] {
+    for (double lag = 0.0; !stop.load(); lag += 1.0) {
+      board.publish(first, lag);
+    }
+  });
+  std::vector<size_t> slots;
+  for (size_t i = 0; i < 3 * RealtimeLagBoard::kChunkSlots; ++i) {
+    slots.push_back(board.acquire());
+    board.publish(slots.back(), -1.0);
+  }
+  stop = true;
+  publisher.join();
+
+  board.publish(first, 1000.0);
+  const auto worst = board.worst(slots.size() + 1);
+  ASSERT_EQ(worst.size(), slots.size() + 1);
+  EXPECT_EQ(worst.front(), 1000.0);
+  EXPECT_EQ(worst.back(), -1.0);
+  for (const size_t slot : slots) {
+    board.release(slot);
+  }
+  board.release(first);
+  EXPECT_TRUE(board.worst(5).empty());
+}
+
+}  // namespace
+}  // namespace asr
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "asr/config.h"
+#include "asr/realtime_recording.h"
+#include "asr/synthetic_recognizer.h"
+
+namespace asr {
+namespace {
+
+constexpr const char* kVadModel = "models/silero_vad.onnx";
+
+class RecordingDir : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() /
+           ("asr_recording_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+  }
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::vector<RecordedRealtimeEvent> read_all(const std::string& path) {
+    RealtimeRecordingReader            reader(path);
+    std::vector<RecordedRealtimeEvent> events;
+    RecordedRealtimeEvent              event;
+    while (reader.next(event)) {
+      events.push_back(event);
+    }
+    return events;
+  }
+
+  std::filesystem::path dir_;
+};
+
+TEST_F(RecordingDir, RoundTripsEventsInOrder) {
+  const auto  connected_at = std::chrono::steady_clock::now();
+  const std::string binary("\x01\x00\xff\x7f", 4);
+  std::string path;
+  {
+    auto recorder = RealtimeRecorder::open(dir_.string(), 42, connected_at, 1024);
+    ASSERT_NE(recorder, nullptr);
+    path = recorder->path();
+    recorder->record(RealtimeRecordKind::Text, connected_at + std::chrono::milliseconds(5),
+                     R"({"type":"session.update"})");
+    recorder->record(RealtimeRecordKind::Binary, connected_at + std::chrono::milliseconds(25), binary);
+  }
+
+  EXPECT_EQ(RealtimeRecordingReader(path).connection_id(), 42U);
+  const auto events = read_all(path);
+  ASSERT_EQ(events.size(), 3U);
+  EXPECT_EQ(events[0].kind, RealtimeRecordKind::Text);
+  EXPECT_EQ(events[0].offset, std::chrono::milliseconds(5));
+  EXPECT_EQ(events[0].payload, R"({"type":"session.update"})");
+  EXPECT_EQ(events[1].kind, RealtimeRecordKind::Binary);
+  EXPECT_EQ(events[1].offset, std::chrono::milliseconds(25));
+  EXPECT_EQ(events[1].payload, binary);
+  EXPECT_EQ(events[2].kind, RealtimeRecordKind::Close);
+  EXPECT_TRUE(events[2].payload.empty());
+}
+
+TEST_F(RecordingDir, SizeCapEndsTheRecording) {
+  const auto  connected_at = std::chrono::steady_clock::now();
+  std::string path;
+  {
+    auto recorder = RealtimeRecorder::open(dir_.string(), 1, connected_at, 100);
+    ASSERT_NE(recorder, nullptr);
+    path = recorder->path();
+    recorder->record(RealtimeRecordKind::Binary, connected_at, std::string(40, 'a'));
+    recorder->record(RealtimeRecordKind::Binary, connected_at, std::string(40, 'b'));  // over the cap
+    recorder->record(RealtimeRecordKind::Binary, connected_at, "c");
+    EXPECT_LE(recorder->bytes_written(), 100U);
+  }
+
+  const auto events = read_all(path);
+  ASSERT_EQ(events.size(), 1U);  // no Close record after the cap
+  EXPECT_EQ(events[0].payload, std::string(40, 'a'));
+}
+
+TEST_F(RecordingDir, RejectsForeignFiles) {
+  EXPECT_THROW(RealtimeRecordingReader((dir_ / "missing.asrrec").string()), RecordingError);
+
+  std::filesystem::create_directories(dir_);
+  const auto path = (dir_ / "junk.asrrec").string();
+  std::ofstream(path) << "definitely not a recording";
+  EXPECT_THROW(RealtimeRecordingReader{path}, RecordingError);
+}
+
+TEST_F(RecordingDir, ReplaysThroughThePipeline) {
+  if (!std::ifstream(kVadModel).good()) {
+    GTEST_SKIP() << "VAD model not found";
+  }
+  const auto  connected_at = std::chrono::steady_clock::now();
+  std::string path;
+  {
+    auto recorder = RealtimeRecorder::open(dir_.string(), 3, connected_at, 1 << 20);
+    ASSERT_NE(recorder, nullptr);
+    path = recorder->path();
+    for (int i = 0; i < 10; ++i) {  // 20 ms of pcm16 silence each
+      recorder->record(RealtimeRecordKind::Binary, connected_at + std::chrono::milliseconds(20 * i),
+                       std::string(640, '\0'));
+    }
+    recorder->record(RealtimeRecordKind::Text, connected_at, R"({"type":"ping"})");
+    recorder->record(RealtimeRecordKind::Text, connected_at, R"({"type":"input_audio_buffer.commit"})");
+  }
+
+  Config cfg;
+  cfg.vad_model   = kVadModel;
+  cfg.sample_rate = 16000;
+  SyntheticRecognizer recognizer(1, SyntheticCostModel{0.0, 0.0, 0.0, false});
+
+  const auto report = replay_realtime_recording(recognizer, cfg, path, 0.0);
+  EXPECT_EQ(report.events, 11U);
+  EXPECT_EQ(report.skipped, 1U);
+  EXPECT_EQ(report.errors, 0U);
+  EXPECT_NEAR(report.audio_sec, 0.2, 1e-6);
+  EXPECT_EQ(report.event_ms.size(), 11U);
+
+  const auto json = realtime_replay_report_json(report);
+  EXPECT_EQ(json["event_ms"]["count"].get<size_t>(), 11U);
+  EXPECT_TRUE(json["event_ms"].contains("p95"));
+  EXPECT_EQ(json["final_ms"]["count"].get<size_t>(), 0U);
+}
+
+}  // namespace
+}  // namespace asr
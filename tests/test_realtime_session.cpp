@@ -247,6 +247,24 @@ TEST(RealtimeSession, ErrorEventIncludesClientEventId) {
   EXPECT_EQ(err.at("event_id"), "evt_client_123");
 }
 
+TEST(RealtimeSession, SessionLagEventReusesBuffer) {
+  RealtimeSession session(4);
+  std::string     buffer;
+
+  session.event_session_lag(true, 1250, buffer);
+  const auto lagging = parse_event_json(buffer);
+  EXPECT_EQ(lagging.at("type"), "session.lag");
+  EXPECT_EQ(lagging.at("event_id"), "evt_1");
+  EXPECT_EQ(lagging.at("state"), "lagging");
+  EXPECT_EQ(lagging.at("lag_ms"), 1250);
+
+  session.event_session_lag(false, 300, buffer);
+  const auto recovered = parse_event_json(buffer);
+  EXPECT_EQ(recovered.at("event_id"), "evt_2");
+  EXPECT_EQ(recovered.at("state"), "recovered");
+  EXPECT_EQ(recovered.at("lag_ms"), 300);
+}
+
 TEST(RealtimeSessionAudio, DecodeRealtimeAudioPcm16) {
   // Bytes: 0x00 0x00 (0), 0xFF 0x7F (32767) -> base64 AAD/fw==
   const auto samples = decode_realtime_audio("AAD/fw==", "pcm16");
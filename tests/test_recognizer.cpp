@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <fstream>
 #include <string>
 #include <thread>
@@ -99,5 +100,50 @@ TEST(Recognizer, ThreadSafety) {
   }
 }
 
+TEST(Recognizer, ElasticThreadsServeIdleAndBusyPool) {
+  if (!model_exists())
+    GTEST_SKIP() << "Model not found";
+  auto cfg                       = make_test_config();
+  cfg.recognizer_elastic_threads = true;
+  Recognizer rec(cfg);
+
+  std::vector<float> audio(16000, 0.0f);
+  EXPECT_LE(rec.recognize(audio, 16000).size(), 5u);
+  EXPECT_EQ(rec.wide_decodes(), 1u);  // alone: the all-core handle
+  EXPECT_EQ(rec.wide_peak(), 1u);
+
+  // Queued work outside the pool keeps a lone decode on its slot.
+  size_t pressure = 1;
+  rec.set_pressure_source([&pressure]() { return pressure; });
+  EXPECT_LE(rec.recognize(audio, 16000).size(), 5u);
+  EXPECT_EQ(rec.wide_decodes(), 1u);
+  pressure = 0;
+
+  // Concurrent decodes fall back to their slots; the wide handle is lent
+  // once at a time, so at most one of them runs on it at any moment.
+  std::vector<float>       long_audio(16000 * 8, 0.0f);
+  std::atomic<size_t>      started{0};
+  std::vector<std::thread> threads;
+  std::vector<std::string> results(3);
+  threads.reserve(results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&rec, &long_audio, &results, &started, i]() {
+      started.fetch_add(1);
+      while (started.load() < results.size()) {
+        std::this_thread::yield();
+      }
+      results[i] = rec.recognize(long_audio, 16000);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (const auto& r : results) {
+    EXPECT_LE(r.size(), 5u);
+  }
+  EXPECT_EQ(rec.wide_peak(), 1u);
+  EXPECT_LE(rec.wide_decodes(), 1u + results.size());
+}
+
 }  // namespace
 }  // namespace asr
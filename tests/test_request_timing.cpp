@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asr/request_timing.h"
+#include "asr/span.h"
+#include "asr/synthetic_recognizer.h"
+
+namespace asr {
+namespace {
+
+TEST(RequestTiming, FormatsServerTimingInMilliseconds) {
+  RequestTiming timing;
+  timing.queue_sec           = 0.0012;
+  timing.recognizer_wait_sec = 0.25;
+  timing.container_sec       = 0.003;
+  timing.resample_sec        = 0.0004;
+  timing.asr_sec             = 0.5;
+  timing.serialize_sec       = 0.00005;
+  timing.total_sec           = 0.76;
+
+  EXPECT_EQ(format_server_timing(timing),
+            "queue;dur=1.2, recognizer_wait;dur=250.0, container;dur=3.0, resample;dur=0.4, vad;dur=0.0, "
+            "asr;dur=500.0, serialize;dur=0.1, total;dur=760.0");
+}
+
+TEST(RequestTiming, JsonLeavesOutSerialization) {
+  RequestTiming timing;
+  timing.queue_sec     = 0.002;
+  timing.serialize_sec = 0.5;
+  timing.total_sec     = 1.0;
+
+  const auto json = request_timing_json(timing);
+  EXPECT_DOUBLE_EQ(json.at("queue_ms").get<double>(), 2.0);
+  EXPECT_DOUBLE_EQ(json.at("total_ms").get<double>(), 1000.0);
+  EXPECT_FALSE(json.contains("serialize_ms"));
+  EXPECT_EQ(json.size(), 7U);
+}
+
+TEST(RequestTiming, SplitsDecodeLoopIntoComponents) {
+  RequestTiming timing;
+  timing.recognizer_wait_sec = 0.2;
+  timing.resample_sec        = 0.05;
+  split_decode_time(timing, 1.0, 0.7);
+  EXPECT_NEAR(timing.asr_sec, 0.5, 1e-9);
+  EXPECT_NEAR(timing.container_sec, 0.25, 1e-9);
+
+  // Clock skew between the nested measurements never goes negative.
+  split_decode_time(timing, 0.1, 0.15);
+  EXPECT_DOUBLE_EQ(timing.container_sec, 0.0);
+}
+
+TEST(RequestTiming, WaitScopeCollectsOnlyItsOwnThread) {
+  record_recognizer_wait(1.0);  // no scope open: dropped
+
+  RecognizerWaitScope outer;
+  record_recognizer_wait(0.25);
+  {
+    RecognizerWaitScope inner;
+    record_recognizer_wait(0.5);
+    std::thread([] { record_recognizer_wait(4.0); }).join();
+    EXPECT_DOUBLE_EQ(inner.seconds(), 0.5);
+  }
+  record_recognizer_wait(0.125);
+  EXPECT_DOUBLE_EQ(outer.seconds(), 0.375);
+}
+
+TEST(RequestTiming, BackendReportsSlotWait) {
+  SyntheticRecognizer      recognizer(1, SyntheticCostModel{50.0, 0.0, 0.0, false});
+  const std::vector<float> audio(1600, 0.0f);
+
+  std::thread holder([&recognizer, &audio] { (void)recognizer.recognize(audio, 16000); });
+  while (recognizer.load().slots_busy == 0) {
+    std::this_thread::yield();
+  }
+
+  RecognizerWaitScope scope;
+  (void)recognizer.recognize(audio, 16000);
+  holder.join();
+  EXPECT_GT(scope.seconds(), 0.01);
+}
+
+}  // namespace
+}  // namespace asr
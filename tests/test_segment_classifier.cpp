@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "asr/config.h"
+#include "asr/segment_classifier.h"
+#include "asr/span.h"
+
+namespace asr {
+namespace {
+
+constexpr int    kRate = 16000;
+constexpr double kPi   = 3.14159265358979323846;
+
+std::vector<float> tones(std::initializer_list<double> hz, double sec) {
+  std::vector<float> out(static_cast<size_t>(sec * kRate));
+  for (size_t i = 0; i < out.size(); ++i) {
+    double v = 0.0;
+    for (const double f : hz) {
+      v += 0.2 * std::sin(2.0 * kPi * f * static_cast<double>(i) / kRate);
+    }
+    out[i] = static_cast<float>(v);
+  }
+  return out;
+}
+
+std::vector<float> white_noise(double sec) {
+  std::mt19937                     rng(7);
+  std::normal_distribution<float> dist(0.0f, 0.1f);
+  std::vector<float>               out(static_cast<size_t>(sec * kRate));
+  for (auto& s : out) {
+    s = dist(rng);
+  }
+  return out;
+}
+
+// Three-note chords with two overtones each, a new chord every 400 ms.
+std::vector<float> hold_music(double sec) {
+  const double       chords[3][3] = {{262.0, 330.0, 392.0}, {294.0, 370.0, 440.0}, {220.0, 277.0, 330.0}};
+  std::vector<float> out(static_cast<size_t>(sec * kRate));
+  for (size_t i = 0; i < out.size(); ++i) {
+    const double t     = static_cast<double>(i) / kRate;
+    const auto&  chord = chords[static_cast<size_t>(t / 0.4) % 3];
+    double       v     = 0.0;
+    for (const double f : chord) {
+      v += 0.1 * std::sin(2.0 * kPi * f * t) + 0.05 * std::sin(4.0 * kPi * f * t) +
+           0.025 * std::sin(6.0 * kPi * f * t);
+    }
+    out[i] = static_cast<float>(v);
+  }
+  return out;
+}
+
+// Voiced speech stand-in: a gliding pitch whose harmonics are shaped by a
+// formant that jumps between vowels every 150 ms, over a little breath noise.
+std::vector<float> speech_like(double sec) {
+  const double                    formants[4] = {700.0, 400.0, 1100.0, 550.0};
+  std::mt19937                    rng(11);
+  std::normal_distribution<float> breath(0.0f, 0.005f);
+  std::vector<float>              out(static_cast<size_t>(sec * kRate));
+  double                          phase = 0.0;
+  for (size_t i = 0; i < out.size(); ++i) {
+    const double t       = static_cast<double>(i) / kRate;
+    const double f0      = 130.0 + 40.0 * std::sin(2.0 * kPi * 3.0 * t);
+    const double formant = formants[static_cast<size_t>(t / 0.15) % 4];
+    phase += 2.0 * kPi * f0 / kRate;
+    double v = 0.0;
+    for (int k = 1; k * f0 < 4000.0; ++k) {
+      const double distance = (k * f0 - formant) / 250.0;
+      v += 0.05 * std::exp(-distance * distance) * std::sin(static_cast<double>(k) * phase) / std::sqrt(k);
+    }
+    out[i] = static_cast<float>(v) + breath(rng);
+  }
+  return out;
+}
+
+TEST(SegmentClassifier, BeepAndDtmfAreTones) {
+  SegmentClassifier classifier(kRate);
+  const auto        beep = tones({1000.0}, 1.0);
+  const auto        dtmf = tones({697.0, 1209.0}, 0.5);  // "1"
+  EXPECT_EQ(classifier.classify(beep), SegmentClass::Tone);
+  EXPECT_EQ(classifier.classify(dtmf), SegmentClass::Tone);
+
+  const auto ringback = tones({425.0}, 1.0);
+  const auto f        = classifier.features(ringback);
+  EXPECT_GT(f.tonality, 0.95f);
+  EXPECT_GT(f.stability, 0.95f);
+  EXPECT_LT(f.flatness, 0.1f);
+}
+
+TEST(SegmentClassifier, SustainedChordsAreMusic) {
+  SegmentClassifier classifier(kRate);
+  const auto        music = hold_music(3.0);
+  const auto        f     = classifier.features(music);
+  EXPECT_GE(f.stability, SegmentClassifier::kMusicStable);
+  EXPECT_EQ(classifier.classify(music), SegmentClass::Music);
+}
+
+TEST(SegmentClassifier, BroadbandHissIsNoise) {
+  SegmentClassifier classifier(kRate);
+  const auto        noise = white_noise(1.0);
+  const auto        f     = classifier.features(noise);
+  EXPECT_NEAR(f.flatness, 0.56f, 0.05f);
+  EXPECT_EQ(classifier.classify(noise), SegmentClass::Noise);
+}
+
+TEST(SegmentClassifier, VoicedSpeechPasses) {
+  SegmentClassifier classifier(kRate);
+  const auto        speech = speech_like(2.0);
+  const auto        f      = classifier.features(speech);
+  EXPECT_LT(f.stability, SegmentClassifier::kMusicStable);
+  EXPECT_LT(f.tonality, SegmentClassifier::kToneTonality);
+  EXPECT_LT(f.flatness, SegmentClassifier::kNoiseFlatness);
+  EXPECT_EQ(classifier.classify(speech), SegmentClass::Speech);
+}
+
+TEST(SegmentClassifier, ShortOrSilentSegmentsAreSpeech) {
+  SegmentClassifier classifier(kRate);
+  const auto        blip = tones({1000.0}, 0.2);  // under kMinFrames
+  EXPECT_EQ(classifier.classify(blip), SegmentClass::Speech);
+  const std::vector<float> silence(kRate, 0.0f);
+  EXPECT_EQ(classifier.features(silence).frames, 0U);
+  EXPECT_EQ(classifier.classify(silence), SegmentClass::Speech);
+}
+
+std::vector<float> joined(std::vector<float> head, const std::vector<float>& tail) {
+  head.insert(head.end(), tail.begin(), tail.end());
+  return head;
+}
+
+TEST(SegmentClassifier, UploadChunkWithSomeSpeechIsKept) {
+  SegmentClassifier classifier(kRate);
+  // A 20 s upload chunk that is mostly hold music or a tone still averages to
+  // non-speech as a whole; block by block the speech keeps it.
+  const auto on_hold = joined(speech_like(3.0), hold_music(17.0));
+  const auto beeping = joined(tones({697.0, 1209.0}, 17.0), speech_like(3.0));
+  EXPECT_EQ(classifier.classify(on_hold), SegmentClass::Music);
+  EXPECT_EQ(classifier.classify_blocks(on_hold), SegmentClass::Speech);
+  EXPECT_EQ(classifier.classify_blocks(beeping), SegmentClass::Speech);
+
+  const auto music = hold_music(20.0);
+  EXPECT_EQ(classifier.classify_blocks(music), SegmentClass::Music);
+  const auto pause_then_tone = joined(std::vector<float>(kRate * 5, 0.0f), tones({1000.0}, 15.5));
+  EXPECT_EQ(classifier.classify_blocks(pause_then_tone), SegmentClass::Tone);
+}
+
+TEST(SegmentClassifier, ParsesFilterModes) {
+  EXPECT_EQ(parse_nonspeech_mode("off"), NonSpeechMode::Off);
+  EXPECT_EQ(parse_nonspeech_mode(" Flag "), NonSpeechMode::Flag);
+  EXPECT_EQ(parse_nonspeech_mode("DROP"), NonSpeechMode::Drop);
+  EXPECT_THROW(parse_nonspeech_mode("maybe"), ConfigError);
+  EXPECT_STREQ(segment_class_name(SegmentClass::Music), "music");
+}
+
+}  // namespace
+}  // namespace asr
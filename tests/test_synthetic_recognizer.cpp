@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asr/config.h"
+#include "asr/executor.h"
+#include "asr/span.h"
+#include "asr/synthetic_recognizer.h"
+
+namespace asr {
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+TEST(SyntheticRecognizer, CostModelScalesWithAudio) {
+  const SyntheticCostModel model{10.0, 50.0, 0.0, false};
+  EXPECT_DOUBLE_EQ(model.base_cost_sec(0.0), 0.010);
+  EXPECT_DOUBLE_EQ(model.base_cost_sec(2.0), 0.110);
+}
+
+TEST(SyntheticRecognizer, DecodeTakesModelledTime) {
+  SyntheticRecognizer      rec(1, SyntheticCostModel{20.0, 10.0, 0.0, false});
+  const std::vector<float> audio(16000, 0.0f);  // 1 s -> 30 ms
+
+  const auto started = Clock::now();
+  const auto text    = rec.recognize(audio, 16000);
+  const auto elapsed = Clock::now() - started;
+  EXPECT_EQ(text, "synthetic 1.00s");
+  EXPECT_GE(elapsed, 30ms);
+  EXPECT_EQ(rec.decodes(), 1u);
+  EXPECT_TRUE(rec.ready());
+
+  EXPECT_TRUE(rec.recognize(span<const float>(), 16000).empty());
+  EXPECT_EQ(rec.decodes(), 1u);
+}
+
+TEST(SyntheticRecognizer, BurnCpuModeHoldsTheSlot) {
+  SyntheticRecognizer      rec(1, SyntheticCostModel{15.0, 0.0, 0.0, true});
+  const std::vector<float> audio(160, 0.0f);
+
+  const auto started = Clock::now();
+  (void)rec.recognize(audio, 16000);
+  EXPECT_GE(Clock::now() - started, 15ms);
+}
+
+TEST(SyntheticRecognizer, SaturatedPoolThrowsBusy) {
+  SyntheticRecognizer      rec(1, SyntheticCostModel{200.0, 0.0, 0.0, false}, /*wait_timeout_ms=*/10);
+  const std::vector<float> audio(160, 0.0f);
+
+  auto first = std::async(std::launch::async, [&rec, &audio]() { return rec.recognize(audio, 16000); });
+  while (rec.load().slots_busy == 0) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(rec.load().slots_total, 1u);
+  EXPECT_THROW((void)rec.recognize(audio, 16000), RecognizerBusyError);
+  EXPECT_FALSE(first.get().empty());
+  EXPECT_EQ(rec.load().slots_busy, 0u);
+}
+
+TEST(SyntheticRecognizer, ReservedSlotsServeOnlyRealtime) {
+  // 2 slots, 1 reserved: an upload holding the shared slot blocks other
+  // uploads but not realtime, which then also borrows the shared slot.
+  SyntheticRecognizer      rec(2, SyntheticCostModel{200.0, 0.0, 0.0, false}, /*wait_timeout_ms=*/10, 1,
+                               /*realtime_slots=*/1);
+  const std::vector<float> audio(160, 0.0f);
+
+  auto upload = std::async(std::launch::async, [&rec, &audio]() { return rec.recognize(audio, 16000); });
+  while (rec.load().slots_busy == 0) {
+    std::this_thread::yield();
+  }
+  EXPECT_THROW((void)rec.recognize(audio, 16000, SlotClass::Shared), RecognizerBusyError);
+
+  auto live = std::async(std::launch::async,
+                         [&rec, &audio]() { return rec.recognize(audio, 16000, SlotClass::Realtime); });
+  while (rec.load().slots_busy < 2) {
+    std::this_thread::yield();
+  }
+  EXPECT_THROW((void)rec.recognize(audio, 16000, SlotClass::Realtime), RecognizerBusyError);
+  EXPECT_FALSE(upload.get().empty());
+  EXPECT_FALSE(live.get().empty());
+
+  // Reserved slot free, shared slot borrowed by realtime: uploads still wait.
+  auto borrowed = std::async(std::launch::async, [&rec, &audio]() {
+    return rec.recognize(audio, 16000, SlotClass::Realtime);
+  });
+  auto reserved = std::async(std::launch::async, [&rec, &audio]() {
+    return rec.recognize(audio, 16000, SlotClass::Realtime);
+  });
+  while (rec.load().slots_busy < 2) {
+    std::this_thread::yield();
+  }
+  EXPECT_THROW((void)rec.recognize(audio, 16000, SlotClass::Shared), RecognizerBusyError);
+  EXPECT_FALSE(borrowed.get().empty());
+  EXPECT_FALSE(reserved.get().empty());
+}
+
+TEST(SyntheticRecognizer, DrivesExecutorAtPoolParallelism) {
+  // 8 decodes of 40 ms on 4 slots behind a 4-worker executor: two waves.
+  SyntheticRecognizer      rec(4, SyntheticCostModel{40.0, 0.0, 0.0, false});
+  BoundedExecutor          executor(4, 16);
+  const std::vector<float> audio(1600, 0.0f);
+  std::atomic<int>         completed{0};
+
+  const auto started = Clock::now();
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(executor.try_submit([&rec, &audio, &completed]() {
+      (void)rec.recognize(audio, 16000);
+      completed.fetch_add(1, std::memory_order_relaxed);
+    }));
+  }
+  ASSERT_TRUE(executor.wait_for_idle(5s));
+  const auto elapsed = Clock::now() - started;
+
+  EXPECT_EQ(completed.load(), 8);
+  EXPECT_EQ(rec.decodes(), 8u);
+  EXPECT_GE(elapsed, 80ms);
+  EXPECT_LT(elapsed, 320ms);  // well under the 8 x 40 ms serial time
+}
+
+TEST(SyntheticRecognizer, FactorySelectsBackendFromConfig) {
+  Config cfg;
+  cfg.recognizer_backend         = "synthetic";
+  cfg.recognizer_pool_size       = 3;
+  cfg.synthetic_call_ms          = 1.0f;
+  cfg.synthetic_ms_per_audio_sec = 2.0f;
+
+  const auto backend = make_recognizer_backend(cfg);
+  ASSERT_NE(backend, nullptr);
+  EXPECT_TRUE(backend->ready());
+  EXPECT_EQ(backend->load().slots_total, 3u);
+  auto* synthetic = dynamic_cast<SyntheticRecognizer*>(backend.get());
+  ASSERT_NE(synthetic, nullptr);
+  EXPECT_DOUBLE_EQ(synthetic->cost_model().ms_per_audio_sec, 2.0);
+}
+
+}  // namespace
+}  // namespace asr
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "asr/config.h"
+#include "asr/tenant.h"
+
+namespace asr {
+namespace {
+
+using namespace std::chrono_literals;
+
+TEST(Tenant, ParsesSpecs) {
+  const auto specs = parse_tenant_specs(" acme:key-1:3:2:120 ; beta:key-2:1 ;");
+  ASSERT_EQ(specs.size(), 2U);
+  EXPECT_EQ(specs[0].name, "acme");
+  EXPECT_EQ(specs[0].api_key, "key-1");
+  EXPECT_EQ(specs[0].weight, 3U);
+  EXPECT_EQ(specs[0].max_concurrent, 2U);
+  EXPECT_DOUBLE_EQ(specs[0].audio_sec_per_min, 120.0);
+  EXPECT_EQ(specs[1].name, "beta");
+  EXPECT_EQ(specs[1].max_concurrent, 0U);
+  EXPECT_DOUBLE_EQ(specs[1].audio_sec_per_min, 0.0);
+
+  EXPECT_TRUE(parse_tenant_specs("").empty());
+  EXPECT_TRUE(parse_tenant_specs("   ").empty());
+}
+
+TEST(Tenant, RejectsMalformedSpecs) {
+  EXPECT_THROW(parse_tenant_specs("acme:key"), ConfigError);
+  EXPECT_THROW(parse_tenant_specs("acme:key:0"), ConfigError);
+  EXPECT_THROW(parse_tenant_specs("acme:key:abc"), ConfigError);
+  EXPECT_THROW(parse_tenant_specs("acme:key:1:-1"), ConfigError);
+  EXPECT_THROW(parse_tenant_specs("acme:key:1:0:-5"), ConfigError);
+  EXPECT_THROW(parse_tenant_specs(":key:1"), ConfigError);
+  EXPECT_THROW(parse_tenant_specs("acme::1"), ConfigError);
+  EXPECT_THROW(parse_tenant_specs("acme:key:1;beta:key:1"), ConfigError);
+  EXPECT_THROW(parse_tenant_specs("acme:a:1;acme:b:1"), ConfigError);
+}
+
+TEST(Tenant, TokenBucketRefillsAndAllowsDebt) {
+  const auto  t0 = TokenBucket::Clock::now();
+  TokenBucket bucket(1.0, 10.0, t0);
+
+  EXPECT_TRUE(bucket.has_tokens(t0));
+  bucket.charge(25.0, t0);
+  EXPECT_DOUBLE_EQ(bucket.available(t0), -15.0);
+  EXPECT_FALSE(bucket.has_tokens(t0 + 10s));
+  EXPECT_TRUE(bucket.has_tokens(t0 + 16s));
+
+  // Refill is capped at the burst size.
+  EXPECT_DOUBLE_EQ(bucket.available(t0 + 1h), 10.0);
+}
+
+TEST(Tenant, ResolvesKeysWithDefaultFallback) {
+  TenantRegistry registry(parse_tenant_specs("acme:key-1:3;beta:key-2:1"));
+  ASSERT_EQ(registry.size(), 3U);
+  EXPECT_EQ(registry.spec(kDefaultTenant).name, "default");
+  EXPECT_EQ(registry.resolve("key-1"), 1U);
+  EXPECT_EQ(registry.resolve("key-2"), 2U);
+  EXPECT_EQ(registry.resolve("unknown"), kDefaultTenant);
+  EXPECT_EQ(registry.resolve(""), kDefaultTenant);
+  EXPECT_EQ(registry.weights(), (std::vector<uint32_t>{1, 3, 1}));
+}
+
+TEST(Tenant, DefaultEntryConfiguresFallbackTenant) {
+  TenantRegistry registry(parse_tenant_specs("default::2:1;acme:key-1:3"));
+  ASSERT_EQ(registry.size(), 2U);
+  EXPECT_EQ(registry.spec(kDefaultTenant).weight, 2U);
+  EXPECT_EQ(registry.spec(kDefaultTenant).max_concurrent, 1U);
+  EXPECT_EQ(registry.resolve(""), kDefaultTenant);
+}
+
+TEST(Tenant, EnforcesConcurrencyCap) {
+  TenantRegistry registry(parse_tenant_specs("acme:key-1:1:2"));
+  const size_t   acme = registry.resolve("key-1");
+
+  EXPECT_EQ(registry.try_admit(acme), TenantAdmission::Admitted);
+  EXPECT_EQ(registry.try_admit(acme), TenantAdmission::Admitted);
+  EXPECT_EQ(registry.try_admit(acme), TenantAdmission::ConcurrencyLimit);
+  EXPECT_EQ(registry.active(acme), 2U);
+
+  // Other tenants are unaffected.
+  EXPECT_EQ(registry.try_admit(kDefaultTenant), TenantAdmission::Admitted);
+
+  registry.release(acme);
+  EXPECT_EQ(registry.try_admit(acme), TenantAdmission::Admitted);
+}
+
+TEST(Tenant, EnforcesAudioQuota) {
+  TenantRegistry registry(parse_tenant_specs("acme:key-1:1:0:60"));
+  const size_t   acme = registry.resolve("key-1");
+
+  EXPECT_TRUE(registry.has_audio_quota(acme));
+  registry.charge_audio(acme, 90.0);
+  EXPECT_FALSE(registry.has_audio_quota(acme));
+  EXPECT_EQ(registry.try_admit(acme), TenantAdmission::QuotaExceeded);
+  EXPECT_EQ(registry.active(acme), 0U);
+
+  // Tenants without a quota are never charged.
+  registry.charge_audio(kDefaultTenant, 1e9);
+  EXPECT_TRUE(registry.has_audio_quota(kDefaultTenant));
+}
+
+}  // namespace
+}  // namespace asr
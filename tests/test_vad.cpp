@@ -169,5 +169,131 @@ TEST(Vad, IsSpeechFlag) {
   EXPECT_FALSE(vad.is_speech());
 }
 
+TEST(Vad, SplitOpenSegmentKeepsEverySampleOnce) {
+  if (!model_exists())
+    GTEST_SKIP() << "VAD model not found";
+  auto                  cfg = make_test_config();
+  VoiceActivityDetector vad(cfg);
+
+  // Not in speech: nothing to split
+  EXPECT_FALSE(vad.split_open_segment(16000));
+
+  auto speech = make_speech_signal(3.0f);
+  for (size_t i = 0; i + 512 <= speech.size(); i += 512) {
+    vad.accept_waveform(span<const float>(speech.data() + i, 512));
+  }
+  if (!vad.is_speech()) {
+    GTEST_SKIP() << "synthetic signal not detected as speech";
+  }
+
+  ASSERT_TRUE(vad.split_open_segment(16000));
+  EXPECT_TRUE(vad.is_speech());
+  ASSERT_FALSE(vad.empty());
+  const SpeechSegment head = vad.front();
+  vad.pop();
+  EXPECT_EQ(static_cast<int64_t>(head.samples.size()), head.end_sample - head.start_sample);
+  EXPECT_GE(head.samples.size(), static_cast<size_t>(cfg.min_speech_duration * 16000.0f));
+
+  vad.flush();
+  ASSERT_FALSE(vad.empty());
+  const auto& tail = vad.front();
+  EXPECT_EQ(tail.start_sample, head.end_sample);  // contiguous, no overlap
+  EXPECT_LE(tail.samples.size(), 16000U);         // only the lookback stayed open
+
+  // One speech run: Started before the split, Stopped at the flush
+  ASSERT_TRUE(vad.has_transition());
+  EXPECT_EQ(vad.front_transition().kind, SpeechTransition::Started);
+  vad.pop_transition();
+  ASSERT_TRUE(vad.has_transition());
+  EXPECT_EQ(vad.front_transition().kind, SpeechTransition::Stopped);
+}
+
+TEST(Vad, OpenSpeechTracksThePauseInProgress) {
+  if (!model_exists())
+    GTEST_SKIP() << "VAD model not found";
+  auto                     cfg = make_test_config();  // min_silence 0.5 s = 8000 samples
+  VoiceActivityDetector    vad(cfg);
+  const std::vector<float> window(512, 0.1f);
+
+  EXPECT_TRUE(vad.open_speech().empty());
+  EXPECT_FLOAT_EQ(vad.silence_progress(), 0.0f);
+
+  // Probabilities are fed directly, so the windows are speech or silence by fiat.
+  for (int i = 0; i < 20; ++i) {
+    vad.accept_window(window, 0.9f);
+  }
+  EXPECT_EQ(vad.open_speech().size(), 20U * 512U);
+  EXPECT_EQ(vad.open_start_sample(), 0);
+  EXPECT_FLOAT_EQ(vad.silence_progress(), 0.0f);
+
+  // A pause: the open segment excludes it and progress counts towards min_silence.
+  for (int i = 0; i < 5; ++i) {
+    vad.accept_window(window, 0.05f);
+  }
+  EXPECT_EQ(vad.open_speech().size(), 20U * 512U);
+  EXPECT_NEAR(vad.silence_progress(), 5.0f * 512.0f / 8000.0f, 1e-6f);
+
+  // Speech resumes: the pause joins the segment and progress starts over.
+  vad.accept_window(window, 0.9f);
+  EXPECT_EQ(vad.open_speech().size(), 26U * 512U);
+  EXPECT_FLOAT_EQ(vad.silence_progress(), 0.0f);
+
+  for (int i = 0; i < 15; ++i) {
+    vad.accept_window(window, 0.05f);
+  }
+  EXPECT_NEAR(vad.silence_progress(), 15.0f * 512.0f / 8000.0f, 1e-6f);
+  EXPECT_TRUE(vad.empty());
+
+  // The window that confirms the pause queues exactly what open_speech() showed.
+  vad.accept_window(window, 0.05f);
+  ASSERT_FALSE(vad.empty());
+  EXPECT_EQ(vad.front().samples.size(), 26U * 512U);
+  EXPECT_EQ(vad.front().start_sample, 0);
+  EXPECT_TRUE(vad.open_speech().empty());
+  EXPECT_FLOAT_EQ(vad.silence_progress(), 0.0f);
+}
+
+TEST(VadShards, CoverEveryWindowOnceWithWarmup) {
+  const auto shards = plan_vad_shards(1000, 4, 100, 60);
+  ASSERT_EQ(shards.size(), 4U);
+  EXPECT_EQ(shards.front().begin, 0U);
+  EXPECT_EQ(shards.front().warmup_begin, 0U);
+  EXPECT_EQ(shards.back().end, 1000U);
+  for (size_t k = 1; k < shards.size(); ++k) {
+    EXPECT_EQ(shards[k].begin, shards[k - 1].end);
+    EXPECT_EQ(shards[k].begin - shards[k].warmup_begin, 60U);
+  }
+
+  EXPECT_EQ(plan_vad_shards(1000, 16, 300, 60).size(), 3U);  // capped by the minimum shard length
+  EXPECT_EQ(plan_vad_shards(250, 4, 300, 60).size(), 1U);
+  EXPECT_EQ(plan_vad_shards(0, 4, 300, 60).size(), 1U);
+}
+
+TEST(Vad, ShardedSegmentationMatchesSequential) {
+  if (!model_exists())
+    GTEST_SKIP() << "VAD model not found";
+  auto cfg = make_test_config();
+
+  // 3 minutes of 2 s bursts between 3 s pauses, ending on a partial window
+  std::vector<float> audio;
+  const auto         burst = make_speech_signal(2.0f);
+  while (audio.size() < 180U * 16000U) {
+    audio.insert(audio.end(), burst.begin(), burst.end());
+    audio.insert(audio.end(), 3U * 16000U, 0.0f);
+  }
+  audio.resize(audio.size() + 100, 0.0f);
+
+  const auto sequential = segment_speech(cfg, audio, 1);
+  const auto sharded    = segment_speech(cfg, audio, 4);
+  ASSERT_EQ(sharded.size(), sequential.size());
+  for (size_t i = 0; i < sequential.size(); ++i) {
+    // Warm-up re-converges the LSTM; allow a window of drift at a boundary.
+    EXPECT_NEAR(static_cast<double>(sharded[i].start_sample), static_cast<double>(sequential[i].start_sample),
+                512.0);
+    EXPECT_NEAR(static_cast<double>(sharded[i].end_sample), static_cast<double>(sequential[i].end_sample),
+                512.0);
+  }
+}
+
 }  // namespace
 }  // namespace asr
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "asr/span.h"
+#include "asr/vad_threshold.h"
+
+namespace asr {
+namespace {
+
+// A window of constant amplitude: RMS = amplitude, level = 20 log10(amplitude) dBFS.
+std::vector<float> window_at(float amplitude) {
+  return std::vector<float>(512, amplitude);
+}
+
+TEST(AdaptiveVadThreshold, QuietChannelKeepsTheBase) {
+  AdaptiveVadThreshold adaptive(0.5f, 0.85f);
+  const auto           quiet = window_at(0.0005f);  // about -66 dBFS
+  for (int i = 0; i < 200; ++i) {
+    adaptive.on_window(quiet, false);
+  }
+  EXPECT_FLOAT_EQ(adaptive.threshold(), 0.5f);
+  EXPECT_NEAR(adaptive.noise_floor_dbfs(), -66.0f, 0.1f);
+}
+
+TEST(AdaptiveVadThreshold, NoiseFloorLiftsUpToHalfTheRange) {
+  AdaptiveVadThreshold adaptive(0.5f, 0.9f);
+  const auto           noisy = window_at(0.1f);  // -20 dBFS, above kNoisyDbfs
+  for (int i = 0; i < 10; ++i) {
+    adaptive.on_window(noisy, false);
+  }
+  EXPECT_FLOAT_EQ(adaptive.threshold(), 0.7f);
+
+  // Speech windows do not count towards the floor, and the floor falls fast.
+  const auto loud = window_at(0.5f);
+  for (int i = 0; i < 100; ++i) {
+    adaptive.on_window(loud, true);
+  }
+  EXPECT_FLOAT_EQ(adaptive.threshold(), 0.7f);
+  const auto quiet = window_at(0.0005f);
+  for (int i = 0; i < 100; ++i) {
+    adaptive.on_window(quiet, false);
+  }
+  EXPECT_LT(adaptive.threshold(), 0.52f);
+}
+
+TEST(AdaptiveVadThreshold, NoiseFloorRisesSlowly) {
+  AdaptiveVadThreshold adaptive(0.5f, 0.9f);
+  const auto           quiet = window_at(0.0005f);
+  adaptive.on_window(quiet, false);
+  const auto burst = window_at(0.1f);  // a few loud non-speech windows
+  for (int i = 0; i < 5; ++i) {
+    adaptive.on_window(burst, false);
+  }
+  EXPECT_LT(adaptive.threshold(), 0.6f);
+}
+
+TEST(AdaptiveVadThreshold, EmptyDecodesStepUpWithHysteresis) {
+  AdaptiveVadThreshold adaptive(0.5f, 0.7f);
+  EXPECT_FALSE(adaptive.on_decode(true));
+  EXPECT_FALSE(adaptive.on_decode(true));
+  EXPECT_FALSE(adaptive.on_decode(false));
+  EXPECT_TRUE(adaptive.on_decode(true));  // 3 of 4 empty
+  EXPECT_FLOAT_EQ(adaptive.threshold(), 0.55f);
+  EXPECT_FLOAT_EQ(adaptive.empty_ratio(), 0.0f);  // fresh history after a step
+
+  // A mixed history in the band holds.
+  for (size_t i = 0; i < AdaptiveVadThreshold::kHistory; ++i) {
+    EXPECT_FALSE(adaptive.on_decode(i % 4 == 0)) << i;
+  }
+  EXPECT_FLOAT_EQ(adaptive.threshold(), 0.55f);
+
+  // Bounded by max.
+  for (int step = 0; step < 10; ++step) {
+    for (size_t i = 0; i < AdaptiveVadThreshold::kMinDecodes; ++i) {
+      (void)adaptive.on_decode(true);
+    }
+  }
+  EXPECT_FLOAT_EQ(adaptive.threshold(), 0.7f);
+
+  // A full history of text steps back down, never below the base.
+  for (int step = 0; step < 10; ++step) {
+    for (size_t i = 0; i < AdaptiveVadThreshold::kHistory; ++i) {
+      (void)adaptive.on_decode(false);
+    }
+  }
+  EXPECT_FLOAT_EQ(adaptive.threshold(), 0.5f);
+}
+
+TEST(AdaptiveVadThreshold, MaxBelowBaseDisablesAdaptation) {
+  AdaptiveVadThreshold adaptive(0.9f, 0.85f);
+  const auto           noisy = window_at(0.1f);
+  adaptive.on_window(noisy, false);
+  for (size_t i = 0; i < AdaptiveVadThreshold::kHistory; ++i) {
+    (void)adaptive.on_decode(true);
+  }
+  EXPECT_FLOAT_EQ(adaptive.threshold(), 0.9f);
+}
+
+}  // namespace
+}  // namespace asr
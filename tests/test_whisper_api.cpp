@@ -206,6 +206,36 @@ TEST(WhisperApi, RenderJsonResponse) {
   EXPECT_EQ(json["text"], "hello world");
 }
 
+TEST(WhisperApi, RenderTimingsInJsonFormatsOnly) {
+  WhisperTranscriptionRequest request;
+  request.model = "whisper-1";
+
+  WhisperTranscriptionResponsePayload payload;
+  payload.text               = "hello";
+  payload.timings            = RequestTiming{};
+  payload.timings->queue_sec = 0.002;
+  payload.timings->asr_sec   = 0.1;
+  payload.timings->total_sec = 0.15;
+
+  for (const auto format : {WhisperResponseFormat::Json, WhisperResponseFormat::VerboseJson}) {
+    request.response_format = format;
+    const auto json         =
+        nlohmann::json::parse(render_whisper_transcription_response(request, payload).body);
+    ASSERT_TRUE(json.contains("timings"));
+    EXPECT_DOUBLE_EQ(json["timings"]["queue_ms"].get<double>(), 2.0);
+    EXPECT_DOUBLE_EQ(json["timings"]["asr_ms"].get<double>(), 100.0);
+    EXPECT_DOUBLE_EQ(json["timings"]["total_ms"].get<double>(), 150.0);
+  }
+
+  request.response_format = WhisperResponseFormat::Text;
+  EXPECT_EQ(render_whisper_transcription_response(request, payload).body, "hello");
+
+  payload.timings.reset();
+  request.response_format = WhisperResponseFormat::Json;
+  EXPECT_FALSE(nlohmann::json::parse(render_whisper_transcription_response(request, payload).body)
+                   .contains("timings"));
+}
+
 TEST(WhisperApi, RenderTextResponse) {
   WhisperTranscriptionRequest request;
   request.model           = "whisper-1";